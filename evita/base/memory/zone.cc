@@ -2,17 +2,23 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <utility>
 
 #include "evita/base/memory/zone.h"
 
+#include "base/logging.h"
 #include "evita/base/memory/zone_allocated.h"
+#include "evita/base/switches.h"
 
 namespace evita {
 
 namespace {
 const size_t kAllocateUnit = 8;
 const size_t kMinSegmentSize = 8 * 1024;
+const size_t kMaxSegmentSize = 1024 * 1024;
 
 size_t RoundUp(size_t num, size_t unit) {
   return ((num + unit - 1) / unit) * unit;
@@ -30,69 +36,167 @@ class Zone::Segment final {
   ~Segment();
 
   Segment* next() const { return next_; }
+  size_t size() const { return size_; }
 
-  void* Allocate(size_t size);
+  void* Allocate(size_t size, size_t alignment);
+  // Makes this segment empty and the last segment.
+  void Reset();
 
  private:
-  Segment* const next_;
-  size_t const max_offset_;
+  char* const memory_;
+  Segment* next_;
   size_t offset_;
-  char* memory_;
+  size_t const size_;
 
   DISALLOW_COPY_AND_ASSIGN(Segment);
 };
 
 Zone::Segment::Segment(size_t size, Segment* next)
-    : next_(next),
-      max_offset_(RoundUp(size, kMinSegmentSize)),
-      offset_(0u),
-      memory_(new char[max_offset_]) {}
+    : memory_(new char[size]), next_(next), offset_(0u), size_(size) {}
 
 Zone::Segment::~Segment() {
   delete[] memory_;
 }
 
-void* Zone::Segment::Allocate(size_t size) {
-  const auto allocate_size = RoundUp(size, kAllocateUnit);
-  const auto next_offset = offset_ + allocate_size;
-  if (next_offset > max_offset_)
+void* Zone::Segment::Allocate(size_t size, size_t alignment) {
+  const auto base = reinterpret_cast<uintptr_t>(memory_);
+  const auto start = RoundUp(base + offset_, alignment) - base;
+  if (start + size > size_)
     return nullptr;
-  auto* const result = &memory_[offset_];
-  offset_ = next_offset;
-  return result;
+  offset_ = start + size;
+  return &memory_[start];
+}
+
+void Zone::Segment::Reset() {
+  next_ = nullptr;
+  offset_ = 0;
 }
 
 //////////////////////////////////////////////////////////////////////
 //
 // Zone
 //
-Zone::Zone(Zone&& other) : name_(other.name_), segment_(other.segment_) {
+Zone::Zone(Zone&& other)
+    : counters_(other.counters_),
+      max_segment_size_(other.max_segment_size_),
+      name_(other.name_),
+      next_segment_size_(other.next_segment_size_),
+      num_allocated_bytes_(other.num_allocated_bytes_),
+      num_reserved_bytes_(other.num_reserved_bytes_),
+      num_segments_(other.num_segments_),
+      segment_(other.segment_) {
+  if (counters_)
+    counters_->DidCreateZone();
+  other.num_allocated_bytes_ = 0;
+  other.num_reserved_bytes_ = 0;
+  other.num_segments_ = 0;
   other.segment_ = nullptr;
 }
 
-Zone::Zone(const char* name) : name_(name), segment_(new Segment(0, nullptr)) {}
+Zone::Zone(const char* name,
+           size_t initial_segment_size,
+           size_t max_segment_size)
+    : counters_(switches::zone_registry
+                    ? ZoneRegistry::GetInstance()->CountersFor(name)
+                    : nullptr),
+      max_segment_size_(RoundUp(max_segment_size, kAllocateUnit)),
+      name_(name),
+      next_segment_size_(RoundUp(initial_segment_size, kAllocateUnit)) {
+  DCHECK_GT(initial_segment_size, 0u);
+  DCHECK_LE(initial_segment_size, max_segment_size);
+  if (counters_)
+    counters_->DidCreateZone();
+}
+
+Zone::Zone(const char* name, size_t initial_segment_size)
+    : Zone(name,
+           initial_segment_size,
+           std::max(initial_segment_size, kMaxSegmentSize)) {}
+
+Zone::Zone(const char* name) : Zone(name, kMinSegmentSize) {}
 
 Zone::~Zone() {
-  auto* segment = segment_;
-  while (segment) {
-    auto* const next_segment = segment->next();
-    delete segment;
-    segment = next_segment;
-  }
+  FreeSegments(segment_);
+  if (counters_)
+    counters_->DidDestroyZone();
 }
 
 Zone& Zone::operator=(Zone&& other) {
+  FreeSegments(segment_);
+  if (counters_)
+    counters_->DidDestroyZone();
+  counters_ = other.counters_;
+  if (counters_)
+    counters_->DidCreateZone();
+  max_segment_size_ = other.max_segment_size_;
+  name_ = other.name_;
+  next_segment_size_ = other.next_segment_size_;
+  num_allocated_bytes_ = other.num_allocated_bytes_;
+  num_reserved_bytes_ = other.num_reserved_bytes_;
+  num_segments_ = other.num_segments_;
   segment_ = other.segment_;
+  other.num_allocated_bytes_ = 0;
+  other.num_reserved_bytes_ = 0;
+  other.num_segments_ = 0;
   other.segment_ = nullptr;
   return *this;
 }
 
+void Zone::AddSegment(size_t size) {
+  segment_ = new Segment(size, segment_);
+  ++num_segments_;
+  num_reserved_bytes_ += size;
+  if (counters_)
+    counters_->DidAllocateSegment(size);
+}
+
 void* Zone::Allocate(size_t size) {
-  for (;;) {
-    if (auto* const pointer = segment_->Allocate(size))
-      return pointer;
-    segment_ = new Segment(size, segment_);
+  return Allocate(size, kAllocateUnit);
+}
+
+void* Zone::Allocate(size_t size, size_t alignment) {
+  DCHECK_GT(alignment, 0u);
+  DCHECK_EQ(alignment & (alignment - 1), 0u) << "Not power of two "
+                                             << alignment;
+  auto* pointer = segment_ ? segment_->Allocate(size, alignment) : nullptr;
+  if (!pointer) {
+    // Memory returned by |new char[]| may not be aligned to |alignment|.
+    AddSegment(std::max(next_segment_size_,
+                        RoundUp(size + alignment, kAllocateUnit)));
+    next_segment_size_ = std::min(next_segment_size_ * 2, max_segment_size_);
+    pointer = segment_->Allocate(size, alignment);
+    DCHECK(pointer);
+  }
+  num_allocated_bytes_ += size;
+  return pointer;
+}
+
+void Zone::FreeSegments(Segment* segment) {
+  while (segment) {
+    auto* const next_segment = segment->next();
+    --num_segments_;
+    num_reserved_bytes_ -= segment->size();
+    if (counters_)
+      counters_->DidFreeSegment(segment->size());
+    delete segment;
+    segment = next_segment;
+  }
+}
+
+void Zone::Reset() {
+  num_allocated_bytes_ = 0;
+  if (!segment_)
+    return;
+  if (!segment_->next()) {
+    segment_->Reset();
+    return;
   }
+  // Replace segments with a segment as large as all of them, so allocations
+  // as many as before |Reset()| fit into one segment.
+  const auto size = num_reserved_bytes_;
+  FreeSegments(segment_);
+  segment_ = nullptr;
+  AddSegment(size);
 }
 
 }  // namespace evita
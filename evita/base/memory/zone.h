@@ -7,6 +7,7 @@
 
 #include "base/macros.h"
 #include "evita/base/evita_base_export.h"
+#include "evita/base/memory/zone_registry.h"
 
 namespace evita {
 
@@ -14,29 +15,69 @@ namespace evita {
 //
 // Zone
 //
+// |Zone| allocates memory from segments. Size of segment starts with
+// |initial_segment_size| and doubles for each new segment until
+// |max_segment_size|. Memory allocated in |Zone| is released at once when
+// |Zone| is destroyed or |Reset()|.
+//
 class EVITA_BASE_EXPORT Zone final {
  public:
   Zone(const Zone& other) = delete;
   Zone(Zone&& other);
+  // |name| should be a string literal, since |ZoneRegistry| refers it.
+  // |ZoneRegistry| tracks zone only if |switches::zone_registry| is true on
+  // construction.
+  Zone(const char* name,
+       size_t initial_segment_size,
+       size_t max_segment_size);
+  Zone(const char* name, size_t initial_segment_size);
   explicit Zone(const char* name);
   ~Zone();
 
   Zone& operator=(const Zone& other) = delete;
   Zone& operator=(Zone&& other);
 
+  const char* name() const { return name_; }
+  // Number of bytes requested by |Allocate()| since construction or the last
+  // |Reset()|.
+  size_t num_allocated_bytes() const { return num_allocated_bytes_; }
+  // Number of bytes in segments.
+  size_t num_reserved_bytes() const { return num_reserved_bytes_; }
+  size_t num_segments() const { return num_segments_; }
+
   // Allocate |size| bytes of memory in the Zone.
   void* Allocate(size_t size);
+  // Allocate |size| bytes of memory aligned to |alignment|, which must be
+  // power of two.
+  void* Allocate(size_t size, size_t alignment);
 
   template <typename T>
   T* AllocateObjects(size_t length) {
-    return static_cast<T*>(Allocate(length * sizeof(T)));
+    return static_cast<T*>(Allocate(length * sizeof(T), alignof(T)));
   }
 
+  // Frees all allocated memory but keeps a segment as large as the high-water
+  // mark, e.g. total size of segments, for reusing memory, e.g. for scratch
+  // memory of each frame. Memory allocated before |Reset()| must not be used
+  // after |Reset()|.
+  void Reset();
+
  private:
   class Segment;
 
+  void AddSegment(size_t size);
+  // Frees |segment| and segments after it.
+  void FreeSegments(Segment* segment);
+
+  // |counters_| is null if |ZoneRegistry| doesn't track this zone.
+  ZoneRegistry::Counters* counters_;
+  size_t max_segment_size_;
   const char* name_;
-  Segment* segment_;
+  size_t next_segment_size_;
+  size_t num_allocated_bytes_ = 0;
+  size_t num_reserved_bytes_ = 0;
+  size_t num_segments_ = 0;
+  Segment* segment_ = nullptr;
 };
 
 }  // namespace evita
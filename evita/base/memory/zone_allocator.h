@@ -32,7 +32,7 @@ class ZoneAllocator {
   };
 
   explicit ZoneAllocator(Zone* zone) throw() : zone_(zone) {}
-  explicit ZoneAllocator(const ZoneAllocator& other) throw()
+  ZoneAllocator(const ZoneAllocator& other) throw()
       : zone_(other.zone_) {}
   template <typename U>
   ZoneAllocator(const ZoneAllocator<U>& other) throw()
@@ -0,0 +1,69 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <unordered_map>
+#include <vector>
+
+#include "evita/base/memory/zone.h"
+#include "evita/base/memory/zone_unordered_map.h"
+#include "evita/base/memory/zone_vector.h"
+#include "evita/base/testing/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace evita {
+
+namespace {
+
+const int kNumberOfElements = 1000;
+const int kNumberOfRepeats = 1000;
+
+}  // namespace
+
+TEST(ZonePerfTest, UnorderedMap) {
+  const auto std_rate =
+      base::MeasureRate(kNumberOfElements, kNumberOfRepeats, []() {
+        std::unordered_map<int, int> map;
+        for (auto index = 0; index < kNumberOfElements; ++index)
+          map[index] = index;
+      });
+  base::PrintPerfResult("unordered_map_insert", "std", std_rate, "ops/s");
+
+  Zone zone("ZonePerfTest");
+  const auto zone_rate =
+      base::MeasureRate(kNumberOfElements, kNumberOfRepeats, [&zone]() {
+        {
+          // |map| must be destroyed before |zone.Reset()|.
+          ZoneUnorderedMap<int, int> map(&zone);
+          for (auto index = 0; index < kNumberOfElements; ++index)
+            map[index] = index;
+        }
+        zone.Reset();
+      });
+  base::PrintPerfResult("unordered_map_insert", "zone", zone_rate, "ops/s");
+}
+
+TEST(ZonePerfTest, Vector) {
+  const auto std_rate =
+      base::MeasureRate(kNumberOfElements, kNumberOfRepeats, []() {
+        std::vector<int> vector;
+        for (auto index = 0; index < kNumberOfElements; ++index)
+          vector.push_back(index);
+      });
+  base::PrintPerfResult("vector_push_back", "std", std_rate, "ops/s");
+
+  Zone zone("ZonePerfTest");
+  const auto zone_rate =
+      base::MeasureRate(kNumberOfElements, kNumberOfRepeats, [&zone]() {
+        {
+          // |vector| must be destroyed before |zone.Reset()|.
+          ZoneVector<int> vector(&zone);
+          for (auto index = 0; index < kNumberOfElements; ++index)
+            vector.push_back(index);
+        }
+        zone.Reset();
+      });
+  base::PrintPerfResult("vector_push_back", "zone", zone_rate, "ops/s");
+}
+
+}  // namespace evita
@@ -0,0 +1,73 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/base/memory/zone_registry.h"
+
+#include "base/logging.h"
+#include "base/memory/singleton.h"
+
+namespace evita {
+
+//////////////////////////////////////////////////////////////////////
+//
+// ZoneRegistry::Counters
+//
+ZoneRegistry::Counters::Counters()
+    : num_reserved_bytes_(0),
+      num_segments_(0),
+      num_zones_(0),
+      peak_reserved_bytes_(0) {}
+
+ZoneRegistry::Counters::~Counters() {}
+
+void ZoneRegistry::Counters::DidAllocateSegment(size_t size) {
+  ++num_segments_;
+  const auto num_reserved_bytes = num_reserved_bytes_ += size;
+  auto peak_reserved_bytes = peak_reserved_bytes_.load();
+  while (peak_reserved_bytes < num_reserved_bytes &&
+         !peak_reserved_bytes_.compare_exchange_weak(peak_reserved_bytes,
+                                                     num_reserved_bytes)) {
+  }
+}
+
+void ZoneRegistry::Counters::DidCreateZone() {
+  ++num_zones_;
+}
+
+void ZoneRegistry::Counters::DidDestroyZone() {
+  DCHECK_GT(num_zones_, 0u);
+  --num_zones_;
+}
+
+void ZoneRegistry::Counters::DidFreeSegment(size_t size) {
+  DCHECK_GT(num_segments_, 0u);
+  DCHECK_GE(num_reserved_bytes_, size);
+  --num_segments_;
+  num_reserved_bytes_ -= size;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// ZoneRegistry
+//
+ZoneRegistry::ZoneRegistry() {}
+ZoneRegistry::~ZoneRegistry() {}
+
+ZoneRegistry::Counters* ZoneRegistry::CountersFor(base::StringPiece name) {
+  base::AutoLock lock_scope(lock_);
+  auto& counters = map_[name];
+  if (!counters)
+    counters.reset(new Counters());
+  return counters.get();
+}
+
+// static
+ZoneRegistry* ZoneRegistry::GetInstance() {
+  // Zones may be destroyed after at exit manager, e.g. zones in leaky
+  // singletons, so |ZoneRegistry| should be leaky.
+  return base::Singleton<ZoneRegistry,
+                         base::LeakySingletonTraits<ZoneRegistry>>::get();
+}
+
+}  // namespace evita
@@ -0,0 +1,83 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_BASE_MEMORY_ZONE_REGISTRY_H_
+#define EVITA_BASE_MEMORY_ZONE_REGISTRY_H_
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "evita/base/evita_base_export.h"
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}
+
+namespace evita {
+
+//////////////////////////////////////////////////////////////////////
+//
+// ZoneRegistry
+//
+// |ZoneRegistry| holds memory usage of zones grouped by name of zone, e.g.
+// all zones of formatted lines, for monitoring memory usage. Zones are
+// tracked only if |switches::zone_registry| is true.
+//
+class EVITA_BASE_EXPORT ZoneRegistry final {
+ public:
+  // Counters of zones having same name. Counters are updated by zones on
+  // creating and destroying zone and segment, which are rare compared with
+  // allocation, and can be read from any thread.
+  class EVITA_BASE_EXPORT Counters final {
+   public:
+    Counters();
+    ~Counters();
+
+    size_t num_reserved_bytes() const { return num_reserved_bytes_; }
+    size_t num_segments() const { return num_segments_; }
+    size_t num_zones() const { return num_zones_; }
+    size_t peak_reserved_bytes() const { return peak_reserved_bytes_; }
+
+    void DidAllocateSegment(size_t size);
+    void DidCreateZone();
+    void DidDestroyZone();
+    void DidFreeSegment(size_t size);
+
+   private:
+    std::atomic<size_t> num_reserved_bytes_;
+    std::atomic<size_t> num_segments_;
+    std::atomic<size_t> num_zones_;
+    std::atomic<size_t> peak_reserved_bytes_;
+
+    DISALLOW_COPY_AND_ASSIGN(Counters);
+  };
+
+  // Returns counters of zones named |name|. Returned counters live forever.
+  Counters* CountersFor(base::StringPiece name);
+
+  static ZoneRegistry* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<ZoneRegistry>;
+
+  ZoneRegistry();
+  ~ZoneRegistry();
+
+  base::Lock lock_;
+  std::unordered_map<base::StringPiece,
+                     std::unique_ptr<Counters>,
+                     base::StringPieceHash>
+      map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneRegistry);
+};
+
+}  // namespace evita
+
+#endif  // EVITA_BASE_MEMORY_ZONE_REGISTRY_H_
@@ -0,0 +1,165 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "evita/base/memory/zone.h"
+
+#include "base/macros.h"
+#include "evita/base/memory/zone_registry.h"
+#include "evita/base/memory/zone_unordered_map.h"
+#include "evita/base/memory/zone_vector.h"
+#include "evita/base/switches.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace evita {
+
+namespace {
+
+// Makes |ZoneRegistry| to track zones created in this scope.
+class ScopedZoneRegistry final {
+ public:
+  ScopedZoneRegistry() { switches::zone_registry = true; }
+  ~ScopedZoneRegistry() { switches::zone_registry = false; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedZoneRegistry);
+};
+
+const ZoneRegistry::Counters& CountersOf(base::StringPiece name) {
+  return *ZoneRegistry::GetInstance()->CountersFor(name);
+}
+
+}  // namespace
+
+TEST(ZoneTest, Allocate) {
+  Zone zone("ZoneTest.Allocate", 64, 256);
+  EXPECT_EQ(0u, zone.num_segments()) << "Zone allocates segment lazily.";
+
+  zone.Allocate(40);
+  EXPECT_EQ(40u, zone.num_allocated_bytes());
+  EXPECT_EQ(1u, zone.num_segments());
+  EXPECT_EQ(64u, zone.num_reserved_bytes());
+
+  zone.Allocate(40);
+  EXPECT_EQ(2u, zone.num_segments());
+  EXPECT_EQ(64u + 128u, zone.num_reserved_bytes())
+      << "Size of segment is doubled.";
+
+  zone.Allocate(100);
+  zone.Allocate(100);
+  EXPECT_EQ(3u, zone.num_segments());
+  EXPECT_EQ(64u + 128u + 256u, zone.num_reserved_bytes());
+
+  zone.Allocate(200);
+  EXPECT_EQ(4u, zone.num_segments());
+  EXPECT_EQ(64u + 128u + 256u + 256u, zone.num_reserved_bytes())
+      << "Size of segment is limited by max segment size.";
+
+  zone.Allocate(1000);
+  EXPECT_EQ(5u, zone.num_segments());
+  EXPECT_LE(64u + 128u + 256u + 256u + 1000u, zone.num_reserved_bytes())
+      << "Large allocation has its own segment.";
+}
+
+TEST(ZoneTest, AllocateAlignment) {
+  Zone zone("ZoneTest.AllocateAlignment");
+  zone.Allocate(1, 1);
+  const auto pointer = zone.Allocate(8, 64);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % 64);
+  const auto characters = zone.AllocateObjects<char>(3);
+  EXPECT_EQ(static_cast<char*>(pointer) + 8, characters)
+      << "Small alignment doesn't waste memory.";
+  const auto doubles = zone.AllocateObjects<double>(2);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(doubles) % alignof(double));
+}
+
+TEST(ZoneTest, Move) {
+  ScopedZoneRegistry zone_registry;
+  Zone zone1("ZoneTest.Move");
+  const auto pointer = static_cast<int*>(zone1.Allocate(sizeof(int)));
+  *pointer = 42;
+  Zone zone2(std::move(zone1));
+  EXPECT_EQ(0u, zone1.num_segments());
+  EXPECT_EQ(1u, zone2.num_segments());
+  EXPECT_EQ(42, *pointer);
+  EXPECT_EQ(2u, CountersOf("ZoneTest.Move").num_zones());
+  EXPECT_EQ(1u, CountersOf("ZoneTest.Move").num_segments());
+}
+
+TEST(ZoneTest, Registry) {
+  const auto& counters = CountersOf("ZoneTest.Registry");
+  {
+    ScopedZoneRegistry zone_registry;
+    Zone zone1("ZoneTest.Registry", 1024);
+    Zone zone2("ZoneTest.Registry", 1024);
+    zone1.Allocate(10);
+    zone2.Allocate(10);
+    zone2.Allocate(2000);
+    EXPECT_EQ(2u, counters.num_zones());
+    EXPECT_EQ(3u, counters.num_segments());
+    EXPECT_EQ(zone1.num_reserved_bytes() + zone2.num_reserved_bytes(),
+              counters.num_reserved_bytes());
+    EXPECT_EQ(counters.num_reserved_bytes(), counters.peak_reserved_bytes());
+  }
+  EXPECT_EQ(0u, counters.num_zones());
+  EXPECT_EQ(0u, counters.num_segments());
+  EXPECT_EQ(0u, counters.num_reserved_bytes());
+  EXPECT_LT(0u, counters.peak_reserved_bytes());
+}
+
+TEST(ZoneTest, RegistryDisabled) {
+  Zone zone("ZoneTest.RegistryDisabled");
+  zone.Allocate(10);
+  const auto& counters = CountersOf("ZoneTest.RegistryDisabled");
+  EXPECT_EQ(0u, counters.num_zones())
+      << "Zones aren't tracked unless switches::zone_registry is true.";
+  EXPECT_EQ(0u, counters.num_segments());
+}
+
+TEST(ZoneTest, Reset) {
+  Zone zone("ZoneTest.Reset", 64);
+  zone.Allocate(40);
+  zone.Allocate(40);
+  zone.Allocate(100);
+  EXPECT_EQ(3u, zone.num_segments());
+
+  zone.Reset();
+  EXPECT_EQ(0u, zone.num_allocated_bytes());
+  EXPECT_EQ(1u, zone.num_segments());
+  EXPECT_EQ(448u, zone.num_reserved_bytes())
+      << "Reset() keeps a segment as large as all segments.";
+  const auto pointer = zone.Allocate(40);
+  zone.Allocate(40);
+  zone.Allocate(100);
+  EXPECT_EQ(1u, zone.num_segments()) << "Allocations fit into one segment.";
+
+  zone.Reset();
+  EXPECT_EQ(448u, zone.num_reserved_bytes());
+  EXPECT_EQ(pointer, zone.Allocate(40))
+      << "Reset() reuses the only segment.";
+}
+
+TEST(ZoneTest, ZoneUnorderedMap) {
+  Zone zone("ZoneTest.ZoneUnorderedMap");
+  ZoneUnorderedMap<int, int> map(&zone);
+  for (auto index = 0; index < 100; ++index)
+    map[index] = index * 2;
+  EXPECT_EQ(100u, map.size());
+  EXPECT_EQ(84, map[42]);
+}
+
+TEST(ZoneTest, ZoneVector) {
+  Zone zone("ZoneTest.ZoneVector");
+  ZoneVector<int> vector(&zone);
+  for (auto index = 0; index < 100; ++index)
+    vector.push_back(index);
+  EXPECT_EQ(100u, vector.size());
+  EXPECT_EQ(42, vector[42]);
+  EXPECT_LE(100 * sizeof(int), zone.num_allocated_bytes());
+}
+
+}  // namespace evita
@@ -6,6 +6,7 @@
 #define EVITA_BASE_MEMORY_ZONE_UNORDERED_MAP_H_
 
 #include <unordered_map>
+#include <utility>
 
 #include "evita/base/memory/zone.h"
 #include "evita/base/memory/zone_allocator.h"
@@ -23,15 +24,17 @@ class ZoneUnorderedMap
                                 T,
                                 typename std::unordered_map<K, T>::hasher,
                                 typename std::unordered_map<K, T>::key_equal,
-                                ZoneAllocator<T>> {
+                                ZoneAllocator<std::pair<const K, T>>> {
   typedef std::unordered_map<K,
                              T,
                              typename std::unordered_map<K, T>::hasher,
                              typename std::unordered_map<K, T>::key_equal,
-                             ZoneAllocator<T>> BaseClass;
+                             ZoneAllocator<std::pair<const K, T>>>
+      BaseClass;
 
  public:
-  explicit ZoneUnorderedMap(Zone* zone) : BaseClass(ZoneAllocator<T>(zone)) {}
+  explicit ZoneUnorderedMap(Zone* zone)
+      : BaseClass(ZoneAllocator<std::pair<const K, T>>(zone)) {}
 };
 
 }  // namespace evita
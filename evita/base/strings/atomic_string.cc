@@ -44,7 +44,9 @@ bool AtomicString::operator==(const AtomicString& other) const {
 }
 
 bool AtomicString::operator==(base::StringPiece16 other) const {
-  return *this == AtomicStringFactory::GetInstance()->New(other);
+  const auto& maybe_other =
+      AtomicStringFactory::GetInstance()->FindIfExists(other);
+  return maybe_other.IsJust() && *this == maybe_other.FromJust();
 }
 
 bool AtomicString::operator!=(const AtomicString& other) const {
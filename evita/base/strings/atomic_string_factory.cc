@@ -2,52 +2,187 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string.h>
+
+#include <new>
+#include <vector>
+
 #include "evita/base/strings/atomic_string_factory.h"
 
 #include "base/logging.h"
 #include "base/memory/singleton.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "evita/base/memory/zone.h"
 #include "evita/base/strings/atomic_string.h"
 
 namespace base {
 
+namespace {
+
+const size_t kInitialShardCapacity = 256;
+
+//////////////////////////////////////////////////////////////////////
+//
+// Entry
+//
+// |value| must be the first member, since |AtomicString| holds a pointer to
+// it.
+//
+struct Entry {
+  base::StringPiece16 value;
+  size_t hash;
+};
+
+// FNV-1a hash of UTF-16 code units.
+size_t HashOf(base::StringPiece16 value) {
+  uint32_t hash = 2166136261u;
+  for (const auto code_unit : value) {
+    hash ^= static_cast<uint32_t>(code_unit);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// AtomicStringFactory::Shard
+//
+class AtomicStringFactory::Shard final {
+ public:
+  Shard();
+  ~Shard();
+
+  const base::StringPiece16* Find(base::StringPiece16 value,
+                                  size_t hash) const;
+  const base::StringPiece16* FindOrAdd(base::StringPiece16 value,
+                                       size_t hash);
+
+ private:
+  size_t capacity() const { return slots_.size(); }
+
+  // Returns index of slot containing |value| or empty slot to insert
+  // |value|. Caller must hold |lock_|.
+  size_t FindSlot(base::StringPiece16 value, size_t hash) const;
+  void Grow();
+  Entry* NewEntry(base::StringPiece16 value, size_t hash);
+
+  mutable base::Lock lock_;
+  size_t size_;
+  std::vector<Entry*> slots_;
+  evita::Zone zone_;
+
+  DISALLOW_COPY_AND_ASSIGN(Shard);
+};
+
+AtomicStringFactory::Shard::Shard()
+    : size_(0), slots_(kInitialShardCapacity), zone_("AtomicStringFactory") {}
+
+AtomicStringFactory::Shard::~Shard() {}
+
+const base::StringPiece16* AtomicStringFactory::Shard::Find(
+    base::StringPiece16 value,
+    size_t hash) const {
+  base::AutoLock lock_scope(lock_);
+  auto* const entry = slots_[FindSlot(value, hash)];
+  return entry ? &entry->value : nullptr;
+}
+
+const base::StringPiece16* AtomicStringFactory::Shard::FindOrAdd(
+    base::StringPiece16 value,
+    size_t hash) {
+  base::AutoLock lock_scope(lock_);
+  auto index = FindSlot(value, hash);
+  if (auto* const present = slots_[index])
+    return &present->value;
+  // Keep load factor less than 3/4.
+  if ((size_ + 1) * 4 > capacity() * 3) {
+    Grow();
+    index = FindSlot(value, hash);
+  }
+  auto* const entry = NewEntry(value, hash);
+  slots_[index] = entry;
+  ++size_;
+  return &entry->value;
+}
+
+size_t AtomicStringFactory::Shard::FindSlot(base::StringPiece16 value,
+                                            size_t hash) const {
+  const auto mask = capacity() - 1;
+  for (auto index = (hash / kNumberOfShards) & mask;;
+       index = (index + 1) & mask) {
+    auto* const entry = slots_[index];
+    if (!entry)
+      return index;
+    if (entry->hash == hash && entry->value == value)
+      return index;
+  }
+}
+
+void AtomicStringFactory::Shard::Grow() {
+  std::vector<Entry*> old_slots(capacity() * 2);
+  slots_.swap(old_slots);
+  const auto mask = capacity() - 1;
+  for (auto* const entry : old_slots) {
+    if (!entry)
+      continue;
+    auto index = (entry->hash / kNumberOfShards) & mask;
+    while (slots_[index])
+      index = (index + 1) & mask;
+    slots_[index] = entry;
+  }
+}
+
+Entry* AtomicStringFactory::Shard::NewEntry(base::StringPiece16 value,
+                                            size_t hash) {
+  const auto size = value.size() * sizeof(base::char16);
+  auto* const string = static_cast<base::char16*>(zone_.Allocate(size));
+  ::memcpy(string, value.data(), size);
+  auto* const entry = static_cast<Entry*>(zone_.Allocate(sizeof(Entry)));
+  new (&entry->value) base::StringPiece16(string, value.size());
+  entry->hash = hash;
+  return entry;
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // AtomicStringFactory
 //
-AtomicStringFactory::AtomicStringFactory() : ZoneOwner("AtomicStringFactory") {}
+AtomicStringFactory::AtomicStringFactory() : unique_name_counter_(0) {
+  for (auto& shard : shards_)
+    shard.reset(new Shard());
+}
 
 AtomicStringFactory::~AtomicStringFactory() {}
 
-AtomicString AtomicStringFactory::New(base::StringPiece16 value) {
-  const auto& it = map_.find(value);
-  if (it != map_.end())
-    return AtomicString(it->second);
-  auto* const string_piece = NewStringPiece(value);
-  const auto& result = map_.emplace(*string_piece, string_piece);
-  DCHECK(result.second) << "Must be inserted";
-  return AtomicString(value);
+Maybe<AtomicString> AtomicStringFactory::FindIfExists(
+    base::StringPiece16 value) const {
+  const auto hash = HashOf(value);
+  auto* const string_piece = ShardFor(hash)->Find(value, hash);
+  if (!string_piece)
+    return Nothing<AtomicString>();
+  return Just(AtomicString(string_piece));
 }
 
-base::StringPiece16* AtomicStringFactory::NewStringPiece(
-    base::StringPiece16 string_piece) {
-  const auto size = string_piece.size() * sizeof(base::char16);
-  auto* const string = static_cast<base::char16*>(Allocate(size));
-  ::memcpy(string, string_piece.data(), size);
-  return new (Allocate(sizeof(base::StringPiece16)))
-      base::StringPiece16(string, string_piece.size());
+AtomicString AtomicStringFactory::New(base::StringPiece16 value) {
+  const auto hash = HashOf(value);
+  return AtomicString(ShardFor(hash)->FindOrAdd(value, hash));
 }
 
 AtomicString AtomicStringFactory::NewUniqueString(const base::char16* format) {
   for (;;) {
     const auto string = base::StringPrintf(format, ++unique_name_counter_);
-    const auto it = map_.find(string);
-    if (it == map_.end())
+    if (FindIfExists(string).IsNothing())
       return New(string);
   }
 }
 
+AtomicStringFactory::Shard* AtomicStringFactory::ShardFor(size_t hash) const {
+  return shards_[hash % kNumberOfShards].get();
+}
+
 // static
 AtomicStringFactory* AtomicStringFactory::GetInstance() {
   return base::Singleton<AtomicStringFactory>::get();
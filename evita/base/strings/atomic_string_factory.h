@@ -5,13 +5,14 @@
 #ifndef EVITA_BASE_STRINGS_ATOMIC_STRING_FACTORY_H_
 #define EVITA_BASE_STRINGS_ATOMIC_STRING_FACTORY_H_
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <string>
-#include <unordered_map>
 
 #include "base/strings/string_piece.h"
 #include "evita/base/evita_base_export.h"
-#include "evita/base/memory/zone_owner.h"
+#include "evita/base/maybe.h"
 
 namespace base {
 
@@ -21,25 +22,33 @@ class AtomicString;
 //
 // AtomicStringFactory
 //
-class EVITA_BASE_EXPORT AtomicStringFactory final : public evita::ZoneOwner {
+// Atomic strings are interned into one of |kNumberOfShards| shards selected
+// by hash value of string, so threads interning different strings rarely
+// contend on the same lock. Each shard is an open addressing hash table of
+// zone allocated entries with precomputed hash value.
+//
+class EVITA_BASE_EXPORT AtomicStringFactory final {
  public:
   AtomicStringFactory();
   ~AtomicStringFactory();
 
+  // Returns interned atomic string of |value| or nothing. This function
+  // never allocates memory.
+  Maybe<AtomicString> FindIfExists(base::StringPiece16 value) const;
   AtomicString New(base::StringPiece16 value);
   AtomicString NewUniqueString(const base::char16* format);
 
   static AtomicStringFactory* GetInstance();
 
  private:
-  using EntityMap = std::unordered_map<base::StringPiece16,
-                                       base::StringPiece16*,
-                                       base::StringPiece16Hash>;
+  class Shard;
+
+  static const size_t kNumberOfShards = 16;
 
-  base::StringPiece16* NewStringPiece(base::StringPiece16 value);
+  Shard* ShardFor(size_t hash) const;
 
-  EntityMap map_;
-  int unique_name_counter_ = 0;
+  std::array<std::unique_ptr<Shard>, kNumberOfShards> shards_;
+  std::atomic<int> unique_name_counter_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomicStringFactory);
 };
@@ -0,0 +1,91 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "evita/base/strings/atomic_string.h"
+#include "evita/base/strings/atomic_string_factory.h"
+#include "evita/base/testing/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumberOfWords = 10000;
+const int kNumberOfRepeats = 20;
+
+std::vector<base::string16> MakeWords(const base::char16* format) {
+  std::vector<base::string16> words;
+  for (auto index = 0; index < kNumberOfWords; ++index)
+    words.push_back(base::StringPrintf(format, index));
+  return std::move(words);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// InternDelegate
+//
+class InternDelegate final : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit InternDelegate(const std::vector<base::string16>* words)
+      : words_(words) {}
+  ~InternDelegate() final = default;
+
+ private:
+  // base::DelegateSimpleThread::Delegate
+  void Run() final {
+    for (auto count = 0; count < kNumberOfRepeats; ++count) {
+      for (const auto& word : *words_)
+        AtomicString atomic_string(word);
+    }
+  }
+
+  const std::vector<base::string16>* const words_;
+
+  DISALLOW_COPY_AND_ASSIGN(InternDelegate);
+};
+
+void RunInternTest(const std::string& trace, int num_threads) {
+  const auto& words = MakeWords(
+      base::StringPrintf(L"intern%d_%%d", num_threads).c_str());
+  InternDelegate delegate(&words);
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (auto index = 0; index < num_threads; ++index) {
+    threads.emplace_back(new base::DelegateSimpleThread(
+        &delegate, base::StringPrintf("intern%d", index)));
+  }
+  const auto num_operations = num_threads * kNumberOfWords * kNumberOfRepeats;
+  const auto rate = MeasureRate(num_operations, 1, [&]() {
+    for (const auto& thread : threads)
+      thread->Start();
+    for (const auto& thread : threads)
+      thread->Join();
+  });
+  PrintPerfResult("intern", trace, rate, "ops/s");
+}
+
+}  // namespace
+
+TEST(AtomicStringPerfTest, FindIfExists) {
+  const auto& words = MakeWords(L"find%d");
+  auto* const factory = AtomicStringFactory::GetInstance();
+  const auto rate = MeasureRate(kNumberOfWords, kNumberOfRepeats, [&]() {
+    for (const auto& word : words)
+      factory->FindIfExists(word);
+  });
+  PrintPerfResult("find_if_exists", "missing", rate, "ops/s");
+}
+
+TEST(AtomicStringPerfTest, Intern) {
+  for (auto num_threads = 1; num_threads <= 8; num_threads *= 2)
+    RunInternTest(base::StringPrintf("threads_%d", num_threads), num_threads);
+}
+
+}  // namespace base
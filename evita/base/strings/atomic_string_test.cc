@@ -5,13 +5,37 @@
 #include <map>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "base/strings/stringprintf.h"
 #include "evita/base/strings/atomic_string.h"
 #include "evita/base/strings/atomic_string_factory.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
 
+TEST(AtomicStringTest, FindIfExists) {
+  auto* const factory = AtomicStringFactory::GetInstance();
+  EXPECT_TRUE(factory->FindIfExists(L"not-interned-yet").IsNothing());
+  EXPECT_FALSE(AtomicString(L"foo") == L"not-interned-yet");
+  EXPECT_TRUE(factory->FindIfExists(L"not-interned-yet").IsNothing());
+
+  const auto& name = AtomicString(L"interned");
+  EXPECT_EQ(Just(name), factory->FindIfExists(L"interned"));
+  EXPECT_TRUE(name == L"interned");
+}
+
+TEST(AtomicStringTest, Many) {
+  std::vector<AtomicString> names;
+  for (auto index = 0; index < 10000; ++index)
+    names.emplace_back(base::StringPrintf(L"many%d", index));
+  for (auto index = 0; index < 10000; ++index) {
+    const auto& name = AtomicString(base::StringPrintf(L"many%d", index));
+    EXPECT_EQ(names[index], name);
+    EXPECT_EQ(base::StringPrintf(L"many%d", index), name.as_string());
+  }
+}
+
 TEST(AtomicStringTest, Map) {
   std::map<AtomicString, int> map;
   map.emplace(AtomicString(L"one"), 1);
@@ -0,0 +1,19 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/base/switches.h"
+
+namespace evita {
+namespace switches {
+
+// Tracks memory usage of zones created while this switch is on in
+// |ZoneRegistry|. This switch is off by default, since looking up counters
+// of zone takes a lock and zones are created for each formatted line and
+// display item list.
+const char kZoneRegistry[] = "zone_registry";
+
+bool zone_registry;
+
+}  // namespace switches
+}  // namespace evita
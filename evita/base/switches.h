@@ -0,0 +1,21 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_BASE_SWITCHES_H_
+#define EVITA_BASE_SWITCHES_H_
+
+#include "evita/base/evita_base_export.h"
+
+namespace evita {
+namespace switches {
+// All switches in alphabetical order. The switches should be documented
+// alongside the definition of their values in the .cc file.
+EVITA_BASE_EXPORT extern const char kZoneRegistry[];
+
+EVITA_BASE_EXPORT extern bool zone_registry;
+
+}  // namespace switches
+}  // namespace evita
+
+#endif  // EVITA_BASE_SWITCHES_H_
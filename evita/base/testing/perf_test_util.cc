@@ -0,0 +1,18 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/base/testing/perf_test_util.h"
+
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+void PrintPerfResult(const std::string& measurement,
+                     const std::string& trace,
+                     double value,
+                     const std::string& units) {
+  perf_test::PrintResult(measurement, "", trace, value, units, true);
+}
+
+}  // namespace base
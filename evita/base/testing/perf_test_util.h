@@ -0,0 +1,45 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_BASE_TESTING_PERF_TEST_UTIL_H_
+#define EVITA_BASE_TESTING_PERF_TEST_UTIL_H_
+
+#include <string>
+
+#include "base/time/time.h"
+
+namespace base {
+
+// Returns elapsed time of running |function| once.
+template <typename Function>
+TimeDelta MeasureTime(const Function& function) {
+  const auto start = TimeTicks::Now();
+  function();
+  return TimeTicks::Now() - start;
+}
+
+// Returns operations per second of running |function| |num_repeats| times,
+// where |function| does |num_operations| operations for each run.
+template <typename Function>
+double MeasureRate(int num_operations,
+                   int num_repeats,
+                   const Function& function) {
+  const auto elapsed = MeasureTime([&]() {
+    for (auto count = 0; count < num_repeats; ++count)
+      function();
+  });
+  return static_cast<double>(num_operations) * num_repeats /
+         elapsed.InSecondsF();
+}
+
+// Prints |value| in |units| as an important result of |trace| in
+// |measurement|.
+void PrintPerfResult(const std::string& measurement,
+                     const std::string& trace,
+                     double value,
+                     const std::string& units);
+
+}  // namespace base
+
+#endif  // EVITA_BASE_TESTING_PERF_TEST_UTIL_H_
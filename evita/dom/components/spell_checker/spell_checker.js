@@ -36,6 +36,12 @@ const kMinWordLength = 3;
 /** @const @type {number} */
 const kMaxNumberOfRequests = 100;
 
+/**
+ * Maximum number of words sent to spelling engine at once by cold scanner.
+ * @const @type {number}
+ */
+const kMaxBatchSize = 1000;
+
 /** @const @type {number} */
 const kHotScanStartDelay = 100;
 
@@ -108,15 +114,56 @@ class Controller {
    */
   requestCheckSpelling(word) {
     ++this.numberOfRequests_;
-    return Editor.checkSpelling(word).then(isCorrect => {
-      --this.numberOfRequests_;
+    return this.didFinishRequest_(Editor.checkSpelling(word).then(isCorrect => {
       if (isCorrect)
         this.correctWords_.add(word);
       else
         this.missSpelledWords_.add(word);
       return isCorrect;
-    });
+    }));
+  }
+
+  /**
+   * Checks spelling of |words| in one request.
+   * @param {!Array<string>} words
+   * @return {!Promise<?>}
+   */
+  requestCheckSpellingBatch(words) {
+    ++this.numberOfRequests_;
+    return this.didFinishRequest_(
+        Editor.checkSpellingBatch(words).then(misspelledWords => {
+          /** @const @type {!Set<string>} */
+          const misspelledSet = new Set(misspelledWords);
+          for (const word of words) {
+            if (misspelledSet.has(word))
+              this.missSpelledWords_.add(word);
+            else
+              this.correctWords_.add(word);
+          }
+        }));
+  }
+
+  /**
+   * Decrements number of requests when |promise| is settled, as finally
+   * clause. Rejection is propagated to caller.
+   * @private
+   * @param {!Promise<?>} promise
+   * @return {!Promise<?>}
+   */
+  didFinishRequest_(promise) {
+    return promise.then(
+        value => {
+          --this.numberOfRequests_;
+          return value;
+        },
+        reason => {
+          --this.numberOfRequests_;
+          throw reason;
+        });
   }
+
+  /** @return {number} */
+  get numberOfRequests() { return this.numberOfRequests_; }
 }
 
 /** @const @type {!Controller} */
@@ -375,7 +422,7 @@ class ColdPainter extends Scanner {
     if (this.offset_ >= this.end_)
       return;
     this.resetLife(kMaxColdScanCount);
-    taskScheduler.schedule(this);
+    taskScheduler.schedule(this, 0, TaskPriority.LOW);
   }
 }
 
@@ -388,36 +435,12 @@ class ColdScanner extends Scanner {
   constructor(document) {
     super(document, 0, 0, 0);
 
-    /** @type {number} */
-    this.checked_ = 0;
+    /** @type {boolean} */
+    this.isWaiting_ = false;
 
-    // TODO(eval1749): We should use |Promise<boolean>| for return type
-    // once Blink IDL parser supports Promise type.
     this.painter_ = new ColdPainter(document);
   }
 
-  /**
-   * @private
-   * @param {number} wordStart
-   * @param {number} wordEnd
-   * @return {boolean}
-   */
-  checkWord(wordStart, wordEnd) {
-    /** @const @type {string} */
-    const word = this.prepareRequest(wordStart, wordEnd);
-    if (word.length === 0) {
-      this.checked_ = wordEnd;
-      return true;
-    }
-
-    if (!controller.canRequest())
-      return false;
-
-    controller.requestCheckSpelling(word).then(
-        () => { this.checked_ = wordEnd; });
-    return false;
-  }
-
   /**
    * @param {number} hotStart
    */
@@ -434,19 +457,66 @@ class ColdScanner extends Scanner {
     this.schedule(0);
   }
 
+  /**
+   * @private
+   * @param {number} start
+   * @param {number} end
+   */
+  paintRange(start, end) {
+    this.painter_.resetOffset(start, end);
+    this.painter_.run();
+  }
+
+  /*
+   * Collects unknown words up to |kMaxBatchSize| and checks them in one
+   * request, then paints scanned range once spelling engine responds.
+   */
   run() {
+    if (this.isWaiting_)
+      return;
     this.ensureOffsets();
     this.resetLife(kMaxColdScanCount);
+    /** @const @type {number} */
+    const scanStart = this.offset;
+    /** @type {number} */
+    let scanEnd = scanStart;
+    /** @const @type {!Set<string>} */
+    const words = new Set();
     for (let wordRange of this.words()) {
-      if (!this.checkWord(wordRange.start, wordRange.end))
+      scanEnd = wordRange.end;
+      /** @const @type {string} */
+      const word = this.prepareRequest(wordRange.start, wordRange.end);
+      if (word.length === 0)
+        continue;
+      words.add(word);
+      if (words.size >= kMaxBatchSize)
         break;
     }
-    this.painter_.resetOffset(this.offset, this.checked_);
-    this.resetLife(this.life);
-    this.painter_.run();
-    this.schedule(0);
+    if (words.size === 0) {
+      this.paintRange(scanStart, scanEnd);
+      this.schedule(0);
+      return;
+    }
+    this.isWaiting_ = true;
+    controller.requestCheckSpellingBatch(Array.from(words))
+        .then(
+            () => {
+              this.isWaiting_ = false;
+              this.paintRange(scanStart, scanEnd);
+              this.schedule(0);
+            },
+            () => {
+              // Words in failed batch are still unknown. We scan them again
+              // after delay rather than stopping cold scanner forever.
+              this.isWaiting_ = false;
+              this.updateOffset(scanStart, Math.max(scanStart, this.end));
+              this.schedule(kColdScanStartDelay);
+            });
   }
 
+  /** @return {boolean} */
+  get isWaiting() { return this.isWaiting_; }
+
   /**
    * @private
    * @param {number} delay
@@ -454,7 +524,7 @@ class ColdScanner extends Scanner {
   schedule(delay) {
     if (this.offset_ >= this.end_)
       return;
-    taskScheduler.schedule(this, delay);
+    taskScheduler.schedule(this, delay, TaskPriority.LOW);
   }
 }
 
@@ -534,7 +604,7 @@ class HotScanner extends Scanner {
   didChangeTextDocument(hotStart) {
     this.updateOffset(hotStart, this.document.length);
     this.caretIsHot_ = true;
-    taskScheduler.schedule(this, kHotScanStartDelay);
+    taskScheduler.schedule(this, kHotScanStartDelay, TaskPriority.HIGH);
   }
 
   didFocusWindow() {
@@ -613,7 +683,7 @@ class HotScanner extends Scanner {
   schedule(delay) {
     if (this.offset_ >= this.end_)
       return;
-    taskScheduler.schedule(this, delay);
+    taskScheduler.schedule(this, delay, TaskPriority.HIGH);
   }
 }
 
@@ -776,6 +846,12 @@ TextDocument.addObserver(new SpellCheckerController());
 // Enable spell checker for existing documents
 TextDocument.list.forEach(document => SpellChecker.enable(document));
 
+/** @constructor */
+spell_checker.ColdScanner = ColdScanner;
+
+/** @const @type {!Controller} */
+spell_checker.controller = controller;
+
 /** @constructor */
 spell_checker.SpellChecker = SpellChecker;
 });
@@ -0,0 +1,51 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+goog.require('spell_checker');
+goog.require('testing');
+
+goog.scope(() => {
+
+const ColdScanner = spell_checker.ColdScanner;
+const controller = spell_checker.controller;
+
+testing.test('SpellChecker.requestCheckSpellingBatch.rejected', (t) => {
+  testRunner.setStringsResult('CheckSpellingBatch', 5, []);
+  let rejected = false;
+  controller.requestCheckSpellingBatch(['hello', 'wrold'])
+      .catch(() => rejected = true);
+  t.expect(controller.numberOfRequests).toEqual(1);
+  testRunner.runMicrotasks();
+  t.expect(rejected, 'rejection is propagated').toEqual(true);
+  t.expect(controller.numberOfRequests).toEqual(0);
+  t.expect(controller.checkSpelling('wrold'), 'word is still unknown')
+      .toEqual('');
+});
+
+testing.test('SpellChecker.ColdScanner.rejected', (t) => {
+  const document = new TextDocument();
+  // Scanners of spell checker for |document| should not consume results of
+  // |Editor.checkSpellingBatch()|.
+  spell_checker.SpellChecker.disable(document);
+  document.replace(0, 0, 'hello wrold');
+  const scanner = new ColdScanner(document);
+  scanner.resetOffset(0, document.length);
+
+  testRunner.setStringsResult('CheckSpellingBatch', 5, []);
+  scanner.run();
+  t.expect(scanner.isWaiting).toEqual(true);
+  testRunner.runMicrotasks();
+  t.expect(scanner.isWaiting).toEqual(false);
+  t.expect(scanner.offset, 'words of failed batch are scanned again')
+      .toEqual(0);
+  t.expect(controller.numberOfRequests).toEqual(0);
+
+  testRunner.setStringsResult('CheckSpellingBatch', 0, ['wrold']);
+  scanner.run();
+  testRunner.runMicrotasks();
+  t.expect(scanner.offset).toEqual(document.length);
+  t.expect(controller.checkSpelling('wrold')).toEqual('misspelled');
+});
+
+});
@@ -16,6 +16,7 @@
 #include "evita/dom/css/css_style.h"
 #include "evita/dom/script_host.h"
 #include "evita/ginx/runner.h"
+#include "evita/text/layout/layout_thread.h"
 
 namespace dom {
 
@@ -39,6 +40,8 @@ void CSSStyleSheetHandle::AppendStyleRule(ScriptHost* script_host,
   const auto& runner = script_host->runner();
   const auto& context = runner->context();
   auto style = CSSStyle::ConvertFromV8(context, raw_style);
+  // Layout thread reads style sheets while it formats text.
+  base::AutoLock lock_scope(*layout::LayoutThread::GetInstance()->lock());
   handle->object_->AppendRule(selector, std::move(style));
 }
 
@@ -47,6 +50,7 @@ int CSSStyleSheetHandle::CountRules(CSSStyleSheetHandle* handle) {
 }
 
 void CSSStyleSheetHandle::DeleteRule(CSSStyleSheetHandle* handle, int index) {
+  base::AutoLock lock_scope(*layout::LayoutThread::GetInstance()->lock());
   handle->object_->RemoveRule(index);
 }
 
@@ -62,6 +66,7 @@ void CSSStyleSheetHandle::InsertStyleRule(ScriptHost* script_host,
   const auto& runner = script_host->runner();
   const auto& context = runner->context();
   auto style = CSSStyle::ConvertFromV8(context, raw_style);
+  base::AutoLock lock_scope(*layout::LayoutThread::GetInstance()->lock());
   handle->object_->InsertRule(selector, std::move(style), index);
 }
 
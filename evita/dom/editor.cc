@@ -156,6 +156,15 @@ v8::Local<v8::Promise> Editor::CheckSpelling(
                  word_to_check));
 }
 
+v8::Local<v8::Promise> Editor::CheckSpellingBatch(
+    const std::vector<base::string16>& words_to_check) {
+  return PromiseResolver::Call(
+      FROM_HERE,
+      base::Bind(&domapi::IoDelegate::CheckSpellingBatch,
+                 base::Unretained(ScriptHost::instance()->io_delegate()),
+                 words_to_check));
+}
+
 bool Editor::CollectGarbage(int hint) {
   if (hint >= 1 && hint <= 1000)
     return ScriptHost::instance()->isolate()->IdleNotification(hint);
@@ -43,6 +43,8 @@ class Editor final : public ginx::Scriptable<Editor> {
 
   static v8::Local<v8::Promise> Editor::CheckSpelling(
       const base::string16& word_to_check);
+  static v8::Local<v8::Promise> CheckSpellingBatch(
+      const std::vector<base::string16>& words_to_check);
 
   // |hint| is 1 to 1000: |v8::V8::IdelNotification(|hint|)| otherwise call
   // |v8::V8::LowMemoryNotification()|
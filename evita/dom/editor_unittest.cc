@@ -41,6 +41,17 @@ TEST_F(EditorTest, checkSpelling) {
   EXPECT_SCRIPT_FALSE("result");
 }
 
+TEST_F(EditorTest, checkSpellingBatch) {
+  EXPECT_SCRIPT_VALID(
+      "var result;"
+      "function checkSpellingBatch(words) {"
+      "  Editor.checkSpellingBatch(words).then(function(x) { result = x; });"
+      "}");
+  mock_io_delegate()->SetStrings("CheckSpellingBatch", 0, {L"wrod"});
+  EXPECT_SCRIPT_VALID("checkSpellingBatch(['word', 'wrod'])");
+  EXPECT_SCRIPT_EQ("wrod", "result.join(', ')");
+}
+
 TEST_F(EditorTest, getFileNameForLoad) {
   EXPECT_CALL(*mock_view_impl(), CreateEditorWindow(_));
   EXPECT_SCRIPT_VALID(
@@ -55,6 +55,16 @@ TextDocument.Obsolete = {
   YES: 'YES'
 };
 
+/**
+ * Values must be matched with |domapi::SaveFileDurability|.
+ * @enum {number}
+ */
+TextDocument.SaveDurability = {
+  NONE: 0,
+  FILE: 1,
+  DIRECTORY: 2
+};
+
 /** @enum{number} */
 var MessageBox = {
   ABORTRETRYIGNORE: 0x2,
@@ -105,6 +115,16 @@ var TableViewRowState = {
   ACTIVATING: 0x0020
 };
 
+/**
+ * Priority of tasks scheduled by |taskScheduler|. Smaller value runs earlier.
+ * @enum{number}
+ */
+var TaskPriority = {
+  HIGH: 0,
+  NORMAL: 1,
+  LOW: 2,
+};
+
 /** @enum{number} */
 var TextWindowComputeMethod = {
   END_OF_WINDOW: 0,
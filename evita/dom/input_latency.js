@@ -0,0 +1,72 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+(function() {
+  const kPrefix = 'InputLatency.';
+
+  /**
+   * Input-to-pixels latency of key presses, mouse presses and wheel events,
+   * measured in microseconds for each stage:
+   *   Queue: from creating event to dispatching it in script thread
+   *   Script: dispatching event to script
+   *   Wait: from dispatched to layout of text window
+   *   Layout: laying out text window
+   *   Paint: from laid out to painted
+   *   Commit: from painted to committed to compositor
+   *   Total: from creating event to committed
+   */
+  class InputLatency {
+    /**
+     * Returns count and percentiles of each stage.
+     * @return {!Promise<!Object>}
+     */
+    static dump() {
+      return Editor.metrics('all').then((json) => {
+        const times = JSON.parse(json)['times'] || {};
+        const result = {};
+        for (const name of Object.keys(times)) {
+          if (!name.startsWith(kPrefix))
+            continue;
+          const histogram = times[name];
+          result[name.substr(kPrefix.length)] = {
+            count: histogram['count'],
+            p50: histogram['p50'],
+            p95: histogram['p95'],
+            p99: histogram['p99'],
+            max: histogram['max'],
+          };
+        }
+        return result;
+      });
+    }
+
+    /**
+     * Writes recently committed input events into |fileName| in Chrome trace
+     * event format for loading into "chrome://tracing".
+     * @param {string} fileName
+     * @return {!Promise<number>}
+     */
+    static writeTo(fileName) {
+      /** @type {Os.File} */
+      let file = null;
+      /** @type {!TextEncoder} */
+      const encoder = new TextEncoder('utf-8');
+      return async(function*() {
+               const json = yield Editor.metrics('latency');
+               const trace = JSON.parse(json)['latency'];
+               file = yield Os.File.open(fileName, 'w');
+               yield file.write(encoder.encode(JSON.stringify(trace)));
+               file.close();
+               return trace['traceEvents'].length;
+             })().catch((reason) => {
+        if (!file)
+          return;
+        file.close();
+        file = null;
+      });
+    }
+  }
+
+  global.InputLatency = InputLatency;
+})();
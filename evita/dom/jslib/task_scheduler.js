@@ -3,59 +3,302 @@
 // found in the LICENSE file.
 
 goog.scope(function() {
-/** @type {number} */
-const kIntervalMs = 100;
+
+//////////////////////////////////////////////////////////////////////
+//
+// ScheduledTask
+//
+class ScheduledTask {
+  /**
+   * @param {!Runnable} task
+   * @param {TaskPriority} priority
+   * @param {number} runAt
+   * @param {number} sequenceNumber
+   */
+  constructor(task, priority, runAt, sequenceNumber) {
+    /** @type {TaskPriority} */
+    this.priority = priority;
+
+    /**
+     * The queue containing this task, one of ready queues or waiting queue.
+     * @type {base.OrderedSet<!ScheduledTask>}
+     */
+    this.queue = null;
+
+    /** @type {number} */
+    this.runAt = runAt;
+
+    /** @const @type {number} */
+    this.sequenceNumber = sequenceNumber;
+
+    /** @const @type {!Runnable} */
+    this.task = task;
+  }
+
+  /**
+   * Orders tasks in ready queue by order of scheduling.
+   * @param {!ScheduledTask} task1
+   * @param {!ScheduledTask} task2
+   * @return {boolean}
+   */
+  static isBeforeReady(task1, task2) {
+    return task1.sequenceNumber < task2.sequenceNumber;
+  }
+
+  /**
+   * Orders tasks in waiting queue by run time, then order of scheduling.
+   * @param {!ScheduledTask} task1
+   * @param {!ScheduledTask} task2
+   * @return {boolean}
+   */
+  static isBeforeWaiting(task1, task2) {
+    if (task1.runAt !== task2.runAt)
+      return task1.runAt < task2.runAt;
+    return task1.sequenceNumber < task2.sequenceNumber;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// TaskStatistics
+//
+class TaskStatistics {
+  constructor() {
+    /** @type {number} */
+    this.count = 0;
+
+    /** @type {number} */
+    this.maxTime = 0;
+
+    /** @type {number} */
+    this.totalTime = 0;
+  }
+
+  /** @param {number} time */
+  add(time) {
+    ++this.count;
+    this.maxTime = Math.max(this.maxTime, time);
+    this.totalTime += time;
+  }
+}
+
+/**
+ * @param {!Runnable} task
+ * @return {string}
+ */
+function taskTypeOf(task) {
+  return task.constructor.name || 'Anonymous';
+}
 
 //////////////////////////////////////////////////////////////////////
 //
 // TaskScheduler
 //
+// |TaskScheduler| runs tasks in idle time as many as fit in idle deadline in
+// order of priority, then order of scheduling. Since |IdleDeadline| has no
+// time remaining when script thread has pending tasks, e.g. input events, we
+// yield to them between tasks.
+//
+// Tasks are kept in an ordered queue per priority once their run time has
+// come, and delayed tasks are kept in a queue ordered by run time until then.
+//
 class TaskScheduler {
   constructor() {
-    /** @const @type {!function()} */
-    this.idleCallback_ = this.runTask.bind(this);
+    /** @const @type {!function(!IdleDeadline)} */
+    this.idleCallback_ = this.runTasks.bind(this);
+
+    /**
+     * Handle of requested idle callback, or zero if we don't request.
+     * @type {number}
+     */
+    this.idleCallbackId_ = 0;
+
+    /** @type {number} */
+    this.lastSequenceNumber_ = 0;
 
-    /** @type {boolean} */
-    this.isWaiting_ = false;
+    /**
+     * Queues of tasks ready to run indexed by |TaskPriority|.
+     * @const @type {!Array<!base.OrderedSet<!ScheduledTask>>}
+     */
+    this.readyQueues_ = [];
+    for (let priority = TaskPriority.HIGH; priority <= TaskPriority.LOW;
+         ++priority) {
+      this.readyQueues_.push(new base.OrderedSet(ScheduledTask.isBeforeReady));
+    }
 
-    /** @const @type {!Set<Runnable>} */
-    this.tasks_ = new Set();
+    /** @const @type {!Map<string, !TaskStatistics>} */
+    this.statistics_ = new Map();
+
+    /** @const @type {!Map<!Runnable, !ScheduledTask>} */
+    this.tasks_ = new Map();
+
+    /** @const @type {!base.OrderedSet<!ScheduledTask>} */
+    this.waitingQueue_ = new base.OrderedSet(ScheduledTask.isBeforeWaiting);
+
+    /** @type {number} */
+    this.waitUntil_ = 0;
   }
 
-  /** @private */
-  runTask() {
-    this.isWaiting_ = false;
-    if (this.tasks_.size === 0)
-      return;
-    const task = this.tasks_.values().next().value;
-    if (!task)
+  /**
+   * Prints number of runs and CPU time of each task type into console, in
+   * descending order of total time.
+   */
+  dump() {
+    const entries = Array.from(this.statistics_.entries());
+    entries.sort((entry1, entry2) => {
+      return entry2[1].totalTime - entry1[1].totalTime;
+    });
+    for (const [type, statistics] of entries) {
+      console.log(
+          `${type}: count=${statistics.count}` +
+          ` total=${statistics.totalTime.toFixed(3)}ms` +
+          ` max=${statistics.maxTime.toFixed(3)}ms`);
+    }
+  }
+
+  /**
+   * Adds |entry| to ready queue of its priority if its run time has come at
+   * |now|, or waiting queue otherwise.
+   * @private
+   * @param {!ScheduledTask} entry
+   * @param {number} now
+   */
+  enqueue(entry, now) {
+    entry.queue = entry.runAt <= now ? this.readyQueues_[entry.priority]
+                                     : this.waitingQueue_;
+    entry.queue.add(entry);
+  }
+
+  /**
+   * @private
+   * @return {boolean}
+   */
+  hasReadyTasks() {
+    return this.readyQueues_.some(queue => !queue.empty());
+  }
+
+  /**
+   * @private
+   * @param {number} now
+   * @return {ScheduledTask}
+   */
+  nextTask(now) {
+    while (!this.waitingQueue_.empty()) {
+      const entry = this.waitingQueue_.minimum;
+      if (entry.runAt > now)
+        break;
+      this.waitingQueue_.remove(entry);
+      this.enqueue(entry, now);
+    }
+    for (const queue of this.readyQueues_) {
+      if (!queue.empty())
+        return queue.minimum;
+    }
+    return null;
+  }
+
+  /**
+   * Removes |task| from scheduler. |task| doesn't run even if it is removed
+   * during running other tasks in the same idle callback.
+   * @param {Runnable} task
+   */
+  remove(task) {
+    const entry = this.tasks_.get(task);
+    if (!entry)
       return;
+    entry.queue.remove(entry);
+    this.tasks_.delete(task);
+  }
+
+  /**
+   * @private
+   * @param {!ScheduledTask} entry
+   */
+  runTask(entry) {
+    const task = entry.task;
     this.remove(task);
-    task.run();
-    this.wait(0);
+    const startTime = Editor.performance.now();
+    try {
+      task.run();
+    } finally {
+      const type = taskTypeOf(task);
+      if (!this.statistics_.has(type))
+        this.statistics_.set(type, new TaskStatistics());
+      this.statistics_.get(type).add(Editor.performance.now() - startTime);
+    }
   }
 
-  /** @param {Runnable} task */
-  remove(task) { this.tasks_.delete(task); }
+  /**
+   * Runs ready tasks until |deadline|. We run at least one task to make
+   * progress, even if |deadline| has been passed.
+   * @private
+   * @param {!IdleDeadline} deadline
+   */
+  runTasks(deadline) {
+    this.idleCallbackId_ = 0;
+    try {
+      do {
+        const entry = this.nextTask(Editor.performance.now());
+        if (!entry)
+          return;
+        this.runTask(entry);
+      } while (deadline.timeRemaining() > 0);
+    } finally {
+      this.wait();
+    }
+  }
 
   /**
+   * Schedules |task| to run after |delay| milliseconds. Scheduling a task
+   * which is already scheduled makes it run earlier or at higher priority,
+   * if requested.
    * @param {Runnable} task
    * @param {number=} delay
+   * @param {TaskPriority=} priority
    */
-  schedule(task, delay = 0) {
-    this.tasks_.add(task);
-    this.wait(delay);
+  schedule(task, delay = 0, priority = TaskPriority.NORMAL) {
+    const now = Editor.performance.now();
+    const runAt = now + delay;
+    const present = this.tasks_.get(task);
+    if (present) {
+      if (present.priority > priority || present.runAt > runAt) {
+        // Since queues are ordered by these fields, we update them out of
+        // queue.
+        present.queue.remove(present);
+        present.priority = Math.min(present.priority, priority);
+        present.runAt = Math.min(present.runAt, runAt);
+        this.enqueue(present, now);
+      }
+    } else {
+      ++this.lastSequenceNumber_;
+      const entry =
+          new ScheduledTask(task, priority, runAt, this.lastSequenceNumber_);
+      this.tasks_.set(task, entry);
+      this.enqueue(entry, now);
+    }
+    this.wait();
   }
 
   /**
+   * Requests idle callback at run time of the earliest task. We replace
+   * requested idle callback if it is later than the earliest task.
    * @private
-   * @param {number} delay
    */
-  wait(delay) {
-    if (this.isWaiting_ || this.tasks_.size === 0)
+  wait() {
+    if (this.tasks_.size === 0)
       return;
-    this.isWaiting_ = true;
-    Editor.requestIdleCallback(this.idleCallback_, {timeout: delay});
+    const now = Editor.performance.now();
+    const runAt =
+        this.hasReadyTasks() ? now : this.waitingQueue_.minimum.runAt;
+    if (this.idleCallbackId_) {
+      if (this.waitUntil_ <= runAt)
+        return;
+      Editor.cancelIdleCallback(this.idleCallbackId_);
+    }
+    this.waitUntil_ = runAt;
+    const delay = Math.max(Math.ceil(runAt - now), 0);
+    this.idleCallbackId_ =
+        Editor.requestIdleCallback(this.idleCallback_, {timeout: delay});
   }
 }
 
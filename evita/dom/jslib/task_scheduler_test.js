@@ -0,0 +1,120 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+goog.require('testing');
+
+goog.scope(() => {
+
+class SampleTask {
+  /**
+   * @param {!Array<string>} log
+   * @param {string} name
+   * @param {function()=} opt_callback
+   */
+  constructor(log, name, opt_callback) {
+    this.callback_ = opt_callback || (() => {});
+    this.log_ = log;
+    this.name_ = name;
+  }
+
+  run() {
+    this.log_.push(this.name_);
+    this.callback_();
+  }
+}
+
+class SampleDeadline {
+  /** @param {number} timeRemaining */
+  constructor(timeRemaining) { this.timeRemaining_ = timeRemaining; }
+
+  /** @return {number} */
+  timeRemaining() { return this.timeRemaining_; }
+}
+
+/**
+ * @param {!core.TaskScheduler} scheduler
+ * @param {number=} timeRemaining
+ */
+function runTasks(scheduler, timeRemaining = 1000) {
+  scheduler.runTasks(new SampleDeadline(timeRemaining));
+}
+
+testing.test('TaskScheduler.deadline', (t) => {
+  const log = [];
+  const scheduler = new core.TaskScheduler();
+  scheduler.schedule(new SampleTask(log, 'a'));
+  scheduler.schedule(new SampleTask(log, 'b'));
+
+  // At least one task runs even if there is no time remaining.
+  runTasks(scheduler, 0);
+  t.expect(log.join(' ')).toEqual('a');
+  runTasks(scheduler, 0);
+  t.expect(log.join(' ')).toEqual('a b');
+});
+
+testing.test('TaskScheduler.delay', (t) => {
+  const log = [];
+  const scheduler = new core.TaskScheduler();
+  const taskA = new SampleTask(log, 'a');
+  scheduler.schedule(taskA, 60 * 1000);
+  scheduler.schedule(new SampleTask(log, 'b'), 0, TaskPriority.LOW);
+
+  runTasks(scheduler);
+  t.expect(log.join(' ')).toEqual('b');
+
+  // Rescheduling without delay makes a delayed task ready.
+  scheduler.schedule(taskA);
+  runTasks(scheduler);
+  t.expect(log.join(' ')).toEqual('b a');
+});
+
+testing.test('TaskScheduler.priority', (t) => {
+  const log = [];
+  const scheduler = new core.TaskScheduler();
+  scheduler.schedule(new SampleTask(log, 'a'), 0, TaskPriority.LOW);
+  scheduler.schedule(new SampleTask(log, 'b'), 0, TaskPriority.NORMAL);
+  scheduler.schedule(new SampleTask(log, 'c'), 0, TaskPriority.HIGH);
+  scheduler.schedule(new SampleTask(log, 'd'));
+  scheduler.schedule(new SampleTask(log, 'e'), 0, TaskPriority.HIGH);
+
+  runTasks(scheduler);
+  t.expect(log.join(' ')).toEqual('c e b d a');
+});
+
+testing.test('TaskScheduler.remove', (t) => {
+  const log = [];
+  const scheduler = new core.TaskScheduler();
+  const taskB = new SampleTask(log, 'b');
+  const taskD = new SampleTask(log, 'd');
+  scheduler.schedule(
+      new SampleTask(log, 'a', () => scheduler.remove(taskD)));
+  scheduler.schedule(taskB);
+  scheduler.schedule(new SampleTask(log, 'c'));
+  scheduler.schedule(taskD);
+  scheduler.remove(taskB);
+  scheduler.remove(taskB);
+
+  // Task removed by other task in the same idle callback doesn't run.
+  runTasks(scheduler);
+  t.expect(log.join(' ')).toEqual('a c');
+});
+
+testing.test('TaskScheduler.schedule', (t) => {
+  const log = [];
+  const scheduler = new core.TaskScheduler();
+  const taskA = new SampleTask(log, 'a');
+  const taskC = new SampleTask(log, 'c');
+  scheduler.schedule(taskA);
+  scheduler.schedule(new SampleTask(log, 'b'));
+  scheduler.schedule(taskC);
+
+  // Rescheduling keeps order of scheduling, or raises priority.
+  scheduler.schedule(taskA, 0, TaskPriority.LOW);
+  scheduler.schedule(taskC, 0, TaskPriority.HIGH);
+  scheduler.schedule(taskC);
+
+  runTasks(scheduler);
+  t.expect(log.join(' ')).toEqual('c a b');
+});
+});
@@ -9,6 +9,8 @@
 
 #include <vector>
 
+#include "base/callback_forward.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
 #include "evita/dom/public/io_callback.h"
 #include "evita/dom/public/io_context_id.h"
@@ -18,6 +20,20 @@
 
 namespace domapi {
 
+class SaveFileData;
+
+// Specifies how durable saved file is when |IoDelegate::SaveFile()|
+// resolves promise. Values are also used by "TextDocument.SaveDurability" in
+// script.
+enum class SaveFileDurability {
+  // Don't flush file buffers. Contents may be lost on power failure.
+  None,
+  // Flush file contents before renaming.
+  File,
+  // Flush file contents and make renaming durable.
+  Directory,
+};
+
 //////////////////////////////////////////////////////////////////////
 //
 // IoDelegate
@@ -26,6 +42,9 @@ class IoDelegate {
  public:
   using CheckSpellingResolver = domapi::Promise<bool>;
 
+  using CheckSpellingBatchResolver =
+      domapi::Promise<std::vector<base::string16>>;
+
   using ComputeFullPathNamePromise = domapi::Promise<base::string16, IoError>;
 
   using GetWinResourceNamessPromise =
@@ -34,12 +53,19 @@ class IoDelegate {
   using GetSpellingSuggestionsResolver =
       domapi::Promise<std::vector<base::string16>>;
 
+  using SaveFileProgress = base::Callback<void(int)>;
+
   virtual ~IoDelegate();
 
   // Check spelling of |word_to_check|.
   virtual void CheckSpelling(const base::string16& word_to_check,
                              const CheckSpellingResolver& callback) = 0;
 
+  // Check spelling of |words_to_check| and returns misspelled words.
+  virtual void CheckSpellingBatch(
+      const std::vector<base::string16>& words_to_check,
+      const CheckSpellingBatchResolver& callback) = 0;
+
   virtual void CloseContext(const IoContextId& context_id,
                             const IoIntPromise& promise) = 0;
 
@@ -104,6 +130,15 @@ class IoDelegate {
   virtual void RemoveFile(const base::string16& file_name,
                           const IoBoolPromise& resolver) = 0;
 
+  // Writes |data| into temporary file in directory of |file_name|, then
+  // renames it to |file_name|. |progress| is called with number of bytes
+  // written so far, if it isn't null.
+  virtual void SaveFile(const base::string16& file_name,
+                        const scoped_refptr<SaveFileData>& data,
+                        SaveFileDurability durability,
+                        const SaveFileProgress& progress,
+                        const IoIntPromise& promise) = 0;
+
   virtual void WriteFile(IoContextId context_id,
                          void* buffer,
                          size_t num_write,
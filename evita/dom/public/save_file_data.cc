@@ -0,0 +1,102 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/dom/public/save_file_data.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace domapi {
+
+SaveFileData::SaveFileData() : error_code_(0), is_closed_(false) {}
+
+SaveFileData::~SaveFileData() {}
+
+int SaveFileData::error_code() const {
+  base::AutoLock lock_scope(lock_);
+  return error_code_;
+}
+
+bool SaveFileData::is_finished() const {
+  base::AutoLock lock_scope(lock_);
+  return error_code_ || (is_closed_ && chunks_.empty());
+}
+
+void SaveFileData::Abort(int error_code) {
+  DCHECK(error_code);
+  {
+    base::AutoLock lock_scope(lock_);
+    if (error_code_)
+      return;
+    error_code_ = error_code;
+    chunks_.clear();
+  }
+  NotifyConsumer();
+}
+
+void SaveFileData::Append(const uint8_t* bytes, size_t length) {
+  auto* runner = bytes;
+  auto* const end = bytes + length;
+  while (runner < end) {
+    if (pending_chunk_.empty())
+      pending_chunk_.reserve(kChunkSize);
+    auto const count = std::min(static_cast<size_t>(end - runner),
+                                kChunkSize - pending_chunk_.size());
+    pending_chunk_.insert(pending_chunk_.end(), runner, runner + count);
+    runner += count;
+    if (pending_chunk_.size() < kChunkSize)
+      continue;
+    {
+      base::AutoLock lock_scope(lock_);
+      DCHECK(!is_closed_);
+      if (error_code_)
+        return;
+      chunks_.push_back(std::move(pending_chunk_));
+    }
+    pending_chunk_ = Chunk();
+    NotifyConsumer();
+  }
+}
+
+void SaveFileData::Close() {
+  {
+    base::AutoLock lock_scope(lock_);
+    DCHECK(!is_closed_);
+    is_closed_ = true;
+    if (!pending_chunk_.empty() && !error_code_)
+      chunks_.push_back(std::move(pending_chunk_));
+  }
+  pending_chunk_ = Chunk();
+  NotifyConsumer();
+}
+
+void SaveFileData::NotifyConsumer() {
+  base::Closure consumer;
+  {
+    base::AutoLock lock_scope(lock_);
+    consumer = consumer_;
+  }
+  // Note: We call |consumer| outside of |lock_|, since it may call
+  // |TakeChunk()| or |SetConsumer()|.
+  if (!consumer.is_null())
+    consumer.Run();
+}
+
+void SaveFileData::SetConsumer(const base::Closure& callback) {
+  base::AutoLock lock_scope(lock_);
+  consumer_ = callback;
+}
+
+bool SaveFileData::TakeChunk(Chunk* chunk) {
+  base::AutoLock lock_scope(lock_);
+  if (chunks_.empty())
+    return false;
+  *chunk = std::move(chunks_.front());
+  chunks_.pop_front();
+  return true;
+}
+
+}  // namespace domapi
@@ -0,0 +1,91 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_DOM_PUBLIC_SAVE_FILE_DATA_H_
+#define EVITA_DOM_PUBLIC_SAVE_FILE_DATA_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace domapi {
+
+//////////////////////////////////////////////////////////////////////
+//
+// SaveFileData
+//
+// A stream of encoded file contents passed from script thread to IO thread
+// without copying. The script thread appends encoded contents, and the IO
+// thread takes filled chunks and writes them while the script thread encodes
+// rest of contents.
+//
+// Either side can abort the stream with an error code, e.g. an encoding error
+// on the script thread or a write error on the IO thread, to stop the other
+// side.
+//
+class SaveFileData final : public base::RefCountedThreadSafe<SaveFileData> {
+ public:
+  using Chunk = std::vector<uint8_t>;
+
+  SaveFileData();
+
+  // Returns error code passed to the first |Abort()| call, or zero.
+  int error_code() const;
+
+  // Returns true if the stream is aborted, or is closed and all chunks are
+  // taken.
+  bool is_finished() const;
+
+  // Aborts the stream with |error_code|. Chunks not taken yet are discarded.
+  void Abort(int error_code);
+
+  // Producer side: Appends |length| bytes from |bytes| into the pending
+  // chunk. The pending chunk is passed to the consumer when it is full.
+  void Append(const uint8_t* bytes, size_t length);
+
+  // Producer side: Passes the pending chunk to the consumer and tells the
+  // consumer that there are no more contents.
+  void Close();
+
+  // Consumer side: |callback| is called on the producer thread whenever
+  // a chunk is ready or the stream is finished. Passing null callback stops
+  // notification.
+  void SetConsumer(const base::Closure& callback);
+
+  // Consumer side: Moves the first ready chunk into |chunk|. Returns false
+  // if no chunk is ready.
+  bool TakeChunk(Chunk* chunk);
+
+  // Size of each chunk, which is also size of each write operation.
+  static const size_t kChunkSize = 1024 * 1024;
+
+ private:
+  friend class base::RefCountedThreadSafe<SaveFileData>;
+
+  ~SaveFileData();
+
+  void NotifyConsumer();
+
+  // Chunks ready for the consumer, guarded by |lock_|.
+  std::deque<Chunk> chunks_;
+  base::Closure consumer_;
+  int error_code_;
+  bool is_closed_;
+  mutable base::Lock lock_;
+
+  // Accessed only by the producer.
+  Chunk pending_chunk_;
+
+  DISALLOW_COPY_AND_ASSIGN(SaveFileData);
+};
+
+}  // namespace domapi
+
+#endif  // EVITA_DOM_PUBLIC_SAVE_FILE_DATA_H_
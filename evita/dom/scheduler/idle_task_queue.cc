@@ -6,16 +6,38 @@
 
 #include "base/trace_event/trace_event.h"
 #include "evita/dom/scheduler/idle_task.h"
+#include "evita/metrics/histogram.h"
 
 namespace dom {
 
+namespace {
+
+// Maximum wait time of idle tasks before they run even if there are pending
+// tasks.
+const int kMaxWaitTimeMilliseconds = 500;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// IdleTaskQueue::TaskCompare
+//
+bool IdleTaskQueue::TaskCompare::operator()(const IdleTask* task1,
+                                            const IdleTask* task2) const {
+  return *task1 < *task2;
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // IdleTaskQueue
 //
-IdleTaskQueue::IdleTaskQueue() {}
+IdleTaskQueue::IdleTaskQueue() : should_stop_(false) {}
 IdleTaskQueue::~IdleTaskQueue() {}
 
+bool IdleTaskQueue::CanRunTask(const base::TimeTicks& deadline) const {
+  return base::TimeTicks::Now() < deadline && !should_stop_.load();
+}
+
 void IdleTaskQueue::CancelTask(int task_id) {
   auto const it = task_map_.find(task_id);
   if (it == task_map_.end())
@@ -29,10 +51,33 @@ int IdleTaskQueue::GiveTask(const IdleTask& task_in) {
   if (task->delayed_run_time() != base::TimeTicks())
     waiting_tasks_.push(task);
   else
-    ready_tasks_.push(task);
+    ready_tasks_.push(ReadyTask{task, base::TimeTicks::Now()});
   return task->id();
 }
 
+bool IdleTaskQueue::IsStarving(const base::TimeTicks& now) {
+  RemoveCanceledTasks();
+  const auto max_wait_time =
+      base::TimeDelta::FromMilliseconds(kMaxWaitTimeMilliseconds);
+  if (!waiting_tasks_.empty() &&
+      now - waiting_tasks_.top()->delayed_run_time() > max_wait_time) {
+    return true;
+  }
+  return !ready_tasks_.empty() &&
+         now - ready_tasks_.front().queued_time > max_wait_time;
+}
+
+void IdleTaskQueue::RemoveCanceledTasks() {
+  while (!waiting_tasks_.empty() && waiting_tasks_.top()->IsCanceled()) {
+    RemoveTask(waiting_tasks_.top());
+    waiting_tasks_.pop();
+  }
+  while (!ready_tasks_.empty() && ready_tasks_.front().task->IsCanceled()) {
+    RemoveTask(ready_tasks_.front().task);
+    ready_tasks_.pop();
+  }
+}
+
 void IdleTaskQueue::RemoveTask(IdleTask* task) {
   auto const it = task_map_.find(task->id());
   DCHECK(it != task_map_.end());
@@ -40,29 +85,44 @@ void IdleTaskQueue::RemoveTask(IdleTask* task) {
   delete task;
 }
 
+void IdleTaskQueue::ResumeIdleTasks() {
+  should_stop_.store(false);
+}
+
 void IdleTaskQueue::RunIdleTasks(const base::TimeTicks& deadline) {
   const auto& now = base::TimeTicks::Now();
   TRACE_EVENT1("script", "IdleTaskQueue::RunIdleTasks", "deadline",
                (deadline - now).InMilliseconds());
   while (!waiting_tasks_.empty() &&
          waiting_tasks_.top()->delayed_run_time() <= now) {
-    ready_tasks_.push(waiting_tasks_.top());
+    if (!CanRunTask(deadline))
+      return;
+    auto* const task = waiting_tasks_.top();
     waiting_tasks_.pop();
+    RunTask(task, task->delayed_run_time(), deadline);
   }
 
   // Run runnable tasks before this loop.
   for (auto count = ready_tasks_.size(); count > 0; --count) {
-    if (deadline <= base::TimeTicks::Now())
-      break;
-    if (should_stop_.load())
-      break;
-    auto* const task = ready_tasks_.front();
+    if (!CanRunTask(deadline))
+      return;
+    const auto ready_task = ready_tasks_.front();
     ready_tasks_.pop();
-    if (!task->IsCanceled())
-      task->Run(deadline);
-    RemoveTask(task);
+    RunTask(ready_task.task, ready_task.queued_time, deadline);
   }
-  should_stop_.store(false);
+}
+
+void IdleTaskQueue::RunTask(IdleTask* task,
+                            const base::TimeTicks& ready_time,
+                            const base::TimeTicks& deadline) {
+  if (!task->IsCanceled()) {
+    METRICS_HISTOGRAM_ADD(
+        "SchedulerImpl.WaitTime.Idle",
+        static_cast<int>(
+            (base::TimeTicks::Now() - ready_time).InMicroseconds()));
+    task->Run(deadline);
+  }
+  RemoveTask(task);
 }
 
 void IdleTaskQueue::StopIdleTasks() {
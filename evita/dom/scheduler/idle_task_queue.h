@@ -8,12 +8,10 @@
 #include <atomic>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "base/macros.h"
-
-namespace base {
-class TimeTicks;
-}
+#include "base/time/time.h"
 
 namespace dom {
 
@@ -23,6 +21,10 @@ class IdleTask;
 //
 // IdleTaskQueue
 //
+// Delayed tasks are run after their delayed run time in order of it, before
+// tasks without delay, since they are already late. Tasks without delay are
+// run in order of |GiveTask()|.
+//
 class IdleTaskQueue final {
  public:
   IdleTaskQueue();
@@ -30,16 +32,41 @@ class IdleTaskQueue final {
 
   void CancelTask(int task_id);
   int GiveTask(const IdleTask& task);
+  // Returns true if a runnable task has been waiting for longer than
+  // maximum wait time at |now|. Canceled tasks don't starve.
+  bool IsStarving(const base::TimeTicks& now);
+  // |SchedulerImpl| calls |ResumeIdleTasks()| and |StopIdleTasks()| with
+  // holding its lock.
+  void ResumeIdleTasks();
   void RunIdleTasks(const base::TimeTicks& deadline);
   void StopIdleTasks();
 
  private:
+  struct ReadyTask {
+    IdleTask* task;
+    base::TimeTicks queued_time;
+  };
+
+  // Orders tasks by |IdleTask::operator<()| instead of address of tasks.
+  struct TaskCompare {
+    bool operator()(const IdleTask* task1, const IdleTask* task2) const;
+  };
+
+  bool CanRunTask(const base::TimeTicks& deadline) const;
+  // Removes canceled tasks at front of |ready_tasks_| and |waiting_tasks_|.
+  void RemoveCanceledTasks();
   void RemoveTask(IdleTask* task);
+  // Runs |task| then removes it. |ready_time| is used for recording wait time
+  // of |task|.
+  void RunTask(IdleTask* task,
+               const base::TimeTicks& ready_time,
+               const base::TimeTicks& deadline);
 
   std::atomic<bool> should_stop_;
-  std::queue<IdleTask*> ready_tasks_;
+  std::queue<ReadyTask> ready_tasks_;
   std::unordered_map<int, IdleTask*> task_map_;
-  std::priority_queue<IdleTask*> waiting_tasks_;
+  std::priority_queue<IdleTask*, std::vector<IdleTask*>, TaskCompare>
+      waiting_tasks_;
 
   DISALLOW_COPY_AND_ASSIGN(IdleTaskQueue);
 };
@@ -0,0 +1,140 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "evita/dom/scheduler/idle_task_queue.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "evita/dom/scheduler/idle_task.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace dom {
+
+class IdleTaskQueueTest : public ::testing::Test {
+ protected:
+  IdleTaskQueueTest() = default;
+  ~IdleTaskQueueTest() override = default;
+
+  IdleTaskQueue* idle_task_queue() { return &idle_task_queue_; }
+  const std::string& log() const { return log_; }
+  void set_stop_after(size_t count) { stop_after_ = count; }
+
+  // Returns id of task which appends |name| to |log_| when it runs.
+  int GiveTask(const char* name);
+  int GiveTask(const char* name, const base::TimeTicks& delayed_run_time);
+  // Returns names of tasks run.
+  std::string RunIdleTasks();
+
+ private:
+  void AppendName(const char* name, const base::TimeTicks& deadline);
+
+  IdleTaskQueue idle_task_queue_;
+  std::string log_;
+  // Number of tasks to run before |AppendName()| stops idle tasks.
+  size_t stop_after_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(IdleTaskQueueTest);
+};
+
+void IdleTaskQueueTest::AppendName(const char* name,
+                                   const base::TimeTicks& deadline) {
+  log_ += name;
+  if (log_.size() == stop_after_)
+    idle_task_queue_.StopIdleTasks();
+}
+
+int IdleTaskQueueTest::GiveTask(const char* name) {
+  return GiveTask(name, base::TimeTicks());
+}
+
+int IdleTaskQueueTest::GiveTask(const char* name,
+                                const base::TimeTicks& delayed_run_time) {
+  return idle_task_queue_.GiveTask(IdleTask(
+      FROM_HERE,
+      base::Bind(&IdleTaskQueueTest::AppendName, base::Unretained(this), name),
+      delayed_run_time));
+}
+
+std::string IdleTaskQueueTest::RunIdleTasks() {
+  log_.clear();
+  idle_task_queue_.ResumeIdleTasks();
+  idle_task_queue_.RunIdleTasks(base::TimeTicks::Now() +
+                                base::TimeDelta::FromSeconds(60));
+  return log_;
+}
+
+TEST_F(IdleTaskQueueTest, CancelTask) {
+  GiveTask("A");
+  const auto task_id = GiveTask("B");
+  GiveTask("C");
+  idle_task_queue()->CancelTask(task_id);
+
+  EXPECT_EQ("AC", RunIdleTasks());
+  EXPECT_EQ("", RunIdleTasks());
+}
+
+TEST_F(IdleTaskQueueTest, IsStarving) {
+  const auto now = base::TimeTicks::Now();
+  const auto& one_second = base::TimeDelta::FromSeconds(1);
+  EXPECT_FALSE(idle_task_queue()->IsStarving(now));
+
+  // A delayed task starves after its delayed run time.
+  GiveTask("A", now + one_second * 10);
+  EXPECT_FALSE(idle_task_queue()->IsStarving(now + one_second * 10));
+  EXPECT_TRUE(idle_task_queue()->IsStarving(now + one_second * 11));
+
+  // A task without delay starves after queued.
+  GiveTask("B");
+  EXPECT_FALSE(idle_task_queue()->IsStarving(now));
+  EXPECT_TRUE(idle_task_queue()->IsStarving(now + one_second));
+}
+
+TEST_F(IdleTaskQueueTest, IsStarvingCanceled) {
+  const auto now = base::TimeTicks::Now();
+  const auto& one_second = base::TimeDelta::FromSeconds(1);
+  const auto task_id = GiveTask("A", now);
+  const auto task_id2 = GiveTask("B");
+  GiveTask("C", now + one_second * 10);
+  EXPECT_TRUE(idle_task_queue()->IsStarving(now + one_second));
+
+  idle_task_queue()->CancelTask(task_id);
+  idle_task_queue()->CancelTask(task_id2);
+  EXPECT_FALSE(idle_task_queue()->IsStarving(now + one_second))
+      << "Canceled tasks don't starve.";
+  EXPECT_TRUE(idle_task_queue()->IsStarving(now + one_second * 11));
+}
+
+TEST_F(IdleTaskQueueTest, RunIdleTasks) {
+  const auto now = base::TimeTicks::Now();
+  GiveTask("A");
+  GiveTask("B", now - base::TimeDelta::FromMilliseconds(10));
+  GiveTask("C");
+  GiveTask("D", now - base::TimeDelta::FromMilliseconds(20));
+  GiveTask("E", now + base::TimeDelta::FromSeconds(60));
+
+  // Delayed tasks run in order of delayed run time before tasks without
+  // delay, and tasks without delay run in order of |GiveTask()|. "E" isn't
+  // ready yet.
+  EXPECT_EQ("DBAC", RunIdleTasks());
+  EXPECT_EQ("", RunIdleTasks());
+}
+
+TEST_F(IdleTaskQueueTest, StopIdleTasks) {
+  for (const auto* name : {"A", "B", "C", "D", "E", "F"})
+    GiveTask(name);
+  idle_task_queue()->StopIdleTasks();
+
+  // |RunIdleTasks()| doesn't resume stopped tasks.
+  idle_task_queue()->RunIdleTasks(base::TimeTicks::Now() +
+                                  base::TimeDelta::FromSeconds(60));
+  EXPECT_EQ("", log());
+
+  set_stop_after(4);
+  EXPECT_EQ("ABCD", RunIdleTasks());
+  EXPECT_EQ("EF", RunIdleTasks());
+}
+
+}  // namespace dom
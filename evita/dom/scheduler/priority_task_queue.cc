@@ -0,0 +1,146 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <queue>
+
+#include "evita/dom/scheduler/priority_task_queue.h"
+
+#include "base/logging.h"
+#include "evita/metrics/histogram.h"
+
+namespace dom {
+
+namespace {
+
+// Maximum wait time of tasks in each priority before they take precedence
+// over tasks in higher priorities. Input events never wait for other tasks.
+const int kMaxWaitTimeMilliseconds[] = {
+    -1,   // TaskPriority::Input
+    50,   // TaskPriority::AnimationFrame
+    100,  // TaskPriority::Io
+    200,  // TaskPriority::Normal
+};
+
+const char* const kWaitTimeNames[] = {
+    "SchedulerImpl.WaitTime.Input", "SchedulerImpl.WaitTime.AnimationFrame",
+    "SchedulerImpl.WaitTime.Io", "SchedulerImpl.WaitTime.Normal",
+};
+
+base::TimeDelta MaxWaitTimeOf(size_t index) {
+  if (kMaxWaitTimeMilliseconds[index] < 0)
+    return base::TimeDelta::Max();
+  return base::TimeDelta::FromMilliseconds(kMaxWaitTimeMilliseconds[index]);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// PriorityTaskQueue::TaskQueue
+//
+class PriorityTaskQueue::TaskQueue final {
+ public:
+  TaskQueue(const char* wait_time_name, const base::TimeDelta& max_wait_time);
+  ~TaskQueue() = default;
+
+  bool empty() const { return tasks_.empty(); }
+  base::TimeTicks oldest_queued_time() const;
+
+  void GiveTask(const base::Closure& task, const base::TimeTicks& now);
+  // Returns true if the oldest task has been waiting for longer than
+  // |max_wait_time_| at |now|.
+  bool IsStarving(const base::TimeTicks& now) const;
+  base::Closure TakeTask(const base::TimeTicks& now);
+
+ private:
+  struct PendingTask {
+    base::Closure task;
+    base::TimeTicks queued_time;
+  };
+
+  base::TimeDelta const max_wait_time_;
+  std::queue<PendingTask> tasks_;
+  metrics::Histogram* const wait_time_histogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskQueue);
+};
+
+PriorityTaskQueue::TaskQueue::TaskQueue(const char* wait_time_name,
+                                        const base::TimeDelta& max_wait_time)
+    : max_wait_time_(max_wait_time),
+      wait_time_histogram_(
+          metrics::HistogramSet::instance()->GetOrCreate(wait_time_name)) {}
+
+base::TimeTicks PriorityTaskQueue::TaskQueue::oldest_queued_time() const {
+  DCHECK(!tasks_.empty());
+  return tasks_.front().queued_time;
+}
+
+void PriorityTaskQueue::TaskQueue::GiveTask(const base::Closure& task,
+                                            const base::TimeTicks& now) {
+  tasks_.push(PendingTask{task, now});
+}
+
+bool PriorityTaskQueue::TaskQueue::IsStarving(
+    const base::TimeTicks& now) const {
+  return !tasks_.empty() && now - oldest_queued_time() > max_wait_time_;
+}
+
+base::Closure PriorityTaskQueue::TaskQueue::TakeTask(
+    const base::TimeTicks& now) {
+  DCHECK(!tasks_.empty());
+  const auto task = tasks_.front().task;
+  wait_time_histogram_->AddSample(
+      static_cast<int>((now - oldest_queued_time()).InMicroseconds()));
+  tasks_.pop();
+  return task;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// PriorityTaskQueue
+//
+PriorityTaskQueue::PriorityTaskQueue() {
+  static_assert(arraysize(kMaxWaitTimeMilliseconds) == kNumberOfTaskPriorities,
+                "kMaxWaitTimeMilliseconds should cover all priorities.");
+  static_assert(arraysize(kWaitTimeNames) == kNumberOfTaskPriorities,
+                "kWaitTimeNames should cover all priorities.");
+  for (auto index = 0u; index < kNumberOfTaskPriorities; ++index) {
+    task_queues_.emplace_back(
+        new TaskQueue(kWaitTimeNames[index], MaxWaitTimeOf(index)));
+  }
+}
+
+PriorityTaskQueue::~PriorityTaskQueue() {}
+
+void PriorityTaskQueue::GiveTask(TaskPriority priority,
+                                 const base::Closure& task,
+                                 const base::TimeTicks& now) {
+  task_queues_[static_cast<size_t>(priority)]->GiveTask(task, now);
+  ++size_;
+}
+
+base::Maybe<base::Closure> PriorityTaskQueue::TakeTask(
+    const base::TimeTicks& now) {
+  TaskQueue* candidate = nullptr;
+  for (const auto& task_queue : task_queues_) {
+    if (task_queue->empty())
+      continue;
+    if (!candidate) {
+      candidate = task_queue.get();
+      continue;
+    }
+    if (!task_queue->IsStarving(now))
+      continue;
+    if (task_queue->oldest_queued_time() < candidate->oldest_queued_time())
+      candidate = task_queue.get();
+  }
+  if (!candidate)
+    return base::Nothing<base::Closure>();
+  DCHECK_GT(size_, 0u);
+  --size_;
+  return base::Just(candidate->TakeTask(now));
+}
+
+}  // namespace dom
@@ -0,0 +1,57 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_DOM_SCHEDULER_PRIORITY_TASK_QUEUE_H_
+#define EVITA_DOM_SCHEDULER_PRIORITY_TASK_QUEUE_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "evita/base/maybe.h"
+#include "evita/dom/scheduler/scheduler.h"
+
+namespace dom {
+
+//////////////////////////////////////////////////////////////////////
+//
+// PriorityTaskQueue
+//
+// |PriorityTaskQueue| holds tasks in a queue per |TaskPriority|. A task in a
+// lower priority queue is taken before tasks in higher priority queues when
+// it has been waiting for longer than the maximum wait time of its queue, to
+// prevent starvation.
+//
+// Note: |PriorityTaskQueue| isn't thread safe. |SchedulerImpl| protects it
+// by its lock.
+//
+class PriorityTaskQueue final {
+ public:
+  PriorityTaskQueue();
+  ~PriorityTaskQueue();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  void GiveTask(TaskPriority priority,
+                const base::Closure& task,
+                const base::TimeTicks& now);
+  // Returns a task to run next at |now|, or |Nothing| if there are no tasks.
+  base::Maybe<base::Closure> TakeTask(const base::TimeTicks& now);
+
+ private:
+  class TaskQueue;
+
+  size_t size_ = 0;
+  // Task queues indexed by |TaskPriority|.
+  std::vector<std::unique_ptr<TaskQueue>> task_queues_;
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityTaskQueue);
+};
+
+}  // namespace dom
+
+#endif  // EVITA_DOM_SCHEDULER_PRIORITY_TASK_QUEUE_H_
@@ -0,0 +1,109 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "evita/dom/scheduler/priority_task_queue.h"
+
+#include "base/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace dom {
+
+namespace {
+
+void AppendString(std::string* log, const char* name) {
+  *log += name;
+}
+
+}  // namespace
+
+class PriorityTaskQueueTest : public ::testing::Test {
+ protected:
+  PriorityTaskQueueTest() : start_time_(base::TimeTicks::Now()) {}
+  ~PriorityTaskQueueTest() override = default;
+
+  PriorityTaskQueue* task_queue() { return &task_queue_; }
+
+  void GiveTask(TaskPriority priority, const char* name, int milliseconds);
+  // Returns names of tasks taken at |milliseconds| until queue is empty.
+  std::string TakeTasks(int milliseconds);
+
+ private:
+  base::TimeTicks TimeAt(int milliseconds) const;
+
+  std::string log_;
+  base::TimeTicks const start_time_;
+  PriorityTaskQueue task_queue_;
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityTaskQueueTest);
+};
+
+void PriorityTaskQueueTest::GiveTask(TaskPriority priority,
+                                     const char* name,
+                                     int milliseconds) {
+  task_queue_.GiveTask(priority, base::Bind(&AppendString, &log_, name),
+                       TimeAt(milliseconds));
+}
+
+std::string PriorityTaskQueueTest::TakeTasks(int milliseconds) {
+  log_.clear();
+  for (;;) {
+    auto maybe_task = task_queue_.TakeTask(TimeAt(milliseconds));
+    if (maybe_task.IsNothing())
+      break;
+    maybe_task.FromJust().Run();
+  }
+  return log_;
+}
+
+base::TimeTicks PriorityTaskQueueTest::TimeAt(int milliseconds) const {
+  return start_time_ + base::TimeDelta::FromMilliseconds(milliseconds);
+}
+
+TEST_F(PriorityTaskQueueTest, Priority) {
+  EXPECT_TRUE(task_queue()->empty());
+  GiveTask(TaskPriority::Normal, "N1", 0);
+  GiveTask(TaskPriority::Io, "O1", 1);
+  GiveTask(TaskPriority::AnimationFrame, "A1", 2);
+  GiveTask(TaskPriority::Input, "I1", 3);
+  GiveTask(TaskPriority::Normal, "N2", 4);
+  GiveTask(TaskPriority::Input, "I2", 5);
+  EXPECT_EQ(6u, task_queue()->size());
+
+  EXPECT_EQ("I1I2A1O1N1N2", TakeTasks(10));
+  EXPECT_TRUE(task_queue()->empty());
+}
+
+TEST_F(PriorityTaskQueueTest, Starving) {
+  GiveTask(TaskPriority::Normal, "N1", 0);
+  GiveTask(TaskPriority::Io, "O1", 100);
+  GiveTask(TaskPriority::Input, "I1", 150);
+  GiveTask(TaskPriority::Normal, "N2", 250);
+
+  // Nothing is starving.
+  EXPECT_EQ("I1O1N1N2", TakeTasks(190));
+
+  GiveTask(TaskPriority::Normal, "N1", 0);
+  GiveTask(TaskPriority::Io, "O1", 100);
+  GiveTask(TaskPriority::Input, "I1", 150);
+  GiveTask(TaskPriority::Normal, "N2", 250);
+
+  // "N1" waited for more than 200ms and "O1" waited for more than 100ms. The
+  // oldest one of starving tasks is taken first, then "N2", which doesn't
+  // starve, follows "I1".
+  EXPECT_EQ("N1O1I1N2", TakeTasks(201));
+}
+
+TEST_F(PriorityTaskQueueTest, StarvingInput) {
+  GiveTask(TaskPriority::Input, "I1", 0);
+  GiveTask(TaskPriority::Normal, "N1", 1);
+  GiveTask(TaskPriority::Input, "I2", 2);
+
+  // A starving task is taken before tasks queued after it, even if they are
+  // input events, but never before tasks queued before it.
+  EXPECT_EQ("I1N1I2", TakeTasks(1000));
+}
+
+}  // namespace dom
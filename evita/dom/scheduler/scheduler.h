@@ -5,6 +5,8 @@
 #ifndef EVITA_DOM_SCHEDULER_SCHEDULER_H_
 #define EVITA_DOM_SCHEDULER_SCHEDULER_H_
 
+#include <stddef.h>
+
 #include <memory>
 
 #include "base/callback.h"
@@ -17,6 +19,20 @@ class AnimationFrameCallback;
 class IdleDeadlineProvider;
 class IdleTask;
 
+// Tasks are run in order of priority, e.g. an input event is handled before
+// I/O completion callbacks queued before it. Window lifecycle notifications
+// are input tasks to keep order of them and input events. Idle tasks are
+// scheduled by |Scheduler::ScheduleIdleTask()|.
+enum class TaskPriority {
+  Input,
+  AnimationFrame,
+  Io,
+  Normal,
+};
+
+const size_t kNumberOfTaskPriorities =
+    static_cast<size_t>(TaskPriority::Normal) + 1;
+
 class Scheduler : public base::TickClock {
  public:
   ~Scheduler() override;
@@ -24,10 +40,14 @@ class Scheduler : public base::TickClock {
   virtual void CancelAnimationFrame(int request_id) = 0;
   virtual void CancelIdleTask(int task_id) = 0;
   virtual void DidBeginFrame(const base::TimeTicks& deadline) = 0;
+  // Returns true if there are tasks waiting for running, e.g. input events.
+  // Idle tasks use this to yield to them.
+  virtual bool HasPendingTasks() const = 0;
   virtual int RequestAnimationFrame(
       std::unique_ptr<AnimationFrameCallback> callback) = 0;
   virtual int ScheduleIdleTask(const IdleTask& task) = 0;
-  virtual void ScheduleTask(const base::Closure& task) = 0;
+  virtual void ScheduleTask(TaskPriority priority,
+                            const base::Closure& task) = 0;
 
  protected:
   Scheduler();
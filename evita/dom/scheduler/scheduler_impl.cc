@@ -2,18 +2,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <queue>
 #include <unordered_map>
 #include <vector>
 
 #include "evita/dom/scheduler/scheduler_impl.h"
 
 #include "base/message_loop/message_loop.h"
-#include "base/synchronization/lock.h"
 #include "base/trace_event/trace_event.h"
-#include "evita/base/maybe.h"
 #include "evita/dom/scheduler/animation_frame_callback.h"
 #include "evita/dom/scheduler/idle_task_queue.h"
+#include "evita/dom/scheduler/priority_task_queue.h"
 #include "evita/dom/scheduler/scheduler_client.h"
 
 namespace dom {
@@ -64,47 +62,6 @@ int SchedulerImpl::AnimationFrameCallbackQueue::Give(
   return last_callback_id_;
 }
 
-//////////////////////////////////////////////////////////////////////
-//
-// SchedulerImpl::TaskQueue
-//
-class SchedulerImpl::TaskQueue {
- public:
-  TaskQueue() = default;
-  ~TaskQueue() = default;
-
-  // Returns true if there is only one task in queue.
-  bool GiveTask(const base::Closure& closure);
-  bool IsEmpty() const;
-  base::Maybe<base::Closure> TakeTask();
-
- private:
-  mutable base::Lock lock_;
-  std::queue<base::Closure> tasks_;
-
-  DISALLOW_COPY_AND_ASSIGN(TaskQueue);
-};
-
-bool SchedulerImpl::TaskQueue::GiveTask(const base::Closure& task) {
-  base::AutoLock lock_scope(lock_);
-  tasks_.push(task);
-  return tasks_.size() == 1;
-}
-
-bool SchedulerImpl::TaskQueue::IsEmpty() const {
-  base::AutoLock lock_scope(lock_);
-  return tasks_.empty();
-}
-
-base::Maybe<base::Closure> SchedulerImpl::TaskQueue::TakeTask() {
-  base::AutoLock lock_scope(lock_);
-  if (tasks_.empty())
-    return base::Nothing<base::Closure>();
-  auto task = base::Just(tasks_.front());
-  tasks_.pop();
-  return task;
-}
-
 enum class SchedulerImpl::State {
   Initialized,
   Running,
@@ -124,10 +81,10 @@ enum class SchedulerImpl::State {
 SchedulerImpl::SchedulerImpl(SchedulerClient* scheduler_client)
     : animation_frame_callback_queue_(new AnimationFrameCallbackQueue()),
       idle_task_queue_(new IdleTaskQueue()),
-      normal_task_queue_(new TaskQueue()),
       scheduler_client_(scheduler_client),
       script_message_loop_(nullptr),
       state_(State::Initialized),
+      task_queue_(new PriorityTaskQueue()),
       view_message_loop_(base::MessageLoop::current()) {}
 
 SchedulerImpl::~SchedulerImpl() {}
@@ -137,7 +94,8 @@ void SchedulerImpl::BeginFrame(const base::TimeTicks& deadline) {
   TRACE_EVENT0("script", "SchedulerImpl::BeginFrame");
   animation_frame_callback_queue_->DidBeginAnimationFrame(
       base::TimeTicks::Now());
-  if (base::TimeTicks::Now() < deadline)
+  const auto now = base::TimeTicks::Now();
+  if (now < deadline && ShouldRunIdleTasks(now))
     idle_task_queue_->RunIdleTasks(deadline);
   scheduler_client_->EnterIdle(deadline);
 }
@@ -147,10 +105,10 @@ void SchedulerImpl::ProcessTasks() {
   ASSERT_ON_SCRIPT_THREAD();
   state_.store(State::Running);
   for (;;) {
-    auto maybe_task = normal_task_queue_->TakeTask();
+    auto maybe_task = TakeTask();
     if (maybe_task.IsNothing()) {
       scheduler_client_->RunMicrotasks();
-      if (normal_task_queue_->IsEmpty())
+      if (!HasPendingTasks())
         break;
       continue;
     }
@@ -159,6 +117,19 @@ void SchedulerImpl::ProcessTasks() {
   state_.store(State::Sleep);
 }
 
+bool SchedulerImpl::ShouldRunIdleTasks(const base::TimeTicks& now) {
+  ASSERT_ON_SCRIPT_THREAD();
+  base::AutoLock lock_scope(lock_);
+  // Idle tasks yield to pending tasks, e.g. input events arrived during
+  // animation frame callbacks, unless they have been waiting too long.
+  if (!task_queue_->empty() && !idle_task_queue_->IsStarving(now))
+    return false;
+  // Since |ScheduleTask()| stops idle tasks with holding |lock_|, a task
+  // scheduled after here always stops idle tasks.
+  idle_task_queue_->ResumeIdleTasks();
+  return true;
+}
+
 void SchedulerImpl::Start(base::MessageLoop* script_message_loop) {
   ASSERT_ON_VIEW_THREAD();
   DCHECK_NE(view_message_loop_, script_message_loop);
@@ -166,6 +137,12 @@ void SchedulerImpl::Start(base::MessageLoop* script_message_loop) {
   script_message_loop_ = script_message_loop;
 }
 
+base::Maybe<base::Closure> SchedulerImpl::TakeTask() {
+  const auto now = base::TimeTicks::Now();
+  base::AutoLock lock_scope(lock_);
+  return task_queue_->TakeTask(now);
+}
+
 // base::TickClock
 base::TimeTicks SchedulerImpl::NowTicks() {
   return base::TimeTicks::Now();
@@ -183,9 +160,14 @@ void SchedulerImpl::CancelIdleTask(int task_id) {
 
 void SchedulerImpl::DidBeginFrame(const base::TimeTicks& deadline) {
   ASSERT_ON_VIEW_THREAD();
-  script_message_loop_->task_runner()->PostTask(
-      FROM_HERE,
-      base::Bind(&SchedulerImpl::BeginFrame, base::Unretained(this), deadline));
+  ScheduleTask(TaskPriority::AnimationFrame,
+               base::Bind(&SchedulerImpl::BeginFrame, base::Unretained(this),
+                          deadline));
+}
+
+bool SchedulerImpl::HasPendingTasks() const {
+  base::AutoLock lock_scope(lock_);
+  return !task_queue_->empty();
 }
 
 int SchedulerImpl::RequestAnimationFrame(
@@ -202,17 +184,26 @@ int SchedulerImpl::ScheduleIdleTask(const IdleTask& task) {
   return idle_task_queue_->GiveTask(task);
 }
 
-void SchedulerImpl::ScheduleTask(const base::Closure& task) {
-  TRACE_EVENT0("script", "SchedulerImpl::ScheduleTask");
+void SchedulerImpl::ScheduleTask(TaskPriority priority,
+                                 const base::Closure& task) {
+  TRACE_EVENT1("script", "SchedulerImpl::ScheduleTask", "priority",
+               static_cast<int>(priority));
   DCHECK(script_message_loop_->task_runner());
-  if (normal_task_queue_->GiveTask(task)) {
+  const auto now = base::TimeTicks::Now();
+  auto is_first_task = false;
+  {
+    base::AutoLock lock_scope(lock_);
+    task_queue_->GiveTask(priority, task, now);
+    is_first_task = task_queue_->size() == 1;
+    idle_task_queue_->StopIdleTasks();
+  }
+  if (is_first_task) {
     // Since file I/O is done in less than 1ms, we should run a task to
     // schedule next file I/O rather than waiting animation frame.
     script_message_loop_->task_runner()->PostTask(
         FROM_HERE,
         base::Bind(&SchedulerImpl::ProcessTasks, base::Unretained(this)));
   }
-  idle_task_queue_->StopIdleTasks();
 }
 
 }  // namespace dom
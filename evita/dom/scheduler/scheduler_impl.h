@@ -7,9 +7,10 @@
 
 #include <atomic>
 #include <memory>
-#include <queue>
 
+#include "base/synchronization/lock.h"
 #include "base/time/time.h"
+#include "evita/base/maybe.h"
 #include "evita/dom/scheduler/scheduler.h"
 
 namespace base {
@@ -20,8 +21,17 @@ namespace dom {
 
 class IdleTask;
 class IdleTaskQueue;
+class PriorityTaskQueue;
 class SchedulerClient;
 
+//////////////////////////////////////////////////////////////////////
+//
+// SchedulerImpl
+//
+// |SchedulerImpl| runs tasks on script thread from |PriorityTaskQueue|, and
+// runs idle tasks after animation frame callbacks when there are no pending
+// tasks or idle tasks are starving.
+//
 class SchedulerImpl final : public Scheduler {
  public:
   explicit SchedulerImpl(SchedulerClient* scheduler_client);
@@ -32,10 +42,13 @@ class SchedulerImpl final : public Scheduler {
  private:
   class AnimationFrameCallbackQueue;
   enum class State;
-  class TaskQueue;
 
   void BeginFrame(const base::TimeTicks& deadline);
   void ProcessTasks();
+  // Returns true if idle tasks can run at |now|.
+  bool ShouldRunIdleTasks(const base::TimeTicks& now);
+  // Returns a task to run next, or |Nothing| if there are no tasks.
+  base::Maybe<base::Closure> TakeTask();
 
   // base::TickClock
   base::TimeTicks NowTicks() final;
@@ -44,17 +57,21 @@ class SchedulerImpl final : public Scheduler {
   void CancelAnimationFrame(int request_id) final;
   void CancelIdleTask(int task_id) final;
   void DidBeginFrame(const base::TimeTicks& deadline) final;
+  bool HasPendingTasks() const final;
   int RequestAnimationFrame(
       std::unique_ptr<AnimationFrameCallback> request) final;
   int ScheduleIdleTask(const IdleTask& task) final;
-  void ScheduleTask(const base::Closure& task) final;
+  void ScheduleTask(TaskPriority priority, const base::Closure& task) final;
 
   std::unique_ptr<AnimationFrameCallbackQueue> animation_frame_callback_queue_;
   std::unique_ptr<IdleTaskQueue> idle_task_queue_;
-  std::unique_ptr<TaskQueue> normal_task_queue_;
+  // Protects |task_queue_| and stopping idle tasks, since tasks are
+  // scheduled from other threads.
+  mutable base::Lock lock_;
   SchedulerClient* const scheduler_client_;
   base::MessageLoop* script_message_loop_;
   std::atomic<State> state_;
+  std::unique_ptr<PriorityTaskQueue> task_queue_;
   base::MessageLoop* const view_message_loop_;
 
   DISALLOW_COPY_AND_ASSIGN(SchedulerImpl);
@@ -28,6 +28,7 @@
 #include "evita/dom/windows/editor_window.h"
 #include "evita/dom/windows/window.h"
 #include "evita/dom/windows/window_set.h"
+#include "evita/gc/collector.h"
 #include "evita/ginx/converter.h"
 #include "evita/ginx/runner.h"
 #include "evita/ginx/v8_platform.h"
@@ -396,6 +397,7 @@ void ScriptHost::Start() {
   isolate->SetAutorunMicrotasks(false);
   isolate->SetPromiseRejectCallback(DidRejectPromise);
   v8Strings::Init(isolate);
+  gc::Collector::instance()->set_lock(dom::Lock::instance()->lock());
   DidStartScriptHost();
 }
 
@@ -59,9 +59,10 @@ domapi::ViewEventHandler* ScriptThread::view_event_handler() const {
   return ScriptHost::instance()->event_handler();
 }
 
-void ScriptThread::ScheduleScriptTask(const base::Closure& task) {
+void ScriptThread::ScheduleScriptTask(TaskPriority priority,
+                                      const base::Closure& task) {
   DCHECK_CALLED_ON_NON_SCRIPT_THREAD();
-  scheduler()->ScheduleTask(task);
+  scheduler()->ScheduleTask(priority, task);
   RequestAnimationFrame();
 }
 
@@ -85,52 +86,59 @@ void ScriptThread::Ping(std::atomic<bool>* cookie) {
 }
 
 // domapi::ViewEventHandler
-#define DEFINE_VIEW_EVENT_HANDLER0(name)                                    \
+#define DEFINE_VIEW_EVENT_HANDLER0(priority, name)                          \
   void ScriptThread::name() {                                               \
     DCHECK_CALLED_ON_NON_SCRIPT_THREAD();                                   \
-    ScheduleScriptTask(FROM_HERE,                                           \
+    ScheduleScriptTask(TaskPriority::priority,                              \
                        base::Bind(&ViewEventHandler::name,                  \
                                   base::Unretained(view_event_handler()))); \
   }
 
-#define DEFINE_VIEW_EVENT_HANDLER1(name, type1)                           \
+#define DEFINE_VIEW_EVENT_HANDLER1(priority, name, type1)                 \
   void ScriptThread::name(type1 param1) {                                 \
     DCHECK_CALLED_ON_NON_SCRIPT_THREAD();                                 \
-    ScheduleScriptTask(base::Bind(&ViewEventHandler::name,                \
+    ScheduleScriptTask(TaskPriority::priority,                            \
+                       base::Bind(&ViewEventHandler::name,                \
                                   base::Unretained(view_event_handler()), \
                                   param1));                               \
   }
 
-#define DEFINE_VIEW_EVENT_HANDLER2(name, type1, type2)                    \
+#define DEFINE_VIEW_EVENT_HANDLER2(priority, name, type1, type2)          \
   void ScriptThread::name(type1 param1, type2 param2) {                   \
     DCHECK_CALLED_ON_NON_SCRIPT_THREAD();                                 \
-    ScheduleScriptTask(base::Bind(&ViewEventHandler::name,                \
+    ScheduleScriptTask(TaskPriority::priority,                            \
+                       base::Bind(&ViewEventHandler::name,                \
                                   base::Unretained(view_event_handler()), \
                                   param1, param2));                       \
   }
 
-#define DEFINE_VIEW_EVENT_HANDLER3(name, type1, type2, type3)             \
+#define DEFINE_VIEW_EVENT_HANDLER3(priority, name, type1, type2, type3)   \
   void ScriptThread::name(type1 param1, type2 param2, type3 param3) {     \
     DCHECK_CALLED_ON_NON_SCRIPT_THREAD();                                 \
-    ScheduleScriptTask(base::Bind(&ViewEventHandler::name,                \
+    ScheduleScriptTask(TaskPriority::priority,                            \
+                       base::Bind(&ViewEventHandler::name,                \
                                   base::Unretained(view_event_handler()), \
                                   param1, param2, param3));               \
   }
 
-#define DEFINE_VIEW_EVENT_HANDLER4(name, type1, type2, type3, type4)      \
+#define DEFINE_VIEW_EVENT_HANDLER4(priority, name, type1, type2, type3,   \
+                                   type4)                                 \
   void ScriptThread::name(type1 param1, type2 param2, type3 param3,       \
                           type4 param4) {                                 \
     DCHECK_CALLED_ON_NON_SCRIPT_THREAD();                                 \
-    ScheduleScriptTask(base::Bind(&ViewEventHandler::name,                \
+    ScheduleScriptTask(TaskPriority::priority,                            \
+                       base::Bind(&ViewEventHandler::name,                \
                                   base::Unretained(view_event_handler()), \
                                   param1, param2, param3, param4));       \
   }
 
-#define DEFINE_VIEW_EVENT_HANDLER5(name, type1, type2, type3, type4, type5) \
+#define DEFINE_VIEW_EVENT_HANDLER5(priority, name, type1, type2, type3,     \
+                                   type4, type5)                            \
   void ScriptThread::name(type1 param1, type2 param2, type3 param3,         \
                           type4 param4, type5 param5) {                     \
     DCHECK_CALLED_ON_NON_SCRIPT_THREAD();                                   \
-    ScheduleScriptTask(base::Bind(&ViewEventHandler::name,                  \
+    ScheduleScriptTask(TaskPriority::priority,                              \
+                       base::Bind(&ViewEventHandler::name,                  \
                                   base::Unretained(view_event_handler()),   \
                                   param1, param2, param3, param4, param5)); \
   }
@@ -141,21 +149,29 @@ void ScriptThread::DidBeginFrame(const base::TimeTicks& deadline) {
   scheduler()->DidBeginFrame(deadline);
 }
 
-DEFINE_VIEW_EVENT_HANDLER1(DidActivateWindow, domapi::WindowId)
-DEFINE_VIEW_EVENT_HANDLER5(DidChangeWindowBounds,
+// Window lifecycle notifications are posted at input priority to keep order
+// of them and input events of each window, e.g. a key stroke sent to a window
+// just realized must be dispatched after |DidRealizeWidget()|.
+DEFINE_VIEW_EVENT_HANDLER1(Input, DidActivateWindow, domapi::WindowId)
+DEFINE_VIEW_EVENT_HANDLER5(Input,
+                           DidChangeWindowBounds,
                            domapi::WindowId,
                            int,
                            int,
                            int,
                            int)
-DEFINE_VIEW_EVENT_HANDLER2(DidChangeWindowVisibility,
+DEFINE_VIEW_EVENT_HANDLER2(Input,
+                           DidChangeWindowVisibility,
                            domapi::WindowId,
                            domapi::Visibility)
-DEFINE_VIEW_EVENT_HANDLER1(DidDestroyWindow, domapi::WindowId)
-DEFINE_VIEW_EVENT_HANDLER2(DidDropWidget, domapi::WindowId, domapi::WindowId)
+DEFINE_VIEW_EVENT_HANDLER1(Input, DidDestroyWindow, domapi::WindowId)
+DEFINE_VIEW_EVENT_HANDLER2(Input,
+                           DidDropWidget,
+                           domapi::WindowId,
+                           domapi::WindowId)
 
-DEFINE_VIEW_EVENT_HANDLER1(DidRealizeWidget, domapi::WindowId)
-DEFINE_VIEW_EVENT_HANDLER1(DispatchFocusEvent, const domapi::FocusEvent&)
+DEFINE_VIEW_EVENT_HANDLER1(Input, DidRealizeWidget, domapi::WindowId)
+DEFINE_VIEW_EVENT_HANDLER1(Input, DispatchFocusEvent, const domapi::FocusEvent&)
 
 void ScriptThread::DispatchKeyboardEvent(const domapi::KeyboardEvent& event) {
   DCHECK_CALLED_ON_NON_SCRIPT_THREAD();
@@ -163,27 +179,36 @@ void ScriptThread::DispatchKeyboardEvent(const domapi::KeyboardEvent& event) {
     ScriptHost::instance()->TerminateScriptExecution();
     return;
   }
-  ScheduleScriptTask(base::Bind(&ViewEventHandler::DispatchKeyboardEvent,
-                                base::Unretained(view_event_handler()), event));
+  ScheduleScriptTask(
+      TaskPriority::Input,
+      base::Bind(&ViewEventHandler::DispatchKeyboardEvent,
+                 base::Unretained(view_event_handler()), event));
 }
 
 // TODO(eval1749): Combine |MouseMove| events if last event is also
 // |MouseMove| event.
-DEFINE_VIEW_EVENT_HANDLER1(DispatchMouseEvent, const domapi::MouseEvent&)
-DEFINE_VIEW_EVENT_HANDLER1(DispatchTextCompositionEvent,
+DEFINE_VIEW_EVENT_HANDLER1(Input, DispatchMouseEvent, const domapi::MouseEvent&)
+DEFINE_VIEW_EVENT_HANDLER1(Input,
+                           DispatchTextCompositionEvent,
                            const domapi::TextCompositionEvent&)
-DEFINE_VIEW_EVENT_HANDLER1(DispatchWheelEvent, const domapi::WheelEvent&)
+DEFINE_VIEW_EVENT_HANDLER1(Input, DispatchWheelEvent, const domapi::WheelEvent&)
 
-DEFINE_VIEW_EVENT_HANDLER2(OpenFile, domapi::WindowId, const base::string16&)
-DEFINE_VIEW_EVENT_HANDLER2(ProcessCommandLine,
+DEFINE_VIEW_EVENT_HANDLER2(Normal,
+                           OpenFile,
+                           domapi::WindowId,
+                           const base::string16&)
+DEFINE_VIEW_EVENT_HANDLER2(Normal,
+                           ProcessCommandLine,
                            const base::string16&,
                            const std::vector<base::string16>&)
-DEFINE_VIEW_EVENT_HANDLER1(QueryClose, domapi::WindowId)
-DEFINE_VIEW_EVENT_HANDLER1(RunCallback, const base::Closure&)
+DEFINE_VIEW_EVENT_HANDLER1(Normal, QueryClose, domapi::WindowId)
+// |RunCallback()| is used for resolving promises of I/O and view requests.
+DEFINE_VIEW_EVENT_HANDLER1(Io, RunCallback, const base::Closure&)
 
 void ScriptThread::WillDestroyViewHost() {
   DCHECK_CALLED_ON_NON_SCRIPT_THREAD();
-  ScheduleScriptTask(base::Bind(&ViewEventHandler::WillDestroyViewHost,
+  ScheduleScriptTask(TaskPriority::Normal,
+                     base::Bind(&ViewEventHandler::WillDestroyViewHost,
                                 base::Unretained(view_event_handler())));
 }
 
@@ -14,6 +14,7 @@
 #include "evita/base/ping_provider.h"
 #include "evita/dom/public/view_delegate.h"
 #include "evita/dom/public/view_event_handler.h"
+#include "evita/dom/scheduler/scheduler.h"
 #include "evita/dom/scheduler/scheduler_client.h"
 #include "evita/ui/animation/animation_frame_handler.h"
 
@@ -45,7 +46,7 @@ class ScriptThread final : public base::PingProvider,
   Scheduler* scheduler() const;
   domapi::ViewEventHandler* view_event_handler() const;
 
-  void ScheduleScriptTask(const base::Closure& task);
+  void ScheduleScriptTask(TaskPriority priority, const base::Closure& task);
 
   // base::PingProvider
   void Ping(std::atomic<bool>* cookie) final;
@@ -6,16 +6,20 @@
 
 #include <algorithm>
 
+#include "base/bind.h"
 #include "base/callback.h"
 #include "base/logging.h"
 #include "evita/dom/public/io_callback.h"
 #include "evita/dom/public/io_error.h"
 #include "evita/dom/public/promise.h"
+#include "evita/dom/public/save_file_data.h"
 
 namespace dom {
 
 MockIoDelegate::MockIoDelegate()
-    : num_close_called_(0), num_remove_called_(0) {}
+    : num_close_called_(0),
+      num_remove_called_(0),
+      save_file_durability_(domapi::SaveFileDurability::None) {}
 
 MockIoDelegate::~MockIoDelegate() {}
 
@@ -23,6 +27,36 @@ void MockIoDelegate::set_bytes(const std::vector<uint8_t> new_bytes) {
   bytes_ = new_bytes;
 }
 
+// Emulates |io::SaveFileIoContext|, which writes chunks as soon as they are
+// appended.
+void MockIoDelegate::DidAppendSaveFileData(
+    const scoped_refptr<domapi::SaveFileData>& data,
+    int error_code,
+    const SaveFileProgress& progress,
+    const domapi::IoIntPromise& promise) {
+  if (error_code) {
+    data->SetConsumer(base::Closure());
+    data->Abort(error_code);
+    promise.reject.Run(domapi::IoError(error_code));
+    return;
+  }
+  domapi::SaveFileData::Chunk chunk;
+  while (data->TakeChunk(&chunk))
+    saving_bytes_.insert(saving_bytes_.end(), chunk.begin(), chunk.end());
+  if (!data->is_finished())
+    return;
+  data->SetConsumer(base::Closure());
+  if (auto const data_error_code = data->error_code()) {
+    promise.reject.Run(domapi::IoError(data_error_code));
+    return;
+  }
+  bytes_.swap(saving_bytes_);
+  saving_bytes_.clear();
+  if (!progress.is_null())
+    progress.Run(static_cast<int>(bytes_.size()));
+  promise.resolve.Run(static_cast<int>(bytes_.size()));
+}
+
 MockIoDelegate::CallResult MockIoDelegate::PopCallResult(
     base::StringPiece name) {
   DCHECK(call_results_.size()) << "Expect " << name;
@@ -114,6 +148,15 @@ void MockIoDelegate::CheckSpelling(const base::string16&,
   promise.resolve.Run(check_spelling_result_);
 }
 
+void MockIoDelegate::CheckSpellingBatch(
+    const std::vector<base::string16>&,
+    const CheckSpellingBatchResolver& promise) {
+  auto const result = PopCallResult("CheckSpellingBatch");
+  if (const auto error_code = result.error_code)
+    return promise.reject.Run(error_code);
+  promise.resolve.Run(strings_);
+}
+
 void MockIoDelegate::CloseContext(const domapi::IoContextId&,
                                   const domapi::IoIntPromise& resolver) {
   ++num_close_called_;
@@ -283,6 +326,28 @@ void MockIoDelegate::RemoveFile(const base::string16&,
     resolver.resolve.Run(true);
 }
 
+void MockIoDelegate::SaveFile(const base::string16&,
+                              const scoped_refptr<domapi::SaveFileData>& data,
+                              domapi::SaveFileDurability durability,
+                              const SaveFileProgress& progress,
+                              const domapi::IoIntPromise& promise) {
+  // Opening temporary file.
+  auto const open_result = PopCallResult("OpenFile");
+  if (auto const error_code = open_result.error_code) {
+    data->Abort(error_code);
+    promise.reject.Run(domapi::IoError(error_code));
+    return;
+  }
+  // Writing temporary file.
+  auto const result = PopCallResult("SaveFile");
+  save_file_durability_ = durability;
+  saving_bytes_.clear();
+  data->SetConsumer(base::Bind(&MockIoDelegate::DidAppendSaveFileData,
+                               base::Unretained(this), data,
+                               result.error_code, progress, promise));
+  DidAppendSaveFileData(data, result.error_code, progress, promise);
+}
+
 void MockIoDelegate::WriteFile(domapi::IoContextId,
                                void* bytes,
                                size_t num_bytes,
@@ -27,6 +27,9 @@ class MockIoDelegate final : public domapi::IoDelegate {
   void set_bytes(const std::vector<uint8_t> new_bytes);
   int num_close_called() const { return num_close_called_; }
   int num_remove_called() const { return num_remove_called_; }
+  domapi::SaveFileDurability save_file_durability() const {
+    return save_file_durability_;
+  }
   void set_check_spelling_result(bool result) {
     check_spelling_result_ = result;
   }
@@ -53,6 +56,8 @@ class MockIoDelegate final : public domapi::IoDelegate {
   // domapi::IoDelegate
   void CheckSpelling(const base::string16& word_to_check,
                      const CheckSpellingResolver& promise) final;
+  void CheckSpellingBatch(const std::vector<base::string16>& words_to_check,
+                          const CheckSpellingBatchResolver& promise) final;
   void CloseContext(const domapi::IoContextId& context_id,
                     const domapi::IoIntPromise& promise) final;
   void ComputeFullPathName(const base::string16& path_name,
@@ -94,6 +99,11 @@ class MockIoDelegate final : public domapi::IoDelegate {
                 const domapi::IoIntPromise& promise) final;
   void RemoveFile(const base::string16& file_name,
                   const domapi::IoBoolPromise& resolver) final;
+  void SaveFile(const base::string16& file_name,
+                const scoped_refptr<domapi::SaveFileData>& data,
+                domapi::SaveFileDurability durability,
+                const SaveFileProgress& progress,
+                const domapi::IoIntPromise& promise) final;
   void WriteFile(domapi::IoContextId context_id,
                  void* buffer,
                  size_t num_write,
@@ -106,6 +116,10 @@ class MockIoDelegate final : public domapi::IoDelegate {
     int num_transferred;
   };
 
+  void DidAppendSaveFileData(const scoped_refptr<domapi::SaveFileData>& data,
+                             int error_code,
+                             const SaveFileProgress& progress,
+                             const domapi::IoIntPromise& promise);
   CallResult PopCallResult(base::StringPiece name);
   void QueryFileStatus(const base::string16& file_name,
                        const domapi::QueryFileStatusPromise& promise) final;
@@ -120,6 +134,8 @@ class MockIoDelegate final : public domapi::IoDelegate {
   bool check_spelling_result_;
   std::vector<base::string16> strings_;
   std::vector<uint8_t> resource_data_;
+  domapi::SaveFileDurability save_file_durability_;
+  std::vector<uint8_t> saving_bytes_;
 
   DISALLOW_COPY_AND_ASSIGN(MockIoDelegate);
 };
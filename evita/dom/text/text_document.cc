@@ -4,19 +4,33 @@
 
 #include "evita/dom/text/text_document.h"
 
+#include <algorithm>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/stringprintf.h"
+#include "base/trace_event/trace_event.h"
 #include "evita/dom/bindings/exception_state.h"
+#include "evita/dom/lock.h"
+#include "evita/dom/promise_resolver.h"
+#include "evita/dom/public/io_delegate.h"
+#include "evita/dom/public/save_file_data.h"
 #include "evita/dom/public/view_delegate.h"
+#include "evita/dom/scheduler/scheduler.h"
 #include "evita/dom/script_host.h"
 #include "evita/dom/text/regular_expression.h"
 #include "evita/dom/v8_strings.h"
 #include "evita/ginx/runner.h"
+#include "evita/ginx/scoped_persistent.h"
 #include "evita/metrics/time_scope.h"
+#include "evita/text/encodings/encoder.h"
+#include "evita/text/encodings/encodings.h"
 #include "evita/text/models/buffer.h"
+#include "evita/text/models/buffer_mutation_observer.h"
 #include "evita/text/models/marker.h"
 #include "evita/text/models/marker_set.h"
 #include "evita/text/models/offset.h"
@@ -25,6 +39,241 @@
 
 namespace dom {
 
+namespace {
+
+// Number of characters to encode in one task.
+const size_t kEncodeSpanLength = 64 * 1024;
+
+//////////////////////////////////////////////////////////////////////
+//
+// SaveProgressReporter
+//
+// Calls script function with number of bytes written so far. This object is
+// referenced by |domapi::IoDelegate::SaveFileProgress| callback.
+//
+class SaveProgressReporter final
+    : public base::RefCountedThreadSafe<SaveProgressReporter> {
+ public:
+  SaveProgressReporter(v8::Isolate* isolate, v8::Local<v8::Function> callback)
+      : callback_(isolate, callback) {}
+
+  void DidWrite(int num_bytes_written);
+
+ private:
+  friend class base::RefCountedThreadSafe<SaveProgressReporter>;
+
+  ~SaveProgressReporter() = default;
+
+  ginx::ScopedPersistent<v8::Function> callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(SaveProgressReporter);
+};
+
+void SaveProgressReporter::DidWrite(int num_bytes_written) {
+  auto const runner = ScriptHost::instance()->runner();
+  auto const isolate = runner->isolate();
+  ginx::Runner::Scope runner_scope(runner);
+  ASSERT_DOM_LOCKED();
+  runner->CallAsFunction(callback_.NewLocal(isolate), runner->global(),
+                         v8::Integer::New(isolate, num_bytes_written));
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// BufferEncoder
+//
+// Encodes a snapshot of buffer contents into |domapi::SaveFileData| by
+// |kEncodeSpanLength| characters per task, so the script thread handles other
+// tasks, e.g. input events, between spans and the IO thread writes encoded
+// chunks while we encode the rest. LF is expanded to CRLF if |newline| isn't
+// LF only. We always put line separator at end of file, because some tools
+// don't work well without it.
+//
+// We read spans from buffer rather than copying whole contents of buffer at
+// start. Since user can edit document while saving, we observe buffer and
+// copy rest of text to encode only when it is about to be changed.
+//
+class BufferEncoder final : public base::RefCounted<BufferEncoder>,
+                            public text::BufferMutationObserver {
+ public:
+  BufferEncoder(TextDocument* document,
+                std::unique_ptr<encodings::Encoder> encoder,
+                int newline,
+                const scoped_refptr<domapi::SaveFileData>& data);
+
+  void Start();
+
+ private:
+  friend class base::RefCounted<BufferEncoder>;
+
+  ~BufferEncoder() final;
+
+  // Stops reading |buffer_| and encodes |rest|, which is text not encoded
+  // yet, instead.
+  void Detach(const base::string16& rest);
+  void EncodeSpan();
+  void ScheduleEncodeSpan();
+
+  // text::BufferMutationObserver
+  void DidDeleteAt(const text::StaticRange& range) final;
+  void DidInsertBefore(const text::StaticRange& range) final;
+  void WillDeleteAt(const text::StaticRange& range) final;
+
+  // |buffer_| is null after detached.
+  const text::Buffer* buffer_;
+  const scoped_refptr<domapi::SaveFileData> data_;
+  // Keeps |TextDocument| owning |buffer_| alive while we read |buffer_|.
+  ginx::ScopedPersistent<v8::Object> document_;
+  const std::unique_ptr<encodings::Encoder> encoder_;
+  // |end_| and |offset_| are offsets in |buffer_|, or in |text_| after
+  // detached from |buffer_|.
+  size_t end_;
+  const bool ends_with_newline_;
+  size_t offset_ = 0;
+  base::string16 span_;
+  // Characters of current span, or rest of text to encode after detached
+  // from |buffer_|.
+  base::string16 text_;
+  const bool use_crlf_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferEncoder);
+};
+
+BufferEncoder::BufferEncoder(TextDocument* document,
+                             std::unique_ptr<encodings::Encoder> encoder,
+                             int newline,
+                             const scoped_refptr<domapi::SaveFileData>& data)
+    : buffer_(document->buffer()),
+      data_(data),
+      document_(ScriptHost::instance()->isolate(),
+                document->GetWrapper(ScriptHost::instance()->isolate())),
+      encoder_(std::move(encoder)),
+      end_(static_cast<size_t>(buffer_->GetEnd().value())),
+      ends_with_newline_(
+          end_ > 0 &&
+          buffer_->GetCharAt(buffer_->GetEnd() - text::OffsetDelta(1)) ==
+              '\n'),
+      use_crlf_(newline != 1) {
+  buffer_->AddObserver(this);
+  span_.reserve(kEncodeSpanLength * 2 + 2);
+}
+
+BufferEncoder::~BufferEncoder() {
+  if (buffer_)
+    buffer_->RemoveObserver(this);
+}
+
+void BufferEncoder::Detach(const base::string16& rest) {
+  DCHECK(buffer_);
+  text_ = rest;
+  end_ = rest.size();
+  offset_ = 0;
+  buffer_->RemoveObserver(this);
+  buffer_ = nullptr;
+  document_.Reset();
+}
+
+void BufferEncoder::EncodeSpan() {
+  TRACE_EVENT0("script", "BufferEncoder::EncodeSpan");
+  if (data_->error_code()) {
+    // IO thread failed to open or write file.
+    return;
+  }
+  auto const end = end_;
+  auto span_end = std::min(offset_ + kEncodeSpanLength, end);
+  // Offset of |text_[0]|.
+  auto const text_start = buffer_ ? offset_ : 0;
+  if (buffer_) {
+    text_.resize(span_end - offset_);
+    buffer_->GetText(&text_[0], text::Offset(static_cast<int>(offset_)),
+                     text::Offset(static_cast<int>(span_end)));
+  }
+  // Don't split surrogate pair.
+  if (span_end < end && IS_HIGH_SURROGATE(text_[span_end - text_start - 1]))
+    --span_end;
+  auto runner = text_.begin() + (offset_ - text_start);
+  auto const span_last = text_.begin() + (span_end - text_start);
+  if (use_crlf_) {
+    span_.clear();
+    while (runner < span_last) {
+      auto const newline = std::find(runner, span_last, '\n');
+      span_.append(runner, newline);
+      if (newline == span_last)
+        break;
+      span_.append(L"\r\n");
+      runner = newline + 1;
+    }
+  } else {
+    span_.assign(runner, span_last);
+  }
+  if (span_end == end && !ends_with_newline_)
+    span_.append(use_crlf_ ? L"\r\n" : L"\n");
+  auto const result = encoder_->Encode(span_, span_end != end);
+  if (result.left) {
+    LOG(ERROR) << base::StringPrintf("EncodingError: codePoint=0x%X",
+                                     result.left);
+    data_->Abort(ERROR_NO_UNICODE_TRANSLATION);
+    return;
+  }
+  data_->Append(result.right.data(), result.right.size());
+  offset_ = span_end;
+  if (offset_ == end)
+    return data_->Close();
+  ScheduleEncodeSpan();
+}
+
+void BufferEncoder::ScheduleEncodeSpan() {
+  ScriptHost::instance()->scheduler()->ScheduleTask(
+      TaskPriority::Normal, base::Bind(&BufferEncoder::EncodeSpan, this));
+}
+
+void BufferEncoder::Start() {
+  if (end_ == 0)
+    return data_->Close();
+  ScheduleEncodeSpan();
+}
+
+// text::BufferMutationObserver
+void BufferEncoder::DidDeleteAt(const text::StaticRange& range) {
+  if (!buffer_ || static_cast<size_t>(range.start().value()) >= end_)
+    return;
+  // Characters before text to encode are deleted.
+  auto const length = static_cast<size_t>(range.length().value());
+  DCHECK_LE(static_cast<size_t>(range.end().value()), offset_);
+  offset_ -= length;
+  end_ -= length;
+}
+
+void BufferEncoder::DidInsertBefore(const text::StaticRange& range) {
+  if (!buffer_)
+    return;
+  auto const start = static_cast<size_t>(range.start().value());
+  if (start >= end_)
+    return;
+  auto const length = static_cast<size_t>(range.length().value());
+  if (start <= offset_) {
+    offset_ += length;
+    end_ += length;
+    return;
+  }
+  // Characters are inserted into text to encode.
+  Detach(buffer_->GetText(text::Offset(static_cast<int>(offset_)),
+                          range.start()) +
+         buffer_->GetText(range.end(),
+                          text::Offset(static_cast<int>(end_ + length))));
+}
+
+void BufferEncoder::WillDeleteAt(const text::StaticRange& range) {
+  if (!buffer_ || static_cast<size_t>(range.start().value()) >= end_ ||
+      static_cast<size_t>(range.end().value()) <= offset_) {
+    return;
+  }
+  Detach(buffer_->GetText(text::Offset(static_cast<int>(offset_)),
+                          text::Offset(static_cast<int>(end_))));
+}
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // TextDocument
@@ -162,6 +411,56 @@ void TextDocument::Replace(text::Offset start,
   buffer_->Replace(start, end, replacement);
 }
 
+v8::Local<v8::Promise> TextDocument::SaveTo(
+    const base::string16& file_name,
+    const base::string16& encoding,
+    int newline,
+    int durability,
+    v8::Local<v8::Function> callback,
+    ExceptionState* exception_state) {
+  if (durability < static_cast<int>(domapi::SaveFileDurability::None) ||
+      durability > static_cast<int>(domapi::SaveFileDurability::Directory)) {
+    exception_state->ThrowRangeError(
+        base::StringPrintf("Invalid durability %d", durability));
+    return v8::Local<v8::Promise>();
+  }
+  std::unique_ptr<encodings::Encoder> encoder(
+      encodings::Encodings::instance()->GetEncoder(encoding));
+  if (!encoder) {
+    exception_state->ThrowError(
+        base::StringPrintf("No such encoding '%ls'", encoding.c_str()));
+    return v8::Local<v8::Promise>();
+  }
+  auto const data = make_scoped_refptr(new domapi::SaveFileData());
+  domapi::IoDelegate::SaveFileProgress progress;
+  if (!callback.IsEmpty()) {
+    progress = base::Bind(&SaveProgressReporter::DidWrite,
+                          make_scoped_refptr(new SaveProgressReporter(
+                              ScriptHost::instance()->isolate(), callback)));
+  }
+  // Note: We start saving before encoding, so the IO thread opens temporary
+  // file and writes encoded chunks while we encode the rest.
+  auto const promise = PromiseResolver::Call(
+      FROM_HERE,
+      base::Bind(&domapi::IoDelegate::SaveFile,
+                 base::Unretained(ScriptHost::instance()->io_delegate()),
+                 file_name, data,
+                 static_cast<domapi::SaveFileDurability>(durability),
+                 progress));
+  make_scoped_refptr(new BufferEncoder(this, std::move(encoder), newline, data))
+      ->Start();
+  return promise;
+}
+
+v8::Local<v8::Promise> TextDocument::SaveTo(const base::string16& file_name,
+                                            const base::string16& encoding,
+                                            int newline,
+                                            int durability,
+                                            ExceptionState* exception_state) {
+  return SaveTo(file_name, encoding, newline, durability,
+                v8::Local<v8::Function>(), exception_state);
+}
+
 void TextDocument::SetSpelling(text::Offset start,
                                text::Offset end,
                                const base::string16& spelling,
@@ -73,6 +73,17 @@ class TextDocument final : public ginx::Scriptable<TextDocument, EventTarget> {
                              text::Offset start,
                              text::Offset end);
   text::Offset Redo(text::Offset position);
+  v8::Local<v8::Promise> SaveTo(const base::string16& file_name,
+                                const base::string16& encoding,
+                                int newline,
+                                int durability,
+                                v8::Local<v8::Function> callback,
+                                ExceptionState* exception_state);
+  v8::Local<v8::Promise> SaveTo(const base::string16& file_name,
+                                const base::string16& encoding,
+                                int newline,
+                                int durability,
+                                ExceptionState* exception_state);
   void SetSpelling(text::Offset start,
                    text::Offset end,
                    const base::string16& spelling,
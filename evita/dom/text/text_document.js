@@ -598,7 +598,9 @@ Object.defineProperties(TextDocument.prototype, {
   properties: {get: getProperties},
   properties_: {value: null, writable: true},
   state: {value: 0, writable: true},
+  saveDurability: {value: TextDocument.SaveDurability.FILE, writable: true},
   savedRevision_: {value: 0, writable: true},
+  savePromise_: {value: null, writable: true},
 
   computeEndOf_: {value: computeEndOf},
   computeMotion_: {value: computeMotion},
@@ -15,6 +15,9 @@ TextDocument.prototype.obsolete;
 /** @export  @type {!Map<string, *>} */
 TextDocument.prototype.properties;
 
+/** @export @type {!TextDocument.SaveDurability} */
+TextDocument.prototype.saveDurability;
+
 /**
  * @param {string} name
  * @param {function()} callback
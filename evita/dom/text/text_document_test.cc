@@ -332,50 +332,61 @@ TEST_F(TextDocumentTest, renameTo) {
   EXPECT_SCRIPT_EQ("bar", "doc.name");
 }
 
-TEST_F(TextDocumentTest, save_failed_open) {
-  mock_io_delegate()->SetMakeTempFileName(L"foo.tmp", 0);
-  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 123);
+TEST_F(TextDocumentTest, save_failed_encode) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
+
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'f\\u0234o\\nbar\\n';"
+      "doc.encoding = 'shift_jis';"
       "doc.save('foo.cc');");
+  RunMessageLoopUntilIdle();
+  EXPECT_EQ(std::vector<uint8_t>(), mock_io_delegate()->bytes());
   EXPECT_SCRIPT_TRUE("doc.fileName.endsWith('foo.cc')");
   EXPECT_SCRIPT_EQ("0", "doc.lastWriteTime.valueOf()");
   EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.UNKNOWN === doc.obsolete");
   EXPECT_SCRIPT_TRUE("doc.lastStatusCheckTime_ != new Date(0)");
 }
 
-TEST_F(TextDocumentTest, save_failed_encode) {
-  mock_io_delegate()->SetMakeTempFileName(L"foo.tmp", 0);
-  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
-  mock_io_delegate()->SetCallResult("CloseContext", 0);
-  mock_io_delegate()->SetCallResult("RemoveFile", 0);
+TEST_F(TextDocumentTest, save_failed_open) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 123);
 
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('foo');"
-      "new TextRange(doc).text = 'f\\u0234o\\nbar\\n';"
-      "doc.encoding = 'shift_jis';"
       "doc.save('foo.cc');");
-  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
-  EXPECT_EQ(1, mock_io_delegate()->num_remove_called());
+  RunMessageLoopUntilIdle();
   EXPECT_SCRIPT_TRUE("doc.fileName.endsWith('foo.cc')");
   EXPECT_SCRIPT_EQ("0", "doc.lastWriteTime.valueOf()");
   EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.UNKNOWN === doc.obsolete");
   EXPECT_SCRIPT_TRUE("doc.lastStatusCheckTime_ != new Date(0)");
 }
 
+TEST_F(TextDocumentTest, save_failed_keepsModified) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 123);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\nbar\\n';"
+      "var failed = false;"
+      "doc.save('foo.cc').catch(x => failed = true);");
+  RunMessageLoopUntilIdle();
+  EXPECT_SCRIPT_TRUE("failed");
+  EXPECT_SCRIPT_TRUE("doc.modified");
+  EXPECT_SCRIPT_EQ("0", "doc.savedRevision_");
+  EXPECT_SCRIPT_EQ("null", "doc.savePromise_");
+}
+
 TEST_F(TextDocumentTest, save_failed_write) {
-  mock_io_delegate()->SetMakeTempFileName(L"foo.tmp", 0);
-  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
-  mock_io_delegate()->SetCallResult("WriteFile", 123);
-  mock_io_delegate()->SetCallResult("CloseContext", 0);
-  mock_io_delegate()->SetCallResult("RemoveFile", 0);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 123);
 
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('foo');"
       "new TextRange(doc).text = 'foo\\nbar\\n';"
       "doc.save('foo.cc');");
-  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
-  EXPECT_EQ(1, mock_io_delegate()->num_remove_called());
+  RunMessageLoopUntilIdle();
   EXPECT_SCRIPT_TRUE("doc.fileName.endsWith('foo.cc')");
   EXPECT_SCRIPT_EQ("0", "doc.lastWriteTime.valueOf()");
   EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.UNKNOWN === doc.obsolete");
@@ -387,13 +398,8 @@ TEST_F(TextDocumentTest, save_succeeded) {
       102, 111, 111, 10,  // foo\n
       98,  97,  114, 10,  // bar\n
   };
-  mock_io_delegate()->set_bytes(expected_bytes);
-  mock_io_delegate()->SetMakeTempFileName(L"foo.tmp", 0);
-  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId::New(), 0);
-  mock_io_delegate()->SetCallResult("WriteFile", 0,
-                                    static_cast<int>(expected_bytes.size()));
-  mock_io_delegate()->SetCallResult("CloseContext", 0);
-  mock_io_delegate()->SetCallResult("MoveFile", 0);
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
   domapi::FileStatus file_status;
   file_status.file_size = 10;
   file_status.is_directory = false;
@@ -404,10 +410,15 @@ TEST_F(TextDocumentTest, save_succeeded) {
 
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('foo');"
-      "new TextRange(doc).text = 'foo\\nbar\\n';"
+      "new TextRange(doc).text = 'foo\\nbar';"
+      "doc.saveDurability = TextDocument.SaveDurability.DIRECTORY;"
       "doc.save('foo.cc');");
-  EXPECT_EQ(1, mock_io_delegate()->num_close_called());
-  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes());
+  RunMessageLoopUntilIdle();
+  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes())
+      << "save() appends line separator at end of file.";
+  EXPECT_EQ(domapi::SaveFileDurability::Directory,
+            mock_io_delegate()->save_file_durability());
+  EXPECT_SCRIPT_FALSE("doc.modified");
 
   EXPECT_SCRIPT_TRUE("doc.fileName.endsWith('foo.cc')");
   EXPECT_SCRIPT_EQ("123456", "doc.lastWriteTime.valueOf()");
@@ -415,6 +426,119 @@ TEST_F(TextDocumentTest, save_succeeded) {
   EXPECT_SCRIPT_TRUE("doc.lastStatusCheckTime_ != new Date(0)");
 }
 
+TEST_F(TextDocumentTest, save_succeeded_editWhileSaving) {
+  std::vector<uint8_t> expected_bytes{
+      102, 111, 111, 10,  // foo\n
+      98,  97,  114, 10,  // bar\n
+  };
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
+  domapi::FileStatus file_status;
+  file_status.file_size = 8;
+  file_status.is_directory = false;
+  file_status.is_symlink = false;
+  file_status.last_write_time = base::Time::FromJsTime(123456.0);
+  file_status.readonly = false;
+  mock_io_delegate()->SetFileStatus(file_status, 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\nbar\\n';"
+      "var savedRevision = doc.revision_;"
+      "doc.save('foo.cc');");
+  // |saveTo_()| has been called and encoding isn't finished yet.
+  EXPECT_SCRIPT_VALID("new TextRange(doc, 0, 0).text = 'baz';");
+  RunMessageLoopUntilIdle();
+  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes());
+  EXPECT_SCRIPT_TRUE("doc.savedRevision_ === savedRevision");
+  EXPECT_SCRIPT_TRUE("doc.revision_ !== savedRevision");
+  EXPECT_SCRIPT_TRUE("doc.modified")
+      << "Document is still modified if it is changed during saving.";
+  EXPECT_SCRIPT_TRUE("TextDocument.Obsolete.NO === doc.obsolete");
+}
+
+TEST_F(TextDocumentTest, saveTo_) {
+  std::vector<uint8_t> expected_bytes{
+      102, 111, 111, 13, 10,  // foo\r\n
+      98,  97,  114, 13, 10,  // bar\r\n
+  };
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\nbar\\n';"
+      "var progress = 0;"
+      "doc.saveTo_('foo.cc', 'utf-8', 3, 0, function(numBytes) {"
+      "  progress = numBytes;"
+      "});");
+  RunMessageLoopUntilIdle();
+  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes());
+  EXPECT_SCRIPT_EQ("10", "progress");
+  EXPECT_SCRIPT_EQ(
+      "Error: Failed to execute 'saveTo_' on 'TextDocument': "
+      "No such encoding 'foo'",
+      "doc.saveTo_('foo.cc', 'foo', 1, 0)");
+  EXPECT_SCRIPT_EQ(
+      "RangeError: Failed to execute 'saveTo_' on 'TextDocument': "
+      "Invalid durability 3",
+      "doc.saveTo_('foo.cc', 'utf-8', 1, 3)");
+}
+
+TEST_F(TextDocumentTest, saveTo_multipleSpans) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\n'.repeat(50000);"
+      "var result = 0;"
+      "doc.saveTo_('foo.cc', 'utf-8', 3, 0).then(x => result = x);");
+  RunMessageLoopUntilIdle();
+  EXPECT_EQ(250000u, mock_io_delegate()->bytes().size());
+  EXPECT_SCRIPT_EQ("250000", "result");
+}
+
+TEST_F(TextDocumentTest, saveTo_editWhileEncoding) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\n'.repeat(50000);"
+      "doc.saveTo_('foo.cc', 'utf-8', 1, 0);"
+      "new TextRange(doc, 0, 0).text = 'bar';"
+      "new TextRange(doc, 100000, 100004).text = '';"
+      "new TextRange(doc, doc.length, doc.length).text = 'baz';");
+  RunMessageLoopUntilIdle();
+  std::vector<uint8_t> expected_bytes;
+  for (auto count = 0; count < 50000; ++count) {
+    expected_bytes.push_back('f');
+    expected_bytes.push_back('o');
+    expected_bytes.push_back('o');
+    expected_bytes.push_back('\n');
+  }
+  EXPECT_EQ(expected_bytes, mock_io_delegate()->bytes())
+      << "Changes after saveTo_() call should not be saved.";
+}
+
+TEST_F(TextDocumentTest, saveTo_largeDocument) {
+  mock_io_delegate()->SetOpenFileResult(domapi::IoContextId(), 0);
+  mock_io_delegate()->SetCallResult("SaveFile", 0);
+
+  EXPECT_SCRIPT_VALID(
+      "var doc = TextDocument.new('foo');"
+      "new TextRange(doc).text = 'foo\\n'.repeat(1024 * 1024);"
+      "var result = 0;"
+      "doc.saveTo_('foo.cc', 'utf-8', 3, 0).then(x => result = x);");
+  RunMessageLoopUntilIdle();
+  const auto& bytes = mock_io_delegate()->bytes();
+  EXPECT_EQ(5u * 1024 * 1024, bytes.size());
+  EXPECT_EQ((std::vector<uint8_t>{'f', 'o', 'o', '\r', '\n'}),
+            std::vector<uint8_t>(bytes.end() - 5, bytes.end()));
+  EXPECT_SCRIPT_EQ("5242880", "result");
+}
+
 TEST_F(TextDocumentTest, setSyntax) {
   EXPECT_SCRIPT_VALID(
       "var doc = TextDocument.new('syntax');"
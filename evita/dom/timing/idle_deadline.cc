@@ -16,12 +16,14 @@ IdleDeadline::IdleDeadline(const base::TimeTicks& deadline)
 IdleDeadline::~IdleDeadline() {}
 
 bool IdleDeadline::did_timeout() const {
-  return TimeRemaining() <= 0;
+  return deadline_ <= ScriptHost::instance()->scheduler()->NowTicks();
 }
 
 double IdleDeadline::TimeRemaining() const {
-  const auto& now = ScriptHost::instance()->scheduler()->NowTicks();
-  return (deadline_ - now).InMillisecondsF();
+  auto* const scheduler = ScriptHost::instance()->scheduler();
+  if (scheduler->HasPendingTasks())
+    return 0;
+  return (deadline_ - scheduler->NowTicks()).InMillisecondsF();
 }
 
 }  // namespace dom
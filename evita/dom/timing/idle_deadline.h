@@ -29,13 +29,17 @@ class IdleDeadline final : public ginx::Scriptable<IdleDeadline> {
   explicit IdleDeadline(const base::TimeTicks& deadline);
   ~IdleDeadline() final;
 
+  void set_deadline(const base::TimeTicks& deadline) { deadline_ = deadline; }
+
  private:
   friend class bindings::IdleDeadlineClass;
 
   // An implementation of IdleDeadline.didTimeout attribute
   bool did_timeout() const;
 
-  // An implementation of IdleDeadline.timeRemaining() method
+  // An implementation of IdleDeadline.timeRemaining() method. Returns zero
+  // when scheduler has pending tasks, e.g. input events, so that idle
+  // callbacks running multiple tasks yield to them.
   double TimeRemaining() const;
 
   base::TimeTicks deadline_;
@@ -82,6 +82,10 @@ void MockScheduler::DidBeginFrame(const base::TimeTicks& deadline) {
   NOTREACHED();
 }
 
+bool MockScheduler::HasPendingTasks() const {
+  return !normal_tasks_.empty();
+}
+
 int MockScheduler::RequestAnimationFrame(
     std::unique_ptr<AnimationFrameCallback> callback) {
   ++last_animation_frame_callback_id_;
@@ -100,7 +104,8 @@ int MockScheduler::ScheduleIdleTask(const IdleTask& task) {
   return idle_task->id();
 }
 
-void MockScheduler::ScheduleTask(const base::Closure& task) {
+void MockScheduler::ScheduleTask(TaskPriority priority,
+                                 const base::Closure& task) {
   normal_tasks_.push(task);
 }
 
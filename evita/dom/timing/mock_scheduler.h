@@ -38,10 +38,11 @@ class MockScheduler final : public Scheduler {
   void CancelAnimationFrame(int callback_id) final;
   void CancelIdleTask(int task_id) final;
   void DidBeginFrame(const base::TimeTicks& deadline) final;
+  bool HasPendingTasks() const final;
   int RequestAnimationFrame(
       std::unique_ptr<AnimationFrameCallback> callback) final;
   int ScheduleIdleTask(const IdleTask& task) final;
-  void ScheduleTask(const base::Closure& task) final;
+  void ScheduleTask(TaskPriority priority, const base::Closure& task) final;
 
   std::unordered_map<int, std::unique_ptr<AnimationFrameCallback>>
       animation_frame_callback_map_;
@@ -17,6 +17,9 @@ namespace dom {
 
 namespace {
 
+// |IdleDeadline| object passed to idle callbacks. We reuse it for each
+// callback with updating deadline.
+IdleDeadline* idle_deadline;
 v8::Eternal<v8::Value> idle_deadline_object;
 
 //////////////////////////////////////////////////////////////////////
@@ -46,9 +49,11 @@ void IdleTaskWrapper::Run(const base::TimeTicks& deadline) {
   auto const isolate = runner->isolate();
   ginx::Runner::Scope runner_scope(runner);
   if (idle_deadline_object.IsEmpty()) {
-    idle_deadline_object.Set(
-        isolate, gin::ConvertToV8(isolate, new IdleDeadline(deadline)));
+    idle_deadline = new IdleDeadline(deadline);
+    idle_deadline_object.Set(isolate,
+                             gin::ConvertToV8(isolate, idle_deadline));
   }
+  idle_deadline->set_deadline(deadline);
   DOM_AUTO_LOCK_SCOPE();
   runner->CallAsFunction(callback_.NewLocal(isolate), v8::Undefined(isolate),
                          idle_deadline_object.Get(isolate));
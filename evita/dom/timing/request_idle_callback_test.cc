@@ -49,6 +49,24 @@ TEST_F(RequestIdleCallbackTest, requestIdleCallback) {
   EXPECT_SCRIPT_FALSE("didRun") << "callback should not be in queue.";
 }
 
+TEST_F(RequestIdleCallbackTest, requestIdleCallbackDeadline) {
+  EXPECT_SCRIPT_VALID(
+      "var timeRemaining = 0;"
+      "function callback(idleDeadline) {"
+      "  timeRemaining = idleDeadline.timeRemaining();"
+      "}"
+      "Editor.requestIdleCallback(callback);");
+  mock_scheduler()->SetIdleTimeRemaining(123);
+  RunMessageLoopUntilIdle();
+  EXPECT_SCRIPT_EQ("123", "timeRemaining");
+
+  EXPECT_SCRIPT_VALID("Editor.requestIdleCallback(callback);");
+  mock_scheduler()->SetIdleTimeRemaining(45);
+  RunMessageLoopUntilIdle();
+  EXPECT_SCRIPT_EQ("45", "timeRemaining")
+      << "Each callback should get its own deadline.";
+}
+
 TEST_F(RequestIdleCallbackTest, requestIdleCallbackTimeout) {
   EXPECT_SCRIPT_VALID(
       "var didRun = false, didTimeout = false, timeRemaining = 0;"
@@ -64,7 +82,7 @@ TEST_F(RequestIdleCallbackTest, requestIdleCallbackTimeout) {
   RunMessageLoopUntilIdle();
   EXPECT_SCRIPT_TRUE("didRun");
   EXPECT_SCRIPT_TRUE("didTimeout");
-  EXPECT_SCRIPT_EQ("-1", "timeRemaining");
+  EXPECT_SCRIPT_EQ("0", "timeRemaining");
 
   EXPECT_SCRIPT_VALID("didRun = false;");
   RunMessageLoopUntilIdle();
@@ -27,6 +27,7 @@
 #include "evita/dom/windows/window_set.h"
 #include "evita/gc/local.h"
 #include "evita/ginx/runner.h"
+#include "evita/metrics/latency_tracker.h"
 #include "evita/text/models/buffer.h"
 
 namespace dom {
@@ -190,6 +191,7 @@ void ViewEventHandlerImpl::DispatchKeyboardEvent(
     const domapi::KeyboardEvent& api_event) {
   TRACE_EVENT_WITH_FLOW0("input", "ViewEventHandlerImpl::DispatchKeyboardEvent",
                          api_event.event_id, TRACE_EVENT_FLAG_FLOW_IN);
+  metrics::LatencyTracker::DispatchScope latency_scope(api_event.event_id);
   auto const window = FromEventTargetId(api_event.target_id);
   if (window) {
     const auto& target_and_event = window->TranslateKeyboardEvent(api_event);
@@ -202,6 +204,7 @@ void ViewEventHandlerImpl::DispatchMouseEvent(
     const domapi::MouseEvent& api_event) {
   TRACE_EVENT_WITH_FLOW0("input", "ViewEventHandlerImpl::DispatchMouseEvent",
                          api_event.event_id, TRACE_EVENT_FLAG_FLOW_IN);
+  metrics::LatencyTracker::DispatchScope latency_scope(api_event.event_id);
   auto const window = FromEventTargetId(api_event.target_id);
   if (window && !window->HandleMouseEvent(api_event)) {
     const auto& target_and_event = window->TranslateMouseEvent(api_event);
@@ -220,6 +223,7 @@ void ViewEventHandlerImpl::DispatchTextCompositionEvent(
 
 void ViewEventHandlerImpl::DispatchWheelEvent(
     const domapi::WheelEvent& api_event) {
+  metrics::LatencyTracker::DispatchScope latency_scope(api_event.event_id);
   auto const window = FromEventTargetId(api_event.target_id);
   if (!window)
     return;
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <cmath>
 
 #include "evita/dom/windows/scroll_bar.h"
@@ -76,7 +77,7 @@ ScrollBar::ScrollBar(ScrollBarOrientation orientation,
       owner_(owner),
       repeat_controller_(
           base::Bind(&ScrollBar::DidFireRepeatTimer, base::Unretained(this))) {
-  SetDisabled(true);
+  UpdatePartStates();
 }
 
 ScrollBar::~ScrollBar() {}
@@ -121,13 +122,10 @@ bool ScrollBar::HandleMouseMoved(const MouseEvent& event) {
     return UpdateHoveredPart(part);
   if (IsDisabled(part))
     return true;
-  const auto delta = layout_->IsVertical() ? point.y() - last_drag_point_.y()
-                                           : point.x() - last_drag_point_.x();
-  last_drag_point_ = point;
-  if (delta < 0)
-    observer_->DidClickLineUp();
-  else if (delta > 0)
-    observer_->DidClickLineDown();
+  const auto delta = layout_->IsVertical() ? point.y() - drag_start_point_.y()
+                                           : point.x() - drag_start_point_.x();
+  const auto value = drag_start_value_ + layout_->ComputeValueDelta(delta);
+  observer_->DidMoveThumb(static_cast<int>(std::round(std::max(value, 0.0f))));
   return true;
 }
 
@@ -166,7 +164,8 @@ bool ScrollBar::HandleMousePressed(const MouseEvent& event) {
     case ScrollBarPart::Thumb:
       layout_->SetState(ScrollBarPart::Thumb, ScrollBarState::Pressed);
       repeat_controller_.Start();
-      last_drag_point_ = point;
+      drag_start_point_ = point;
+      drag_start_value_ = data_.thumb().lower();
       break;
   }
   owner_->DidChangeScrollBar();
@@ -215,34 +214,42 @@ void ScrollBar::SetDisabled(bool new_disabled) {
   if (disabled_ == new_disabled)
     return;
   disabled_ = new_disabled;
-  const auto state =
-      disabled_ ? ScrollBarState::Disabled : ScrollBarState::Normal;
-  layout_->SetState(ScrollBarPart::BackwardButton, state);
-  layout_->SetState(ScrollBarPart::BackwardTrack, state);
-  layout_->SetState(ScrollBarPart::ForwardButton, state);
-  layout_->SetState(ScrollBarPart::ForwardTrack, state);
-  layout_->SetState(ScrollBarPart::Thumb, state);
+  UpdatePartStates();
   owner_->DidChangeScrollBar();
 }
 
+ScrollBarState ScrollBar::StateOf(ScrollBarPart part) const {
+  return layout_->StateOf(part);
+}
+
 bool ScrollBar::UpdateHoveredPart(ScrollBarPart part) {
   if (hovered_part_ == part)
     return false;
-  owner_->DidChangeScrollBar();
   if (hovered_part_ != ScrollBarPart::None) {
     layout_->SetState(hovered_part_, IsDisabled(hovered_part_)
                                          ? ScrollBarState::Disabled
                                          : ScrollBarState::Normal);
   }
   hovered_part_ = part;
-  if (hovered_part_ == ScrollBarPart::None)
-    return true;
-  if (IsDisabled(hovered_part_)) {
-    hovered_part_ = ScrollBarPart::None;
-    return true;
+  if (hovered_part_ != ScrollBarPart::None) {
+    if (IsDisabled(hovered_part_))
+      hovered_part_ = ScrollBarPart::None;
+    else
+      layout_->SetState(hovered_part_, ScrollBarState::Hovered);
   }
-  layout_->SetState(hovered_part_, ScrollBarState::Hovered);
+  // Since owner takes snapshot of part states, we notify after updating them.
+  owner_->DidChangeScrollBar();
   return true;
 }
 
+void ScrollBar::UpdatePartStates() {
+  const auto state =
+      disabled_ ? ScrollBarState::Disabled : ScrollBarState::Normal;
+  layout_->SetState(ScrollBarPart::BackwardButton, state);
+  layout_->SetState(ScrollBarPart::BackwardTrack, state);
+  layout_->SetState(ScrollBarPart::ForwardButton, state);
+  layout_->SetState(ScrollBarPart::ForwardTrack, state);
+  layout_->SetState(ScrollBarPart::Thumb, state);
+}
+
 }  // namespace dom
@@ -67,6 +67,7 @@ class ScrollBar final {
   void SetBounds(const gfx::FloatRect& bounds);
   void SetData(const ScrollBarData& new_data);
   void SetDisabled(bool new_disabled);
+  ScrollBarState StateOf(ScrollBarPart part) const;
 
  private:
   void DidFireRepeatTimer();
@@ -76,12 +77,15 @@ class ScrollBar final {
   bool IsDisabled(ScrollBarPart part) const;
   // Return true if hovered part is changed.
   bool UpdateHoveredPart(ScrollBarPart part);
+  void UpdatePartStates();
 
   ScrollBarPart active_part_;
   ScrollBarData data_;
   ScrollBarPart hovered_part_;
-  bool disabled_ = false;
-  gfx::FloatPoint last_drag_point_;
+  bool disabled_ = true;
+  gfx::FloatPoint drag_start_point_;
+  // Thumb position in data value at start of dragging.
+  float drag_start_value_ = 0;
   std::unique_ptr<layout::ScrollBar> layout_;
   ui::ScrollBarObserver* const observer_;
   ScrollBarOwner* const owner_;
@@ -7,7 +7,6 @@
 #include "evita/dom/windows/text_window.h"
 
 #include "base/logging.h"
-#include "base/timer/timer.h"
 #include "base/trace_event/trace_event.h"
 #include "evita/base/strings/atomic_string.h"
 #include "evita/dom/bindings/exception_state.h"
@@ -16,7 +15,6 @@
 #include "evita/dom/public/cursor.h"
 #include "evita/dom/public/scroll_bar_orientation.h"
 #include "evita/dom/public/scroll_bar_part.h"
-#include "evita/dom/public/text_area_display_item.h"
 #include "evita/dom/public/view_delegate.h"
 #include "evita/dom/public/view_events.h"
 #include "evita/dom/scheduler/animation_frame_callback.h"
@@ -26,7 +24,9 @@
 #include "evita/dom/text/text_range.h"
 #include "evita/dom/windows/scroll_bar.h"
 #include "evita/dom/windows/text_selection.h"
-#include "evita/text/layout/paint_view_builder.h"
+#include "evita/dom/windows/text_window_layout.h"
+#include "evita/metrics/latency_tracker.h"
+#include "evita/text/layout/buffer_replica.h"
 #include "evita/text/layout/render_selection.h"
 #include "evita/text/layout/text_view.h"
 #include "evita/text/models/buffer.h"
@@ -34,29 +34,26 @@
 #include "evita/text/models/marker_set.h"
 #include "evita/text/models/selection.h"
 #include "evita/text/models/static_range.h"
-#include "evita/text/paint/public/caret.h"
-#include "evita/text/paint/public/selection.h"
-#include "evita/text/paint/public/view.h"
 #include "evita/ui/base/selection_state.h"
-#include "evita/visuals/display/public/display_item_list.h"
 
 namespace dom {
 
-using Caret = TextWindow::Caret;
-using CaretDisplayItem = paint::Caret;
 using gfx::FloatPoint;
 using gfx::FloatRect;
 using gfx::FloatSize;
-using domapi::ScrollBarData;
-using layout::PaintViewBuilder;
 using layout::TextSelectionModel;
-using paint::CaretState;
+using ScopedTextView = TextWindowLayout::ScopedTextView;
 
 namespace {
 
 css::StyleSheet* s_default_style_sheet;
 
-const auto kBlinkInterval = 16 * 20;  // milliseconds
+// Parts of scroll bar of which states are sent to layout thread.
+const domapi::ScrollBarPart kScrollBarParts[] = {
+    domapi::ScrollBarPart::BackwardButton, domapi::ScrollBarPart::BackwardTrack,
+    domapi::ScrollBarPart::ForwardButton, domapi::ScrollBarPart::ForwardTrack,
+    domapi::ScrollBarPart::Thumb,
+};
 
 gfx::FloatPoint ToFloatPoint(const gfx::PointF& point) {
   return gfx::FloatPoint(point.x, point.y);
@@ -84,116 +81,8 @@ TextSelectionModel ComputeTextSelectionModel(TextWindow* window,
       selection.anchor_offset(), selection.focus_offset());
 }
 
-base::TimeDelta GetCaretBlinkInterval() {
-  const auto interval = ::GetCaretBlinkTime();
-  if (!interval)
-    return base::TimeDelta::FromMilliseconds(kBlinkInterval);
-  if (interval == INFINITE)
-    return base::TimeDelta();
-  return base::TimeDelta::FromMilliseconds(interval);
-}
-
 }  // namespace
 
-//////////////////////////////////////////////////////////////////////
-//
-// TextWindow::Caret
-//
-class TextWindow::Caret final {
- public:
-  explicit Caret(TextWindow* owner);
-  ~Caret() = default;
-
-  void DidChangeWindowBounds();
-  void DidHideWindow();
-  void DidKillFocus();
-  void DidSetFocus();
-  CaretDisplayItem Paint() const;
-  void Update(const gfx::FloatRect& new_bounds, const base::TimeTicks& now);
-
- private:
-  void DidFireCaretTimer();
-  void StartCaretBlinkTimer();
-  void StopCaretBlinkTimer();
-
-  gfx::FloatRect bounds_;
-  TextWindow* const owner_;
-  CaretState state_ = CaretState::None;
-  base::TimeTicks show_start_time_;
-  base::RepeatingTimer blink_timer_;
-
-  DISALLOW_COPY_AND_ASSIGN(Caret);
-};
-
-Caret::Caret(TextWindow* owner) : owner_(owner) {}
-
-void Caret::DidFireCaretTimer() {
-  owner_->RequestAnimationFrame();
-}
-
-void Caret::DidChangeWindowBounds() {
-  StopCaretBlinkTimer();
-}
-
-void Caret::DidKillFocus() {
-  StopCaretBlinkTimer();
-}
-
-void Caret::DidHideWindow() {
-  StopCaretBlinkTimer();
-}
-
-void Caret::DidSetFocus() {
-  DCHECK(state_ == CaretState::None);
-}
-
-CaretDisplayItem Caret::Paint() const {
-  return CaretDisplayItem(state_, ToRectF(bounds_));
-}
-
-void Caret::StartCaretBlinkTimer() {
-  const auto interval = GetCaretBlinkInterval();
-  if (interval == base::TimeDelta())
-    return;
-  blink_timer_.Start(FROM_HERE, interval, base::Bind(&Caret::DidFireCaretTimer,
-                                                     base::Unretained(this)));
-}
-
-void Caret::StopCaretBlinkTimer() {
-  blink_timer_.Stop();
-  bounds_ = gfx::FloatRect();
-  state_ = CaretState::None;
-}
-
-void Caret::Update(const gfx::FloatRect& new_bounds,
-                   const base::TimeTicks& now) {
-  if (bounds_ == new_bounds) {
-    if (bounds_.IsEmpty()) {
-      DCHECK(state_ == CaretState::None);
-      return;
-    }
-
-    // When the caret stays at same point, caret is blinking.
-    const auto interval = GetCaretBlinkInterval();
-    if (interval == base::TimeDelta())
-      return;
-    const auto delta = now - show_start_time_;
-    const auto index = delta / interval;
-    state_ = index % 2 ? paint::CaretState::Hide : paint::CaretState::Show;
-    return;
-  }
-
-  bounds_ = new_bounds;
-  if (bounds_.IsEmpty()) {
-    StopCaretBlinkTimer();
-    state_ = CaretState::None;
-    return;
-  }
-  state_ = CaretState::Show;
-  show_start_time_ = now;
-  StartCaretBlinkTimer();
-}
-
 //////////////////////////////////////////////////////////////////////
 //
 // TextWindow
@@ -202,13 +91,15 @@ TextWindow::TextWindow(ScriptHost* script_host,
                        TextRange* selection_range,
                        css::StyleSheet* style_sheet)
     : Scriptable(script_host),
-      caret_(new Caret(this)),
       markers_(new text::MarkerSet(text::MarkerSet::Kind::Fragile,
                                    *selection_range->document()->buffer())),
       selection_(new TextSelection(this, selection_range)),
-      text_view_(new layout::TextView(*selection_range->document()->buffer(),
-                                      *markers_,
-                                      style_sheet)),
+      text_layout_(
+          new TextWindowLayout(window_id(),
+                               *selection_range->document()->buffer(),
+                               *markers_,
+                               style_sheet,
+                               script_host->view_delegate())),
       vertical_scroll_bar_(
           new ScrollBar(domapi::ScrollBarOrientation::Vertical, this, this)) {
   document()->buffer()->AddObserver(this);
@@ -229,6 +120,7 @@ TextWindow::~TextWindow() {
   document()->buffer()->RemoveObserver(this);
   markers_->RemoveObserver(this);
   selection_->text_selection()->RemoveObserver(this);
+  text_layout_->Detach();
 }
 
 text::Buffer* TextWindow::buffer() const {
@@ -240,18 +132,20 @@ TextDocument* TextWindow::document() const {
 }
 
 float TextWindow::zoom() const {
-  return text_view_->zoom();
+  ScopedTextView text_view(text_layout_.get());
+  return text_view->zoom();
 }
 
 void TextWindow::set_zoom(float new_zoom, ExceptionState* exception_state) {
-  if (text_view_->zoom() == new_zoom)
-    return;
   if (new_zoom <= 0.0f) {
     exception_state->ThrowRangeError(
         "TextWindow zoom must be greater than zero.");
     return;
   }
-  text_view_->SetZoom(new_zoom);
+  ScopedTextView text_view(text_layout_.get());
+  if (text_view->zoom() == new_zoom)
+    return;
+  text_view->SetZoom(new_zoom);
   RequestAnimationFrame();
 }
 
@@ -300,7 +194,8 @@ text::Offset TextWindow::ComputeMotion(int method) {
 }
 
 text::Offset TextWindow::ComputeEndOfLine(text::Offset text_offset) {
-  return text_view_->ComputeEndOfLine(text_offset);
+  ScopedTextView text_view(text_layout_.get());
+  return text_view->ComputeEndOfLine(text_offset);
 }
 
 text::Offset TextWindow::ComputeScreenMotion(int n,
@@ -309,21 +204,24 @@ text::Offset TextWindow::ComputeScreenMotion(int n,
   // TODO(eval1749): We should not call |LargetScroll()| in |ComputeMotion|.
   if (LargeScroll(0, n))
     return HitTestPoint(point.x(), point.y());
+  ScopedTextView text_view(text_layout_.get());
   if (n > 0)
-    return std::min(text_view_->text_end(), buffer()->GetEnd());
+    return std::min(text_view->text_end(), buffer()->GetEnd());
   if (n < 0)
-    return text_view_->text_start();
+    return text_view->text_start();
   return offset;
 }
 
 text::Offset TextWindow::ComputeStartOfLine(text::Offset text_offset) {
-  return text_view_->ComputeStartOfLine(text_offset);
+  ScopedTextView text_view(text_layout_.get());
+  return text_view->ComputeStartOfLine(text_offset);
 }
 
 text::Offset TextWindow::ComputeWindowLineMotion(int n,
                                                  const gfx::FloatPoint& pt,
                                                  text::Offset lPosn) {
-  text_view_->FormatIfNeeded();
+  ScopedTextView text_view(text_layout_.get());
+  text_view->FormatIfNeeded();
   if (n > 0) {
     const auto lBufEnd = buffer()->GetEnd();
     if (lPosn >= lBufEnd)
@@ -331,12 +229,12 @@ text::Offset TextWindow::ComputeWindowLineMotion(int n,
     auto lGoal = lPosn;
     auto k = 0;
     for (k = 0; k < n; ++k) {
-      lGoal = ComputeEndOfLine(lGoal);
+      lGoal = text_view->ComputeEndOfLine(lGoal);
       if (lGoal >= lBufEnd)
         break;
       ++lGoal;
     }
-    return text_view_->MapPointXToOffset(std::min(lGoal, lBufEnd), pt.x());
+    return text_view->MapPointXToOffset(std::min(lGoal, lBufEnd), pt.x());
   }
   if (n < 0) {
     n = -n;
@@ -344,60 +242,61 @@ text::Offset TextWindow::ComputeWindowLineMotion(int n,
     auto lStart = lPosn;
     auto k = 0;
     for (k = 0; k < n; ++k) {
-      lStart = ComputeStartOfLine(lStart);
+      lStart = text_view->ComputeStartOfLine(lStart);
       if (lStart <= lBufStart)
         break;
       --lStart;
     }
 
-    return text_view_->MapPointXToOffset(std::max(lStart, lBufStart), pt.x());
+    return text_view->MapPointXToOffset(std::max(lStart, lBufStart), pt.x());
   }
   return lPosn;
 }
 
 text::Offset TextWindow::ComputeWindowMotion(int n, text::Offset offset) {
-  text_view_->FormatIfNeeded();
+  ScopedTextView text_view(text_layout_.get());
+  text_view->FormatIfNeeded();
   if (n > 0)
-    return std::max(std::min(text_view_->text_end() - text::OffsetDelta(1),
+    return std::max(std::min(text_view->text_end() - text::OffsetDelta(1),
                              buffer()->GetEnd()),
-                    text_view_->text_start());
+                    text_view->text_start());
   if (n < 0)
-    return text_view_->text_start();
+    return text_view->text_start();
   return offset;
 }
 
+// Takes snapshot of states used for painting at end of animation frame, when
+// script has finished changing them, and requests layout thread to paint.
 void TextWindow::DidBeginAnimationFrame(const base::TimeTicks& now) {
   DCHECK(is_waiting_animation_frame_);
   is_waiting_animation_frame_ = false;
-  if (!visible())
-    return;
-  TRACE_EVENT_WITH_FLOW0("view", "TextWindow::DidBeginAnimationFrame",
-                         window_id(), TRACE_EVENT_FLAG_FLOW_OUT);
-  const auto selection =
+  TRACE_EVENT0("view", "TextWindow::DidBeginAnimationFrame");
+  TextWindowLayout::FrameState state;
+  state.frame_id = ++last_frame_id_;
+  state.revision = text_layout_->replica()->RecordedRevision();
+  state.scroll_bar_bounds = ToRectF(vertical_scroll_bar_->bounds());
+  for (const auto part : kScrollBarParts) {
+    state.scroll_bar_states.emplace_back(part,
+                                         vertical_scroll_bar_->StateOf(part));
+  }
+  state.selection =
       ComputeTextSelectionModel(this, *selection_->text_selection());
-  text_view_->Update(selection);
-  const auto caret_bounds =
-      ToFloatRect(text_view_->ComputeCaretBounds(selection));
-  caret_->Update(caret_bounds, now);
-  const auto paint_view =
-      PaintViewBuilder().Build(text_view_->block(), selection, caret_->Paint());
-  UpdateScrollBar();
-  auto display_item = std::make_unique<domapi::TextAreaDisplayItem>(
-      paint_view, std::move(vertical_scroll_bar_->Paint()));
-  script_host()->view_delegate()->PaintTextArea(window_id(),
-                                                std::move(display_item));
+  state.visible = visible();
+  text_layout_->RequestFrame(state);
 }
 
 // Maps position specified buffer position and returns height
 // of caret, If specified buffer position isn't in window, this function
 // returns 0.
 text::Offset TextWindow::HitTestPoint(float x, float y) {
+  UpdateScrollBar();
   const auto& point = gfx::FloatPoint(x, y);
   const auto scroll_bar_part = vertical_scroll_bar_->HitTestPoint(point);
   if (scroll_bar_part != domapi::ScrollBarPart::None)
     return text::Offset::Invalid();
-  text_view_->FormatIfNeeded();
-  return std::min(text_view_->HitTestPoint(gfx::PointF(x, y)),
+  ScopedTextView text_view(text_layout_.get());
+  text_view->FormatIfNeeded();
+  return std::min(text_view->HitTestPoint(gfx::PointF(x, y)),
                   buffer()->GetEnd());
 }
 
@@ -405,12 +304,14 @@ text::Offset TextWindow::HitTestPoint(float x, float y) {
 // of caret, If specified buffer position isn't in window, this function
 // returns |text::Offset::Invalid()|.
 gfx::FloatRect TextWindow::HitTestTextPosition(text::Offset offset) {
-  text_view_->FormatIfNeeded();
-  return ToFloatRect(text_view_->HitTestTextPosition(offset));
+  ScopedTextView text_view(text_layout_.get());
+  text_view->FormatIfNeeded();
+  return ToFloatRect(text_view->HitTestTextPosition(offset));
 }
 
 bool TextWindow::LargeScroll(int, int iDy) {
-  text_view_->FormatIfNeeded();
+  ScopedTextView text_view(text_layout_.get());
+  text_view->FormatIfNeeded();
   auto scrolled = false;
   if (iDy < 0) {
     // Scroll Down -- place top line out of window.
@@ -418,25 +319,25 @@ bool TextWindow::LargeScroll(int, int iDy) {
 
     const auto lBufStart = text::Offset(0);
     for (auto k = 0; k < iDy; ++k) {
-      const auto lStart = text_view_->text_start();
+      const auto lStart = text_view->text_start();
       if (lStart == lBufStart)
         break;
 
       // Scroll down until page start goes out to page.
       do {
-        if (!text_view_->ScrollDown())
+        if (!text_view->ScrollDown())
           break;
         scrolled = true;
-      } while (text_view_->text_end() != lStart);
+      } while (text_view->text_end() != lStart);
     }
   } else if (iDy > 0) {
     // Scroll Up -- format page from page end.
     const auto lBufEnd = buffer()->GetEnd();
     for (auto k = 0; k < iDy; ++k) {
-      const auto lStart = text_view_->text_end();
+      const auto lStart = text_view->text_end();
       if (lStart >= lBufEnd)
         break;
-      text_view_->Format(lStart);
+      text_view->Format(lStart);
       scrolled = true;
     }
   }
@@ -455,7 +356,8 @@ base::string16 TextWindow::MarkerAt(text::Offset offset,
 }
 
 void TextWindow::MakeSelectionVisible() {
-  text_view_->MakeSelectionVisible();
+  ScopedTextView text_view(text_layout_.get());
+  text_view->MakeSelectionVisible();
 }
 
 // static
@@ -468,6 +370,8 @@ void TextWindow::Reconvert(const base::string16& text) {
 }
 
 void TextWindow::RequestAnimationFrame() {
+  metrics::LatencyTracker::instance()->DidRequestFrame(window_id(),
+                                                       last_frame_id_ + 1);
   if (is_waiting_animation_frame_)
     return;
   is_waiting_animation_frame_ = true;
@@ -497,16 +401,17 @@ void TextWindow::SetMarker(text::Offset start,
 }
 
 bool TextWindow::SmallScroll(int, int y_count) {
+  ScopedTextView text_view(text_layout_.get());
   auto scrolled = false;
   if (y_count < 0) {
     for (auto k = y_count; k; ++k) {
-      if (!text_view_->ScrollDown())
+      if (!text_view->ScrollDown())
         break;
       scrolled = true;
     }
   } else if (y_count > 0) {
     for (auto k = 0; k < y_count; ++k) {
-      if (!text_view_->ScrollUp())
+      if (!text_view->ScrollUp())
         break;
       scrolled = true;
     }
@@ -526,9 +431,10 @@ void TextWindow::UpdateBounds() {
 
   const auto text_block_bounds = gfx::FloatRect(
       canvas_bounds.size() - gfx::FloatSize(vertical_scroll_bar_width, 0.0f));
-  text_view_->SetBounds(gfx::RectF(text_block_bounds.x(), text_block_bounds.y(),
-                                   text_block_bounds.right(),
-                                   text_block_bounds.bottom()));
+  {
+    ScopedTextView text_view(text_layout_.get());
+    text_view->SetBounds(ToRectF(text_block_bounds));
+  }
 
   // Place vertical scroll bar at right edge of text block.
   const auto vertical_scroll_bar_bounds = gfx::FloatRect(
@@ -537,11 +443,12 @@ void TextWindow::UpdateBounds() {
   vertical_scroll_bar_->SetBounds(vertical_scroll_bar_bounds);
 }
 
+// Updates scroll bar data for handling mouse events on script thread. Layout
+// thread computes scroll bar data for painting by itself.
 void TextWindow::UpdateScrollBar() {
-  ScrollBarData data(base::FloatRange(0, buffer()->GetEnd().value() + 1),
-                     base::FloatRange(text_view_->text_start().value(),
-                                      text_view_->text_end().value()));
-  vertical_scroll_bar_->SetData(data);
+  ScopedTextView text_view(text_layout_.get());
+  vertical_scroll_bar_->SetData(
+      TextWindowLayout::ComputeScrollBarData(text_view.get()));
 }
 
 // ScrollBarOwner
@@ -559,19 +466,23 @@ void TextWindow::DidPressScrollBar() {
 
 // text::BufferMutationObserver
 void TextWindow::DidChangeStyle(const text::StaticRange& range) {
+  text_layout_->replica()->DidChangeStyle(range);
   RequestAnimationFrame();
 }
 
 void TextWindow::DidDeleteAt(const text::StaticRange& range) {
+  text_layout_->replica()->DidDeleteAt(range);
   RequestAnimationFrame();
 }
 
 void TextWindow::DidInsertBefore(const text::StaticRange& range) {
+  text_layout_->replica()->DidInsertBefore(range);
   RequestAnimationFrame();
 }
 
 // text::MarkerSetObserver
 void TextWindow::DidChangeMarker(const text::StaticRange& range) {
+  text_layout_->replica()->DidChangeMarker(range);
   RequestAnimationFrame();
 }
 
@@ -600,12 +511,16 @@ void TextWindow::DidClickPageUp() {
 void TextWindow::DidMoveThumb(int value) {
   if (value < 0)
     return;
-  text_view_->Format(text::Offset(value));
+  {
+    ScopedTextView text_view(text_layout_.get());
+    text_view->Format(text_view->ComputeOffsetOfVisualLine(value));
+  }
   RequestAnimationFrame();
 }
 
 // ViewEventTarget
 bool TextWindow::HandleMouseEvent(const domapi::MouseEvent& event) {
+  UpdateScrollBar();
   if (event.event_type == domapi::EventType::MouseMove) {
     const auto& point = gfx::FloatPoint(event.client_x, event.client_y);
     const auto cursor_id = vertical_scroll_bar_->bounds().Contains(point)
@@ -620,25 +535,24 @@ bool TextWindow::HandleMouseEvent(const domapi::MouseEvent& event) {
 void TextWindow::DidChangeBounds() {
   UpdateBounds();
   RequestAnimationFrame();
-  caret_->DidChangeWindowBounds();
+  text_layout_->ResetCaret();
 }
 
 void TextWindow::DidHideWindow() {
   Window::DidHideWindow();
   RequestAnimationFrame();
-  caret_->DidHideWindow();
+  text_layout_->ResetCaret();
 }
 
 void TextWindow::DidKillFocus() {
   Window::DidKillFocus();
   RequestAnimationFrame();
-  caret_->DidKillFocus();
+  text_layout_->ResetCaret();
 }
 
 void TextWindow::DidSetFocus() {
   Window::DidSetFocus();
   RequestAnimationFrame();
-  caret_->DidSetFocus();
 }
 
 void TextWindow::DidShowWindow() {
@@ -9,6 +9,7 @@
 
 #include "evita/dom/windows/window.h"
 
+#include "base/memory/ref_counted.h"
 #include "evita/dom/windows/rect.h"
 #include "evita/dom/windows/scroll_bar.h"
 #include "evita/gc/member.h"
@@ -22,10 +23,6 @@ namespace css {
 class StyleSheet;
 }
 
-namespace layout {
-class TextView;
-}
-
 namespace text {
 class Buffer;
 class MarkerSet;
@@ -38,6 +35,7 @@ class ScrollBar;
 class TextDocument;
 class TextRange;
 class TextSelection;
+class TextWindowLayout;
 
 namespace bindings {
 class TextWindowClass;
@@ -55,8 +53,6 @@ class TextWindow final : public ginx::Scriptable<TextWindow, Window>,
   using FloatPoint = gfx::FloatPoint;
 
  public:
-  class Caret;
-
   ~TextWindow() final;
 
  private:
@@ -149,11 +145,12 @@ class TextWindow final : public ginx::Scriptable<TextWindow, Window>,
   void DidShowWindow() final;
   void ForceUpdateWindow() final;
 
-  const std::unique_ptr<Caret> caret_;
   bool is_waiting_animation_frame_ = false;
+  // Sequence number of the last frame requested to |text_layout_|.
+  int last_frame_id_ = 0;
   const std::unique_ptr<text::MarkerSet> markers_;
   const gc::Member<TextSelection> selection_;
-  const std::unique_ptr<layout::TextView> text_view_;
+  const scoped_refptr<TextWindowLayout> text_layout_;
   const std::unique_ptr<ScrollBar> vertical_scroll_bar_;
 
   DISALLOW_COPY_AND_ASSIGN(TextWindow);
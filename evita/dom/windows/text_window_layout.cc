@@ -0,0 +1,309 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "evita/dom/windows/text_window_layout.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/dom/public/scroll_bar_orientation.h"
+#include "evita/dom/public/scroll_bar_part.h"
+#include "evita/dom/public/scroll_bar_state.h"
+#include "evita/dom/public/text_area_display_item.h"
+#include "evita/dom/public/view_delegate.h"
+#include "evita/metrics/latency_tracker.h"
+#include "evita/text/layout/buffer_replica.h"
+#include "evita/text/layout/layout_thread.h"
+#include "evita/text/layout/paint_view_builder.h"
+#include "evita/text/layout/scroll_bar.h"
+#include "evita/text/layout/text_view.h"
+#include "evita/text/paint/public/caret.h"
+#include "evita/text/paint/public/view.h"
+#include "evita/visuals/display/public/display_item_list.h"
+
+namespace dom {
+
+using CaretDisplayItem = paint::Caret;
+using layout::LayoutThread;
+using layout::PaintViewBuilder;
+using paint::CaretState;
+
+namespace {
+
+const auto kBlinkInterval = 16 * 20;  // milliseconds
+
+// Pre-formatting in idle time runs in chunks of |kIdleTaskBudget| so that
+// script thread doesn't wait for layout lock long.
+const auto kIdleTaskBudget = 5;  // milliseconds
+
+base::TimeDelta GetCaretBlinkInterval() {
+  const auto interval = ::GetCaretBlinkTime();
+  if (!interval)
+    return base::TimeDelta::FromMilliseconds(kBlinkInterval);
+  if (interval == INFINITE)
+    return base::TimeDelta();
+  return base::TimeDelta::FromMilliseconds(interval);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextWindowLayout::Caret
+//
+// Since timers are bound to thread which starts them, caret blinks by
+// posting delayed tasks to layout thread with |timer_id()|, which is changed
+// when blinking is stopped.
+//
+class TextWindowLayout::Caret final {
+ public:
+  explicit Caret(TextWindowLayout* owner);
+  ~Caret() = default;
+
+  int timer_id() const { return timer_id_; }
+
+  CaretDisplayItem Paint() const;
+  void Reset();
+  void StartCaretBlinkTimer();
+  void Update(const gfx::RectF& new_bounds, const base::TimeTicks& now);
+
+ private:
+  gfx::RectF bounds_;
+  TextWindowLayout* const owner_;
+  CaretState state_ = CaretState::None;
+  base::TimeTicks show_start_time_;
+  int timer_id_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Caret);
+};
+
+TextWindowLayout::Caret::Caret(TextWindowLayout* owner) : owner_(owner) {}
+
+CaretDisplayItem TextWindowLayout::Caret::Paint() const {
+  return CaretDisplayItem(state_, bounds_);
+}
+
+void TextWindowLayout::Caret::Reset() {
+  ++timer_id_;
+  bounds_ = gfx::RectF();
+  state_ = CaretState::None;
+}
+
+void TextWindowLayout::Caret::StartCaretBlinkTimer() {
+  const auto interval = GetCaretBlinkInterval();
+  if (interval == base::TimeDelta())
+    return;
+  LayoutThread::GetInstance()->PostDelayedTask(
+      FROM_HERE, base::Bind(&TextWindowLayout::DidFireCaretTimer,
+                            make_scoped_refptr(owner_), timer_id_),
+      interval);
+}
+
+void TextWindowLayout::Caret::Update(const gfx::RectF& new_bounds,
+                                     const base::TimeTicks& now) {
+  if (bounds_ == new_bounds) {
+    if (bounds_.empty()) {
+      DCHECK(state_ == CaretState::None);
+      return;
+    }
+
+    // When the caret stays at same point, caret is blinking.
+    const auto interval = GetCaretBlinkInterval();
+    if (interval == base::TimeDelta())
+      return;
+    const auto delta = now - show_start_time_;
+    const auto index = delta / interval;
+    state_ = index % 2 ? CaretState::Hide : CaretState::Show;
+    return;
+  }
+
+  Reset();
+  bounds_ = new_bounds;
+  if (bounds_.empty())
+    return;
+  state_ = CaretState::Show;
+  show_start_time_ = now;
+  StartCaretBlinkTimer();
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextWindowLayout::FrameState
+//
+TextWindowLayout::FrameState::FrameState() {}
+TextWindowLayout::FrameState::FrameState(const FrameState& other) = default;
+TextWindowLayout::FrameState::~FrameState() {}
+
+TextWindowLayout::FrameState& TextWindowLayout::FrameState::operator=(
+    const FrameState& other) = default;
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextWindowLayout::ScopedTextView
+//
+TextWindowLayout::ScopedTextView::ScopedTextView(TextWindowLayout* layout)
+    : lock_scope_(*LayoutThread::GetInstance()->lock()),
+      text_view_(layout->text_view_.get()) {
+  DCHECK(!LayoutThread::GetInstance()->CalledOnLayoutThread());
+  DCHECK(text_view_) << "Layout is detached.";
+  layout->replica_->Commit();
+}
+
+TextWindowLayout::ScopedTextView::~ScopedTextView() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextWindowLayout
+//
+TextWindowLayout::TextWindowLayout(domapi::WindowId window_id,
+                                   const text::Buffer& buffer,
+                                   const text::MarkerSet& markers,
+                                   css::StyleSheet* style_sheet,
+                                   domapi::ViewDelegate* view_delegate)
+    : caret_(new Caret(this)),
+      replica_(new layout::BufferReplica(buffer, markers)),
+      scroll_bar_(
+          new layout::ScrollBar(domapi::ScrollBarOrientation::Vertical)),
+      text_view_(new layout::TextView(replica_->buffer(),
+                                      replica_->markers(),
+                                      style_sheet)),
+      view_delegate_(view_delegate),
+      window_id_(window_id) {}
+
+TextWindowLayout::~TextWindowLayout() {
+  DCHECK(!text_view_) << "Layout should be detached.";
+}
+
+// Scroll bar data is in visual lines, e.g. lines wrapped at window width,
+// rather than in offsets, so that the thumb reflects how much text is
+// visible regardless of length of lines.
+// static
+domapi::ScrollBarData TextWindowLayout::ComputeScrollBarData(
+    layout::TextView* text_view) {
+  const auto view_start =
+      text_view->ComputeVisualLineOf(text_view->text_start());
+  const auto view_end = view_start + text_view->num_visible_lines();
+  const auto num_visual_lines =
+      std::max(text_view->num_visual_lines(), view_end);
+  return ScrollBarData(base::FloatRange(0, num_visual_lines),
+                       base::FloatRange(view_start, view_end));
+}
+
+void TextWindowLayout::Detach() {
+  base::AutoLock lock_scope(*LayoutThread::GetInstance()->lock());
+  caret_->Reset();
+  text_view_.reset();
+}
+
+void TextWindowLayout::DidEnterIdle() {
+  base::AutoLock lock_scope(*LayoutThread::GetInstance()->lock());
+  is_idle_task_requested_ = false;
+  if (!text_view_)
+    return;
+  TRACE_EVENT0("view", "TextWindowLayout::DidEnterIdle");
+  const auto num_visual_lines = text_view_->num_visual_lines();
+  const auto deadline = base::TimeTicks::Now() +
+                        base::TimeDelta::FromMilliseconds(kIdleTaskBudget);
+  // Lines around view port are more likely used than visual line index.
+  if (!text_view_->Preformat(deadline))
+    text_view_->UpdateVisualLineIndex(deadline);
+  if (text_view_->NeedsPreformat() || text_view_->NeedsUpdateVisualLineIndex())
+    RequestIdleTask();
+  if (text_view_->num_visual_lines() == num_visual_lines)
+    return;
+  // Update scroll bar.
+  ScheduleFrame();
+}
+
+void TextWindowLayout::DidFireCaretTimer(int timer_id) {
+  base::AutoLock lock_scope(*LayoutThread::GetInstance()->lock());
+  if (caret_->timer_id() != timer_id)
+    return;
+  ScheduleFrame();
+  caret_->StartCaretBlinkTimer();
+}
+
+void TextWindowLayout::DidRequestFrame() {
+  base::AutoLock lock_scope(*LayoutThread::GetInstance()->lock());
+  FrameState state;
+  {
+    base::AutoLock pending_lock_scope(pending_lock_);
+    is_frame_scheduled_ = false;
+    state = pending_state_;
+  }
+  if (!text_view_ || !state.visible)
+    return;
+  // When script thread has committed mutations newer than |state|, it has
+  // requested another frame.
+  if (!replica_->CommitUntil(state.revision))
+    return;
+  TRACE_EVENT_WITH_FLOW0("view", "TextWindowLayout::DidRequestFrame",
+                         window_id_, TRACE_EVENT_FLAG_FLOW_OUT);
+  metrics::LatencyTracker::LayoutScope latency_scope(window_id_,
+                                                    state.frame_id);
+  text_view_->Update(state.selection);
+  caret_->Update(text_view_->ComputeCaretBounds(state.selection),
+                 base::TimeTicks::Now());
+  const auto paint_view = PaintViewBuilder().Build(
+      text_view_->block(), state.selection, caret_->Paint());
+  text_view_->DidCommitLayout();
+
+  const auto& data = ComputeScrollBarData(text_view_.get());
+  const auto disabled = data.track() == data.thumb();
+  scroll_bar_->SetBounds(state.scroll_bar_bounds);
+  scroll_bar_->SetData(data);
+  for (const auto& part_state : state.scroll_bar_states) {
+    if (disabled) {
+      scroll_bar_->SetState(part_state.first, ScrollBarState::Disabled);
+      continue;
+    }
+    scroll_bar_->SetState(part_state.first,
+                          part_state.second == ScrollBarState::Disabled
+                              ? ScrollBarState::Normal
+                              : part_state.second);
+  }
+
+  auto display_item = std::make_unique<domapi::TextAreaDisplayItem>(
+      paint_view, std::move(scroll_bar_->Paint()));
+  view_delegate_->PaintTextArea(window_id_, std::move(display_item));
+  if (text_view_->NeedsPreformat() || text_view_->NeedsUpdateVisualLineIndex())
+    RequestIdleTask();
+}
+
+void TextWindowLayout::RequestFrame(const FrameState& state) {
+  {
+    base::AutoLock lock_scope(pending_lock_);
+    pending_state_ = state;
+  }
+  ScheduleFrame();
+}
+
+void TextWindowLayout::RequestIdleTask() {
+  if (is_idle_task_requested_)
+    return;
+  is_idle_task_requested_ = true;
+  LayoutThread::GetInstance()->PostTask(
+      FROM_HERE,
+      base::Bind(&TextWindowLayout::DidEnterIdle, make_scoped_refptr(this)));
+}
+
+void TextWindowLayout::ResetCaret() {
+  base::AutoLock lock_scope(*LayoutThread::GetInstance()->lock());
+  caret_->Reset();
+}
+
+void TextWindowLayout::ScheduleFrame() {
+  base::AutoLock lock_scope(pending_lock_);
+  if (is_frame_scheduled_)
+    return;
+  is_frame_scheduled_ = true;
+  LayoutThread::GetInstance()->PostTask(
+      FROM_HERE,
+      base::Bind(&TextWindowLayout::DidRequestFrame, make_scoped_refptr(this)));
+}
+
+}  // namespace dom
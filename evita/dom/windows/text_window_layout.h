@@ -0,0 +1,154 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_DOM_WINDOWS_TEXT_WINDOW_LAYOUT_H_
+#define EVITA_DOM_WINDOWS_TEXT_WINDOW_LAYOUT_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "evita/dom/public/scroll_bar_data.h"
+#include "evita/dom/public/window_id.h"
+#include "evita/gfx/rect_f.h"
+#include "evita/text/layout/render_selection.h"
+
+namespace css {
+class StyleSheet;
+}
+
+namespace domapi {
+enum class ScrollBarPart;
+enum class ScrollBarState;
+class ViewDelegate;
+}
+
+namespace layout {
+class BufferReplica;
+class ScrollBar;
+class TextView;
+}
+
+namespace text {
+class Buffer;
+class MarkerSet;
+}
+
+namespace dom {
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextWindowLayout
+//
+// Formats text of |TextWindow| on layout thread. |TextWindow| records
+// mutations of its buffer and markers into |replica()|, and requests a frame
+// with |FrameState|, a snapshot of script thread states at end of animation
+// frame. Layout thread commits |replica()| up to revision of the snapshot,
+// formats text, then sends paint view to |domapi::ViewDelegate|.
+//
+// Script thread accesses |TextView| by |ScopedTextView| for synchronous
+// queries, e.g. computing motion and hit testing.
+//
+class TextWindowLayout final
+    : public base::RefCountedThreadSafe<TextWindowLayout> {
+ public:
+  using ScrollBarData = domapi::ScrollBarData;
+  using ScrollBarPart = domapi::ScrollBarPart;
+  using ScrollBarState = domapi::ScrollBarState;
+
+  struct FrameState {
+    FrameState();
+    FrameState(const FrameState& other);
+    ~FrameState();
+
+    FrameState& operator=(const FrameState& other);
+
+    // Sequence number of frames of |TextWindow| for tracking input latency.
+    int frame_id = 0;
+    // Number of mutations recorded into |replica()| at snapshot.
+    int revision = 0;
+    gfx::RectF scroll_bar_bounds;
+    // Scroll bar part states except for |Disabled|, which is computed from
+    // scroll bar data on layout thread.
+    std::vector<std::pair<ScrollBarPart, ScrollBarState>> scroll_bar_states;
+    layout::TextSelectionModel selection;
+    bool visible = false;
+  };
+
+  // Holds layout lock and commits all recorded mutations for accessing
+  // |TextView| on script thread. Don't nest |ScopedTextView|.
+  class ScopedTextView final {
+   public:
+    explicit ScopedTextView(TextWindowLayout* layout);
+    ~ScopedTextView();
+
+    layout::TextView* operator->() const { return text_view_; }
+    layout::TextView* get() const { return text_view_; }
+
+   private:
+    base::AutoLock lock_scope_;
+    layout::TextView* const text_view_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedTextView);
+  };
+
+  TextWindowLayout(domapi::WindowId window_id,
+                   const text::Buffer& buffer,
+                   const text::MarkerSet& markers,
+                   css::StyleSheet* style_sheet,
+                   domapi::ViewDelegate* view_delegate);
+
+  layout::BufferReplica* replica() const { return replica_.get(); }
+
+  // Returns scroll bar data in visual lines of |text_view|.
+  static ScrollBarData ComputeScrollBarData(layout::TextView* text_view);
+  // Releases |TextView| on script thread, since |TextView| observes style
+  // sheet owned by script thread. Layout thread does nothing after detached.
+  void Detach();
+  void RequestFrame(const FrameState& state);
+  // Stops blinking caret, e.g. window bounds are changed or window loses
+  // focus. Called on script thread.
+  void ResetCaret();
+
+ private:
+  friend class base::RefCountedThreadSafe<TextWindowLayout>;
+
+  class Caret;
+
+  ~TextWindowLayout();
+
+  // Following functions are called on layout thread.
+  void DidEnterIdle();
+  void DidFireCaretTimer(int timer_id);
+  void DidRequestFrame();
+  void RequestIdleTask();
+  void ScheduleFrame();
+
+  // Guarded by layout lock.
+  const std::unique_ptr<Caret> caret_;
+  // Guarded by |pending_lock_|.
+  bool is_frame_scheduled_ = false;
+  // Guarded by layout lock.
+  bool is_idle_task_requested_ = false;
+  // Guards |is_frame_scheduled_| and |pending_state_|.
+  base::Lock pending_lock_;
+  FrameState pending_state_;
+  const std::unique_ptr<layout::BufferReplica> replica_;
+  // Paints scroll bar of |TextWindow| from |FrameState|. Guarded by layout
+  // lock.
+  const std::unique_ptr<layout::ScrollBar> scroll_bar_;
+  // |text_view_| depends on |replica_|. Guarded by layout lock.
+  std::unique_ptr<layout::TextView> text_view_;
+  domapi::ViewDelegate* const view_delegate_;
+  const domapi::WindowId window_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextWindowLayout);
+};
+
+}  // namespace dom
+
+#endif  // EVITA_DOM_WINDOWS_TEXT_WINDOW_LAYOUT_H_
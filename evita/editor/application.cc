@@ -12,6 +12,7 @@
 #include "base/strings/string16.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "evita/base/switches.h"
 #include "evita/dom/script_thread.h"
 #include "evita/editor/application_proxy.h"
 #include "evita/editor/dom_lock.h"
@@ -120,6 +121,8 @@ void Application::Run() {
 
   auto const switch_set = editor::SwitchSet::instance();
 
+  switch_set->Register(evita::switches::kZoneRegistry,
+                       &evita::switches::zone_registry);
   switch_set->Register(views::switches::kEditorWindowDisplayPaint,
                        &views::switches::editor_window_display_paint);
   switch_set->Register(views::switches::kFormWindowDisplayPaint,
@@ -15,6 +15,7 @@
 #include "base/trace_event/trace_event.h"
 #include "evita/dom/public/view_event_handler.h"
 #include "evita/editor/application.h"
+#include "evita/metrics/latency_tracker.h"
 #include "evita/ui/animation/animation_frame_handler.h"
 #include "evita/ui/compositor/compositor.h"
 #include "evita/ui/focus_controller.h"
@@ -122,6 +123,7 @@ void Scheduler::CommitFrame() {
   DCHECK_EQ(State::Running, state_);
   TRACE_EVENT0("scheduler", "Scheduler::CommitFrame");
   ui::Compositor::instance()->CommitIfNeeded();
+  metrics::LatencyTracker::instance()->DidCommitFrame();
   last_paint_time_ = base::TimeTicks::Now();
 }
 
@@ -5,6 +5,8 @@
 
 #include "base/logging.h"
 #include "evita/gc/collector.h"
+#include "evita/gc/heap.h"
+#include "evita/gc/member.h"
 #include "evita/gc/visitor.h"
 
 namespace gc {
@@ -18,6 +20,25 @@ AbstractCollectable::~AbstractCollectable() {
   CHECK(is_dead());
 }
 
+void* AbstractCollectable::operator new(size_t size) {
+  return Collector::instance()->Allocate(size);
+}
+
+void AbstractCollectable::operator delete(void* pointer) {
+  Collector::instance()->Free(pointer);
+}
+
+// gc::Visitable
+AbstractCollectable* AbstractCollectable::AsCollectable() {
+  return this;
+}
+
+void WriteBarrier(const void* slot, AbstractCollectable* collectable) {
+  if (!collectable)
+    return;
+  Collector::instance()->WriteBarrier(slot, collectable);
+}
+
 }  // namespace internal
 }  // namespace gc
 
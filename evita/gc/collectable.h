@@ -3,6 +3,8 @@
 #ifndef EVITA_GC_COLLECTABLE_H_
 #define EVITA_GC_COLLECTABLE_H_
 
+#include <stddef.h>
+
 #include <ostream>
 
 #include "evita/gc/visitable.h"
@@ -10,6 +12,7 @@
 namespace gc {
 
 class Collector;
+class Heap;
 class Visitor;
 
 namespace internal {
@@ -22,15 +25,31 @@ class AbstractCollectable : public Visitable {
 
   bool is_dead() const { return state_ == kDead; }
   bool is_alive() const { return state_ == kAlive; }
+  bool is_old() const { return is_old_; }
+
+  // Collectable objects are allocated in |Heap| of |Collector|.
+  static void* operator new(size_t size);
+  static void operator delete(void* pointer);
 
  protected:
   AbstractCollectable();
   virtual ~AbstractCollectable();
 
  private:
-  friend class Collector;
-  friend class Visitor;
-
+  friend class gc::Collector;
+  friend class gc::Heap;
+  friend class gc::Visitor;
+
+  // gc::Visitable
+  AbstractCollectable* AsCollectable() final;
+
+  // True if this object is reachable in current or the last marking.
+  bool is_marked_ = false;
+  // True if this object survived a collection.
+  bool is_old_ = false;
+  // True if this object is in remembered set of |Collector|, e.g. an old
+  // object holding a pointer to a young object.
+  bool is_remembered_ = false;
   State state_;
 
   DISALLOW_COPY_AND_ASSIGN(AbstractCollectable);
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 
@@ -12,6 +13,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
 #include "evita/gc/collectable.h"
+#include "evita/gc/heap.h"
 #include "evita/gc/visitor.h"
 
 namespace gc {
@@ -21,36 +23,14 @@ namespace {
 using CounterMap =
     std::unordered_map<base::StringPiece, int, base::StringPieceHash>;
 
-class CollectorVisitor final : public Visitor {
- public:
-  explicit CollectorVisitor(Collector* collector) : collector_(collector) {}
-  ~CollectorVisitor() override = default;
-
-  const Collector::CollectableSet& live_set() const { return live_set_; }
-
-  void Visit(Collectable* collectable) override {
-    CHECK(!collectable->is_dead());
-    if (visited_set_.find(collectable) == visited_set_.end())
-      return;
-    visited_set_.insert(collectable);
-    collectable->Accept(this);
-    live_set_.insert(collectable);
-  }
+// Number of objects to mark between checking deadline.
+const int kMarkStepCheckInterval = 64;
 
-  void Visit(Visitable* visitable) override {
-    if (visited_set_.find(visitable) == visited_set_.end())
-      return;
-    visited_set_.insert(visitable);
-    visitable->Accept(this);
-  }
+// Minimum number of old objects to start full collection.
+const size_t kMinFullCollectionSize = 10000;
 
- private:
-  Collector* collector_;
-  Collector::CollectableSet live_set_;
-  Collector::VisitableSet visited_set_;
-
-  DISALLOW_COPY_AND_ASSIGN(CollectorVisitor);
-};
+// Number of young objects to start minor collection.
+const size_t kYoungGenerationSize = 1000;
 
 void MapToJson(std::basic_ostringstream<base::char16>& ostream,  // NOLINT
                const base::StringPiece& map_name,
@@ -68,60 +48,216 @@ void MapToJson(std::basic_ostringstream<base::char16>& ostream,  // NOLINT
   ostream << ']';
 }
 
+void PausesToJson(std::basic_ostringstream<base::char16>& ostream,  // NOLINT
+                  const base::StringPiece& map_name,
+                  const std::map<int, int>& map) {
+  const base::string16 comma = L",\n";
+  base::string16 delimiter = L"";
+
+  ostream << '"' << base::ASCIIToUTF16(map_name) << L"\": [";
+  for (auto key_value : map) {
+    ostream << delimiter;
+    ostream << L"{\"key\": " << key_value.first
+            << L", \"value\": " << key_value.second << '}';
+    delimiter = comma;
+  }
+  ostream << ']';
+}
+
 }  // namespace
 
+//////////////////////////////////////////////////////////////////////
+//
+// Collector::Marker
+//
+// |Marker| marks objects reachable from objects passed to |Visit()| using
+// worklist of marked but not yet scanned objects, a.k.a. gray objects. In
+// minor collection, |Marker| doesn't enter old objects, since they survive
+// and young objects referenced from them are in remembered set.
+//
+class Collector::Marker final : public Visitor {
+ public:
+  enum class Mode {
+    Full,
+    Minor,
+  };
+
+  explicit Marker(Mode mode) : mode_(mode) {}
+  ~Marker() final = default;
+
+  // Scans marked objects until |deadline|. Returns true if all reachable
+  // objects are marked.
+  bool ProcessWorklist(const base::TimeTicks& deadline);
+
+  // Visitor
+  void Visit(Collectable* collectable) final;
+  void Visit(Visitable* visitable) final;
+
+ private:
+  const Mode mode_;
+  // Non-collectable visitables visited, since they don't have mark bit.
+  VisitableSet visited_set_;
+  std::vector<Collectable*> worklist_;
+
+  DISALLOW_COPY_AND_ASSIGN(Marker);
+};
+
+bool Collector::Marker::ProcessWorklist(const base::TimeTicks& deadline) {
+  auto count = 0;
+  while (!worklist_.empty()) {
+    auto* const collectable = worklist_.back();
+    worklist_.pop_back();
+    collectable->Accept(this);
+    ++count;
+    if (count % kMarkStepCheckInterval == 0 &&
+        base::TimeTicks::Now() >= deadline) {
+      break;
+    }
+  }
+  return worklist_.empty();
+}
+
+// Visitor
+void Collector::Marker::Visit(Collectable* collectable) {
+  if (!collectable || collectable->is_marked_)
+    return;
+  CHECK(!collectable->is_dead());
+  if (mode_ == Mode::Minor && collectable->is_old_)
+    return;
+  collectable->is_marked_ = true;
+  worklist_.push_back(collectable);
+}
+
+void Collector::Marker::Visit(Visitable* visitable) {
+  if (!visitable)
+    return;
+  if (auto* const collectable = visitable->AsCollectable())
+    return Visit(collectable);
+  if (!visited_set_.insert(visitable).second)
+    return;
+  visitable->Accept(this);
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // Collector
 //
-Collector::Collector() : lock_(new base::Lock()) {}
+Collector::Collector()
+    : heap_(new Heap()),
+      lock_(nullptr),
+      next_full_collection_size_(kMinFullCollectionSize),
+      state_(State::Idle) {}
 
 Collector::~Collector() {}
 
 void Collector::AddToLiveSet(Collectable* collectable) {
-  base::AutoLock lock_scope(*lock_);
-  live_set_.insert(collectable);
+  AssertLocked();
+  heap_->DidConstruct(collectable);
+  // Objects allocated during incremental marking are alive at end of marking.
+  collectable->is_marked_ = is_marking();
+  young_objects_.push_back(collectable);
 }
 
 void Collector::AddToRootSet(Visitable* visitable) {
-  base::AutoLock lock_scope(*lock_);
+  AssertLocked();
   root_set_.insert(visitable);
+  if (is_marking())
+    marker_->Visit(visitable);
+}
+
+void* Collector::Allocate(size_t size) {
+  AssertLocked();
+  return heap_->Allocate(size);
+}
+
+void Collector::AssertLocked() const {
+  if (lock_)
+    lock_->AssertAcquired();
+}
+
+void Collector::ClearRememberedSet() {
+  for (auto* const collectable : remembered_set_)
+    collectable->is_remembered_ = false;
+  remembered_set_.clear();
 }
 
 void Collector::CollectGarbage() {
-  CollectorVisitor visitor(this);
-  for (auto const visitable : root_set_) {
-    visitable->Accept(&visitor);
-  }
+  AssertLocked();
+  const auto start = base::TimeTicks::Now();
+  StartIncrementalMarking();
+  FinishMarking();
+  RecordPause(&full_pauses_, start);
+}
 
-  CollectableSet live_set;
-  for (auto const collectable : visitor.live_set()) {
-    live_set_.erase(collectable);
-    live_set.insert(collectable);
+void Collector::CollectYoungGarbage() {
+  AssertLocked();
+  // Incremental marking will collect young objects too.
+  if (is_marking())
+    return;
+  const auto start = base::TimeTicks::Now();
+  Marker marker(Marker::Mode::Minor);
+  for (auto* const visitable : root_set_)
+    marker.Visit(visitable);
+  for (auto* const collectable : remembered_set_) {
+    if (collectable->is_old_)
+      collectable->Accept(&marker);
+    else
+      marker.Visit(collectable);
   }
+  marker.ProcessWorklist(base::TimeTicks::Max());
+  ClearRememberedSet();
+  std::vector<Collectable*> dead_objects;
+  SweepObjects(&young_objects_, &dead_objects);
+  PromoteYoungObjects();
+  DestroyObjects(dead_objects);
+  RecordPause(&minor_pauses_, start);
+}
 
-  for (auto const collectable : live_set_) {
+void Collector::DestroyObjects(const std::vector<Collectable*>& objects) {
+  // Mark all objects dead before destroying them, since destructor of an
+  // object may refer another dead object.
+  for (auto* const collectable : objects)
+    collectable->state_ = Collectable::kDead;
+  for (auto* const collectable : objects)
     delete collectable;
-  }
+  heap_->ReleaseEmptyPages();
+}
 
-  live_set_ = live_set;
+void Collector::FinishMarking() {
+  DCHECK(is_marking());
+  marker_->ProcessWorklist(base::TimeTicks::Max());
+  marker_.reset();
+  state_ = State::Idle;
+  ClearRememberedSet();
+  // Unmarked young objects are promoted here but they are destroyed by
+  // sweeping pages.
+  PromoteYoungObjects();
+  std::vector<Collectable*> dead_objects;
+  heap_->Sweep(&dead_objects);
+  DestroyObjects(dead_objects);
+  next_full_collection_size_ =
+      std::max(kMinFullCollectionSize, num_old_objects() * 2);
+}
+
+void Collector::Free(void* pointer) {
+  AssertLocked();
+  heap_->Free(pointer);
 }
 
 base::string16 Collector::GetJson(const base::string16& name) const {
-  // TODO(eval1749): Do we really need to have DOM lock here?
-  // UI_ASSERT_DOM_LOCKED();
+  AssertLocked();
   if (name != L"all")
     return base::string16();
 
   CounterMap live_map;
-  for (auto const collectable : live_set_) {
+  heap_->ForEachObject([&live_map](Collectable* collectable) {
     base::StringPiece key(collectable->visitable_class_name());
     auto it = live_map.find(key);
     if (it == live_map.end())
       live_map[key] = 1;
     else
       ++it->second;
-  }
+  });
 
   CounterMap root_map;
   for (auto const visitable : root_set_) {
@@ -138,14 +274,112 @@ base::string16 Collector::GetJson(const base::string16& name) const {
   MapToJson(ostream, "live", live_map);
   ostream << L",\n";
   MapToJson(ostream, "root", root_map);
+  ostream << L",\n";
+  ostream << L"\"old\": " << num_old_objects() << L",\n";
+  ostream << L"\"young\": " << young_objects_.size() << L",\n";
+  ostream << L"\"pages\": " << heap_->num_pages() << L",\n";
+  ostream << L"\"reserved_bytes\": " << heap_->num_reserved_bytes() << L",\n";
+  PausesToJson(ostream, "full_pauses", full_pauses_);
+  ostream << L",\n";
+  PausesToJson(ostream, "minor_pauses", minor_pauses_);
+  ostream << L",\n";
+  PausesToJson(ostream, "step_pauses", step_pauses_);
   ostream << '}';
   return ostream.str();
 }
 
+bool Collector::NeedsIdleWork() const {
+  return is_marking() || young_objects_.size() >= kYoungGenerationSize ||
+         num_old_objects() >= next_full_collection_size_;
+}
+
+void Collector::PerformIdleWork(const base::TimeTicks& deadline) {
+  AssertLocked();
+  if (is_marking()) {
+    const auto start = base::TimeTicks::Now();
+    if (marker_->ProcessWorklist(deadline))
+      FinishMarking();
+    RecordPause(&step_pauses_, start);
+    return;
+  }
+  if (young_objects_.size() >= kYoungGenerationSize)
+    CollectYoungGarbage();
+  if (num_old_objects() >= next_full_collection_size_)
+    StartIncrementalMarking();
+}
+
+size_t Collector::num_old_objects() const {
+  return heap_->num_objects() - young_objects_.size();
+}
+
+void Collector::PromoteYoungObjects() {
+  for (auto* const collectable : young_objects_)
+    collectable->is_old_ = true;
+  young_objects_.clear();
+}
+
+// static
+void Collector::RecordPause(PauseHistogram* histogram,
+                            const base::TimeTicks& start) {
+  const auto pause = (base::TimeTicks::Now() - start).InMicroseconds();
+  // Pause times are bucketed by power of two microseconds.
+  auto bucket = 1;
+  while (bucket < pause)
+    bucket *= 2;
+  ++(*histogram)[bucket];
+}
+
 void Collector::RemoveFromRootSet(Visitable* visitable) {
-  base::AutoLock lock_scope(*lock_);
+  AssertLocked();
   auto const count = root_set_.erase(visitable);
   CHECK_EQ(1u, count);
 }
 
+void Collector::StartIncrementalMarking() {
+  AssertLocked();
+  if (is_marking())
+    return;
+  marker_.reset(new Marker(Marker::Mode::Full));
+  state_ = State::Marking;
+  for (auto* const visitable : root_set_)
+    marker_->Visit(visitable);
+}
+
+// static
+void Collector::SweepObjects(std::vector<Collectable*>* objects,
+                             std::vector<Collectable*>* dead_objects) {
+  auto survivor = objects->begin();
+  for (auto* const collectable : *objects) {
+    if (!collectable->is_marked_) {
+      dead_objects->push_back(collectable);
+      continue;
+    }
+    collectable->is_marked_ = false;
+    *survivor = collectable;
+    ++survivor;
+  }
+  objects->erase(survivor, objects->end());
+}
+
+void Collector::WriteBarrier(const void* slot, Collectable* collectable) {
+  AssertLocked();
+  // Dijkstra insertion barrier: An object stored during incremental marking
+  // must be marked, since its holder may be scanned already.
+  if (is_marking())
+    marker_->Visit(collectable);
+  if (collectable->is_old_)
+    return;
+  // Remember old holder of |slot| for tracing it in minor collection. Young
+  // holder is traced if it is reachable. If |slot| isn't in |Heap|, e.g. a
+  // member of non-collectable object, we remember |collectable| itself.
+  auto* const holder = heap_->ObjectOf(slot);
+  if (holder && !holder->is_old_)
+    return;
+  auto* const remembered = holder ? holder : collectable;
+  if (remembered->is_remembered_)
+    return;
+  remembered->is_remembered_ = true;
+  remembered_set_.push_back(remembered);
+}
+
 }  // namespace gc
@@ -5,11 +5,14 @@
 #ifndef EVITA_GC_COLLECTOR_H_
 #define EVITA_GC_COLLECTOR_H_
 
+#include <map>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
 #include "common/memory/singleton.h"
 
 namespace base {
@@ -18,12 +21,34 @@ class Lock;
 
 namespace gc {
 
+class Heap;
 class Visitable;
 
 namespace internal {
 class AbstractCollectable;
 }  // namespace internal
 
+//////////////////////////////////////////////////////////////////////
+//
+// Collector
+//
+// |Collector| is a generational mark-and-sweep collector. Objects allocated
+// since the last collection are young. A minor collection, see
+// |CollectYoungGarbage()|, reclaims unreachable young objects, e.g. temporary
+// objects created by script, without scanning nor sweeping old objects. The
+// write barrier in |Member<T>| remembers old objects holding young objects,
+// found by address of |Member<T>| in |Heap|, and a minor collection marks
+// from them and young objects reachable from roots. A full collection marks whole heap incrementally in
+// time-sliced steps, see |PerformIdleWork()|, with Dijkstra write barrier in
+// |Member<T>|, then sweeps unmarked objects by scanning pages of |Heap|.
+//
+// Both of them require that collectable objects hold pointers to other
+// collectable objects in |Member<T>| and report them in |Accept()|.
+//
+// |Collector| isn't thread safe. Allocation, storing into |Member<T>| and
+// collection should be serialized by caller, e.g. by DOM lock. Once the lock
+// is set by |set_lock()|, |Collector| checks that it is held in debug build.
+//
 class Collector final : public common::Singleton<Collector> {
   DECLARE_SINGLETON_CLASS(Collector);
 
@@ -34,18 +59,79 @@ class Collector final : public common::Singleton<Collector> {
 
   ~Collector();
 
+  bool is_marking() const { return state_ == State::Marking; }
+  // Sets |lock| which callers of |Collector| should hold.
+  void set_lock(base::Lock* lock) { lock_ = lock; }
+
   void AddToRootSet(Visitable* visitable);
   void AddToLiveSet(Collectable* collectable);
+  // Allocates memory for a collectable object from |Heap|.
+  void* Allocate(size_t size);
+  // Collects all unreachable objects without interruption. If incremental
+  // marking is in progress, this function finishes it.
   void CollectGarbage();
+  // Collects young objects which are neither reachable from roots nor stored
+  // in |Member<T>|.
+  void CollectYoungGarbage();
+  // Frees memory of a collectable object allocated by |Allocate()|.
+  void Free(void* pointer);
   base::string16 GetJson(const base::string16& name) const;
+  // Returns true if |PerformIdleWork()| has work to do. This function can be
+  // called without lock as a hint.
+  bool NeedsIdleWork() const;
+  // Performs collection work until |deadline|, e.g. a minor collection when
+  // young generation is full, or a step of incremental marking. This function
+  // should be called in idle time of thread which holds the lock.
+  void PerformIdleWork(const base::TimeTicks& deadline);
   void RemoveFromRootSet(Visitable* visitable);
+  void StartIncrementalMarking();
+  // Called by |Member<T>| when a pointer to |collectable| is stored into
+  // |slot|.
+  void WriteBarrier(const void* slot, Collectable* collectable);
 
  private:
+  class Marker;
+
+  // A map from upper bound of pause time in microseconds to number of pauses.
+  using PauseHistogram = std::map<int, int>;
+
+  enum class State {
+    Idle,
+    Marking,
+  };
+
   Collector();
 
-  CollectableSet live_set_;
-  std::unique_ptr<base::Lock> lock_;
+  // Checks that the lock set by |set_lock()| is held in debug build.
+  void AssertLocked() const;
+  // Clears remembered bit of objects in |remembered_set_| and empties it.
+  void ClearRememberedSet();
+  void DestroyObjects(const std::vector<Collectable*>& objects);
+  void FinishMarking();
+  size_t num_old_objects() const;
+  void PromoteYoungObjects();
+  static void RecordPause(PauseHistogram* histogram,
+                          const base::TimeTicks& start);
+  // Moves unmarked objects in |objects| to |dead_objects| and clears mark
+  // bit of survivors.
+  static void SweepObjects(std::vector<Collectable*>* objects,
+                           std::vector<Collectable*>* dead_objects);
+
+  PauseHistogram full_pauses_;
+  std::unique_ptr<Heap> heap_;
+  base::Lock* lock_;
+  std::unique_ptr<Marker> marker_;
+  PauseHistogram minor_pauses_;
+  // Number of old objects to start next full collection.
+  size_t next_full_collection_size_;
+  // Old objects holding young objects and young objects stored in
+  // |Member<T>| outside of |Heap|. These objects are roots of minor
+  // collection.
+  std::vector<Collectable*> remembered_set_;
   VisitableSet root_set_;
+  State state_;
+  PauseHistogram step_pauses_;
+  std::vector<Collectable*> young_objects_;
 
   DISALLOW_COPY_AND_ASSIGN(Collector);
 };
@@ -0,0 +1,186 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <unordered_set>
+
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "evita/base/testing/perf_test_util.h"
+#include "evita/gc/collectable.h"
+#include "evita/gc/collector.h"
+#include "evita/gc/member.h"
+#include "evita/gc/visitable.h"
+#include "evita/gc/visitor.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gc {
+
+namespace {
+
+const int kNumberOfObjects = 10000;
+const int kNumberOfRepeats = 100;
+
+//////////////////////////////////////////////////////////////////////
+//
+// PerfObject
+//
+class PerfObject final : public Collectable<PerfObject> {
+  DECLARE_GC_COLLECTABLE_OBJECT(PerfObject);
+
+ public:
+  PerfObject() = default;
+  ~PerfObject() final = default;
+
+  void set_next(PerfObject* next) { next_ = next; }
+
+ private:
+  // Visitable
+  void Accept(Visitor* visitor) final { visitor->Visit(next_); }
+
+  int data_[4];
+  Member<PerfObject> next_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfObject);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// PerfRoot
+//
+class PerfRoot final : public Visitable {
+ public:
+  explicit PerfRoot(PerfObject* object) : object_(object) {
+    Collector::instance()->AddToRootSet(this);
+  }
+  ~PerfRoot() final { Collector::instance()->RemoveFromRootSet(this); }
+
+ private:
+  // Visitable
+  void Accept(Visitor* visitor) final { visitor->Visit(object_); }
+  const char* visitable_class_name() const final { return "PerfRoot"; }
+
+  PerfObject* const object_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfRoot);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// LiveSet
+//
+// |LiveSet| emulates tracking objects before |Heap|: objects are allocated by
+// global operator new and registered into |std::unordered_set| with lock,
+// then collection rebuilds set of survivors.
+//
+class LiveSet final {
+ public:
+  struct Object {
+    int data_[4];
+    Object* next = nullptr;
+  };
+
+  LiveSet() = default;
+  ~LiveSet() { Collect(nullptr); }
+
+  Object* NewObject() {
+    auto* const object = new Object();
+    base::AutoLock lock_scope(lock_);
+    live_set_.insert(object);
+    return object;
+  }
+
+  void Collect(Object* root) {
+    std::unordered_set<Object*> visited_set;
+    for (auto* runner = root; runner; runner = runner->next)
+      visited_set.insert(runner);
+    std::unordered_set<Object*> live_set;
+    for (auto* const object : visited_set) {
+      live_set_.erase(object);
+      live_set.insert(object);
+    }
+    for (auto* const object : live_set_)
+      delete object;
+    live_set_ = live_set;
+  }
+
+ private:
+  base::Lock lock_;
+  std::unordered_set<Object*> live_set_;
+
+  DISALLOW_COPY_AND_ASSIGN(LiveSet);
+};
+
+}  // namespace
+
+TEST(CollectorPerfTest, Allocate) {
+  LiveSet live_set;
+  auto live_set_elapsed = base::TimeDelta();
+  for (auto count = 0; count < kNumberOfRepeats; ++count) {
+    live_set_elapsed += base::MeasureTime([&]() {
+      for (auto index = 0; index < kNumberOfObjects; ++index)
+        live_set.NewObject();
+    });
+    live_set.Collect(nullptr);
+  }
+  base::PrintPerfResult(
+      "allocate", "live_set",
+      kNumberOfObjects * kNumberOfRepeats / live_set_elapsed.InSecondsF(),
+      "ops/s");
+
+  auto heap_elapsed = base::TimeDelta();
+  for (auto count = 0; count < kNumberOfRepeats; ++count) {
+    heap_elapsed += base::MeasureTime([]() {
+      for (auto index = 0; index < kNumberOfObjects; ++index)
+        new PerfObject();
+    });
+    Collector::instance()->CollectGarbage();
+  }
+  base::PrintPerfResult(
+      "allocate", "heap",
+      kNumberOfObjects * kNumberOfRepeats / heap_elapsed.InSecondsF(),
+      "ops/s");
+}
+
+// Measures pause time of full collection of heap where half of objects are
+// alive.
+TEST(CollectorPerfTest, FullCollection) {
+  LiveSet live_set;
+  auto live_set_elapsed = base::TimeDelta();
+  LiveSet::Object* live_set_root = nullptr;
+  for (auto count = 0; count < kNumberOfRepeats; ++count) {
+    live_set_root = nullptr;
+    for (auto index = 0; index < kNumberOfObjects / 2; ++index) {
+      auto* const object = live_set.NewObject();
+      object->next = live_set_root;
+      live_set_root = object;
+      live_set.NewObject();
+    }
+    live_set_elapsed +=
+        base::MeasureTime([&]() { live_set.Collect(live_set_root); });
+  }
+  base::PrintPerfResult("full_collection", "live_set",
+                        live_set_elapsed.InMillisecondsF() / kNumberOfRepeats,
+                        "ms");
+
+  auto* const head = new PerfObject();
+  PerfRoot root(head);
+  auto heap_elapsed = base::TimeDelta();
+  for (auto count = 0; count < kNumberOfRepeats; ++count) {
+    auto* last = head;
+    for (auto index = 0; index < kNumberOfObjects / 2; ++index) {
+      auto* const object = new PerfObject();
+      last->set_next(object);
+      last = object;
+      new PerfObject();
+    }
+    heap_elapsed +=
+        base::MeasureTime([]() { Collector::instance()->CollectGarbage(); });
+  }
+  base::PrintPerfResult("full_collection", "heap",
+                        heap_elapsed.InMillisecondsF() / kNumberOfRepeats,
+                        "ms");
+}
+
+}  // namespace gc
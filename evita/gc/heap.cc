@@ -0,0 +1,302 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+
+#include "evita/gc/heap.h"
+
+#include "base/logging.h"
+#include "base/memory/aligned_memory.h"
+#include "evita/gc/collectable.h"
+
+namespace gc {
+
+namespace {
+
+const size_t kAlignment = 16;
+
+const size_t kSizeClasses[] = {16,  32,   48,   64,   96,   128,
+                               192, 256,  384,  512,  768,  1024,
+                               1536, 2048, 3072, 4096, 6144, 8192};
+
+size_t RoundUp(size_t num, size_t unit) {
+  return ((num + unit - 1) / unit) * unit;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// Heap::Page
+//
+// A page starts with |Page| followed by table of objects and slots.
+//
+class Heap::Page final {
+ public:
+  Page(size_t size_class, size_t slot_size, size_t page_size);
+  ~Page() = default;
+
+  bool is_available() const { return is_available_; }
+  void set_is_available(bool value) { is_available_ = value; }
+  bool is_empty() const { return num_allocated_slots_ == 0; }
+  bool is_full() const { return !free_list_ && bump_ == end_; }
+  Page* next_available() const { return next_available_; }
+  void set_next_available(Page* page) { next_available_ = page; }
+  size_t page_size() const { return page_size_; }
+  size_t size_class() const { return size_class_; }
+
+  void* Allocate();
+  void DidConstruct(Collectable* collectable);
+  void ForEachObject(
+      const std::function<void(Collectable*)>& callback) const;
+  void Free(void* pointer);
+  Collectable* ObjectOf(const void* pointer) const;
+  void Sweep(std::vector<Collectable*>* dead_objects);
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  size_t IndexOf(const void* pointer) const;
+  size_t num_used_slots() const;
+
+  // Next never used slot.
+  char* bump_;
+  char* end_;
+  FreeSlot* free_list_ = nullptr;
+  bool is_available_ = false;
+  Page* next_available_ = nullptr;
+  size_t num_allocated_slots_ = 0;
+  // Objects constructed in slots.
+  Collectable** objects_;
+  const size_t page_size_;
+  const size_t size_class_;
+  const size_t slot_size_;
+  char* slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(Page);
+};
+
+Heap::Page::Page(size_t size_class, size_t slot_size, size_t page_size)
+    : page_size_(page_size), size_class_(size_class), slot_size_(slot_size) {
+  const auto start = reinterpret_cast<char*>(this);
+  const auto header_size = RoundUp(sizeof(*this), kAlignment);
+  auto num_slots = (page_size - header_size) / (slot_size + sizeof(*objects_));
+  for (;;) {
+    const auto slots_offset =
+        RoundUp(header_size + num_slots * sizeof(*objects_), kAlignment);
+    if (slots_offset + num_slots * slot_size <= page_size) {
+      slots_ = start + slots_offset;
+      break;
+    }
+    --num_slots;
+  }
+  DCHECK_GE(num_slots, 1u);
+  objects_ = reinterpret_cast<Collectable**>(start + header_size);
+  std::fill(objects_, objects_ + num_slots, nullptr);
+  bump_ = slots_;
+  end_ = slots_ + num_slots * slot_size;
+}
+
+void* Heap::Page::Allocate() {
+  if (auto* const slot = free_list_) {
+    free_list_ = slot->next;
+    ++num_allocated_slots_;
+    return slot;
+  }
+  if (bump_ == end_)
+    return nullptr;
+  auto* const slot = bump_;
+  bump_ += slot_size_;
+  ++num_allocated_slots_;
+  return slot;
+}
+
+void Heap::Page::DidConstruct(Collectable* collectable) {
+  const auto index = IndexOf(collectable);
+  DCHECK(!objects_[index]);
+  objects_[index] = collectable;
+}
+
+void Heap::Page::ForEachObject(
+    const std::function<void(Collectable*)>& callback) const {
+  for (auto index = 0u; index < num_used_slots(); ++index) {
+    if (auto* const collectable = objects_[index])
+      callback(collectable);
+  }
+}
+
+void Heap::Page::Free(void* pointer) {
+  DCHECK_GT(num_allocated_slots_, 0u);
+  objects_[IndexOf(pointer)] = nullptr;
+  auto* const slot = static_cast<FreeSlot*>(pointer);
+  slot->next = free_list_;
+  free_list_ = slot;
+  --num_allocated_slots_;
+}
+
+Heap::Collectable* Heap::Page::ObjectOf(const void* pointer) const {
+  const auto address = static_cast<const char*>(pointer);
+  if (address < slots_ || address >= bump_)
+    return nullptr;
+  return objects_[IndexOf(pointer)];
+}
+
+size_t Heap::Page::IndexOf(const void* pointer) const {
+  const auto offset = static_cast<const char*>(pointer) - slots_;
+  DCHECK_GE(offset, 0);
+  DCHECK_LT(static_cast<const char*>(pointer), bump_);
+  return static_cast<size_t>(offset) / slot_size_;
+}
+
+size_t Heap::Page::num_used_slots() const {
+  return static_cast<size_t>(bump_ - slots_) / slot_size_;
+}
+
+void Heap::Page::Sweep(std::vector<Collectable*>* dead_objects) {
+  for (auto index = 0u; index < num_used_slots(); ++index) {
+    auto* const collectable = objects_[index];
+    if (!collectable)
+      continue;
+    if (!collectable->is_marked_) {
+      dead_objects->push_back(collectable);
+      continue;
+    }
+    collectable->is_marked_ = false;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// Heap
+//
+Heap::Heap() : num_objects_(0), num_reserved_bytes_(0) {
+  available_pages_.fill(nullptr);
+}
+
+Heap::~Heap() {
+  for (auto* const page : pages_) {
+    page->~Page();
+    base::AlignedFree(page);
+  }
+}
+
+void* Heap::Allocate(size_t size) {
+  ++num_objects_;
+  auto size_class = 0u;
+  while (size_class < kNumberOfSizeClasses && kSizeClasses[size_class] < size)
+    ++size_class;
+  if (size_class == kNumberOfSizeClasses) {
+    // A large object has its own page.
+    const auto page_size = RoundUp(
+        RoundUp(sizeof(Page), kAlignment) + sizeof(Collectable*) + kAlignment +
+            size,
+        kPageSize);
+    return NewPage(size_class, RoundUp(size, kAlignment), page_size)
+        ->Allocate();
+  }
+  for (;;) {
+    auto* page = available_pages_[size_class];
+    if (!page) {
+      page = NewPage(size_class, kSizeClasses[size_class], kPageSize);
+      PushAvailablePage(page);
+    }
+    if (auto* const pointer = page->Allocate())
+      return pointer;
+    // |page| is full.
+    available_pages_[size_class] = page->next_available();
+    page->set_is_available(false);
+  }
+}
+
+void Heap::DidConstruct(Collectable* collectable) {
+  PageOf(collectable)->DidConstruct(collectable);
+}
+
+void Heap::ForEachObject(
+    const std::function<void(Collectable*)>& callback) const {
+  for (auto* const page : pages_)
+    page->ForEachObject(callback);
+}
+
+void Heap::Free(void* pointer) {
+  DCHECK_GT(num_objects_, 0u);
+  auto* const page = PageOf(pointer);
+  page->Free(pointer);
+  --num_objects_;
+  if (page->size_class() < kNumberOfSizeClasses && !page->is_available())
+    PushAvailablePage(page);
+}
+
+Heap::Page* Heap::NewPage(size_t size_class,
+                          size_t slot_size,
+                          size_t page_size) {
+  auto* const memory = base::AlignedAlloc(page_size, kPageSize);
+  auto* const page = new (memory) Page(size_class, slot_size, page_size);
+  pages_.insert(std::upper_bound(pages_.begin(), pages_.end(), page), page);
+  num_reserved_bytes_ += page_size;
+  return page;
+}
+
+Heap::Collectable* Heap::ObjectOf(const void* pointer) const {
+  // Since a large object page spans multiple |kPageSize|, we can't find page
+  // by masking |pointer| which may not be in |Heap|.
+  const auto it = std::upper_bound(
+      pages_.begin(), pages_.end(), pointer,
+      [](const void* value, const Page* page) { return value < page; });
+  if (it == pages_.begin())
+    return nullptr;
+  auto* const page = *std::prev(it);
+  if (static_cast<const char*>(pointer) >=
+      reinterpret_cast<const char*>(page) + page->page_size()) {
+    return nullptr;
+  }
+  return page->ObjectOf(pointer);
+}
+
+// static
+Heap::Page* Heap::PageOf(const void* pointer) {
+  return reinterpret_cast<Page*>(reinterpret_cast<uintptr_t>(pointer) &
+                                 ~(kPageSize - 1));
+}
+
+void Heap::PushAvailablePage(Page* page) {
+  DCHECK(!page->is_available());
+  page->set_next_available(available_pages_[page->size_class()]);
+  page->set_is_available(true);
+  available_pages_[page->size_class()] = page;
+}
+
+void Heap::ReleaseEmptyPages() {
+  available_pages_.fill(nullptr);
+  auto survivor = pages_.begin();
+  for (auto* const page : pages_) {
+    const auto size_class = page->size_class();
+    const auto is_large = size_class == kNumberOfSizeClasses;
+    if (page->is_empty() && (is_large || available_pages_[size_class])) {
+      num_reserved_bytes_ -= page->page_size();
+      page->~Page();
+      base::AlignedFree(page);
+      continue;
+    }
+    *survivor = page;
+    ++survivor;
+    page->set_is_available(false);
+    if (!is_large && !page->is_full())
+      PushAvailablePage(page);
+  }
+  pages_.erase(survivor, pages_.end());
+}
+
+void Heap::Sweep(std::vector<Collectable*>* dead_objects) {
+  for (auto* const page : pages_)
+    page->Sweep(dead_objects);
+}
+
+}  // namespace gc
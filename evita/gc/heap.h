@@ -0,0 +1,84 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GC_HEAP_H_
+#define EVITA_GC_HEAP_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace gc {
+
+namespace internal {
+class AbstractCollectable;
+}  // namespace internal
+
+//////////////////////////////////////////////////////////////////////
+//
+// Heap
+//
+// |Heap| allocates collectable objects from pages. A page is aligned to
+// |kPageSize| and has slots of one size class with a table of objects
+// constructed in slots. A slot is allocated by popping intrusive free list of
+// the page or bumping pointer to never used slot. Objects larger than the
+// largest size class have their own page.
+//
+// |Heap| isn't thread safe. |Collector| owns |Heap| and checks that callers
+// hold the lock set by |Collector::set_lock()|.
+//
+class Heap final {
+ public:
+  using Collectable = internal::AbstractCollectable;
+
+  static const size_t kPageSize = 64 * 1024;
+
+  Heap();
+  ~Heap();
+
+  size_t num_objects() const { return num_objects_; }
+  size_t num_pages() const { return pages_.size(); }
+  size_t num_reserved_bytes() const { return num_reserved_bytes_; }
+
+  void* Allocate(size_t size);
+  // Records |collectable| is constructed in a slot allocated by |Allocate()|.
+  void DidConstruct(Collectable* collectable);
+  void ForEachObject(const std::function<void(Collectable*)>& callback) const;
+  void Free(void* pointer);
+  // Returns object of which slot contains |pointer|, or null if |pointer| isn't
+  // in slots of |Heap|, e.g. stack or memory allocated by |new|.
+  Collectable* ObjectOf(const void* pointer) const;
+  // Releases pages which don't have objects except for one page of each
+  // size class.
+  void ReleaseEmptyPages();
+  // Scans all pages and moves unmarked objects to |dead_objects| and clears
+  // mark bit of survivors.
+  void Sweep(std::vector<Collectable*>* dead_objects);
+
+ private:
+  class Page;
+
+  static const size_t kNumberOfSizeClasses = 18;
+
+  Page* NewPage(size_t size_class, size_t slot_size, size_t page_size);
+  static Page* PageOf(const void* pointer);
+  void PushAvailablePage(Page* page);
+
+  // Singly linked lists of pages having free slots for each size class.
+  std::array<Page*, kNumberOfSizeClasses> available_pages_;
+  size_t num_objects_;
+  size_t num_reserved_bytes_;
+  // All pages including pages for large objects sorted by address.
+  std::vector<Page*> pages_;
+
+  DISALLOW_COPY_AND_ASSIGN(Heap);
+};
+
+}  // namespace gc
+
+#endif  // EVITA_GC_HEAP_H_
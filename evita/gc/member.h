@@ -10,12 +10,23 @@
 
 namespace gc {
 
-// Note: At time time, December 2013, it is just marker for root set.
+namespace internal {
+class AbstractCollectable;
+// Tells |Collector| that a pointer to |collectable| is stored into |slot|.
+void WriteBarrier(const void* slot, AbstractCollectable* collectable);
+}  // namespace internal
+
+// |Member<T>| holds a pointer to a collectable object from another
+// collectable object. Storing a pointer through |Member<T>| runs the write
+// barrier for incremental marking and young generation collection of
+// |Collector|.
 template <typename T>
 class Member final {
  public:
-  explicit Member(const Member& other) : ptr_(other.ptr_) {}
-  explicit Member(T* ptr) : ptr_(ptr) {}
+  Member(const Member& other) : ptr_(other.ptr_) {
+    internal::WriteBarrier(this, ptr_);
+  }
+  explicit Member(T* ptr) : ptr_(ptr) { internal::WriteBarrier(this, ptr_); }
   Member() : ptr_(nullptr) {}
   ~Member() = default;
 
@@ -27,11 +38,13 @@ class Member final {
 
   Member& operator=(const Member& other) {
     ptr_ = other.ptr_;
+    internal::WriteBarrier(this, ptr_);
     return *this;
   }
 
   Member& operator=(T* ptr) {
     ptr_ = ptr;
+    internal::WriteBarrier(this, ptr_);
     return *this;
   }
 
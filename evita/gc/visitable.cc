@@ -16,4 +16,8 @@ void Visitable::Accept(Visitor* visitor) {
   visitor->Visit(this);
 }
 
+internal::AbstractCollectable* Visitable::AsCollectable() {
+  return nullptr;
+}
+
 }  // namespace gc
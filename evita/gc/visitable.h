@@ -9,6 +9,10 @@ namespace gc {
 
 class Visitor;
 
+namespace internal {
+class AbstractCollectable;
+}
+
 class Visitable {
  public:
   Visitable();
@@ -17,6 +21,8 @@ class Visitable {
   virtual const char* visitable_class_name() const = 0;
 
   virtual void Accept(Visitor* visitor);
+  // Returns this object if it is managed by |Collector|, or null.
+  virtual internal::AbstractCollectable* AsCollectable();
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Visitable);
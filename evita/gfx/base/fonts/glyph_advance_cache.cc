@@ -0,0 +1,90 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/gfx/base/fonts/glyph_advance_cache.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace gfx {
+
+namespace {
+
+bool IsSurrogate(uint32_t code_point) {
+  return code_point >= 0xD800 && code_point <= 0xDFFF;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// GlyphAdvanceCache::Provider
+//
+GlyphAdvanceCache::Provider::Provider() {}
+GlyphAdvanceCache::Provider::~Provider() {}
+
+//////////////////////////////////////////////////////////////////////
+//
+// GlyphAdvanceCache
+//
+GlyphAdvanceCache::GlyphAdvanceCache(const Provider* provider)
+    : provider_(provider) {
+  DCHECK(provider_);
+}
+
+GlyphAdvanceCache::~GlyphAdvanceCache() {}
+
+float GlyphAdvanceCache::GetAdvance(uint32_t code_point, bool* is_hit) {
+  DCHECK(!IsSurrogate(code_point)) << code_point;
+  base::AutoLock lock_scope(lock_);
+  *is_hit = true;
+  if (code_point < 0x10000)
+    return GetOrFillPage(code_point, is_hit)[code_point % kPageSize];
+  const auto& it = non_bmp_advances_.find(code_point);
+  if (it != non_bmp_advances_.end())
+    return it->second;
+  *is_hit = false;
+  auto advance = 0.0f;
+  provider_->GetAdvances(&code_point, 1, &advance);
+  non_bmp_advances_.emplace(code_point, advance);
+  return advance;
+}
+
+const GlyphAdvanceCache::Page& GlyphAdvanceCache::GetOrFillPage(
+    uint32_t code_point,
+    bool* is_hit) {
+  DCHECK_LT(code_point, 0x10000u);
+  auto& page = pages_[code_point / kPageSize];
+  if (page)
+    return *page;
+  *is_hit = false;
+  std::array<uint32_t, kPageSize> code_points;
+  const auto page_start = code_point & ~(kPageSize - 1);
+  for (size_t index = 0; index < kPageSize; ++index)
+    code_points[index] = static_cast<uint32_t>(page_start + index);
+  page.reset(new Page());
+  provider_->GetAdvances(code_points.data(), code_points.size(),
+                         page->data());
+  return *page;
+}
+
+float GlyphAdvanceCache::GetTotalAdvance(const base::char16* chars,
+                                         size_t num_chars,
+                                         bool* is_hit) {
+  DCHECK(!HasSurrogate(chars, num_chars));
+  base::AutoLock lock_scope(lock_);
+  *is_hit = true;
+  auto total = 0.0f;
+  for (auto* runner = chars; runner < chars + num_chars; ++runner)
+    total += GetOrFillPage(*runner, is_hit)[*runner % kPageSize];
+  return total;
+}
+
+bool GlyphAdvanceCache::HasSurrogate(const base::char16* chars,
+                                     size_t num_chars) {
+  return std::any_of(chars, chars + num_chars, IsSurrogate);
+}
+
+}  // namespace gfx
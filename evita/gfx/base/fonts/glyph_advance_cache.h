@@ -0,0 +1,94 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_BASE_FONTS_GLYPH_ADVANCE_CACHE_H_
+#define EVITA_GFX_BASE_FONTS_GLYPH_ADVANCE_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "base/synchronization/lock.h"
+#include "evita/gfx/gfx_export.h"
+
+namespace gfx {
+
+//////////////////////////////////////////////////////////////////////
+//
+// GlyphAdvanceCache
+//
+// Memoizes advance width of glyphs of a font. Advances of BMP code points
+// are stored in dense pages of 256 code points, and each page is filled by
+// one |Provider::GetAdvances()| call on the first miss. Advances of other
+// code points are stored in a hash table. Surrogate code units aren't
+// cached, callers should measure strings containing them without cache.
+//
+// This class is thread safe, since fonts are shared by threads, e.g. paint
+// thread measures text for |DrawRecorder|. |Provider::GetAdvances()| is
+// called with holding lock.
+//
+class GFX_EXPORT GlyphAdvanceCache final {
+ public:
+  //////////////////////////////////////////////////////////////////////
+  //
+  // Provider
+  //
+  // Provides advance width of glyphs, e.g. in design units of a font.
+  //
+  class GFX_EXPORT Provider {
+   public:
+    virtual ~Provider();
+
+    // Stores advance width of |code_points[i]| into |advances[i]|.
+    virtual void GetAdvances(const uint32_t* code_points,
+                             size_t num_code_points,
+                             float* advances) const = 0;
+
+   protected:
+    Provider();
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(Provider);
+  };
+
+  explicit GlyphAdvanceCache(const Provider* provider);
+  ~GlyphAdvanceCache();
+
+  // Returns true if |chars| contains surrogate code unit.
+  static bool HasSurrogate(const base::char16* chars, size_t num_chars);
+
+  // Returns advance width of |code_point|, which should not be a surrogate
+  // code unit. |*is_hit| is set to false if cache calls provider.
+  float GetAdvance(uint32_t code_point, bool* is_hit);
+
+  // Returns sum of advance width of |chars|, which should not contain
+  // surrogate code unit. |*is_hit| is set to false if cache calls provider.
+  float GetTotalAdvance(const base::char16* chars,
+                        size_t num_chars,
+                        bool* is_hit);
+
+ private:
+  static const size_t kPageSize = 256;
+  static const size_t kNumberOfPages = 0x10000 / kPageSize;
+
+  using Page = std::array<float, kPageSize>;
+
+  const Page& GetOrFillPage(uint32_t code_point, bool* is_hit);
+
+  base::Lock lock_;
+  std::unordered_map<uint32_t, float> non_bmp_advances_;
+  std::array<std::unique_ptr<Page>, kNumberOfPages> pages_;
+  const Provider* const provider_;
+
+  DISALLOW_COPY_AND_ASSIGN(GlyphAdvanceCache);
+};
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_BASE_FONTS_GLYPH_ADVANCE_CACHE_H_
@@ -0,0 +1,154 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/gfx/base/fonts/glyph_advance_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gfx {
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// FakeProvider
+//
+// Advance of code point is 1 for ASCII and 2 for others.
+//
+class FakeProvider final : public GlyphAdvanceCache::Provider {
+ public:
+  FakeProvider() = default;
+  ~FakeProvider() final = default;
+
+  int num_calls() const { return num_calls_; }
+  size_t num_code_points() const { return num_code_points_; }
+
+ private:
+  // GlyphAdvanceCache::Provider
+  void GetAdvances(const uint32_t* code_points,
+                   size_t num_code_points,
+                   float* advances) const final {
+    ++num_calls_;
+    num_code_points_ += num_code_points;
+    for (size_t index = 0; index < num_code_points; ++index)
+      advances[index] = code_points[index] < 0x80 ? 1.0f : 2.0f;
+  }
+
+  mutable int num_calls_ = 0;
+  mutable size_t num_code_points_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeProvider);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// TotalAdvanceDelegate
+//
+class TotalAdvanceDelegate final : public base::DelegateSimpleThread::Delegate {
+ public:
+  TotalAdvanceDelegate(GlyphAdvanceCache* cache, const base::string16* text)
+      : cache_(cache), text_(text) {}
+  ~TotalAdvanceDelegate() final = default;
+
+  float total() const { return total_; }
+
+ private:
+  // base::DelegateSimpleThread::Delegate
+  void Run() final {
+    auto is_hit = false;
+    total_ = cache_->GetTotalAdvance(text_->data(), text_->size(), &is_hit);
+  }
+
+  GlyphAdvanceCache* const cache_;
+  const base::string16* const text_;
+  float total_ = 0.0f;
+
+  DISALLOW_COPY_AND_ASSIGN(TotalAdvanceDelegate);
+};
+
+}  // namespace
+
+TEST(GlyphAdvanceCacheTest, GetAdvance) {
+  FakeProvider provider;
+  GlyphAdvanceCache cache(&provider);
+  auto is_hit = true;
+
+  EXPECT_EQ(1.0f, cache.GetAdvance('a', &is_hit));
+  EXPECT_FALSE(is_hit);
+  EXPECT_EQ(1, provider.num_calls());
+  EXPECT_EQ(256u, provider.num_code_points()) << "Fill whole page at once.";
+  EXPECT_EQ(1.0f, cache.GetAdvance('b', &is_hit));
+  EXPECT_TRUE(is_hit);
+  EXPECT_EQ(2.0f, cache.GetAdvance(0xE9, &is_hit));
+  EXPECT_TRUE(is_hit);
+  EXPECT_EQ(1, provider.num_calls()) << "Same page";
+
+  EXPECT_EQ(2.0f, cache.GetAdvance(0x3042, &is_hit));
+  EXPECT_FALSE(is_hit);
+  EXPECT_EQ(2.0f, cache.GetAdvance(0x3044, &is_hit));
+  EXPECT_TRUE(is_hit);
+  EXPECT_EQ(2, provider.num_calls());
+
+  EXPECT_EQ(2.0f, cache.GetAdvance(0x1F600, &is_hit));
+  EXPECT_FALSE(is_hit);
+  EXPECT_EQ(2.0f, cache.GetAdvance(0x1F600, &is_hit));
+  EXPECT_TRUE(is_hit);
+  EXPECT_EQ(3, provider.num_calls());
+}
+
+TEST(GlyphAdvanceCacheTest, GetTotalAdvance) {
+  FakeProvider provider;
+  GlyphAdvanceCache cache(&provider);
+  const base::string16 text = L"ab\x3042\x3044";
+  auto is_hit = true;
+
+  EXPECT_EQ(6.0f, cache.GetTotalAdvance(text.data(), text.size(), &is_hit));
+  EXPECT_FALSE(is_hit);
+  EXPECT_EQ(2, provider.num_calls());
+  EXPECT_EQ(6.0f, cache.GetTotalAdvance(text.data(), text.size(), &is_hit));
+  EXPECT_TRUE(is_hit);
+  EXPECT_EQ(2, provider.num_calls());
+  EXPECT_EQ(0.0f, cache.GetTotalAdvance(text.data(), 0, &is_hit));
+}
+
+TEST(GlyphAdvanceCacheTest, GetTotalAdvanceOnThreads) {
+  FakeProvider provider;
+  GlyphAdvanceCache cache(&provider);
+  base::string16 text;
+  for (auto code_point = 0x3000; code_point < 0x4000; code_point += 0x80)
+    text.push_back(static_cast<base::char16>(code_point));
+  const auto kNumberOfThreads = 4;
+  std::vector<std::unique_ptr<TotalAdvanceDelegate>> delegates;
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (auto index = 0; index < kNumberOfThreads; ++index) {
+    delegates.emplace_back(new TotalAdvanceDelegate(&cache, &text));
+    threads.emplace_back(new base::DelegateSimpleThread(
+        delegates.back().get(), base::StringPrintf("advance%d", index)));
+  }
+  for (const auto& thread : threads)
+    thread->Start();
+  for (const auto& thread : threads)
+    thread->Join();
+
+  for (const auto& delegate : delegates)
+    EXPECT_EQ(text.size() * 2.0f, delegate->total());
+  EXPECT_EQ(16, provider.num_calls()) << "Each page is filled once.";
+}
+
+TEST(GlyphAdvanceCacheTest, HasSurrogate) {
+  const base::char16 text[] = {'a', 0xD83D, 0xDE00, 'b'};
+
+  EXPECT_FALSE(GlyphAdvanceCache::HasSurrogate(text, 1));
+  EXPECT_TRUE(GlyphAdvanceCache::HasSurrogate(text, 2));
+  EXPECT_TRUE(GlyphAdvanceCache::HasSurrogate(text + 2, 1));
+  EXPECT_FALSE(GlyphAdvanceCache::HasSurrogate(text + 3, 1));
+}
+
+}  // namespace gfx
@@ -92,6 +92,18 @@ bool FloatRect::Intersects(const FloatRect& other) const {
            other.bottom() <= y());
 }
 
+FloatRect FloatRect::Union(const FloatRect& other) const {
+  if (other.IsEmpty())
+    return *this;
+  if (IsEmpty())
+    return other;
+  const auto rx = std::min(x(), other.x());
+  const auto ry = std::min(y(), other.y());
+  const auto rr = std::max(right(), other.right());
+  const auto rb = std::max(bottom(), other.bottom());
+  return FloatRect(FloatPoint(rx, ry), FloatSize(rr - rx, rb - ry));
+}
+
 std::ostream& operator<<(std::ostream& ostream, const FloatRect& rect) {
   return ostream << rect.origin() << '+' << rect.size();
 }
@@ -75,6 +75,10 @@ class GFX_EXPORT FloatRect final {
   // Returns true if the area of the rectangle is zero.
   bool IsEmpty() const { return size_.IsEmpty(); }
 
+  // Computes the smallest rectangle containing this rectangle and the given
+  // rectangle. An empty rectangle is ignored.
+  FloatRect Union(const FloatRect& other) const;
+
  private:
   FloatPoint origin_;
   FloatSize size_;
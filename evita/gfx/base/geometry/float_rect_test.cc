@@ -51,4 +51,16 @@ TEST(FloatFloatRectTest, Intersects) {
                    .Intersects(FloatRect(FloatSize(1, 1))));
 }
 
+TEST(FloatFloatRectTest, Union) {
+  EXPECT_EQ(FloatRect(FloatPoint(10, 20), FloatSize(90, 80)),
+            FloatRect(FloatPoint(10, 20), FloatSize(30, 40))
+                .Union(FloatRect(FloatPoint(50, 60), FloatSize(50, 40))));
+  EXPECT_EQ(FloatRect(FloatPoint(10, 20), FloatSize(30, 40)),
+            FloatRect(FloatPoint(10, 20), FloatSize(30, 40))
+                .Union(FloatRect()));
+  EXPECT_EQ(
+      FloatRect(FloatPoint(10, 20), FloatSize(30, 40)),
+      FloatRect().Union(FloatRect(FloatPoint(10, 20), FloatSize(30, 40))));
+}
+
 }  // namespace gfx
@@ -0,0 +1,96 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+#include "evita/gfx/base/paint/draw_recorder.h"
+
+#include "base/logging.h"
+#include "evita/gfx/base/geometry/int_size.h"
+
+namespace gfx {
+
+namespace {
+
+int Clamp(float value, int max_value) {
+  return std::min(std::max(static_cast<int>(value), 0), max_value);
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// DrawRecorder::Coverage
+//
+float DrawRecorder::Coverage::overdraw() const {
+  if (num_painted_pixels == 0)
+    return 0.0f;
+  return static_cast<float>(num_pixel_writes) /
+         static_cast<float>(num_painted_pixels);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// DrawRecorder
+//
+DrawRecorder::DrawRecorder() {}
+DrawRecorder::~DrawRecorder() {}
+
+DrawRecorder::Coverage DrawRecorder::ComputeCoverage(
+    const IntSize& size) const {
+  const auto width = size.width();
+  const auto height = size.height();
+  Coverage coverage;
+  if (width <= 0 || height <= 0)
+    return coverage;
+  std::vector<uint32_t> bitmap(static_cast<size_t>(width) * height);
+  for (const auto& item : items_) {
+    const auto& bounds = item.bounds;
+    // Pixels touched by |bounds|, e.g. anti-aliased edges are painted.
+    const auto left = Clamp(std::floor(bounds.x()), width);
+    const auto top = Clamp(std::floor(bounds.y()), height);
+    const auto right = Clamp(std::ceil(bounds.right()), width);
+    const auto bottom = Clamp(std::ceil(bounds.bottom()), height);
+    for (auto y = top; y < bottom; ++y) {
+      auto* pixel = &bitmap[static_cast<size_t>(y) * width + left];
+      for (auto x = left; x < right; ++x) {
+        if (*pixel == 0)
+          ++coverage.num_painted_pixels;
+        ++*pixel;
+        ++coverage.num_pixel_writes;
+        ++pixel;
+      }
+    }
+  }
+  return coverage;
+}
+
+size_t DrawRecorder::CountOf(Op op) const {
+  return static_cast<size_t>(
+      std::count_if(items_.begin(), items_.end(),
+                    [op](const Item& item) { return item.op == op; }));
+}
+
+void DrawRecorder::Record(Op op, const FloatRect& bounds) {
+  items_.push_back(Item{op, bounds});
+}
+
+void DrawRecorder::Reset() {
+  items_.clear();
+}
+
+std::ostream& operator<<(std::ostream& ostream, DrawRecorder::Op op) {
+  static const char* const texts[] = {
+      "Bitmap", "Clear", "FillRectangle", "Geometry",
+      "Line",   "Rectangle", "Text",
+  };
+  const auto it = std::begin(texts) + static_cast<size_t>(op);
+  return ostream << (it < std::end(texts) ? *it : "Invalid");
+}
+
+}  // namespace gfx
@@ -0,0 +1,80 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_BASE_PAINT_DRAW_RECORDER_H_
+#define EVITA_GFX_BASE_PAINT_DRAW_RECORDER_H_
+
+#include <stddef.h>
+
+#include <iosfwd>
+#include <vector>
+
+#include "base/macros.h"
+#include "evita/gfx/base/geometry/float_rect.h"
+#include "evita/gfx/gfx_export.h"
+
+namespace gfx {
+
+class IntSize;
+
+//////////////////////////////////////////////////////////////////////
+//
+// DrawRecorder
+//
+// Records draw calls issued to a canvas as list of operation and bounds, so
+// painters can be tested and benchmarked without looking at pixels. Recorded
+// calls can be rasterized as boxes, e.g. text as its bounding box, into a CPU
+// bitmap of paint counts to compute overdraw.
+//
+class GFX_EXPORT DrawRecorder final {
+ public:
+  enum class Op {
+    Bitmap,
+    Clear,
+    FillRectangle,
+    Geometry,
+    Line,
+    Rectangle,
+    Text,
+  };
+
+  struct Item {
+    Op op;
+    FloatRect bounds;
+  };
+
+  // Result of rasterizing recorded items.
+  struct Coverage {
+    size_t num_painted_pixels = 0;
+    size_t num_pixel_writes = 0;
+
+    // Returns average number of writes to painted pixel, 1.0 means no
+    // overdraw.
+    float overdraw() const;
+  };
+
+  DrawRecorder();
+  ~DrawRecorder();
+
+  const std::vector<Item>& items() const { return items_; }
+
+  // Rasterizes bounds of recorded items into bitmap of |size| and returns
+  // coverage. Items outside of bitmap are clipped.
+  Coverage ComputeCoverage(const IntSize& size) const;
+  size_t CountOf(Op op) const;
+  void Record(Op op, const FloatRect& bounds);
+  void Reset();
+
+ private:
+  std::vector<Item> items_;
+
+  DISALLOW_COPY_AND_ASSIGN(DrawRecorder);
+};
+
+GFX_EXPORT std::ostream& operator<<(std::ostream& ostream,
+                                    DrawRecorder::Op op);
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_BASE_PAINT_DRAW_RECORDER_H_
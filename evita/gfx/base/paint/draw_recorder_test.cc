@@ -0,0 +1,50 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/gfx/base/paint/draw_recorder.h"
+
+#include "evita/gfx/base/geometry/int_size.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gfx {
+
+TEST(DrawRecorderTest, ComputeCoverage) {
+  DrawRecorder recorder;
+  recorder.Record(DrawRecorder::Op::Clear, FloatRect(FloatSize(10, 10)));
+  recorder.Record(DrawRecorder::Op::Text,
+                  FloatRect(FloatPoint(2.5f, 1), FloatSize(3, 2)));
+  recorder.Record(DrawRecorder::Op::FillRectangle,
+                  FloatRect(FloatPoint(8, 8), FloatSize(5, 5)));
+
+  const auto& coverage = recorder.ComputeCoverage(IntSize(10, 10));
+  EXPECT_EQ(100u, coverage.num_painted_pixels);
+  EXPECT_EQ(112u, coverage.num_pixel_writes)
+      << "Partially covered pixels are painted and items are clipped.";
+  EXPECT_EQ(1.12f, coverage.overdraw());
+}
+
+TEST(DrawRecorderTest, ComputeCoverageEmpty) {
+  DrawRecorder recorder;
+  const auto& coverage = recorder.ComputeCoverage(IntSize(10, 10));
+  EXPECT_EQ(0u, coverage.num_painted_pixels);
+  EXPECT_EQ(0.0f, coverage.overdraw());
+}
+
+TEST(DrawRecorderTest, Record) {
+  DrawRecorder recorder;
+  recorder.Record(DrawRecorder::Op::Text, FloatRect(FloatSize(1, 2)));
+  recorder.Record(DrawRecorder::Op::Line, FloatRect(FloatSize(3, 4)));
+  recorder.Record(DrawRecorder::Op::Text, FloatRect(FloatSize(5, 6)));
+
+  ASSERT_EQ(3u, recorder.items().size());
+  EXPECT_EQ(DrawRecorder::Op::Line, recorder.items()[1].op);
+  EXPECT_EQ(FloatRect(FloatSize(3, 4)), recorder.items()[1].bounds);
+  EXPECT_EQ(2u, recorder.CountOf(DrawRecorder::Op::Text));
+  EXPECT_EQ(0u, recorder.CountOf(DrawRecorder::Op::Bitmap));
+
+  recorder.Reset();
+  EXPECT_TRUE(recorder.items().empty());
+}
+
+}  // namespace gfx
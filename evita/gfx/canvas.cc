@@ -4,6 +4,7 @@
 
 #include <d2d1_2helper.h>
 
+#include <algorithm>
 #include <cmath>
 #include <utility>
 
@@ -103,6 +104,7 @@ Canvas::ScopedState::~ScopedState() {
 Canvas::Canvas(CanvasOwner* owner)
     : batch_nesting_level_(0),
       bitmap_id_(0),
+      draw_recorder_(nullptr),
       owner_(owner),
       should_clear_(true),
       swap_chain_(owner->CreateSwapChain()) {
@@ -135,6 +137,7 @@ void Canvas::BeginDraw() {
 }
 
 void Canvas::Clear(const ColorF& color) {
+  RecordDraw(DrawRecorder::Op::Clear, GetLocalBounds());
   GetRenderTarget()->Clear(color);
 }
 
@@ -177,6 +180,7 @@ void Canvas::DrawBitmap(const Bitmap& bitmap,
                         const RectF& src_rect,
                         float opacity,
                         D2D1_BITMAP_INTERPOLATION_MODE mode) {
+  RecordDraw(DrawRecorder::Op::Bitmap, dst_rect);
   GetRenderTarget()->DrawBitmap(bitmap, dst_rect, opacity, mode, src_rect);
 }
 
@@ -185,6 +189,11 @@ void Canvas::DrawLine(const Brush& brush,
                       const PointF& point2,
                       float pen_width) {
   DCHECK(drawing()) << "You should call gfx::Canvas::BeginDraw()";
+  RecordDraw(DrawRecorder::Op::Line,
+             RectF(PointF(std::min(point1.x, point2.x) - pen_width / 2,
+                          std::min(point1.y, point2.y) - pen_width / 2),
+                   PointF(std::max(point1.x, point2.x) + pen_width / 2,
+                          std::max(point1.y, point2.y) + pen_width / 2)));
   GetRenderTarget()->DrawLine(point1, point2, brush, pen_width);
 }
 
@@ -193,6 +202,7 @@ void Canvas::DrawRectangle(const Brush& brush,
                            float strokeWidth) {
   DCHECK(drawing()) << "You should call gfx::Canvas::BeginDraw()";
   DCHECK(!rect.empty());
+  RecordDraw(DrawRecorder::Op::Rectangle, rect);
   GetRenderTarget()->DrawRectangle(rect, brush, strokeWidth);
 }
 
@@ -202,6 +212,7 @@ void Canvas::DrawText(const TextFormat& text_format,
                       const base::string16& text) {
   DCHECK(drawing()) << "You should call gfx::Canvas::BeginDraw()";
   DCHECK(!bounds.empty());
+  RecordDraw(DrawRecorder::Op::Text, bounds);
   GetRenderTarget()->DrawText(text.data(), static_cast<uint32_t>(text.length()),
                               text_format, bounds, brush);
 }
@@ -218,6 +229,7 @@ void Canvas::EndDraw() {
 void Canvas::FillRectangle(const Brush& brush, const RectF& rect) {
   DCHECK(drawing()) << "You should call gfx::Canvas::BeginDraw()";
   DCHECK(rect);
+  RecordDraw(DrawRecorder::Op::FillRectangle, rect);
   GetRenderTarget()->FillRectangle(rect, brush);
 }
 
@@ -251,6 +263,15 @@ ID2D1RenderTarget* Canvas::GetRenderTarget() const {
   return swap_chain_->d2d_device_context();
 }
 
+void Canvas::RecordDraw(DrawRecorder::Op op, const RectF& bounds) {
+  if (!draw_recorder_)
+    return;
+  auto const origin = bounds.origin() + offset_;
+  draw_recorder_->Record(
+      op, FloatRect(FloatPoint(origin.x, origin.y),
+                    FloatSize(bounds.width(), bounds.height())));
+}
+
 void Canvas::RemoveObserver(CanvasObserver* observer) {
   observers_.RemoveObserver(observer);
 }
@@ -298,6 +319,10 @@ void Canvas::SetBounds(const RectF& new_bounds) {
   swap_chain_->DidChangeBounds(new_bounds);
 }
 
+void Canvas::SetDrawRecorder(DrawRecorder* recorder) {
+  draw_recorder_ = recorder;
+}
+
 void Canvas::SetOffsetBounds(const gfx::RectF& bounds) {
   offset_ += bounds.origin();
   bounds_ = bounds_.Intersect(gfx::RectF(offset_, bounds.size()));
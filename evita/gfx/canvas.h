@@ -11,6 +11,7 @@
 #include "base/observer_list.h"
 #include "base/strings/string16.h"
 #include "common/win/scoped_comptr.h"
+#include "evita/gfx/base/paint/draw_recorder.h"
 #include "evita/gfx/dpi_handler.h"
 #include "evita/gfx/rect_f.h"
 
@@ -77,6 +78,7 @@ class Canvas final : public DpiHandler {
   int bitmap_id() const { return bitmap_id_; }
   // |drawing()| is for debugging.
   bool drawing() const { return batch_nesting_level_ != 0; }
+  DrawRecorder* draw_recorder() const { return draw_recorder_; }
   float height() const { return bounds_.height(); }
   Bitmap* screen_bitmap() const { return screen_bitmap_.get(); }
   bool should_clear() const { return should_clear_; }
@@ -110,7 +112,13 @@ class Canvas final : public DpiHandler {
   ID2D1RenderTarget* GetRenderTarget() const;
   void RemoveObserver(CanvasObserver* observer);
   void RestoreScreenImage(const RectF& bounds);
+  // Records draw call |op| at |bounds| in local coordinate into
+  // |draw_recorder()|, if any. Painters which draw via |ID2D1RenderTarget|
+  // directly should call this.
+  void RecordDraw(DrawRecorder::Op op, const RectF& bounds);
   bool Canvas::SaveScreenImage(const RectF& bounds);
+  // Draw calls are recorded into |recorder| until |SetDrawRecorder(nullptr)|.
+  void SetDrawRecorder(DrawRecorder* recorder);
   void SetBounds(const RectF& bounds);
   void SetOffsetBounds(const gfx::RectF& bounds);
   bool UpdateReadyState() const;
@@ -130,6 +138,7 @@ class Canvas final : public DpiHandler {
   int batch_nesting_level_;
   int bitmap_id_;
   gfx::RectF bounds_;
+  DrawRecorder* draw_recorder_;
   base::ObserverList<CanvasObserver> observers_;
   gfx::PointF offset_;
   CanvasOwner* const owner_;
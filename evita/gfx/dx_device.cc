@@ -43,9 +43,16 @@ DxDevice::DxDevice() {
       D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_SINGLETHREADED;
 #endif
   common::ComPtr<ID3D11Device> d3d_device;
-  COM_VERIFY(::D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
-                                 d3d11_flags, nullptr, 0, D3D11_SDK_VERSION,
-                                 &d3d_device, feature_levels, nullptr));
+  auto const hr = ::D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE,
+                                      nullptr, d3d11_flags, nullptr, 0,
+                                      D3D11_SDK_VERSION, &d3d_device,
+                                      feature_levels, nullptr);
+  if (FAILED(hr)) {
+    // Fall back to software rasterizer, e.g. headless test bots without GPU.
+    COM_VERIFY(::D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr,
+                                   d3d11_flags, nullptr, 0, D3D11_SDK_VERSION,
+                                   &d3d_device, feature_levels, nullptr));
+  }
   COM_VERIFY(dxgi_device_.QueryFrom(d3d_device));
 
   common::ComPtr<IDXGIAdapter> dxgi_adapter;
@@ -9,11 +9,14 @@
 #include "evita/gfx/font.h"
 
 #include "base/logging.h"
-#include "common/memory/singleton.h"
+#include "base/memory/singleton.h"
+#include "base/synchronization/lock.h"
+#include "evita/gfx/base/fonts/glyph_advance_cache.h"
 #include "evita/gfx/brush.h"
 #include "evita/gfx/canvas.h"
 #include "evita/gfx/direct2d_factory_win.h"
 #include "evita/gfx/font_face.h"
+#include "evita/metrics/counter.h"
 
 namespace {
 
@@ -37,22 +40,29 @@ namespace gfx {
 //
 // Font::Cache
 //
-class Font::Cache final : public common::Singleton<Font::Cache> {
-  DECLARE_SINGLETON_CLASS(Font::Cache);
-
+// Fonts are shared by script thread and layout thread, so |Cache| is guarded
+// by |lock_|. Fonts are never destroyed once created.
+//
+class Font::Cache final {
  public:
   const Font& GetOrCreate(const gfx::FontProperties& font_props);
 
+  static Cache* GetInstance();
+
  private:
+  friend struct base::DefaultSingletonTraits<Cache>;
+
   Cache() = default;
-  ~Cache() final = default;
+  ~Cache() = default;
 
+  base::Lock lock_;
   std::unordered_map<gfx::FontProperties, Font*> map_;
 
   DISALLOW_COPY_AND_ASSIGN(Cache);
 };
 
 const Font& Font::Cache::GetOrCreate(const gfx::FontProperties& font_props) {
+  base::AutoLock lock_scope(lock_);
   const auto present = map_.find(font_props);
   if (present != map_.end())
     return *present->second;
@@ -61,13 +71,19 @@ const Font& Font::Cache::GetOrCreate(const gfx::FontProperties& font_props) {
   return *new_font;
 }
 
+// static
+Font::Cache* Font::Cache::GetInstance() {
+  return base::Singleton<Cache>::get();
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // Font
 //
-class Font::FontImpl {
+class Font::FontImpl final : public GlyphAdvanceCache::Provider {
  public:
   explicit FontImpl(const gfx::FontProperties& properties);
+  ~FontImpl() final = default;
 
   // [C]
   SimpleMetrics CalculateMetrics() const;
@@ -86,6 +102,7 @@ class Font::FontImpl {
                                         size_t num_chars) const;
   std::vector<DWRITE_GLYPH_METRICS> GetGlyphMetrics(const base::char16* chars,
                                                     size_t num_chars) const;
+  uint32_t GetTotalAdvance(const base::char16* chars, size_t num_chars) const;
   // [H]
   bool HasCharacter(base::char16 sample) const;
 
@@ -95,6 +112,11 @@ class Font::FontImpl {
       const std::vector<uint16_t> glyph_indexes) const;
   DWRITE_FONT_METRICS GetMetrics() const;
 
+  // GlyphAdvanceCache::Provider
+  void GetAdvances(const uint32_t* code_points,
+                   size_t num_code_points,
+                   float* advances) const final;
+
   const std::unique_ptr<gfx::FontFace> font_face_;
   const float em_size_;  // the logical size of the font in DIP units.
   const float pixels_per_dip_;
@@ -123,12 +145,9 @@ Font::SimpleMetrics Font::FontImpl::CalculateMetrics() const {
 }
 
 uint32_t Font::FontImpl::CalculateFixedWidth() const {
-  static base::char16 cacheable_chars[0x7E - 0x20 + 1];
-  if (!cacheable_chars[0]) {
-    for (int ch = ' '; ch <= 0x7E; ++ch) {
-      cacheable_chars[ch - 0x20] = static_cast<base::char16>(ch);
-    }
-  }
+  base::char16 cacheable_chars[0x7E - 0x20 + 1];
+  for (int ch = ' '; ch <= 0x7E; ++ch)
+    cacheable_chars[ch - 0x20] = static_cast<base::char16>(ch);
 
   const auto metrics =
       GetGlyphMetrics(cacheable_chars, arraysize(cacheable_chars));
@@ -182,6 +201,23 @@ void Font::FontImpl::DrawText(gfx::Canvas* canvas,
                           DWRITE_MEASURING_MODE_NATURAL);
 }
 
+// GlyphAdvanceCache::Provider
+void Font::FontImpl::GetAdvances(const uint32_t* code_points,
+                                 size_t num_code_points,
+                                 float* advances) const {
+  DCHECK_GE(num_code_points, 1u);
+  std::vector<uint16_t> glyph_indexes(num_code_points);
+  COM_VERIFY((*font_face_)
+                 ->GetGlyphIndices(code_points,
+                                   static_cast<DWORD>(num_code_points),
+                                   &glyph_indexes[0]));
+  const auto& metrics = GetGlyphMetrics(glyph_indexes);
+  for (const auto& metric : metrics) {
+    *advances = static_cast<float>(metric.advanceWidth);
+    ++advances;
+  }
+}
+
 std::vector<uint16_t> Font::FontImpl::GetGlyphIndexes(const base::char16* chars,
                                                       size_t num_chars) const {
   DCHECK_GE(num_chars, 1u);
@@ -223,6 +259,18 @@ DWRITE_FONT_METRICS Font::FontImpl::GetMetrics() const {
   return metrics;
 }
 
+// Returns sum of advances in design units without |GlyphAdvanceCache| for
+// strings containing surrogate.
+uint32_t Font::FontImpl::GetTotalAdvance(const base::char16* chars,
+                                         size_t num_chars) const {
+  if (!num_chars)
+    return 0;
+  uint32_t total = 0;
+  for (const auto& metric : GetGlyphMetrics(chars, num_chars))
+    total += metric.advanceWidth;
+  return total;
+}
+
 bool Font::FontImpl::HasCharacter(base::char16 sample) const {
   uint32_t code_point = sample;
   uint16_t glyph_index;
@@ -236,6 +284,7 @@ bool Font::FontImpl::HasCharacter(base::char16 sample) const {
 //
 Font::Font(const gfx::FontProperties& properties)
     : font_impl_(new FontImpl(properties)),
+      advance_cache_(new GlyphAdvanceCache(font_impl_.get())),
       metrics_(font_impl_->CalculateMetrics()) {}
 
 Font::~Font() {}
@@ -246,6 +295,12 @@ void Font::DrawText(gfx::Canvas* canvas,
                     const base::char16* chars,
                     size_t num_chars) const {
   const auto baseline = rect.origin() + gfx::SizeF(0.0f, metrics_.ascent);
+  if (canvas->draw_recorder()) {
+    canvas->RecordDraw(
+        DrawRecorder::Op::Text,
+        gfx::RectF(rect.origin(),
+                   gfx::SizeF(GetTextWidth(chars, num_chars), height())));
+  }
   font_impl_->DrawText(canvas, text_brush, baseline, chars, num_chars);
 }
 
@@ -258,25 +313,34 @@ void Font::DrawText(gfx::Canvas* canvas,
 }
 
 const Font& Font::Get(const gfx::FontProperties& properties) {
-  return Cache::instance()->GetOrCreate(properties);
+  return Cache::GetInstance()->GetOrCreate(properties);
 }
 
 float Font::GetCharWidth(base::char16 wch) const {
   if (IsCacheableChar(wch) && metrics_.fixed_width)
     return metrics_.fixed_width;
-  return GetTextWidth(&wch, 1);
+  if (GlyphAdvanceCache::HasSurrogate(&wch, 1))
+    return font_impl_->ConvertToDip(font_impl_->GetTotalAdvance(&wch, 1));
+  auto is_hit = false;
+  const auto advance = advance_cache_->GetAdvance(wch, &is_hit);
+  METRICS_COUNTER_ADD("Font::GetCharWidth", is_hit ? "hit" : "miss");
+  return font_impl_->ConvertToDip(static_cast<uint32_t>(advance));
 }
 
 float Font::GetTextWidth(const base::char16* chars, size_t num_chars) const {
   if (metrics_.fixed_width && IsCachableString(chars, num_chars))
     return metrics_.fixed_width * num_chars;
-
-  const auto metrics = font_impl_->GetGlyphMetrics(chars, num_chars);
-  auto width = 0;
-  for (const auto metric : metrics) {
-    width += metric.advanceWidth;
+  // Note: We sum advances in design units before converting to DIP as
+  // DirectWrite does.
+  if (GlyphAdvanceCache::HasSurrogate(chars, num_chars)) {
+    return font_impl_->ConvertToDip(
+        font_impl_->GetTotalAdvance(chars, num_chars));
   }
-  return font_impl_->ConvertToDip(width);
+  auto is_hit = false;
+  const auto total =
+      advance_cache_->GetTotalAdvance(chars, num_chars, &is_hit);
+  METRICS_COUNTER_ADD("Font::GetTextWidth", is_hit ? "hit" : "miss");
+  return font_impl_->ConvertToDip(static_cast<uint32_t>(total));
 }
 
 float Font::GetTextWidth(const base::string16& string) const {
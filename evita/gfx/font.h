@@ -15,6 +15,7 @@
 
 namespace gfx {
 struct FontProperties;
+class GlyphAdvanceCache;
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -63,6 +64,7 @@ class Font {
   float ascent() const { return metrics_.ascent; }
 
   const std::unique_ptr<FontImpl> font_impl_;
+  const std::unique_ptr<GlyphAdvanceCache> advance_cache_;
   const SimpleMetrics metrics_;
 
   DISALLOW_COPY_AND_ASSIGN(Font);
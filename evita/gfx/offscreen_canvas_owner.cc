@@ -0,0 +1,22 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/gfx/offscreen_canvas_owner.h"
+
+#include "evita/gfx/dx_device.h"
+#include "evita/gfx/swap_chain.h"
+
+namespace gfx {
+
+OffscreenCanvasOwner::OffscreenCanvasOwner(const RectF& bounds)
+    : bounds_(bounds) {}
+
+OffscreenCanvasOwner::~OffscreenCanvasOwner() {}
+
+// CanvasOwner
+std::unique_ptr<SwapChain> OffscreenCanvasOwner::CreateSwapChain() {
+  return SwapChain::CreateForBitmap(DxDevice::instance(), bounds_);
+}
+
+}  // namespace gfx
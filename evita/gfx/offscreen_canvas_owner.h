@@ -0,0 +1,39 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_GFX_OFFSCREEN_CANVAS_OWNER_H_
+#define EVITA_GFX_OFFSCREEN_CANVAS_OWNER_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "evita/gfx/canvas_owner.h"
+#include "evita/gfx/rect_f.h"
+
+namespace gfx {
+
+//////////////////////////////////////////////////////////////////////
+//
+// OffscreenCanvasOwner
+//
+// |OffscreenCanvasOwner| provides |Canvas| rendering into an offscreen bitmap
+// without window, e.g. for testing and benchmarking painters.
+//
+class OffscreenCanvasOwner final : public CanvasOwner {
+ public:
+  explicit OffscreenCanvasOwner(const RectF& bounds);
+  ~OffscreenCanvasOwner() final;
+
+ private:
+  // CanvasOwner
+  std::unique_ptr<SwapChain> CreateSwapChain() final;
+
+  const RectF bounds_;
+
+  DISALLOW_COPY_AND_ASSIGN(OffscreenCanvasOwner);
+};
+
+}  // namespace gfx
+
+#endif  // EVITA_GFX_OFFSCREEN_CANVAS_OWNER_H_
@@ -24,11 +24,16 @@ SwapChain::SwapChain(ID2D1Device* d2d_device,
       is_ready_(false),
       swap_chain_(swap_chain),
       swap_chain_waitable_(swap_chain_->GetFrameLatencyWaitableObject()) {
-  // Antialias Mode = D2D1_ANTIALIAS_MODE_PER_PRIMITIVE
-  // Primitive Blend = D2D1_PRIMITIVE_BLEND_SOURCE_OVER
-  // Text Antialias Mode = D2D1_TEXT_ANTIALIAS_MODE_DEFAULT
-  COM_VERIFY(d2d_device->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
-                                             &d2d_device_context_));
+  CreateDeviceContext(d2d_device);
+  UpdateDeviceContext();
+}
+
+SwapChain::SwapChain(ID2D1Device* d2d_device, const RectF& bounds)
+    : bounds_(bounds),
+      is_first_present_(true),
+      is_ready_(true),
+      swap_chain_waitable_(nullptr) {
+  CreateDeviceContext(d2d_device);
   UpdateDeviceContext();
 }
 
@@ -58,6 +63,14 @@ void SwapChain::AddDirtyRect(const RectF& new_dirty_rect_f) {
   dirty_rects_ = new_dirty_rects;
 }
 
+std::unique_ptr<SwapChain> SwapChain::CreateForBitmap(DxDevice* device,
+                                                      const RectF& bounds) {
+  DCHECK(!bounds.empty());
+  TRACE_EVENT0("gfx", "SwapChain::CreateForBitmap");
+  return std::unique_ptr<SwapChain>(
+      new SwapChain(device->d2d_device(), RectF(bounds.size())));
+}
+
 std::unique_ptr<SwapChain> SwapChain::CreateForComposition(
     DxDevice* device,
     const RectF& bounds) {
@@ -129,10 +142,51 @@ std::unique_ptr<SwapChain> SwapChain::CreateForHwnd(HWND hwnd) {
       new SwapChain(device->d2d_device(), swap_chain2));
 }
 
+void SwapChain::CreateDeviceContext(ID2D1Device* d2d_device) {
+  // Antialias Mode = D2D1_ANTIALIAS_MODE_PER_PRIMITIVE
+  // Primitive Blend = D2D1_PRIMITIVE_BLEND_SOURCE_OVER
+  // Text Antialias Mode = D2D1_TEXT_ANTIALIAS_MODE_DEFAULT
+  COM_VERIFY(d2d_device->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
+                                             &d2d_device_context_));
+}
+
+common::ComPtr<ID2D1Bitmap1> SwapChain::CreateTargetBitmap() {
+  common::ComPtr<ID2D1Factory> d2d_factory;
+  d2d_device_context_->GetFactory(&d2d_factory);
+
+  float dpi_x, dpi_y;
+  d2d_factory->GetDesktopDpi(&dpi_x, &dpi_y);
+  auto const bitmap_properties = D2D1::BitmapProperties1(
+      D2D1_BITMAP_OPTIONS_TARGET | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
+      D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM,
+                        D2D1_ALPHA_MODE_PREMULTIPLIED),
+      dpi_x, dpi_y);
+
+  common::ComPtr<ID2D1Bitmap1> d2d_bitmap;
+  if (!swap_chain_) {
+    auto const enclosing_rect = ToEnclosingRect(bounds_);
+    COM_VERIFY(d2d_device_context_->CreateBitmap(
+        gfx::SizeU(static_cast<uint32_t>(enclosing_rect.width()),
+                   static_cast<uint32_t>(enclosing_rect.height())),
+        nullptr, 0, bitmap_properties, &d2d_bitmap));
+    return std::move(d2d_bitmap);
+  }
+
+  common::ComPtr<IDXGISurface> dxgi_back_buffer;
+  swap_chain_->GetBuffer(0, IID_PPV_ARGS(&dxgi_back_buffer));
+  COM_VERIFY(d2d_device_context_->CreateBitmapFromDxgiSurface(
+      dxgi_back_buffer, bitmap_properties, &d2d_bitmap));
+  return std::move(d2d_bitmap);
+}
+
 void SwapChain::DidChangeBounds(const RectF& new_bounds) {
   TRACE_EVENT0("gfx", "SwapChain::DidChangeBounds");
   d2d_device_context_->SetTarget(nullptr);
   bounds_ = new_bounds;
+  if (!swap_chain_) {
+    UpdateDeviceContext();
+    return;
+  }
   auto const enclosing_rect = ToEnclosingRect(new_bounds);
   COM_VERIFY(swap_chain_->ResizeBuffers(
       0u, static_cast<UINT>(enclosing_rect.width()),
@@ -146,6 +200,12 @@ void SwapChain::Present() {
     return;
   DCHECK(is_ready_);
   TRACE_EVENT1("gfx", "SwapChain::Present", "count", dirty_rects_.size());
+  if (!swap_chain_) {
+    // Offscreen bitmap is always ready.
+    dirty_rects_.clear();
+    is_first_present_ = false;
+    return;
+  }
   DXGI_PRESENT_PARAMETERS parameters = {0};
   std::vector<RECT> dirty_rects;
   if (!is_first_present_) {
@@ -166,7 +226,7 @@ void SwapChain::Present() {
 
 void SwapChain::UpdateDeviceContext() {
   TRACE_EVENT0("gfx", "SwapChain::UpdateDeviceContext");
-  {
+  if (swap_chain_) {
     DXGI_RGBA color;
     color.r = 1.0f;
     color.g = 1.0f;
@@ -177,23 +237,7 @@ void SwapChain::UpdateDeviceContext() {
 
   // Allocate back buffer for d2d device context.
   {
-    common::ComPtr<IDXGISurface> dxgi_back_buffer;
-    swap_chain_->GetBuffer(0, IID_PPV_ARGS(&dxgi_back_buffer));
-
-    common::ComPtr<ID2D1Factory> d2d_factory;
-    d2d_device_context_->GetFactory(&d2d_factory);
-
-    float dpi_x, dpi_y;
-    d2d_factory->GetDesktopDpi(&dpi_x, &dpi_y);
-    auto const bitmap_properties = D2D1::BitmapProperties1(
-        D2D1_BITMAP_OPTIONS_TARGET | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM,
-                          D2D1_ALPHA_MODE_PREMULTIPLIED),
-        dpi_x, dpi_y);
-
-    common::ComPtr<ID2D1Bitmap1> d2d_back_buffer;
-    COM_VERIFY(d2d_device_context_->CreateBitmapFromDxgiSurface(
-        dxgi_back_buffer, bitmap_properties, &d2d_back_buffer));
+    auto const d2d_back_buffer = CreateTargetBitmap();
     d2d_device_context_->SetTarget(d2d_back_buffer);
 
     auto const size = d2d_back_buffer->GetPixelSize();
@@ -206,7 +250,7 @@ void SwapChain::UpdateDeviceContext() {
 }
 
 bool SwapChain::UpdateReadyState() const {
-  if (is_ready_)
+  if (is_ready_ || !swap_chain_)
     return true;
   auto const wait = ::WaitForSingleObject(swap_chain_waitable_, 0);
   switch (wait) {
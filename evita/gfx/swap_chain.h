@@ -30,6 +30,11 @@ class SwapChain final {
   IDXGISwapChain2* swap_chain() const { return swap_chain_; }
 
   void AddDirtyRect(const RectF& dirty_rects);
+  // Creates swap chain without presentation surface, which renders into
+  // an offscreen bitmap, e.g. for testing and benchmarking painters without
+  // window.
+  static std::unique_ptr<SwapChain> CreateForBitmap(DxDevice* device,
+                                                    const RectF& bounds);
   static std::unique_ptr<SwapChain> CreateForComposition(DxDevice* device,
                                                          const RectF& bounds);
   static std::unique_ptr<SwapChain> CreateForHwnd(HWND hwnd);
@@ -40,6 +45,10 @@ class SwapChain final {
  private:
   SwapChain(ID2D1Device* d2d_device,
             common::ComPtr<IDXGISwapChain2> swap_chain);
+  SwapChain(ID2D1Device* d2d_device, const RectF& bounds);
+
+  void CreateDeviceContext(ID2D1Device* d2d_device);
+  common::ComPtr<ID2D1Bitmap1> CreateTargetBitmap();
 
   void UpdateDeviceContext();
 
@@ -50,6 +59,7 @@ class SwapChain final {
   // To avoid calling |WaitForSingleObject()|, |is_ready_| holds last checked
   // result.
   mutable bool is_ready_;
+  // |swap_chain_| is null for offscreen bitmap.
   const common::ComPtr<IDXGISwapChain2> swap_chain_;
   HANDLE const swap_chain_waitable_;
 
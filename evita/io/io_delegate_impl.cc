@@ -21,6 +21,7 @@
 #include "evita/io/file_io_context.h"
 #include "evita/io/io_context_utils.h"
 #include "evita/io/process_io_context.h"
+#include "evita/io/save_file_io_context.h"
 #include "evita/io/win_resource_io_context.h"
 #include "evita/spellchecker/spelling_engine.h"
 
@@ -78,6 +79,20 @@ void IoDelegateImpl::CheckSpelling(const base::string16& word_to_check,
           word_to_check)));
 }
 
+void IoDelegateImpl::CheckSpellingBatch(
+    const std::vector<base::string16>& words_to_check,
+    const CheckSpellingBatchResolver& promise) {
+  TRACE_EVENT1("io", "IoDelegateImpl::CheckSpellingBatch", "size",
+               words_to_check.size());
+  TRACE_EVENT_WITH_FLOW1("promise", "Promise", promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
+                         "step", "IoDelegateImpl::CheckSpellingBatch");
+  RunCallback(base::Bind(
+      promise.resolve,
+      spellchecker::SpellingEngine::GetSpellingEngine()->CheckSpellingBatch(
+          words_to_check)));
+}
+
 void IoDelegateImpl::CloseContext(const domapi::IoContextId& context_id,
                                   const domapi::IoIntPromise& promise) {
   const auto& it = context_map_.find(context_id);
@@ -316,6 +331,20 @@ void IoDelegateImpl::RemoveFile(const base::string16& file_name,
   RunCallback(base::Bind(resolver.resolve, true));
 }
 
+void IoDelegateImpl::SaveFile(const base::string16& file_name,
+                              const scoped_refptr<domapi::SaveFileData>& data,
+                              domapi::SaveFileDurability durability,
+                              const SaveFileProgress& progress,
+                              const domapi::IoIntPromise& promise) {
+  TRACE_EVENT0("io", "IoDelegateImpl::SaveFile");
+  TRACE_EVENT_WITH_FLOW1("promise", "Promise", promise.sequence_num,
+                         TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT,
+                         "step", "IoDelegateImpl::SaveFile");
+  // |SaveFileIoContext| deletes itself when saving is finished.
+  (new SaveFileIoContext(file_name, data, durability, progress, promise))
+      ->Start();
+}
+
 void IoDelegateImpl::WriteFile(domapi::IoContextId context_id,
                                void* buffer,
                                size_t num_write,
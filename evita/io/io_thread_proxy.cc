@@ -8,6 +8,7 @@
 #include "base/callback.h"
 #include "base/message_loop/message_loop.h"
 #include "base/threading/thread.h"
+#include "evita/dom/public/save_file_data.h"
 
 namespace io {
 
@@ -38,6 +39,13 @@ IoThreadProxy::~IoThreadProxy() {}
                               p1, p2, p3, p4));                               \
   }
 
+#define DEFINE_DELEGATE_5(name, type1, type2, type3, type4, type5)            \
+  void IoThreadProxy::name(type1 p1, type2 p2, type3 p3, type4 p4, type5 p5) { \
+    thread_->task_runner()->PostTask(                                         \
+        FROM_HERE, base::Bind(&IoDelegate::name, base::Unretained(delegate_), \
+                              p1, p2, p3, p4, p5));                           \
+  }
+
 #define DEFINE_DELEGATE_6(name, ty1, ty2, ty3, ty4, ty5, ty6)                 \
   void IoThreadProxy::name(ty1 p1, ty2 p2, ty3 p3, ty4 p4, ty5 p5, ty6 p6) {  \
     thread_->task_runner()->PostTask(                                         \
@@ -48,6 +56,9 @@ IoThreadProxy::~IoThreadProxy() {}
 DEFINE_DELEGATE_2(CheckSpelling,
                   const base::string16&,
                   const CheckSpellingResolver&)
+DEFINE_DELEGATE_2(CheckSpellingBatch,
+                  const std::vector<base::string16>&,
+                  const CheckSpellingBatchResolver&)
 DEFINE_DELEGATE_2(CloseContext,
                   const domapi::IoContextId&,
                   const domapi::IoIntPromise&)
@@ -105,6 +116,12 @@ DEFINE_DELEGATE_4(ReadFile,
 DEFINE_DELEGATE_2(RemoveFile,
                   const base::string16&,
                   const domapi::IoBoolPromise&)
+DEFINE_DELEGATE_5(SaveFile,
+                  const base::string16&,
+                  const scoped_refptr<domapi::SaveFileData>&,
+                  domapi::SaveFileDurability,
+                  const SaveFileProgress&,
+                  const domapi::IoIntPromise&)
 DEFINE_DELEGATE_4(WriteFile,
                   domapi::IoContextId,
                   void*,
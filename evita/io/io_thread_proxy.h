@@ -23,6 +23,8 @@ class IoThreadProxy : public domapi::IoDelegate {
   // domapi::IoDelegate
   void CheckSpelling(const base::string16& word_to_check,
                      const CheckSpellingResolver& promise) final;
+  void CheckSpellingBatch(const std::vector<base::string16>& words_to_check,
+                          const CheckSpellingBatchResolver& promise) final;
   void CloseContext(const domapi::IoContextId& context_id,
                     const domapi::IoIntPromise& promise) final;
   void ComputeFullPathName(const base::string16& path_name,
@@ -66,6 +68,11 @@ class IoThreadProxy : public domapi::IoDelegate {
                 const domapi::IoIntPromise& promise) final;
   void RemoveFile(const base::string16& file_name,
                   const domapi::IoBoolPromise& resolver) final;
+  void SaveFile(const base::string16& file_name,
+                const scoped_refptr<domapi::SaveFileData>& data,
+                domapi::SaveFileDurability durability,
+                const SaveFileProgress& progress,
+                const domapi::IoIntPromise& promise) final;
   void WriteFile(domapi::IoContextId context_id,
                  void* buffer,
                  size_t num_write,
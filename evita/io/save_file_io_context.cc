@@ -0,0 +1,194 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/io/save_file_io_context.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/editor/application.h"
+#include "evita/io/io_context_utils.h"
+#include "evita/io/io_manager.h"
+
+namespace io {
+
+namespace {
+
+base::string16 DirectoryNameOf(const base::string16& file_name) {
+  auto const slash = file_name.find_last_of(L"/\\");
+  if (slash == base::string16::npos)
+    return L".";
+  return file_name.substr(0, slash);
+}
+
+}  // namespace
+
+SaveFileIoContext::SaveFileIoContext(
+    const base::string16& file_name,
+    const scoped_refptr<domapi::SaveFileData>& data,
+    domapi::SaveFileDurability durability,
+    const domapi::IoDelegate::SaveFileProgress& progress,
+    const domapi::IoIntPromise& promise)
+    : data_(data),
+      durability_(durability),
+      error_(0),
+      file_name_(file_name),
+      next_offset_(0),
+      num_pending_writes_(0),
+      num_written_(0),
+      progress_(progress),
+      promise_(promise),
+      weak_ptr_factory_(this) {
+  TRACE_EVENT_ASYNC_BEGIN0("io", "SaveFile", this);
+}
+
+SaveFileIoContext::~SaveFileIoContext() {
+  TRACE_EVENT_ASYNC_END1("io", "SaveFile", this, "size", num_written_);
+}
+
+// Called on IO thread when the script thread appends a chunk or finishes
+// |data_|.
+void SaveFileIoContext::DidAppendData() {
+  StartWrites();
+}
+
+void SaveFileIoContext::Finish() {
+  DCHECK_EQ(0, num_pending_writes_);
+  // Stop notification from script thread and encoding if it is still running.
+  data_->SetConsumer(base::Closure());
+  if (error_)
+    data_->Abort(static_cast<int>(error_));
+  if (file_handle_.is_valid()) {
+    if (!error_ && durability_ != domapi::SaveFileDurability::None) {
+      TRACE_EVENT0("io", "SaveFileIoContext::FlushFileBuffers");
+      if (!::FlushFileBuffers(file_handle_.get())) {
+        error_ = ::GetLastError();
+        PLOG(ERROR) << "FlushFileBuffers failed";
+      }
+    }
+    if (!::CloseHandle(file_handle_.get()) && !error_) {
+      error_ = ::GetLastError();
+      PLOG(ERROR) << "CloseHandle failed";
+    }
+    file_handle_.release();
+  }
+  if (!error_) {
+    // |MOVEFILE_WRITE_THROUGH| makes |MoveFileEx()| return after directory
+    // entry is flushed to disk.
+    auto const flags =
+        durability_ == domapi::SaveFileDurability::Directory
+            ? MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+            : MOVEFILE_REPLACE_EXISTING;
+    auto const succeeded = ::MoveFileExW(temp_file_name_.c_str(),
+                                         file_name_.c_str(), flags);
+    if (!succeeded) {
+      error_ = ::GetLastError();
+      PLOG(ERROR) << "MoveFileEx " << file_name_ << " failed";
+    }
+  }
+  if (error_) {
+    if (!temp_file_name_.empty())
+      ::DeleteFileW(temp_file_name_.c_str());
+    Reject(promise_.reject, error_);
+  } else {
+    Resolve(promise_.resolve, static_cast<uint32_t>(num_written_));
+  }
+  delete this;
+}
+
+void SaveFileIoContext::Start() {
+  base::string16 temp_file_name(MAX_PATH, 0);
+  if (!::GetTempFileNameW(DirectoryNameOf(file_name_).c_str(), L"ed", 0,
+                          &temp_file_name[0])) {
+    error_ = ::GetLastError();
+    PLOG(ERROR) << "GetTempFileName failed";
+    return Finish();
+  }
+  temp_file_name.resize(temp_file_name.find(static_cast<base::char16>(0)));
+  temp_file_name_ = temp_file_name;
+
+  file_handle_.reset(::CreateFileW(
+      temp_file_name_.c_str(), GENERIC_WRITE, FILE_SHARE_DELETE, nullptr,
+      CREATE_ALWAYS, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr));
+  if (!file_handle_) {
+    error_ = ::GetLastError();
+    PLOG(ERROR) << "CreateFileW " << temp_file_name_ << " failed";
+    return Finish();
+  }
+  editor::Application::instance()->io_manager()->RegisterIoHandler(
+      file_handle_.get(), static_cast<base::MessagePumpForIO::IOHandler*>(this));
+
+  // |data_| calls consumer callback on script thread.
+  data_->SetConsumer(base::Bind(
+      base::IgnoreResult(&base::SingleThreadTaskRunner::PostTask),
+      base::ThreadTaskRunnerHandle::Get(), FROM_HERE,
+      base::Bind(&SaveFileIoContext::DidAppendData,
+                 weak_ptr_factory_.GetWeakPtr())));
+  StartWrites();
+}
+
+void SaveFileIoContext::StartWrite(WriteRequest* request) {
+  DCHECK(!request->is_pending);
+  if (error_)
+    return;
+  if (auto const error_code = data_->error_code()) {
+    // Script thread failed to encode contents.
+    error_ = static_cast<DWORD>(error_code);
+    return;
+  }
+  auto& chunk = request->chunk;
+  if (!data_->TakeChunk(&chunk))
+    return;
+  request->overlapped.Offset = static_cast<DWORD>(next_offset_);
+  request->overlapped.OffsetHigh = static_cast<DWORD>(next_offset_ >> 32);
+  next_offset_ += chunk.size();
+  // Completion is notified via I/O completion port even if |WriteFile()|
+  // finishes synchronously.
+  auto const succeeded =
+      ::WriteFile(file_handle_.get(), chunk.data(),
+                  static_cast<DWORD>(chunk.size()), nullptr,
+                  &request->overlapped);
+  if (!succeeded && ::GetLastError() != ERROR_IO_PENDING) {
+    error_ = ::GetLastError();
+    PLOG(ERROR) << "WriteFile failed";
+    return;
+  }
+  request->is_pending = true;
+  ++num_pending_writes_;
+}
+
+void SaveFileIoContext::StartWrites() {
+  for (auto& request : requests_) {
+    if (!request.is_pending)
+      StartWrite(&request);
+  }
+  if (num_pending_writes_)
+    return;
+  if (!error_ && !data_->is_finished())
+    return;
+  Finish();
+}
+
+// base::MessagePumpForIO::IOHandler
+void SaveFileIoContext::OnIOCompleted(
+    base::MessagePumpForIO::IOContext* context,
+    DWORD bytes_transferred,
+    DWORD error) {
+  auto* const request = static_cast<WriteRequest*>(context);
+  DCHECK(request->is_pending);
+  request->is_pending = false;
+  --num_pending_writes_;
+  num_written_ += bytes_transferred;
+  TRACE_COUNTER_ID1("io", "SaveFile", this, num_written_);
+  if (error && !error_)
+    error_ = error;
+  if (!error_ && !progress_.is_null())
+    RunCallback(base::Bind(progress_, static_cast<int>(num_written_)));
+  StartWrites();
+}
+
+}  // namespace io
@@ -0,0 +1,82 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_IO_SAVE_FILE_IO_CONTEXT_H_
+#define EVITA_IO_SAVE_FILE_IO_CONTEXT_H_
+
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_pump_win.h"
+#include "base/strings/string16.h"
+#include "common/win/scoped_handle.h"
+#include "evita/dom/public/io_delegate.h"
+#include "evita/dom/public/promise.h"
+#include "evita/dom/public/save_file_data.h"
+
+namespace io {
+
+//////////////////////////////////////////////////////////////////////
+//
+// SaveFileIoContext
+//
+// Writes |SaveFileData| into a temporary file in the same directory of
+// the target file with up to |kMaxPendingWrites| overlapped writes, then
+// atomically replaces the target file by renaming. Chunks are written as soon
+// as the script thread appends them, and writing is finished when the script
+// thread closes |SaveFileData|. File buffers are flushed
+// as specified by |domapi::SaveFileDurability|. This object deletes itself
+// when saving is finished.
+//
+class SaveFileIoContext final : private base::MessagePumpForIO::IOHandler {
+ public:
+  SaveFileIoContext(const base::string16& file_name,
+                    const scoped_refptr<domapi::SaveFileData>& data,
+                    domapi::SaveFileDurability durability,
+                    const domapi::IoDelegate::SaveFileProgress& progress,
+                    const domapi::IoIntPromise& promise);
+  ~SaveFileIoContext() final;
+
+  void Start();
+
+ private:
+  struct WriteRequest : base::MessagePumpForIO::IOContext {
+    domapi::SaveFileData::Chunk chunk;
+    bool is_pending = false;
+  };
+
+  static const int kMaxPendingWrites = 2;
+
+  void DidAppendData();
+  void Finish();
+  void StartWrite(WriteRequest* request);
+  void StartWrites();
+
+  // base::MessagePumpForIO::IOHandler
+  void OnIOCompleted(base::MessagePumpForIO::IOContext* context,
+                     DWORD bytes_transferred,
+                     DWORD error) final;
+
+  const scoped_refptr<domapi::SaveFileData> data_;
+  const domapi::SaveFileDurability durability_;
+  DWORD error_;
+  common::win::scoped_handle file_handle_;
+  const base::string16 file_name_;
+  uint64_t next_offset_;
+  int num_pending_writes_;
+  uint64_t num_written_;
+  const domapi::IoDelegate::SaveFileProgress progress_;
+  const domapi::IoIntPromise promise_;
+  WriteRequest requests_[kMaxPendingWrites];
+  base::string16 temp_file_name_;
+  base::WeakPtrFactory<SaveFileIoContext> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SaveFileIoContext);
+};
+
+}  // namespace io
+
+#endif  // EVITA_IO_SAVE_FILE_IO_CONTEXT_H_
@@ -7,22 +7,87 @@
 #include <sstream>
 
 #include "base/strings/utf_string_conversions.h"
-#include "evita/editor/dom_lock.h"
+#include "evita/metrics/thread_shard.h"
 
 namespace metrics {
 
-Counter::Counter(const base::StringPiece& name) : name_(name) {}
+//////////////////////////////////////////////////////////////////////
+//
+// Counter::Shard
+//
+// Shards are aligned to cache line to avoid false sharing between threads.
+//
+struct alignas(64) Counter::Shard {
+  Shard() {
+    for (auto& count : counts)
+      count.store(0, std::memory_order_relaxed);
+  }
+
+  std::atomic<int64_t> counts[kMaxSamples];
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// Counter
+//
+const char Counter::kOtherSample[] = "(other)";
+
+Counter::Counter(const base::StringPiece& name)
+    : name_(name),
+      num_samples_(0),
+      shards_(new Shard[kNumberOfThreadShards]) {}
 
 Counter::~Counter() {}
 
 void Counter::AddSample(const base::StringPiece& sample) {
-  auto const it = map_.find(sample);
-  if (it != map_.end())
-    ++it->second;
-  else
-    map_[sample] = 1;
+  shards_[ThreadShardIndex()].counts[IndexOf(sample)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+std::vector<std::pair<base::StringPiece, int64_t>> Counter::GetSnapshot()
+    const {
+  std::vector<std::pair<base::StringPiece, int64_t>> snapshot;
+  const auto num_samples = num_samples_.load(std::memory_order_acquire);
+  for (auto index = 0u; index < num_samples; ++index) {
+    auto count = int64_t(0);
+    for (auto shard = 0u; shard < kNumberOfThreadShards; ++shard)
+      count += shards_[shard].counts[index].load(std::memory_order_relaxed);
+    snapshot.push_back(std::make_pair(samples_[index], count));
+  }
+  return snapshot;
+}
+
+size_t Counter::IndexOf(const base::StringPiece& sample) {
+  const auto num_samples = num_samples_.load(std::memory_order_acquire);
+  for (auto index = 0u; index < num_samples; ++index) {
+    if (samples_[index] == sample)
+      return index;
+  }
+  if (num_samples == kMaxSamples) {
+    // No more new sample, the last entry is |kOtherSample|.
+    return kMaxSamples - 1;
+  }
+  base::AutoLock lock_scope(lock_);
+  const auto num_samples2 = num_samples_.load(std::memory_order_relaxed);
+  for (auto index = num_samples; index < num_samples2; ++index) {
+    if (samples_[index] == sample)
+      return index;
+  }
+  if (num_samples2 == kMaxSamples) {
+    // The last entry is |kOtherSample|.
+    return kMaxSamples - 1;
+  }
+  samples_[num_samples2] = num_samples2 == kMaxSamples - 1
+                               ? base::StringPiece(kOtherSample)
+                               : sample;
+  num_samples_.store(num_samples2 + 1, std::memory_order_release);
+  return num_samples2;
 }
 
+//////////////////////////////////////////////////////////////////////
+//
+// CounterSet
+//
 CounterSet::CounterSet() {}
 
 CounterSet::~CounterSet() {}
@@ -34,26 +99,27 @@ void CounterSet::AddSample(const base::StringPiece& name,
 }
 
 Counter* CounterSet::GetOrCreate(const base::StringPiece& name) {
+  base::AutoLock lock_scope(lock_);
   auto const it = map_.find(name);
   if (it != map_.end())
     return it->second;
-  auto const histogram = new Counter(name);
-  map_[name] = histogram;
-  return histogram;
+  auto const counter = new Counter(name);
+  map_[name] = counter;
+  return counter;
 }
 
 base::string16 CounterSet::GetJson(const base::string16& name) const {
-  UI_ASSERT_DOM_LOCKED();
   if (name != L"all")
     return base::string16();
   std::basic_ostringstream<base::char16> ostream;
   ostream << '{';
   const base::string16 comma = L",\n";
   base::string16 delimiter = L"";
+  base::AutoLock lock_scope(lock_);
   for (auto it : map_) {
     ostream << delimiter << '"' << base::ASCIIToUTF16(it.first) << L"\": [";
     base::string16 delimiter2 = L"";
-    for (auto key_value : it.second->data()) {
+    for (const auto& key_value : it.second->GetSnapshot()) {
       ostream << delimiter2;
       ostream << L"{\"key\": \"" << base::ASCIIToUTF16(key_value.first)
               << L"\", \"value\": " << key_value.second << '}';
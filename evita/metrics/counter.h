@@ -5,32 +5,69 @@
 #ifndef EVITA_METRICS_COUNTER_H_
 #define EVITA_METRICS_COUNTER_H_
 
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "base/macros.h"
+#include "base/strings/string16.h"
 #include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 #include "common/memory/singleton.h"
 
 namespace metrics {
 
+//////////////////////////////////////////////////////////////////////
+//
+// Counter
+//
+// |Counter| counts occurrences of a small number of samples, e.g. "hit" and
+// "miss". Samples should be string literals. Counting a sample seen before is
+// lock-free and can be called from any thread.
+//
 class Counter final {
  public:
-  using SampleMap =
-      std::unordered_map<base::StringPiece, int, base::StringPieceHash>;
+  // Samples more than |kMaxSamples| are counted as |kOtherSample|.
+  static const size_t kMaxSamples = 16;
+  static const char kOtherSample[];
 
   explicit Counter(const base::StringPiece& name);
   ~Counter();
 
-  const SampleMap& data() const { return map_; }
+  base::StringPiece name() const { return name_; }
 
   void AddSample(const base::StringPiece& sample);
+  // Returns pairs of sample and count aggregated from all threads.
+  std::vector<std::pair<base::StringPiece, int64_t>> GetSnapshot() const;
 
  private:
-  SampleMap map_;
+  struct Shard;
+
+  size_t IndexOf(const base::StringPiece& sample);
+
   base::StringPiece name_;
+  // Guards adding a new sample to |samples_|.
+  base::Lock lock_;
+  // Number of valid entries of |samples_|. Entries of |samples_| are
+  // published by release store of |num_samples_|.
+  std::atomic<size_t> num_samples_;
+  base::StringPiece samples_[kMaxSamples];
+  std::unique_ptr<Shard[]> shards_;
 
   DISALLOW_COPY_AND_ASSIGN(Counter);
 };
 
+//////////////////////////////////////////////////////////////////////
+//
+// CounterSet
+//
+// Hot paths should cache a counter returned by |GetOrCreate()|, e.g. in
+// function local static variable, since counters live forever.
+//
 class CounterSet : public common::Singleton<CounterSet> {
   DECLARE_SINGLETON_CLASS(CounterSet);
 
@@ -45,6 +82,7 @@ class CounterSet : public common::Singleton<CounterSet> {
  private:
   CounterSet();
 
+  mutable base::Lock lock_;
   std::unordered_map<base::StringPiece, Counter*, base::StringPieceHash> map_;
 
   DISALLOW_COPY_AND_ASSIGN(CounterSet);
@@ -52,7 +90,15 @@ class CounterSet : public common::Singleton<CounterSet> {
 
 }  // namespace metrics
 
-#define METRICS_COUNT(sample) \
-  ::metrics::CounterSet::instance()->AddSample(__FUNCTION__, sample)
+// Adds |sample| to counter |name| without looking up counter by name except
+// for the first time.
+#define METRICS_COUNTER_ADD(name, sample)                        \
+  do {                                                           \
+    static auto* const metrics_counter =                         \
+        ::metrics::CounterSet::instance()->GetOrCreate(name);    \
+    metrics_counter->AddSample(sample);                          \
+  } while (false)
+
+#define METRICS_COUNT(sample) METRICS_COUNTER_ADD(__FUNCTION__, sample)
 
 #endif  // EVITA_METRICS_COUNTER_H_
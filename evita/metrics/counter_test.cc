@@ -0,0 +1,51 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "evita/metrics/counter.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace metrics {
+
+TEST(CounterTest, AddSample) {
+  Counter counter("test");
+  counter.AddSample("foo");
+  counter.AddSample("bar");
+  counter.AddSample("foo");
+
+  const auto& snapshot = counter.GetSnapshot();
+  ASSERT_EQ(2u, snapshot.size());
+  EXPECT_EQ("foo", snapshot[0].first);
+  EXPECT_EQ(2, snapshot[0].second);
+  EXPECT_EQ("bar", snapshot[1].first);
+  EXPECT_EQ(1, snapshot[1].second);
+}
+
+TEST(CounterTest, AddSampleOverflow) {
+  const size_t max_samples = Counter::kMaxSamples;
+  // |Counter| holds samples as |base::StringPiece|.
+  std::vector<std::string> samples;
+  for (auto index = 0u; index < max_samples + 4; ++index)
+    samples.push_back("sample" + std::to_string(index));
+
+  Counter counter("test");
+  for (const auto& sample : samples)
+    counter.AddSample(sample);
+  counter.AddSample(samples.front());
+  counter.AddSample(samples.back());
+
+  const auto& snapshot = counter.GetSnapshot();
+  ASSERT_EQ(max_samples, snapshot.size());
+  EXPECT_EQ(samples.front(), snapshot.front().first);
+  EXPECT_EQ(2, snapshot.front().second);
+  EXPECT_EQ(Counter::kOtherSample, snapshot.back().first);
+  EXPECT_EQ(6, snapshot.back().second)
+      << "Samples after " << max_samples - 1
+      << " samples are counted as other.";
+}
+
+}  // namespace metrics
@@ -0,0 +1,209 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/metrics/histogram.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "base/bits.h"
+#include "base/logging.h"
+#include "base/strings/utf_string_conversions.h"
+#include "evita/metrics/thread_shard.h"
+
+namespace metrics {
+
+namespace {
+
+const int kSubBucketBits = 4;
+static_assert(1 << kSubBucketBits == Histogram::kNumberOfSubBuckets,
+              "kSubBucketBits must match kNumberOfSubBuckets");
+
+// Values in [0, 2 * kNumberOfSubBuckets) have their own buckets, and each
+// range [2^k, 2^(k+1)) for k in [kSubBucketBits + 1, 30] has
+// |kNumberOfSubBuckets| buckets.
+const size_t kNumberOfBuckets =
+    Histogram::kNumberOfSubBuckets * (32 - kSubBucketBits);
+
+void UpdateMaximum(std::atomic<int>* maximum, int value) {
+  auto current = maximum->load(std::memory_order_relaxed);
+  while (current < value &&
+         !maximum->compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+void UpdateMinimum(std::atomic<int>* minimum, int value) {
+  auto current = minimum->load(std::memory_order_relaxed);
+  while (current > value &&
+         !minimum->compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// Histogram::Shard
+//
+// Shards are aligned to cache line to avoid false sharing between threads.
+//
+struct alignas(64) Histogram::Shard {
+  Shard() : count(0), maximum(0), minimum(std::numeric_limits<int>::max()),
+            sum(0) {
+    for (auto& bucket : buckets)
+      bucket.store(0, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint32_t> buckets[kNumberOfBuckets];
+  std::atomic<int64_t> count;
+  std::atomic<int> maximum;
+  std::atomic<int> minimum;
+  std::atomic<int64_t> sum;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// Histogram::Snapshot
+//
+Histogram::Snapshot::Snapshot() : count(0), maximum(0), minimum(0), sum(0) {}
+Histogram::Snapshot::Snapshot(const Snapshot& other) = default;
+Histogram::Snapshot::~Snapshot() {}
+
+int Histogram::Snapshot::ValueAtPercentile(double percentile) const {
+  if (count == 0)
+    return 0;
+  const auto rank = static_cast<int64_t>(
+      std::ceil(count * std::min(std::max(percentile, 0.0), 100.0) / 100));
+  auto total = int64_t(0);
+  for (const auto& bucket : buckets) {
+    total += bucket.second;
+    if (total >= rank)
+      return std::min(std::max(bucket.first, minimum), maximum);
+  }
+  return maximum;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// Histogram
+//
+Histogram::Histogram(const base::StringPiece& name)
+    : name_(name), shards_(new Shard[kNumberOfThreadShards]) {}
+
+Histogram::~Histogram() {}
+
+void Histogram::AddSample(int value) {
+  value = std::max(value, 0);
+  auto& shard = shards_[ThreadShardIndex()];
+  shard.buckets[BucketIndexOf(value)].fetch_add(1, std::memory_order_relaxed);
+  shard.count.fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(value, std::memory_order_relaxed);
+  UpdateMaximum(&shard.maximum, value);
+  UpdateMinimum(&shard.minimum, value);
+}
+
+// static
+size_t Histogram::BucketIndexOf(int value) {
+  DCHECK_GE(value, 0);
+  if (value < kNumberOfSubBuckets * 2)
+    return static_cast<size_t>(value);
+  const auto exponent = base::bits::Log2Floor(static_cast<uint32_t>(value));
+  const auto shift = exponent - kSubBucketBits;
+  const auto sub_bucket = (value >> shift) & (kNumberOfSubBuckets - 1);
+  return static_cast<size_t>(kNumberOfSubBuckets * shift + kNumberOfSubBuckets +
+                             sub_bucket);
+}
+
+// static
+int Histogram::BucketLowerBoundOf(size_t index) {
+  DCHECK_LT(index, kNumberOfBuckets);
+  if (index < kNumberOfSubBuckets * 2)
+    return static_cast<int>(index);
+  const auto shift = static_cast<int>(index / kNumberOfSubBuckets) - 1;
+  const auto sub_bucket = static_cast<int>(index % kNumberOfSubBuckets);
+  return (kNumberOfSubBuckets + sub_bucket) << shift;
+}
+
+Histogram::Snapshot Histogram::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.minimum = std::numeric_limits<int>::max();
+  for (auto index = 0u; index < kNumberOfBuckets; ++index) {
+    auto count = int64_t(0);
+    for (auto shard = 0u; shard < kNumberOfThreadShards; ++shard)
+      count += shards_[shard].buckets[index].load(std::memory_order_relaxed);
+    if (count)
+      snapshot.buckets.push_back(std::make_pair(BucketLowerBoundOf(index),
+                                                count));
+  }
+  for (auto index = 0u; index < kNumberOfThreadShards; ++index) {
+    const auto& shard = shards_[index];
+    snapshot.count += shard.count.load(std::memory_order_relaxed);
+    snapshot.maximum = std::max(snapshot.maximum,
+                                shard.maximum.load(std::memory_order_relaxed));
+    snapshot.minimum = std::min(snapshot.minimum,
+                                shard.minimum.load(std::memory_order_relaxed));
+    snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  if (snapshot.count == 0)
+    snapshot.minimum = 0;
+  return snapshot;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// HistogramSet
+//
+HistogramSet::HistogramSet() {}
+
+HistogramSet::~HistogramSet() {}
+
+Histogram* HistogramSet::GetOrCreate(const base::StringPiece& name) {
+  base::AutoLock lock_scope(lock_);
+  auto const it = map_.find(name);
+  if (it != map_.end())
+    return it->second;
+  auto const histogram = new Histogram(name);
+  map_[name] = histogram;
+  return histogram;
+}
+
+base::string16 HistogramSet::GetJson(const base::string16& name) const {
+  if (name != L"all")
+    return base::string16();
+  std::basic_ostringstream<base::char16> ostream;
+  ostream << '{';
+  const base::string16 comma = L",\n";
+  base::string16 delimiter = L"";
+  base::AutoLock lock_scope(lock_);
+  for (auto it : map_) {
+    const auto& snapshot = it.second->GetSnapshot();
+    ostream << delimiter << '"' << base::ASCIIToUTF16(it.first) << L"\": {"
+            << L"\"count\": " << snapshot.count << L", "
+            << L"\"sum\": " << snapshot.sum << L", "
+            << L"\"min\": " << snapshot.minimum << L", "
+            << L"\"p50\": " << snapshot.ValueAtPercentile(50) << L", "
+            << L"\"p95\": " << snapshot.ValueAtPercentile(95) << L", "
+            << L"\"p99\": " << snapshot.ValueAtPercentile(99) << L", "
+            << L"\"max\": " << snapshot.maximum << L", "
+            << L"\"buckets\": [";
+    base::string16 delimiter2 = L"";
+    for (const auto& bucket : snapshot.buckets) {
+      ostream << delimiter2;
+      ostream << L"{\"key\": " << bucket.first << L", " << L"\"value\": "
+              << bucket.second << '}';
+      delimiter2 = comma;
+    }
+    ostream << L"]}";
+    delimiter = comma;
+  }
+  ostream << '}';
+  return ostream.str();
+}
+
+}  // namespace metrics
@@ -0,0 +1,113 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_METRICS_HISTOGRAM_H_
+#define EVITA_METRICS_HISTOGRAM_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "common/memory/singleton.h"
+
+namespace metrics {
+
+//////////////////////////////////////////////////////////////////////
+//
+// Histogram
+//
+// |Histogram| is a log-linear histogram of non-negative integers, a.k.a. HDR
+// histogram. Values less than |kNumberOfSubBuckets * 2| are recorded exactly,
+// and each range [2^k, 2^(k+1)) of larger values is divided into
+// |kNumberOfSubBuckets| buckets, so relative error of percentiles is at most
+// 1/|kNumberOfSubBuckets|.
+//
+// |AddSample()| is lock-free and can be called from any thread.
+//
+class Histogram final {
+ public:
+  // Aggregated values of histogram at a point in time.
+  struct Snapshot {
+    Snapshot();
+    Snapshot(const Snapshot& other);
+    ~Snapshot();
+
+    // Returns lower bound of the bucket containing |percentile| in
+    // [0, 100] of samples.
+    int ValueAtPercentile(double percentile) const;
+
+    // Pairs of lower bound of bucket and number of samples in bucket.
+    std::vector<std::pair<int, int64_t>> buckets;
+    int64_t count;
+    int maximum;
+    int minimum;
+    int64_t sum;
+  };
+
+  static const int kNumberOfSubBuckets = 16;
+
+  explicit Histogram(const base::StringPiece& name);
+  ~Histogram();
+
+  base::StringPiece name() const { return name_; }
+
+  void AddSample(int value);
+  Snapshot GetSnapshot() const;
+
+  static size_t BucketIndexOf(int value);
+  static int BucketLowerBoundOf(size_t index);
+
+ private:
+  struct Shard;
+
+  base::StringPiece name_;
+  std::unique_ptr<Shard[]> shards_;
+
+  DISALLOW_COPY_AND_ASSIGN(Histogram);
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// HistogramSet
+//
+// Hot paths should cache a histogram returned by |GetOrCreate()|, e.g. in
+// function local static variable, since histograms live forever.
+//
+class HistogramSet final : public common::Singleton<HistogramSet> {
+  DECLARE_SINGLETON_CLASS(HistogramSet);
+
+ public:
+  ~HistogramSet();
+
+  Histogram* GetOrCreate(const base::StringPiece& name);
+  base::string16 GetJson(const base::string16& name) const;
+
+ private:
+  HistogramSet();
+
+  mutable base::Lock lock_;
+  std::unordered_map<base::StringPiece, Histogram*, base::StringPieceHash> map_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramSet);
+};
+
+}  // namespace metrics
+
+// Adds |sample| to histogram |name| without looking up histogram by name
+// except for the first time.
+#define METRICS_HISTOGRAM_ADD(name, sample)                          \
+  do {                                                               \
+    static auto* const metrics_histogram =                           \
+        ::metrics::HistogramSet::instance()->GetOrCreate(name);      \
+    metrics_histogram->AddSample(sample);                            \
+  } while (false)
+
+#endif  // EVITA_METRICS_HISTOGRAM_H_
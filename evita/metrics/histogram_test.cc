@@ -0,0 +1,82 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <limits>
+
+#include "evita/metrics/histogram.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace metrics {
+
+TEST(HistogramTest, AddSample) {
+  Histogram histogram("test");
+  histogram.AddSample(3);
+  histogram.AddSample(-1);
+  histogram.AddSample(100);
+  histogram.AddSample(3);
+
+  const auto& snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(4, snapshot.count);
+  EXPECT_EQ(100, snapshot.maximum);
+  EXPECT_EQ(0, snapshot.minimum) << "Negative value is recorded as zero.";
+  EXPECT_EQ(106, snapshot.sum);
+  ASSERT_EQ(3u, snapshot.buckets.size());
+  EXPECT_EQ(std::make_pair(0, int64_t(1)), snapshot.buckets[0]);
+  EXPECT_EQ(std::make_pair(3, int64_t(2)), snapshot.buckets[1]);
+  EXPECT_EQ(std::make_pair(100, int64_t(1)), snapshot.buckets[2]);
+}
+
+TEST(HistogramTest, BucketIndexOf) {
+  EXPECT_EQ(0u, Histogram::BucketIndexOf(0));
+  EXPECT_EQ(31u, Histogram::BucketIndexOf(31));
+  EXPECT_EQ(32u, Histogram::BucketIndexOf(32));
+  EXPECT_EQ(32u, Histogram::BucketIndexOf(33));
+  EXPECT_EQ(33u, Histogram::BucketIndexOf(34));
+  EXPECT_EQ(47u, Histogram::BucketIndexOf(63));
+  EXPECT_EQ(48u, Histogram::BucketIndexOf(64));
+  EXPECT_EQ(48u, Histogram::BucketIndexOf(67));
+  EXPECT_EQ(49u, Histogram::BucketIndexOf(68));
+  EXPECT_EQ(447u, Histogram::BucketIndexOf(std::numeric_limits<int>::max()));
+}
+
+TEST(HistogramTest, BucketLowerBoundOf) {
+  EXPECT_EQ(0, Histogram::BucketLowerBoundOf(0));
+  EXPECT_EQ(31, Histogram::BucketLowerBoundOf(31));
+  EXPECT_EQ(32, Histogram::BucketLowerBoundOf(32));
+  EXPECT_EQ(34, Histogram::BucketLowerBoundOf(33));
+  EXPECT_EQ(62, Histogram::BucketLowerBoundOf(47));
+  EXPECT_EQ(64, Histogram::BucketLowerBoundOf(48));
+  EXPECT_EQ(68, Histogram::BucketLowerBoundOf(49));
+  EXPECT_EQ(31 << 26, Histogram::BucketLowerBoundOf(447));
+
+  // Lower bound of bucket is mapped to the bucket and a value just below it
+  // is mapped to the previous bucket.
+  for (auto index = 1u; index < 448u; ++index) {
+    const auto lower_bound = Histogram::BucketLowerBoundOf(index);
+    EXPECT_EQ(index, Histogram::BucketIndexOf(lower_bound)) << lower_bound;
+    EXPECT_EQ(index - 1, Histogram::BucketIndexOf(lower_bound - 1))
+        << lower_bound;
+  }
+}
+
+TEST(HistogramTest, ValueAtPercentile) {
+  Histogram histogram("test");
+  EXPECT_EQ(0, histogram.GetSnapshot().ValueAtPercentile(50));
+
+  for (auto value = 1; value <= 100; ++value)
+    histogram.AddSample(value);
+  const auto& snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(1, snapshot.ValueAtPercentile(0));
+  EXPECT_EQ(10, snapshot.ValueAtPercentile(10));
+  EXPECT_EQ(50, snapshot.ValueAtPercentile(50));
+  // 95 is in bucket [92, 96).
+  EXPECT_EQ(92, snapshot.ValueAtPercentile(95));
+  // 99 is in bucket [96, 100).
+  EXPECT_EQ(96, snapshot.ValueAtPercentile(99));
+  EXPECT_EQ(100, snapshot.ValueAtPercentile(100));
+  EXPECT_EQ(100, snapshot.ValueAtPercentile(200));
+}
+
+}  // namespace metrics
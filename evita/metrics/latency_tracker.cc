@@ -0,0 +1,280 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include "evita/metrics/latency_tracker.h"
+
+#include "base/logging.h"
+#include "base/strings/utf_string_conversions.h"
+#include "evita/metrics/counter.h"
+#include "evita/metrics/histogram.h"
+
+namespace metrics {
+
+namespace {
+
+// Events not reaching screen in |kMaxLatencySeconds|, e.g. events changing
+// hidden window, are abandoned.
+const int kMaxLatencySeconds = 5;
+
+// Number of events in flight. We don't track events beyond this.
+const size_t kMaxPendingRecords = 256;
+
+// Number of committed events kept for trace export.
+const size_t kMaxRecords = 1024;
+
+// |kStageNames[i]| is the name of duration between stamp |i - 1| and |i|.
+const char* const kStageNames[] = {
+    "Total", "Queue", "Script", "Wait", "Layout", "Paint", "Commit",
+};
+
+const char* const kHistogramNames[] = {
+    "InputLatency.Total",  "InputLatency.Queue",  "InputLatency.Script",
+    "InputLatency.Wait",   "InputLatency.Layout", "InputLatency.Paint",
+    "InputLatency.Commit",
+};
+
+int64_t ToMicroseconds(const base::TimeTicks& time_ticks) {
+  return (time_ticks - base::TimeTicks()).InMicroseconds();
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// LatencyTracker::DispatchScope
+//
+LatencyTracker::DispatchScope::DispatchScope(int event_id)
+    : event_id_(event_id) {
+  LatencyTracker::instance()->DidStartDispatch(event_id_);
+}
+
+LatencyTracker::DispatchScope::~DispatchScope() {
+  LatencyTracker::instance()->DidFinishDispatch(event_id_);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LatencyTracker::LayoutScope
+//
+LatencyTracker::LayoutScope::LayoutScope(int window_id, int frame_id)
+    : frame_id_(frame_id), window_id_(window_id) {
+  LatencyTracker::instance()->DidStartLayout(window_id_, frame_id_);
+}
+
+LatencyTracker::LayoutScope::~LayoutScope() {
+  LatencyTracker::instance()->DidFinishLayout(window_id_, frame_id_);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// LatencyTracker
+//
+LatencyTracker::LatencyTracker() {
+  static_assert(arraysize(kStageNames) == kNumberOfStamps,
+                "kStageNames should have an entry for each stamp.");
+  static_assert(arraysize(kHistogramNames) == kNumberOfStamps,
+                "kHistogramNames should have an entry for each stamp.");
+  for (const auto& name : kHistogramNames)
+    histograms_.push_back(HistogramSet::instance()->GetOrCreate(name));
+}
+
+LatencyTracker::~LatencyTracker() {}
+
+void LatencyTracker::DidCommitFrame() {
+  const auto now = base::TimeTicks::Now();
+  base::AutoLock lock_scope(lock_);
+  if (pending_records_.empty())
+    return;
+  StampAllLocked(Stamp::Committed, now);
+  const auto it = std::remove_if(
+      pending_records_.begin(), pending_records_.end(),
+      [this, now](const Record& record) {
+        if (record.num_stamps == kNumberOfStamps) {
+          RecordLocked(record);
+          METRICS_COUNTER_ADD("InputLatency", "committed");
+          return true;
+        }
+        if ((now - record.stamps[0]).InSeconds() < kMaxLatencySeconds)
+          return false;
+        METRICS_COUNTER_ADD("InputLatency", "abandoned");
+        return true;
+      });
+  pending_records_.erase(it, pending_records_.end());
+}
+
+void LatencyTracker::DidCreateEvent(int event_id,
+                                    const char* type,
+                                    const base::TimeTicks& time_stamp) {
+  base::AutoLock lock_scope(lock_);
+  if (pending_records_.size() == kMaxPendingRecords) {
+    METRICS_COUNTER_ADD("InputLatency", "dropped");
+    return;
+  }
+  Record record;
+  record.event_id = event_id;
+  record.frame_id = 0;
+  record.num_stamps = 1;
+  record.stamps[0] = time_stamp;
+  record.type = type;
+  record.window_id = 0;
+  pending_records_.push_back(record);
+}
+
+void LatencyTracker::DidFinishDispatch(int event_id) {
+  StampEvent(event_id, Stamp::DispatchFinished);
+  base::AutoLock lock_scope(lock_);
+  is_dispatching_ = false;
+  const auto it = std::find_if(pending_records_.begin(),
+                               pending_records_.end(),
+                               [event_id](const Record& record) {
+                                 return record.event_id == event_id;
+                               });
+  if (it == pending_records_.end() || it->frame_id)
+    return;
+  METRICS_COUNTER_ADD("InputLatency", "no_frame");
+  pending_records_.erase(it);
+}
+
+void LatencyTracker::DidFinishLayout(int window_id, int frame_id) {
+  const auto now = base::TimeTicks::Now();
+  base::AutoLock lock_scope(lock_);
+  StampFrameLocked(Stamp::LayoutFinished, window_id, frame_id, now);
+}
+
+void LatencyTracker::DidPaint(int window_id) {
+  const auto now = base::TimeTicks::Now();
+  base::AutoLock lock_scope(lock_);
+  StampFrameLocked(Stamp::Painted, window_id, std::numeric_limits<int>::max(),
+                   now);
+}
+
+void LatencyTracker::DidRequestFrame(int window_id, int frame_id) {
+  DCHECK_GT(frame_id, 0);
+  base::AutoLock lock_scope(lock_);
+  if (!is_dispatching_)
+    return;
+  for (auto& record : pending_records_) {
+    if (record.event_id != dispatching_event_id_)
+      continue;
+    // The first window changed by the event is consumer of the event.
+    if (record.frame_id)
+      return;
+    record.frame_id = frame_id;
+    record.window_id = window_id;
+    return;
+  }
+}
+
+void LatencyTracker::DidStartDispatch(int event_id) {
+  StampEvent(event_id, Stamp::DispatchStarted);
+  base::AutoLock lock_scope(lock_);
+  dispatching_event_id_ = event_id;
+  is_dispatching_ = true;
+}
+
+void LatencyTracker::DidStartLayout(int window_id, int frame_id) {
+  const auto now = base::TimeTicks::Now();
+  base::AutoLock lock_scope(lock_);
+  StampFrameLocked(Stamp::LayoutStarted, window_id, frame_id, now);
+}
+
+base::string16 LatencyTracker::GetJson(const base::string16& name) const {
+  if (name != L"latency")
+    return base::string16();
+  std::basic_ostringstream<base::char16> ostream;
+  ostream << L"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  base::string16 delimiter = L"";
+  const base::string16 comma = L",\n";
+  const auto& print_event = [&](const char* event_name, int event_id,
+                                const base::TimeTicks& time_stamp,
+                                char phase) {
+    ostream << delimiter << L"{\"cat\": \"input\", \"id\": \"" << event_id
+            << L"\", \"name\": \"" << base::ASCIIToUTF16(event_name)
+            << L"\", \"ph\": \"" << phase << L"\", \"pid\": 0, \"tid\": 0, "
+            << L"\"ts\": " << ToMicroseconds(time_stamp) << '}';
+    delimiter = comma;
+  };
+  base::AutoLock lock_scope(lock_);
+  for (auto count = 0u; count < records_.size(); ++count) {
+    const auto& record =
+        records_[(next_record_index_ + count) % records_.size()];
+    print_event(record.type, record.event_id, record.stamps[0], 'b');
+    for (auto index = 1u; index < kNumberOfStamps; ++index) {
+      print_event(kStageNames[index], record.event_id,
+                  record.stamps[index - 1], 'b');
+      print_event(kStageNames[index], record.event_id, record.stamps[index],
+                  'e');
+    }
+    print_event(record.type, record.event_id,
+                record.stamps[kNumberOfStamps - 1], 'e');
+  }
+  ostream << L"]}";
+  return ostream.str();
+}
+
+void LatencyTracker::RecordLocked(const Record& record) {
+  lock_.AssertAcquired();
+  DCHECK_EQ(kNumberOfStamps, record.num_stamps);
+  for (auto index = 1u; index < kNumberOfStamps; ++index) {
+    const auto& delta = record.stamps[index] - record.stamps[index - 1];
+    histograms_[index]->AddSample(static_cast<int>(delta.InMicroseconds()));
+  }
+  const auto& total = record.stamps[kNumberOfStamps - 1] - record.stamps[0];
+  histograms_[0]->AddSample(static_cast<int>(total.InMicroseconds()));
+  if (records_.size() < kMaxRecords) {
+    records_.push_back(record);
+    return;
+  }
+  records_[next_record_index_] = record;
+  next_record_index_ = (next_record_index_ + 1) % records_.size();
+}
+
+// Stamps records waiting for |stamp|.
+void LatencyTracker::StampAllLocked(Stamp stamp, const base::TimeTicks& now) {
+  lock_.AssertAcquired();
+  const auto index = static_cast<size_t>(stamp);
+  for (auto& record : pending_records_) {
+    if (record.num_stamps != index)
+      continue;
+    record.stamps[index] = now;
+    ++record.num_stamps;
+  }
+}
+
+void LatencyTracker::StampFrameLocked(Stamp stamp,
+                                      int window_id,
+                                      int frame_id,
+                                      const base::TimeTicks& now) {
+  lock_.AssertAcquired();
+  const auto index = static_cast<size_t>(stamp);
+  for (auto& record : pending_records_) {
+    if (record.num_stamps != index || !record.frame_id ||
+        record.window_id != window_id || record.frame_id > frame_id) {
+      continue;
+    }
+    record.stamps[index] = now;
+    ++record.num_stamps;
+  }
+}
+
+void LatencyTracker::StampEvent(int event_id, Stamp stamp) {
+  const auto now = base::TimeTicks::Now();
+  const auto index = static_cast<size_t>(stamp);
+  base::AutoLock lock_scope(lock_);
+  for (auto& record : pending_records_) {
+    if (record.event_id != event_id)
+      continue;
+    if (record.num_stamps != index)
+      return;
+    record.stamps[index] = now;
+    ++record.num_stamps;
+    return;
+  }
+}
+
+}  // namespace metrics
@@ -0,0 +1,146 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_METRICS_LATENCY_TRACKER_H_
+#define EVITA_METRICS_LATENCY_TRACKER_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "common/memory/singleton.h"
+
+namespace metrics {
+
+class Histogram;
+
+//////////////////////////////////////////////////////////////////////
+//
+// LatencyTracker
+//
+// |LatencyTracker| measures input-to-pixels latency of input events. An input
+// event is stamped at creation on UI thread, then on start and finish of
+// dispatching in script thread, then on start and finish of layout of the
+// frame of text window which the event changes, then on painting the window
+// on UI thread, and finally on committing the painted frame to compositor.
+//
+// An event is consumed by a frame when the window requests the frame during
+// dispatching the event, see |DidRequestFrame()|. Events which don't request
+// any frame, e.g. key strokes which don't change anything, are expired at
+// end of dispatching rather than being charged to unrelated frames.
+//
+// Durations between stamps are recorded in histograms named
+// "InputLatency.<Stage>" in microseconds, and stamps of recently committed
+// events are kept for exporting as Chrome trace event JSON.
+//
+// All member functions can be called on any thread.
+//
+class LatencyTracker final : public common::Singleton<LatencyTracker> {
+  DECLARE_SINGLETON_CLASS(LatencyTracker);
+
+ public:
+  // Stamps |event_id| during dispatching it in script thread.
+  class DispatchScope final {
+   public:
+    explicit DispatchScope(int event_id);
+    ~DispatchScope();
+
+   private:
+    int const event_id_;
+
+    DISALLOW_COPY_AND_ASSIGN(DispatchScope);
+  };
+
+  // Stamps events consumed by frame |frame_id| of window |window_id| or
+  // earlier frames of the window, which are coalesced into |frame_id|,
+  // during layout of the frame.
+  class LayoutScope final {
+   public:
+    LayoutScope(int window_id, int frame_id);
+    ~LayoutScope();
+
+   private:
+    int const frame_id_;
+    int const window_id_;
+
+    DISALLOW_COPY_AND_ASSIGN(LayoutScope);
+  };
+
+  ~LatencyTracker();
+
+  void DidCommitFrame();
+  void DidCreateEvent(int event_id,
+                      const char* type,
+                      const base::TimeTicks& time_stamp);
+  void DidFinishDispatch(int event_id);
+  void DidFinishLayout(int window_id, int frame_id);
+  void DidPaint(int window_id);
+  // Called when window |window_id| requests frame |frame_id|, which is
+  // positive and increasing for each window. The event being dispatched, if
+  // any, is consumed by the frame.
+  void DidRequestFrame(int window_id, int frame_id);
+  void DidStartDispatch(int event_id);
+  void DidStartLayout(int window_id, int frame_id);
+
+  // Returns recently committed events in Chrome trace event format for
+  // |name| "latency", or empty string for other names.
+  base::string16 GetJson(const base::string16& name) const;
+
+ private:
+  friend class LatencyTrackerTest;
+
+  enum class Stamp {
+    Created,
+    DispatchStarted,
+    DispatchFinished,
+    LayoutStarted,
+    LayoutFinished,
+    Painted,
+    Committed,
+  };
+
+  static const size_t kNumberOfStamps =
+      static_cast<size_t>(Stamp::Committed) + 1;
+
+  struct Record {
+    int event_id;
+    // Frame consuming this event, or zero if this event doesn't request
+    // frame yet.
+    int frame_id;
+    size_t num_stamps;
+    base::TimeTicks stamps[kNumberOfStamps];
+    const char* type;
+    int window_id;
+  };
+
+  LatencyTracker();
+
+  void RecordLocked(const Record& record);
+  void StampAllLocked(Stamp stamp, const base::TimeTicks& now);
+  void StampEvent(int event_id, Stamp stamp);
+  // Stamps records consumed by frame |frame_id| or earlier frames of window
+  // |window_id|.
+  void StampFrameLocked(Stamp stamp,
+                        int window_id,
+                        int frame_id,
+                        const base::TimeTicks& now);
+
+  // Event being dispatched on script thread, valid if |is_dispatching_|.
+  int dispatching_event_id_ = 0;
+  // Histograms of each stage and total latency.
+  std::vector<Histogram*> histograms_;
+  bool is_dispatching_ = false;
+  mutable base::Lock lock_;
+  size_t next_record_index_ = 0;
+  std::vector<Record> pending_records_;
+  std::vector<Record> records_;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyTracker);
+};
+
+}  // namespace metrics
+
+#endif  // EVITA_METRICS_LATENCY_TRACKER_H_
@@ -0,0 +1,140 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/metrics/latency_tracker.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace metrics {
+
+//////////////////////////////////////////////////////////////////////
+//
+// LatencyTrackerTest
+//
+class LatencyTrackerTest : public ::testing::Test {
+ protected:
+  LatencyTrackerTest() : tracker_(new LatencyTracker()) {}
+  ~LatencyTrackerTest() override = default;
+
+  LatencyTracker* tracker() const { return tracker_.get(); }
+
+  // Creates event |event_id| and dispatches it. During dispatching, the event
+  // requests frame |frame_id| of window |window_id| if |frame_id| is positive.
+  void DispatchEvent(int event_id, int window_id, int frame_id);
+  size_t NumberOfCommittedEvents() const;
+  size_t NumberOfPendingEvents() const;
+  // Returns number of stamps of pending event |event_id|, or zero if there is
+  // no such event.
+  size_t NumberOfStampsOf(int event_id) const;
+
+ private:
+  const std::unique_ptr<LatencyTracker> tracker_;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyTrackerTest);
+};
+
+void LatencyTrackerTest::DispatchEvent(int event_id,
+                                       int window_id,
+                                       int frame_id) {
+  tracker_->DidCreateEvent(event_id, "keydown", base::TimeTicks::Now());
+  tracker_->DidStartDispatch(event_id);
+  if (frame_id > 0)
+    tracker_->DidRequestFrame(window_id, frame_id);
+  tracker_->DidFinishDispatch(event_id);
+}
+
+size_t LatencyTrackerTest::NumberOfCommittedEvents() const {
+  return tracker_->records_.size();
+}
+
+size_t LatencyTrackerTest::NumberOfPendingEvents() const {
+  return tracker_->pending_records_.size();
+}
+
+size_t LatencyTrackerTest::NumberOfStampsOf(int event_id) const {
+  for (const auto& record : tracker_->pending_records_) {
+    if (record.event_id == event_id)
+      return record.num_stamps;
+  }
+  return 0;
+}
+
+TEST_F(LatencyTrackerTest, DidCommitFrame) {
+  DispatchEvent(1, 10, 1);
+  tracker()->DidStartLayout(10, 1);
+  tracker()->DidFinishLayout(10, 1);
+  tracker()->DidPaint(10);
+  EXPECT_EQ(6u, NumberOfStampsOf(1));
+
+  tracker()->DidCommitFrame();
+  EXPECT_EQ(0u, NumberOfPendingEvents());
+  EXPECT_EQ(1u, NumberOfCommittedEvents());
+  EXPECT_NE(base::string16::npos,
+            tracker()->GetJson(L"latency").find(L"\"id\": \"1\""));
+  EXPECT_EQ(base::string16(), tracker()->GetJson(L"all"));
+}
+
+TEST_F(LatencyTrackerTest, DidFinishDispatch) {
+  DispatchEvent(1, 10, 0);
+  EXPECT_EQ(0u, NumberOfPendingEvents())
+      << "Event which doesn't request frame is expired.";
+
+  tracker()->DidStartLayout(10, 1);
+  tracker()->DidFinishLayout(10, 1);
+  tracker()->DidPaint(10);
+  tracker()->DidCommitFrame();
+  EXPECT_EQ(0u, NumberOfCommittedEvents());
+}
+
+TEST_F(LatencyTrackerTest, DidPaint) {
+  DispatchEvent(1, 10, 1);
+  DispatchEvent(2, 20, 1);
+  tracker()->DidStartLayout(10, 1);
+  tracker()->DidFinishLayout(10, 1);
+  tracker()->DidStartLayout(20, 1);
+  tracker()->DidFinishLayout(20, 1);
+
+  tracker()->DidPaint(20);
+  tracker()->DidCommitFrame();
+  EXPECT_EQ(5u, NumberOfStampsOf(1)) << "Window 10 isn't painted yet.";
+  EXPECT_EQ(1u, NumberOfCommittedEvents());
+}
+
+TEST_F(LatencyTrackerTest, DidRequestFrame) {
+  tracker()->DidCreateEvent(1, "keydown", base::TimeTicks::Now());
+  tracker()->DidStartDispatch(1);
+  tracker()->DidRequestFrame(10, 1);
+  tracker()->DidRequestFrame(20, 1);
+  tracker()->DidFinishDispatch(1);
+
+  tracker()->DidRequestFrame(10, 2);
+  tracker()->DidStartLayout(20, 1);
+  EXPECT_EQ(3u, NumberOfStampsOf(1))
+      << "The first window requesting frame consumes the event.";
+  tracker()->DidStartLayout(10, 1);
+  EXPECT_EQ(4u, NumberOfStampsOf(1))
+      << "Requesting frame after dispatching doesn't change consumer.";
+}
+
+TEST_F(LatencyTrackerTest, DidStartLayout) {
+  DispatchEvent(1, 10, 1);
+  DispatchEvent(2, 10, 2);
+  DispatchEvent(3, 20, 1);
+
+  tracker()->DidStartLayout(10, 1);
+  EXPECT_EQ(4u, NumberOfStampsOf(1));
+  EXPECT_EQ(3u, NumberOfStampsOf(2)) << "Event 2 is consumed by frame 2.";
+  EXPECT_EQ(3u, NumberOfStampsOf(3)) << "Event 3 is consumed by window 20.";
+
+  tracker()->DidFinishLayout(10, 1);
+  tracker()->DidStartLayout(10, 3);
+  EXPECT_EQ(5u, NumberOfStampsOf(1)) << "Event 1 is already laid out.";
+  EXPECT_EQ(4u, NumberOfStampsOf(2))
+      << "Frame 3 contains changes of frame 2, e.g. frame 2 is skipped.";
+  EXPECT_EQ(3u, NumberOfStampsOf(3));
+}
+
+}  // namespace metrics
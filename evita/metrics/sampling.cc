@@ -8,21 +8,30 @@
 
 namespace metrics {
 
-Sampling::Sampling(size_t max_samples)
-    : max_samples_(max_samples), samples_(max_samples) {
+Sampling::Sampling(size_t max_samples) : oldest_(0), samples_(max_samples) {
   maximum_ = minimum_ = samples_.front();
 }
 
 Sampling::~Sampling() {}
 
+float Sampling::last() const {
+  return samples_[(oldest_ + samples_.size() - 1) % samples_.size()];
+}
+
+std::vector<float> Sampling::samples() const {
+  std::vector<float> samples(samples_.begin() + oldest_, samples_.end());
+  samples.insert(samples.end(), samples_.begin(), samples_.begin() + oldest_);
+  return samples;
+}
+
 void Sampling::AddSample(base::TimeDelta sample) {
   AddSample(static_cast<float>(sample.InMillisecondsF()));
 }
 
 void Sampling::AddSample(float sample) {
-  auto const discard_sample = samples_.front();
-  samples_.pop_front();
-  samples_.push_back(sample);
+  auto const discard_sample = samples_[oldest_];
+  samples_[oldest_] = sample;
+  oldest_ = (oldest_ + 1) % samples_.size();
   maximum_ = std::max(maximum_, sample);
   minimum_ = std::min(minimum_, sample);
   if (discard_sample != maximum_ && discard_sample != minimum_)
@@ -5,7 +5,7 @@
 #ifndef EVITA_METRICS_SAMPLING_H_
 #define EVITA_METRICS_SAMPLING_H_
 
-#include <list>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/time/time.h"
@@ -16,15 +16,18 @@ namespace metrics {
 //
 // Sampling
 //
+// |Sampling| keeps the last |max_samples| samples in a ring buffer.
+//
 class Sampling final {
  public:
   explicit Sampling(size_t max_samples = 100);
   ~Sampling();
 
-  float last() const { return samples_.back(); }
+  float last() const;
   float maximum() const { return maximum_; }
   float minimum() const { return minimum_; }
-  const std::list<float> samples() const { return samples_; }
+  // Returns samples from oldest to newest.
+  std::vector<float> samples() const;
 
   void AddSample(base::TimeDelta sample);
   void AddSample(float sample);
@@ -35,8 +38,9 @@ class Sampling final {
  private:
   float maximum_;
   float minimum_;
-  size_t max_samples_;
-  std::list<float> samples_;
+  // Index of the oldest sample in |samples_|.
+  size_t oldest_;
+  std::vector<float> samples_;
 
   DISALLOW_COPY_AND_ASSIGN(Sampling);
 };
@@ -0,0 +1,46 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "evita/metrics/sampling.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace metrics {
+
+TEST(SamplingTest, AddSample) {
+  Sampling sampling(3);
+  EXPECT_EQ(std::vector<float>({0, 0, 0}), sampling.samples());
+
+  sampling.AddSample(1.0f);
+  sampling.AddSample(2.0f);
+  EXPECT_EQ(std::vector<float>({0, 1, 2}), sampling.samples());
+  EXPECT_EQ(2.0f, sampling.last());
+  EXPECT_EQ(2.0f, sampling.maximum());
+  EXPECT_EQ(0.0f, sampling.minimum());
+
+  // Discarding the oldest sample updates minimum.
+  sampling.AddSample(3.0f);
+  sampling.AddSample(4.0f);
+  EXPECT_EQ(std::vector<float>({2, 3, 4}), sampling.samples());
+  EXPECT_EQ(4.0f, sampling.last());
+  EXPECT_EQ(4.0f, sampling.maximum());
+  EXPECT_EQ(2.0f, sampling.minimum());
+
+  sampling.AddSample(base::TimeDelta::FromMilliseconds(1));
+  EXPECT_EQ(std::vector<float>({3, 4, 1}), sampling.samples());
+  EXPECT_EQ(1.0f, sampling.last());
+  EXPECT_EQ(4.0f, sampling.maximum());
+  EXPECT_EQ(1.0f, sampling.minimum());
+
+  // Discarding the maximum sample updates maximum.
+  sampling.AddSample(0.5f);
+  sampling.AddSample(0.25f);
+  EXPECT_EQ(std::vector<float>({1, 0.5f, 0.25f}), sampling.samples());
+  EXPECT_EQ(1.0f, sampling.maximum());
+  EXPECT_EQ(0.25f, sampling.minimum());
+}
+
+}  // namespace metrics
@@ -0,0 +1,17 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/metrics/thread_shard.h"
+
+#include "base/threading/platform_thread.h"
+
+namespace metrics {
+
+size_t ThreadShardIndex() {
+  // Thread ids on Windows are multiple of four.
+  return (static_cast<size_t>(base::PlatformThread::CurrentId()) >> 2) %
+         kNumberOfThreadShards;
+}
+
+}  // namespace metrics
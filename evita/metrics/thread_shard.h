@@ -0,0 +1,22 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_METRICS_THREAD_SHARD_H_
+#define EVITA_METRICS_THREAD_SHARD_H_
+
+#include <stddef.h>
+
+namespace metrics {
+
+// Number of shards of metrics. A thread updates metrics in its shard with
+// relaxed atomic operations to avoid contention with other threads, and
+// readers aggregate all shards.
+const size_t kNumberOfThreadShards = 8;
+
+// Returns index of shard for the current thread.
+size_t ThreadShardIndex();
+
+}  // namespace metrics
+
+#endif  // EVITA_METRICS_THREAD_SHARD_H_
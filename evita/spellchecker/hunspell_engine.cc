@@ -4,14 +4,22 @@
 
 #include <windows.h>
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <utility>
 
 #include "evita/spellchecker/hunspell_engine.h"
 
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/thread.h"
 #include "common/win/scoped_handle.h"
 #include "third_party/hunspell/src/hunspell/hunspell.hxx"
 
@@ -31,6 +39,42 @@ static_assert(kMaxSuggestLen <= kMaxCheckedLen, "MaxSuggestLen too long");
 
 // Max number of dictionary suggestions.
 const int kMaxSuggestions = 5;
+
+// Maximum number of hunspell instances in worker pool.
+const int kMaxNumberOfWorkers = 4;
+
+// Minimum number of words handled by one worker in |CheckSpellingBatch()|.
+// Small batches are checked on the calling thread to avoid thread hopping.
+const size_t kMinWordsPerWorker = 64;
+
+//////////////////////////////////////////////////////////////////////
+//
+// BatchBarrier
+//
+// Signals |event_| when all workers participating in a batch are finished.
+//
+class BatchBarrier final {
+ public:
+  explicit BatchBarrier(int count)
+      : count_(count),
+        event_(base::WaitableEvent::ResetPolicy::MANUAL,
+               base::WaitableEvent::InitialState::NOT_SIGNALED) {}
+  ~BatchBarrier() = default;
+
+  void Signal() {
+    if (--count_ == 0)
+      event_.Signal();
+  }
+
+  void Wait() { event_.Wait(); }
+
+ private:
+  std::atomic<int> count_;
+  base::WaitableEvent event_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchBarrier);
+};
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////
@@ -93,43 +137,65 @@ base::string16 HunspellEngine::Dictionary::GetFileName() {
 
 //////////////////////////////////////////////////////////////////////
 //
-// HunspellEngine
+// HunspellEngine::Worker
 //
-HunspellEngine::HunspellEngine() : lock_(new base::Lock()) {}
+// A |Worker| owns a |Hunspell| instance sharing dictionary data with other
+// workers. Since |Hunspell| isn't thread safe, each instance is guarded by
+// its own lock, and batch requests are processed on worker's thread.
+//
+class HunspellEngine::Worker final {
+ public:
+  Worker(const Dictionary& dictionary, int index);
+  ~Worker();
 
-HunspellEngine::~HunspellEngine() {}
+  bool CheckSpelling(const std::string& utf8_word_to_check);
+  void CheckWords(const std::vector<std::string>* utf8_words,
+                  size_t start,
+                  size_t end,
+                  std::vector<uint8_t>* results,
+                  BatchBarrier* barrier);
+  std::vector<base::string16> GetSpellingSuggestions(
+      const std::string& utf8_wrong_word);
+  void PostTask(const base::Location& from_here, const base::Closure& task);
 
-// spellchecker::SpellingEngine
-bool HunspellEngine::CheckSpelling(const base::string16& word_to_check) {
-  DCHECK(!word_to_check.empty());
-  if (!EnsureInitialized())
-    return true;
-  std::string utf8_word_to_check(base::UTF16ToUTF8(word_to_check));
-  if (utf8_word_to_check.size() > kMaxCheckedLen)
+ private:
+  std::unique_ptr<Hunspell> hunspell_;
+  base::Lock lock_;
+  base::Thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+HunspellEngine::Worker::Worker(const Dictionary& dictionary, int index)
+    : hunspell_(new Hunspell(dictionary.data(), dictionary.size())),
+      thread_(base::StringPrintf("spellchecker worker %d", index)) {}
+
+HunspellEngine::Worker::~Worker() {}
+
+bool HunspellEngine::Worker::CheckSpelling(
+    const std::string& utf8_word_to_check) {
+  if (utf8_word_to_check.empty() || utf8_word_to_check.size() > kMaxCheckedLen)
     return true;
+  base::AutoLock lock_scope(lock_);
   return hunspell_->spell(utf8_word_to_check.c_str()) != 0;
 }
 
-bool HunspellEngine::EnsureInitialized() {
-  if (hunspell_)
-    return true;
-  base::AutoLock lock_scope(*lock_);
-  if (dictionary_)
-    return dictionary_->is_valid();
-  dictionary_.reset(new Dictionary());
-  if (!dictionary_->is_valid())
-    return false;
-  hunspell_.reset(new Hunspell(dictionary_->data(), dictionary_->size()));
-  return true;
+void HunspellEngine::Worker::CheckWords(
+    const std::vector<std::string>* utf8_words,
+    size_t start,
+    size_t end,
+    std::vector<uint8_t>* results,
+    BatchBarrier* barrier) {
+  for (auto index = start; index < end; ++index)
+    (*results)[index] = CheckSpelling((*utf8_words)[index]);
+  if (barrier)
+    barrier->Signal();
 }
 
-std::vector<base::string16> HunspellEngine::GetSpellingSuggestions(
-    const base::string16& wrong_word) {
-  DCHECK(!wrong_word.empty());
-  if (!EnsureInitialized())
-    return std::vector<base::string16>();
-  std::string utf8_wrong_word(base::UTF16ToUTF8(wrong_word));
+std::vector<base::string16> HunspellEngine::Worker::GetSpellingSuggestions(
+    const std::string& utf8_wrong_word) {
   char** utf8_suggestions = nullptr;
+  base::AutoLock lock_scope(lock_);
   auto const num_suggestions =
       hunspell_->suggest(&utf8_suggestions, utf8_wrong_word.c_str());
   std::vector<base::string16> suggestions;
@@ -144,4 +210,92 @@ std::vector<base::string16> HunspellEngine::GetSpellingSuggestions(
   return std::move(suggestions);
 }
 
+void HunspellEngine::Worker::PostTask(const base::Location& from_here,
+                                      const base::Closure& task) {
+  if (!thread_.IsRunning())
+    CHECK(thread_.Start()) << "failed to start spellchecker worker";
+  thread_.task_runner()->PostTask(from_here, task);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// HunspellEngine
+//
+HunspellEngine::HunspellEngine()
+    : is_initialized_(false), lock_(new base::Lock()) {}
+
+HunspellEngine::~HunspellEngine() {}
+
+// spellchecker::SpellingEngine
+bool HunspellEngine::DoCheckSpelling(const base::string16& word_to_check) {
+  DCHECK(!word_to_check.empty());
+  return workers_.front()->CheckSpelling(base::UTF16ToUTF8(word_to_check));
+}
+
+std::vector<base::string16> HunspellEngine::DoCheckSpellingBatch(
+    const std::vector<base::string16>& words_to_check) {
+  DCHECK(!words_to_check.empty());
+  std::vector<std::string> utf8_words;
+  utf8_words.reserve(words_to_check.size());
+  for (const auto& word : words_to_check)
+    utf8_words.push_back(base::UTF16ToUTF8(word));
+
+  std::vector<uint8_t> results(utf8_words.size(), 1);
+  auto const num_workers =
+      std::min(workers_.size(),
+               (utf8_words.size() + kMinWordsPerWorker - 1) /
+                   kMinWordsPerWorker);
+  if (num_workers <= 1) {
+    workers_.front()->CheckWords(&utf8_words, 0, utf8_words.size(), &results,
+                                 nullptr);
+  } else {
+    auto const chunk_size = (utf8_words.size() + num_workers - 1) / num_workers;
+    BatchBarrier barrier(static_cast<int>(num_workers));
+    for (size_t index = 0; index < num_workers; ++index) {
+      auto const start = index * chunk_size;
+      auto const end = std::min(start + chunk_size, utf8_words.size());
+      auto const worker = workers_[index].get();
+      worker->PostTask(
+          FROM_HERE,
+          base::Bind(&Worker::CheckWords, base::Unretained(worker),
+                     base::Unretained(&utf8_words), start, end,
+                     base::Unretained(&results), base::Unretained(&barrier)));
+    }
+    barrier.Wait();
+  }
+
+  std::vector<base::string16> misspelled_words;
+  for (size_t index = 0; index < results.size(); ++index) {
+    if (results[index])
+      continue;
+    misspelled_words.push_back(words_to_check[index]);
+  }
+  return std::move(misspelled_words);
+}
+
+std::vector<base::string16> HunspellEngine::DoGetSpellingSuggestions(
+    const base::string16& wrong_word) {
+  DCHECK(!wrong_word.empty());
+  return workers_.front()->GetSpellingSuggestions(
+      base::UTF16ToUTF8(wrong_word));
+}
+
+bool HunspellEngine::EnsureInitialized() {
+  if (is_initialized_.load())
+    return true;
+  base::AutoLock lock_scope(*lock_);
+  if (dictionary_)
+    return dictionary_->is_valid();
+  dictionary_.reset(new Dictionary());
+  if (!dictionary_->is_valid())
+    return false;
+  auto const num_workers = std::max(
+      1, std::min(kMaxNumberOfWorkers, base::SysInfo::NumberOfProcessors() - 1));
+  for (auto index = 0; index < num_workers; ++index)
+    workers_.emplace_back(new Worker(*dictionary_, index));
+  DidChangeDictionary();
+  is_initialized_.store(true);
+  return true;
+}
+
 }  // namespace spellchecker
@@ -5,14 +5,13 @@
 #ifndef EVITA_SPELLCHECKER_HUNSPELL_ENGINE_H_
 #define EVITA_SPELLCHECKER_HUNSPELL_ENGINE_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
 #include "common/memory/singleton.h"
 #include "evita/spellchecker/spelling_engine.h"
 
-class Hunspell;
-
 namespace base {
 class Lock;
 }
@@ -25,20 +24,27 @@ class HunspellEngine final : public common::Singleton<HunspellEngine>,
 
  private:
   class Dictionary;
+  class Worker;
 
   HunspellEngine();
   ~HunspellEngine() final;
 
   // spellchecker::SpellingEngine
-  bool CheckSpelling(const base::string16& word_to_check) final;
-  bool EnsureInitialized() final;
-  std::vector<base::string16> GetSpellingSuggestions(
+  bool DoCheckSpelling(const base::string16& word_to_check) final;
+  std::vector<base::string16> DoCheckSpellingBatch(
+      const std::vector<base::string16>& words_to_check) final;
+  std::vector<base::string16> DoGetSpellingSuggestions(
       const base::string16& wrong_word) final;
+  bool EnsureInitialized() final;
 
   std::unique_ptr<Dictionary> dictionary_;
-  std::unique_ptr<Hunspell> hunspell_;
+  std::atomic<bool> is_initialized_;
   std::unique_ptr<base::Lock> lock_;
 
+  // Pool of hunspell instances sharing |dictionary_|. The first worker is
+  // also used for checking single word on the calling thread.
+  std::vector<std::unique_ptr<Worker>> workers_;
+
   DISALLOW_COPY_AND_ASSIGN(HunspellEngine);
 };
 
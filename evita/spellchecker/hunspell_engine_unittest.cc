@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #pragma warning(push)
 #pragma warning(disable : 4365 4625 4626 4826)
 #include "testing/gtest/include/gtest/gtest.h"
@@ -31,6 +33,24 @@ TEST_F(HunspellEngineTest, CheckSpelling) {
   EXPECT_FALSE(spelling_engine()->CheckSpelling(L"foobarbaz"));
 }
 
+TEST_F(HunspellEngineTest, CheckSpellingBatch) {
+  std::vector<base::string16> words;
+  for (auto index = 0; index < 500; ++index) {
+    words.push_back(L"word");
+    words.push_back(L"foobarbaz");
+  }
+  auto const misspelled_words = spelling_engine()->CheckSpellingBatch(words);
+  EXPECT_EQ(500u, misspelled_words.size());
+  for (const auto& word : misspelled_words)
+    EXPECT_EQ(L"foobarbaz", word);
+}
+
+TEST_F(HunspellEngineTest, CheckSpellingBatchEmpty) {
+  EXPECT_TRUE(
+      spelling_engine()->CheckSpellingBatch(std::vector<base::string16>())
+          .empty());
+}
+
 TEST_F(HunspellEngineTest, GetSpellingSuggestions) {
   auto const suggestions = spelling_engine()->GetSpellingSuggestions(L"wrod");
   EXPECT_EQ(5u, suggestions.size());
@@ -0,0 +1,166 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <list>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include "evita/spellchecker/spelling_cache.h"
+
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+
+namespace spellchecker {
+
+namespace {
+
+// Maximum number of words in suggestion table. Suggestions are requested
+// only by user, so we don't need to have many entries.
+const size_t kMaxSuggestionWords = 256;
+
+void StatsToJson(std::basic_ostringstream<base::char16>& ostream,  // NOLINT
+                 const base::char16* name,
+                 const SpellingCache::Stats& stats) {
+  ostream << '"' << name << L"\": {\"hits\": " << stats.num_hits
+          << L", \"misses\": " << stats.num_misses << L", \"size\": "
+          << stats.size << '}';
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// SpellingCache::Table
+//
+template <typename Value>
+class SpellingCache::Table final {
+ public:
+  explicit Table(size_t max_size);
+  ~Table() = default;
+
+  Stats stats() const { return {num_hits_, num_misses_, map_.size()}; }
+
+  void Clear();
+  base::Maybe<Value> Find(const base::string16& key);
+  void Set(const base::string16& key, const Value& value);
+
+ private:
+  using Entry = std::pair<base::string16, Value>;
+  using EntryList = std::list<Entry>;
+
+  // Most recently used entry is at front.
+  EntryList entries_;
+  std::unordered_map<base::string16, typename EntryList::iterator> map_;
+  const size_t max_size_;
+  int num_hits_ = 0;
+  int num_misses_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Table);
+};
+
+template <typename Value>
+SpellingCache::Table<Value>::Table(size_t max_size) : max_size_(max_size) {
+  DCHECK_GT(max_size_, 0u);
+}
+
+template <typename Value>
+void SpellingCache::Table<Value>::Clear() {
+  entries_.clear();
+  map_.clear();
+}
+
+template <typename Value>
+base::Maybe<Value> SpellingCache::Table<Value>::Find(
+    const base::string16& key) {
+  const auto& it = map_.find(key);
+  if (it == map_.end()) {
+    ++num_misses_;
+    return base::Nothing<Value>();
+  }
+  ++num_hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return base::Just(it->second->second);
+}
+
+template <typename Value>
+void SpellingCache::Table<Value>::Set(const base::string16& key,
+                                      const Value& value) {
+  const auto& it = map_.find(key);
+  if (it != map_.end()) {
+    it->second->second = value;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (map_.size() == max_size_) {
+    map_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, value);
+  map_.emplace(key, entries_.begin());
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// SpellingCache
+//
+SpellingCache::SpellingCache(size_t max_words)
+    : lock_(new base::Lock()),
+      suggestions_(new Table<std::vector<base::string16>>(
+          std::min(max_words, kMaxSuggestionWords))),
+      verdicts_(new Table<bool>(max_words)) {}
+
+SpellingCache::~SpellingCache() {}
+
+SpellingCache::Stats SpellingCache::check_stats() const {
+  base::AutoLock lock_scope(*lock_);
+  return verdicts_->stats();
+}
+
+SpellingCache::Stats SpellingCache::suggest_stats() const {
+  base::AutoLock lock_scope(*lock_);
+  return suggestions_->stats();
+}
+
+void SpellingCache::Clear() {
+  base::AutoLock lock_scope(*lock_);
+  suggestions_->Clear();
+  verdicts_->Clear();
+}
+
+base::Maybe<bool> SpellingCache::FindVerdict(const base::string16& word) {
+  base::AutoLock lock_scope(*lock_);
+  return verdicts_->Find(word);
+}
+
+base::Maybe<std::vector<base::string16>> SpellingCache::FindSuggestions(
+    const base::string16& word) {
+  base::AutoLock lock_scope(*lock_);
+  return suggestions_->Find(word);
+}
+
+base::string16 SpellingCache::GetJson() const {
+  std::basic_ostringstream<base::char16> ostream;
+  ostream << '{';
+  StatsToJson(ostream, L"check", check_stats());
+  ostream << L",\n";
+  StatsToJson(ostream, L"suggest", suggest_stats());
+  ostream << '}';
+  return ostream.str();
+}
+
+void SpellingCache::SetSuggestions(
+    const base::string16& word,
+    const std::vector<base::string16>& suggestions) {
+  base::AutoLock lock_scope(*lock_);
+  suggestions_->Set(word, suggestions);
+}
+
+void SpellingCache::SetVerdict(const base::string16& word, bool is_correct) {
+  base::AutoLock lock_scope(*lock_);
+  verdicts_->Set(word, is_correct);
+}
+
+}  // namespace spellchecker
@@ -0,0 +1,64 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_SPELLCHECKER_SPELLING_CACHE_H_
+#define EVITA_SPELLCHECKER_SPELLING_CACHE_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "evita/base/maybe.h"
+
+namespace base {
+class Lock;
+}
+
+namespace spellchecker {
+
+//////////////////////////////////////////////////////////////////////
+//
+// SpellingCache
+//
+// A thread safe, size bounded cache of spell checking results. Each table
+// evicts least recently used word when it is full.
+//
+class SpellingCache final {
+ public:
+  struct Stats {
+    int num_hits;
+    int num_misses;
+    size_t size;
+  };
+
+  explicit SpellingCache(size_t max_words);
+  ~SpellingCache();
+
+  Stats check_stats() const;
+  Stats suggest_stats() const;
+
+  void Clear();
+  base::Maybe<bool> FindVerdict(const base::string16& word);
+  base::Maybe<std::vector<base::string16>> FindSuggestions(
+      const base::string16& word);
+  base::string16 GetJson() const;
+  void SetSuggestions(const base::string16& word,
+                      const std::vector<base::string16>& suggestions);
+  void SetVerdict(const base::string16& word, bool is_correct);
+
+ private:
+  template <typename Value>
+  class Table;
+
+  std::unique_ptr<base::Lock> lock_;
+  std::unique_ptr<Table<std::vector<base::string16>>> suggestions_;
+  std::unique_ptr<Table<bool>> verdicts_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpellingCache);
+};
+
+}  // namespace spellchecker
+
+#endif  // EVITA_SPELLCHECKER_SPELLING_CACHE_H_
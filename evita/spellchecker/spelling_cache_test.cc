@@ -0,0 +1,59 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "evita/spellchecker/spelling_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace spellchecker {
+
+TEST(SpellingCacheTest, Clear) {
+  SpellingCache cache(10);
+  cache.SetVerdict(L"word", true);
+  cache.SetSuggestions(L"wrod", {L"word"});
+  cache.Clear();
+  EXPECT_TRUE(cache.FindVerdict(L"word").IsNothing());
+  EXPECT_TRUE(cache.FindSuggestions(L"wrod").IsNothing());
+  EXPECT_EQ(0u, cache.check_stats().size);
+  EXPECT_EQ(0u, cache.suggest_stats().size);
+}
+
+TEST(SpellingCacheTest, Evict) {
+  SpellingCache cache(2);
+  cache.SetVerdict(L"foo", true);
+  cache.SetVerdict(L"bar", false);
+  // Make "foo" most recently used.
+  EXPECT_EQ(base::Just(true), cache.FindVerdict(L"foo"));
+  cache.SetVerdict(L"baz", true);
+  EXPECT_EQ(base::Just(true), cache.FindVerdict(L"foo"));
+  EXPECT_TRUE(cache.FindVerdict(L"bar").IsNothing());
+  EXPECT_EQ(base::Just(true), cache.FindVerdict(L"baz"));
+  EXPECT_EQ(2u, cache.check_stats().size);
+}
+
+TEST(SpellingCacheTest, FindSuggestions) {
+  SpellingCache cache(10);
+  const std::vector<base::string16> suggestions = {L"word", L"sword"};
+  EXPECT_TRUE(cache.FindSuggestions(L"wrod").IsNothing());
+  cache.SetSuggestions(L"wrod", suggestions);
+  EXPECT_EQ(suggestions, cache.FindSuggestions(L"wrod").FromJust());
+}
+
+TEST(SpellingCacheTest, FindVerdict) {
+  SpellingCache cache(10);
+  EXPECT_TRUE(cache.FindVerdict(L"word").IsNothing());
+  cache.SetVerdict(L"word", true);
+  cache.SetVerdict(L"wrod", false);
+  EXPECT_EQ(base::Just(true), cache.FindVerdict(L"word"));
+  EXPECT_EQ(base::Just(false), cache.FindVerdict(L"wrod"));
+
+  auto const stats = cache.check_stats();
+  EXPECT_EQ(2, stats.num_hits);
+  EXPECT_EQ(1, stats.num_misses);
+  EXPECT_EQ(2u, stats.size);
+}
+
+}  // namespace spellchecker
@@ -2,18 +2,115 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <unordered_set>
+#include <utility>
+
 #include "evita/spellchecker/spelling_engine.h"
 
 #include "evita/spellchecker/hunspell_engine.h"
+#include "evita/spellchecker/spelling_cache.h"
 
 namespace spellchecker {
 
-SpellingEngine::SpellingEngine() {}
+namespace {
+// Maximum number of words in spelling cache. Identifiers and words in
+// a source file are repeated many times, so this should be enough for
+// a few large documents.
+const size_t kMaxCachedWords = 64 * 1024;
+}  // namespace
+
+SpellingEngine::SpellingEngine() : cache_(new SpellingCache(kMaxCachedWords)) {}
 
 SpellingEngine::~SpellingEngine() {}
 
+bool SpellingEngine::CheckSpelling(const base::string16& word_to_check) {
+  if (!EnsureInitialized())
+    return true;
+  const auto& maybe_verdict = cache_->FindVerdict(word_to_check);
+  if (maybe_verdict.IsJust())
+    return maybe_verdict.FromJust();
+  auto const is_correct = DoCheckSpelling(word_to_check);
+  cache_->SetVerdict(word_to_check, is_correct);
+  return is_correct;
+}
+
+std::vector<base::string16> SpellingEngine::CheckSpellingBatch(
+    const std::vector<base::string16>& words_to_check) {
+  if (words_to_check.empty() || !EnsureInitialized())
+    return std::vector<base::string16>();
+
+  std::unordered_set<base::string16> misspelled_set;
+  std::unordered_set<base::string16> unknown_set;
+  std::vector<base::string16> unknown_words;
+  for (const auto& word : words_to_check) {
+    if (word.empty())
+      continue;
+    const auto& maybe_verdict = cache_->FindVerdict(word);
+    if (maybe_verdict.IsJust()) {
+      if (!maybe_verdict.FromJust())
+        misspelled_set.insert(word);
+      continue;
+    }
+    if (unknown_set.insert(word).second)
+      unknown_words.push_back(word);
+  }
+
+  if (!unknown_words.empty()) {
+    for (const auto& word : DoCheckSpellingBatch(unknown_words)) {
+      misspelled_set.insert(word);
+      cache_->SetVerdict(word, false);
+    }
+    for (const auto& word : unknown_words) {
+      if (misspelled_set.count(word))
+        continue;
+      cache_->SetVerdict(word, true);
+    }
+  }
+
+  std::vector<base::string16> misspelled_words;
+  for (const auto& word : words_to_check) {
+    if (!misspelled_set.count(word))
+      continue;
+    misspelled_words.push_back(word);
+  }
+  return std::move(misspelled_words);
+}
+
+void SpellingEngine::DidChangeDictionary() {
+  cache_->Clear();
+}
+
+std::vector<base::string16> SpellingEngine::DoCheckSpellingBatch(
+    const std::vector<base::string16>& words_to_check) {
+  std::vector<base::string16> misspelled_words;
+  for (const auto& word : words_to_check) {
+    if (DoCheckSpelling(word))
+      continue;
+    misspelled_words.push_back(word);
+  }
+  return std::move(misspelled_words);
+}
+
+base::string16 SpellingEngine::GetJson(const base::string16& name) const {
+  if (name != L"all")
+    return base::string16();
+  return cache_->GetJson();
+}
+
 SpellingEngine* SpellingEngine::GetSpellingEngine() {
   return HunspellEngine::instance();
 }
 
+std::vector<base::string16> SpellingEngine::GetSpellingSuggestions(
+    const base::string16& wrong_word) {
+  if (!EnsureInitialized())
+    return std::vector<base::string16>();
+  const auto& maybe_suggestions = cache_->FindSuggestions(wrong_word);
+  if (maybe_suggestions.IsJust())
+    return maybe_suggestions.FromJust();
+  auto suggestions = DoGetSpellingSuggestions(wrong_word);
+  cache_->SetSuggestions(wrong_word, suggestions);
+  return std::move(suggestions);
+}
+
 }  // namespace spellchecker
@@ -5,6 +5,7 @@
 #ifndef EVITA_SPELLCHECKER_SPELLING_ENGINE_H_
 #define EVITA_SPELLCHECKER_SPELLING_ENGINE_H_
 
+#include <memory>
 #include <vector>
 
 #include "base/macros.h"
@@ -12,21 +13,50 @@
 
 namespace spellchecker {
 
+class SpellingCache;
+
+//////////////////////////////////////////////////////////////////////
+//
+// SpellingEngine
+//
+// Results of spell checking and suggestions are memoized in |cache_| which
+// is shared among threads.
+//
 class SpellingEngine {
  public:
   virtual ~SpellingEngine();
 
+  SpellingCache* cache() const { return cache_.get(); }
+
   static SpellingEngine* GetSpellingEngine();
 
-  virtual bool CheckSpelling(const base::string16& word_to_check) = 0;
+  bool CheckSpelling(const base::string16& word_to_check);
+
+  // Returns misspelled words in |words_to_check|, in order of appearance.
+  std::vector<base::string16> CheckSpellingBatch(
+      const std::vector<base::string16>& words_to_check);
+
   virtual bool EnsureInitialized() = 0;
-  virtual std::vector<base::string16> GetSpellingSuggestions(
-      const base::string16& wrong_word) = 0;
+  base::string16 GetJson(const base::string16& name) const;
+  std::vector<base::string16> GetSpellingSuggestions(
+      const base::string16& wrong_word);
 
  protected:
   SpellingEngine();
 
+  // Derived class should call this function when dictionary is changed to
+  // discard cached results.
+  void DidChangeDictionary();
+
  private:
+  virtual bool DoCheckSpelling(const base::string16& word_to_check) = 0;
+  virtual std::vector<base::string16> DoCheckSpellingBatch(
+      const std::vector<base::string16>& words_to_check);
+  virtual std::vector<base::string16> DoGetSpellingSuggestions(
+      const base::string16& wrong_word) = 0;
+
+  const std::unique_ptr<SpellingCache> cache_;
+
   DISALLOW_COPY_AND_ASSIGN(SpellingEngine);
 };
 
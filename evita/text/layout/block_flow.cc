@@ -4,18 +4,24 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <utility>
 #include <vector>
 
 #include "evita/text/layout/block_flow.h"
 
+#include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "evita/base/adaptors/reversed.h"
+#include "evita/metrics/counter.h"
+#include "evita/metrics/time_scope.h"
 #include "evita/text/layout/line/inline_box.h"
 #include "evita/text/layout/line/root_inline_box.h"
 #include "evita/text/layout/line/root_inline_box_cache.h"
+#include "evita/text/layout/line/wrap_point_cache.h"
 #include "evita/text/layout/text_format_context.h"
 #include "evita/text/layout/text_formatter.h"
+#include "evita/text/layout/visual_line_index.h"
 #include "evita/text/models/buffer.h"
 #include "evita/text/models/marker_set.h"
 #include "evita/text/models/static_range.h"
@@ -23,6 +29,74 @@
 
 namespace layout {
 
+namespace {
+
+// Maximum number of lines in line cache. Lines far from view port are
+// discarded when line cache has more lines.
+const size_t kMaxCachedLines = 4096;
+
+// Number of screens to pre-format above and below view port.
+const float kNumPreformatScreens = 2.0f;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// BlockFlow::CountState
+//
+// Counting visual lines of a chunk is resumed from this state, since a chunk
+// containing very long line may not be counted in one idle time.
+//
+struct BlockFlow::CountState {
+  text::Offset chunk_start;
+  // Format context of the next line to count.
+  text::Offset line_start;
+  text::Offset offset;
+  int line_index = 0;
+  // Number of visual lines counted so far.
+  int count = 0;
+  bool is_counting = false;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// BlockFlow::PreformatState
+//
+struct BlockFlow::PreformatState {
+  // Start offset of the top line formatted above view port.
+  text::Offset backward_start;
+  float backward_height = 0.0f;
+  // Format context of the line after the bottom line formatted below view
+  // port.
+  text::Offset forward_line_start;
+  text::Offset forward_offset;
+  int forward_line_index = TextFormatContext::kUnknownLineIndex;
+  float forward_height = 0.0f;
+  bool is_backward_done = false;
+  bool is_forward_done = false;
+  // |BlockFlow::version_| of view port pre-formatting for, or -1 if
+  // pre-formatting is canceled.
+  int version = -1;
+
+  // Time spent for formatting lines by pre-formatting for estimating time
+  // saved by pre-formatting.
+  base::TimeDelta format_time;
+  int num_formatted_lines = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// BlockFlow::VisualLineMemo
+//
+struct BlockFlow::VisualLineMemo {
+  text::Offset offset;
+  // |StyleTree::version()| and |VisualLineIndex::version()| of
+  // |visual_line|.
+  int style_version = -1;
+  int version = -1;
+  int visual_line = 0;
+};
+
 //////////////////////////////////////////////////////////////////////
 //
 // BlockFlow
@@ -30,10 +104,16 @@ namespace layout {
 BlockFlow::BlockFlow(const text::Buffer& text_buffer,
                      const text::MarkerSet& markers,
                      const StyleTree& style_tree)
-    : markers_(markers),
+    : count_state_(new CountState()),
+      markers_(markers),
+      preformat_(new PreformatState()),
       style_tree_(style_tree),
+      style_version_(style_tree.version()),
       text_buffer_(text_buffer),
-      text_line_cache_(new RootInlineBoxCache(text_buffer, markers)) {
+      text_line_cache_(new RootInlineBoxCache(text_buffer, markers)),
+      visual_line_index_(new VisualLineIndex(text_buffer)),
+      visual_line_memo_(new VisualLineMemo()),
+      wrap_points_(new WrapPointCache(text_buffer, markers)) {
   DCHECK_EQ(&text_buffer, &markers.buffer());
   markers_.AddObserver(this);
   text_buffer_.AddObserver(this);
@@ -52,6 +132,10 @@ text::Offset BlockFlow::text_start() const {
   return lines_.front()->text_start();
 }
 
+int BlockFlow::num_visual_lines() const {
+  return visual_line_index_->num_visual_lines();
+}
+
 void BlockFlow::Append(RootInlineBox* line) {
   if (lines_.empty()) {
     DCHECK_EQ(lines_height_, 0.0f);
@@ -67,6 +151,13 @@ void BlockFlow::Append(RootInlineBox* line) {
   lines_.push_back(std::move(line));
 }
 
+void BlockFlow::CancelCountVisualLines(text::Offset offset) {
+  auto& state = *count_state_;
+  if (!state.is_counting || offset > state.offset)
+    return;
+  state.is_counting = false;
+}
+
 text::Offset BlockFlow::ComputeEndOfLine(text::Offset text_offset) {
   TRACE_EVENT0("views", "BlockFlow::ComputeEndOfLine");
 
@@ -85,6 +176,49 @@ text::Offset BlockFlow::ComputeEndOfLine(text::Offset text_offset) {
   }
 }
 
+text::Offset BlockFlow::ComputeOffsetOfVisualLine(int visual_line) {
+  TRACE_EVENT0("views", "BlockFlow::ComputeOffsetOfVisualLine");
+  const auto& chunk = visual_line_index_->ChunkOfVisualLine(visual_line);
+  EnsureTextLineCache();
+  if (chunk.is_dirty) {
+    // Estimate offset by ratio of visual lines rather than formatting dirty
+    // chunk from its start, then snap it to start of line.
+    const auto rest =
+        std::min(std::max(visual_line - chunk.visual_line, 0),
+                 chunk.num_visual_lines);
+    const auto ratio = static_cast<double>(rest) / chunk.num_visual_lines;
+    const auto offset =
+        chunk.start + text::OffsetDelta(static_cast<int>(
+                          (chunk.end - chunk.start).value() * ratio));
+    return wrap_points_->WrapPointBefore(offset, chunk.start).offset;
+  }
+  std::unique_ptr<TextFormatter> formatter(
+      new TextFormatter(FormatContextFor(chunk.start, chunk.start, 0)));
+  for (auto rest = visual_line - chunk.visual_line;;) {
+    if (rest <= 0)
+      return formatter->text_offset();
+    if (formatter->line_index() == 0) {
+      // Skip wrapped lines in long logical line by wrap point.
+      const auto line_start = formatter->text_offset();
+      const auto& wrap_point =
+          wrap_points_->WrapPointOfLineIndex(line_start, rest);
+      if (wrap_point.line_index > 0) {
+        rest -= wrap_point.line_index;
+        formatter.reset(new TextFormatter(FormatContextFor(
+            line_start, wrap_point.offset, wrap_point.line_index)));
+        continue;
+      }
+    }
+    const auto line = FormatLine(formatter.get());
+    // |visual_line| may be beyond end of document.
+    if (line->IsEndOfDocument() ||
+        (!chunk.is_last && line->text_end() >= chunk.end)) {
+      return line->text_start();
+    }
+    --rest;
+  }
+}
+
 text::Offset BlockFlow::ComputeStartOfLine(text::Offset text_offset) {
   TRACE_EVENT0("views", "BlockFlow::ComputeStartOfLine");
   DCHECK(text_offset.IsValid());
@@ -114,6 +248,119 @@ text::Offset BlockFlow::ComputeVisibleEnd() const {
   return lines_.front()->text_end();
 }
 
+int BlockFlow::ComputeVisualLineOf(text::Offset text_offset) {
+  TRACE_EVENT0("views", "BlockFlow::ComputeVisualLineOf");
+  // |TextWindow| asks visual line of view port on every frame. Result is
+  // valid until text, formatting or visual line index is changed.
+  auto& memo = *visual_line_memo_;
+  if (memo.offset == text_offset &&
+      memo.style_version == style_tree_.version() &&
+      memo.version == visual_line_index_->version()) {
+    return memo.visual_line;
+  }
+  memo.visual_line = ComputeVisualLineOfInternal(text_offset);
+  memo.offset = text_offset;
+  memo.style_version = style_tree_.version();
+  memo.version = visual_line_index_->version();
+  return memo.visual_line;
+}
+
+int BlockFlow::ComputeVisualLineOfInternal(text::Offset text_offset) {
+  const auto& chunk = visual_line_index_->ChunkAt(text_offset);
+  if (chunk.is_dirty) {
+    // Estimate visual line by ratio of offset rather than formatting dirty
+    // chunk from its start. |UpdateVisualLineIndex()| counts it later.
+    const auto ratio =
+        static_cast<double>((text_offset - chunk.start).value()) /
+        std::max((chunk.end - chunk.start).value(), 1);
+    return chunk.visual_line +
+           static_cast<int>((chunk.num_visual_lines - 1) *
+                            std::min(ratio, 1.0));
+  }
+  EnsureTextLineCache();
+  // Start counting from the nearest wrap point before |text_offset| rather
+  // than start of chunk, which may be far from |text_offset| in long line.
+  const auto& wrap_point =
+      wrap_points_->WrapPointBefore(text_offset, chunk.start);
+  auto visual_line =
+      chunk.visual_line +
+      CountVisualLinesBetween(chunk.start, wrap_point.line_start) +
+      wrap_point.line_index;
+  TextFormatter formatter(FormatContextFor(
+      wrap_point.line_start, wrap_point.offset, wrap_point.line_index));
+  for (;; ++visual_line) {
+    const auto& line = FormatLine(&formatter);
+    if (text_offset < line->text_end() || line->IsEndOfDocument())
+      return visual_line;
+  }
+}
+
+bool BlockFlow::CountVisualLines(text::Offset chunk_start,
+                                 text::Offset chunk_end,
+                                 bool is_last_chunk,
+                                 const base::TimeTicks& deadline) {
+  auto& state = *count_state_;
+  if (!state.is_counting || state.chunk_start != chunk_start) {
+    state.chunk_start = chunk_start;
+    state.line_start = chunk_start;
+    state.offset = chunk_start;
+    state.line_index = 0;
+    state.count = 0;
+    state.is_counting = true;
+  }
+  TextFormatter formatter(
+      FormatContextFor(state.line_start, state.offset, state.line_index));
+  for (;;) {
+    const auto line_index = formatter.line_index();
+    std::unique_ptr<RootInlineBox> formatted_line;
+    auto line = text_line_cache_->FindLine(formatter.text_offset());
+    if (line) {
+      formatter.DidFormat(line);
+    } else {
+      formatted_line = formatter.FormatLine();
+      line = formatted_line.get();
+    }
+    wrap_points_->DidFormat(*line, line_index);
+    ++state.count;
+    if (line->IsEndOfDocument() ||
+        (!is_last_chunk && line->text_end() >= chunk_end)) {
+      state.is_counting = false;
+      return true;
+    }
+    if (base::TimeTicks::Now() < deadline)
+      continue;
+    state.line_start =
+        line->IsEndOfLine() ? line->text_end() : line->line_start();
+    state.offset = line->text_end();
+    state.line_index = formatter.line_index();
+    return false;
+  }
+}
+
+int BlockFlow::CountVisualLinesBetween(text::Offset start, text::Offset end) {
+  std::unique_ptr<TextFormatter> formatter(
+      new TextFormatter(FormatContextFor(start, start, 0)));
+  auto count = 0;
+  while (formatter->text_offset() < end) {
+    if (formatter->line_index() == 0) {
+      // Skip wrapped lines in long logical line by the last wrap point.
+      const auto line_start = formatter->text_offset();
+      const auto& wrap_point = wrap_points_->WrapPointOfLineIndex(
+          line_start, std::numeric_limits<int>::max());
+      if (wrap_point.line_index > 0) {
+        count += wrap_point.line_index;
+        formatter.reset(new TextFormatter(FormatContextFor(
+            line_start, wrap_point.offset, wrap_point.line_index)));
+      }
+    }
+    const auto line = FormatLine(formatter.get());
+    ++count;
+    if (line->IsEndOfDocument())
+      break;
+  }
+  return count;
+}
+
 bool BlockFlow::DiscardFirstLine() {
   if (lines_.empty())
     return false;
@@ -148,7 +395,24 @@ void BlockFlow::EnsureLinePoints() {
 }
 
 void BlockFlow::EnsureTextLineCache() {
+  if (style_version_ != style_tree_.version()) {
+    // Cached lines and wrap points refer computed styles invalidated by rule
+    // changes or zoom. Note: |MarkDirty()| discards |lines_| in cache.
+    style_version_ = style_tree_.version();
+    MarkDirty();
+    count_state_->is_counting = false;
+    text_line_cache_->Clear();
+    visual_line_index_->Invalidate();
+    wrap_points_->Clear();
+  }
   text_line_cache_->Invalidate(gfx::RectF(bounds_.size()), zoom_);
+  wrap_points_->Invalidate(bounds_.width(), zoom_);
+  // Keep lines in |lines_|, since we hold pointers to them.
+  if (lines_.empty()) {
+    text_line_cache_->Shrink(view_start_, view_start_, kMaxCachedLines);
+    return;
+  }
+  text_line_cache_->Shrink(text_start(), text_end(), kMaxCachedLines);
 }
 
 RootInlineBox* BlockFlow::FindLineContainng(text::Offset offset) const {
@@ -176,7 +440,10 @@ RootInlineBox* BlockFlow::FindLineContainng(text::Offset offset) const {
 
 void BlockFlow::Format(text::Offset text_offset) {
   TRACE_EVENT0("view", "BlockFlow::Format");
+  METRICS_TIME_SCOPE();
   EnsureTextLineCache();
+  const auto num_cache_hits = num_cache_hits_;
+  const auto num_cache_misses = num_cache_misses_;
   lines_.clear();
   lines_height_ = 0;
   dirty_line_point_ = false;
@@ -210,17 +477,26 @@ void BlockFlow::Format(text::Offset text_offset) {
   EnsureLinePoints();
   view_start_ = lines_.front()->text_start();
   ++version_;
+  RecordFormatMetrics(num_cache_hits_ - num_cache_hits,
+                      num_cache_misses_ - num_cache_misses);
 }
 
 TextFormatContext BlockFlow::FormatContextFor(text::Offset line_start,
-                                              text::Offset offset) const {
+                                              text::Offset offset,
+                                              int line_index) const {
   return TextFormatContext(text_buffer_, markers_, style_tree_, line_start,
-                           offset, bounds_, zoom_);
+                           offset, line_index, bounds_, zoom_);
 }
 
+// Returns format context starting at the nearest known wrap point before
+// |offset| rather than start of line, since start of line may be very far
+// from |offset| in a long line. Start of chunk containing |offset| bounds
+// looking for start of line.
 TextFormatContext BlockFlow::FormatContextFor(text::Offset offset) const {
-  const auto line_start = text_buffer_.ComputeStartOfLine(offset);
-  return FormatContextFor(line_start, line_start);
+  const auto& chunk = visual_line_index_->ChunkAt(offset);
+  const auto& wrap_point = wrap_points_->WrapPointBefore(offset, chunk.start);
+  return FormatContextFor(wrap_point.line_start, wrap_point.offset,
+                          wrap_point.line_index);
 }
 
 bool BlockFlow::FormatIfNeeded() {
@@ -232,13 +508,20 @@ bool BlockFlow::FormatIfNeeded() {
 }
 
 RootInlineBox* BlockFlow::FormatLine(TextFormatter* formatter) {
+  const auto line_index = formatter->line_index();
   const auto& cached_line =
       text_line_cache_->FindLine(formatter->text_offset());
   if (cached_line) {
+    ++num_cache_hits_;
     formatter->DidFormat(cached_line);
+    wrap_points_->DidFormat(*cached_line, line_index);
     return cached_line;
   }
-  return text_line_cache_->Register(std::move(formatter->FormatLine()));
+  ++num_cache_misses_;
+  const auto line =
+      text_line_cache_->Register(std::move(formatter->FormatLine()));
+  wrap_points_->DidFormat(*line, line_index);
+  return line;
 }
 
 text::Offset BlockFlow::HitTestPoint(gfx::PointF block_point) const {
@@ -304,6 +587,8 @@ text::Offset BlockFlow::MapPointXToOffset(text::Offset text_offset,
 }
 
 void BlockFlow::MarkDirty() {
+  // Cancel pre-formatting, since lines around view port are changed.
+  preformat_->version = -1;
   lines_.clear();
   dirty_line_point_ = true;
   lines_height_ = 0;
@@ -320,12 +605,113 @@ bool BlockFlow::NeedsFormat() const {
   return false;
 }
 
+bool BlockFlow::NeedsPreformat() const {
+  if (ShouldFormat())
+    return false;
+  if (preformat_->version != version_)
+    return true;
+  return !preformat_->is_backward_done || !preformat_->is_forward_done;
+}
+
+bool BlockFlow::NeedsUpdateVisualLineIndex() const {
+  return !visual_line_index_->is_clean();
+}
+
+bool BlockFlow::Preformat(const base::TimeTicks& deadline) {
+  TRACE_EVENT0("views", "BlockFlow::Preformat");
+  if (!NeedsPreformat())
+    return false;
+  EnsureTextLineCache();
+  if (NeedsFormat())
+    return false;
+  if (preformat_->version != version_)
+    StartPreformat();
+  const auto max_height = bounds_.height() * kNumPreformatScreens;
+  const auto start_time = base::TimeTicks::Now();
+  const auto num_cache_misses = num_cache_misses_;
+  // Format lines below and above view port alternately, since we don't know
+  // which direction user scrolls.
+  for (;;) {
+    const auto is_forward_formatted = PreformatForward(max_height);
+    const auto is_backward_formatted = PreformatBackward(max_height);
+    if (!is_forward_formatted && !is_backward_formatted)
+      break;
+    if (base::TimeTicks::Now() >= deadline)
+      break;
+  }
+  preformat_->format_time += base::TimeTicks::Now() - start_time;
+  preformat_->num_formatted_lines += num_cache_misses_ - num_cache_misses;
+  return NeedsPreformat();
+}
+
+bool BlockFlow::PreformatBackward(float max_height) {
+  auto& state = *preformat_;
+  if (state.is_backward_done)
+    return false;
+  if (state.backward_height >= max_height ||
+      state.backward_start == text::Offset(0)) {
+    state.is_backward_done = true;
+    return false;
+  }
+  const auto goal_offset = state.backward_start - text::OffsetDelta(1);
+  const auto& context = FormatContextFor(goal_offset);
+  TextFormatter formatter(context);
+  for (;;) {
+    const auto line = FormatLine(&formatter);
+    state.backward_height += line->height();
+    if (goal_offset < line->text_end())
+      break;
+  }
+  state.backward_start = context.offset();
+  return true;
+}
+
+bool BlockFlow::PreformatForward(float max_height) {
+  auto& state = *preformat_;
+  if (state.is_forward_done)
+    return false;
+  if (state.forward_height >= max_height) {
+    state.is_forward_done = true;
+    return false;
+  }
+  TextFormatter formatter(FormatContextFor(state.forward_line_start,
+                                          state.forward_offset,
+                                          state.forward_line_index));
+  const auto line = FormatLine(&formatter);
+  state.forward_height += line->height();
+  state.forward_offset = line->text_end();
+  state.forward_line_start =
+      line->IsEndOfLine() ? line->text_end() : line->line_start();
+  state.forward_line_index = formatter.line_index();
+  state.is_forward_done = line->IsEndOfDocument();
+  return true;
+}
+
 void BlockFlow::Prepend(RootInlineBox* line) {
   lines_height_ += line->height();
   lines_.push_front(std::move(line));
   dirty_line_point_ = true;
 }
 
+void BlockFlow::RecordFormatMetrics(int num_cache_hits,
+                                    int num_cache_misses) {
+  // Coverage of line cache when formatting view port.
+  const auto coverage = num_cache_misses == 0
+                            ? "all_lines_cached"
+                            : num_cache_hits == 0 ? "no_lines_cached"
+                                                  : "some_lines_cached";
+  METRICS_COUNTER_ADD("BlockFlow::Format", coverage);
+  const auto& state = *preformat_;
+  if (num_cache_hits == 0 || state.num_formatted_lines == 0)
+    return;
+  // Estimate time saved by pre-formatting with average time of formatting
+  // a line in pre-formatting.
+  const auto saved_time =
+      state.format_time * num_cache_hits / state.num_formatted_lines;
+  METRICS_HISTOGRAM_ADD("BlockFlow::Format.PreformatSavedMicroseconds",
+                        static_cast<int>(saved_time.InMicroseconds()));
+}
+
 bool BlockFlow::ScrollDown() {
   TRACE_EVENT0("views", "BlockFlow::ScrollDown");
   FormatIfNeeded();
@@ -449,7 +835,8 @@ bool BlockFlow::ScrollUp() {
   const auto offset = last_line->text_end();
   const auto line_start =
       last_line->IsEndOfLine() ? offset : last_line->line_start();
-  TextFormatter formatter(FormatContextFor(line_start, offset));
+  TextFormatter formatter(FormatContextFor(
+      line_start, offset, TextFormatContext::kUnknownLineIndex));
   Append(FormatLine(&formatter));
   return true;
 }
@@ -458,6 +845,10 @@ void BlockFlow::SetBounds(const gfx::RectF& new_bounds) {
   DCHECK(!new_bounds.empty());
   if (bounds_ == new_bounds)
     return;
+  if (bounds_.width() != new_bounds.width()) {
+    count_state_->is_counting = false;
+    visual_line_index_->Invalidate();
+  }
   bounds_ = new_bounds;
   MarkDirty();
 }
@@ -467,6 +858,8 @@ void BlockFlow::SetZoom(float new_zoom) {
   if (zoom_ == new_zoom)
     return;
   zoom_ = new_zoom;
+  count_state_->is_counting = false;
+  visual_line_index_->Invalidate();
   MarkDirty();
 }
 
@@ -474,12 +867,51 @@ bool BlockFlow::ShouldFormat() const {
   return lines_.empty();
 }
 
+void BlockFlow::StartPreformat() {
+  auto& state = *preformat_;
+  const auto last_line = lines_.back();
+  state.backward_start = lines_.front()->text_start();
+  state.backward_height = 0.0f;
+  state.forward_line_start =
+      last_line->IsEndOfLine() ? last_line->text_end() : last_line->line_start();
+  state.forward_offset = last_line->text_end();
+  state.forward_line_index = TextFormatContext::kUnknownLineIndex;
+  state.forward_height = 0.0f;
+  state.is_backward_done = false;
+  state.is_forward_done = last_line->IsEndOfDocument();
+  state.version = version_;
+}
+
+bool BlockFlow::UpdateVisualLineIndex(const base::TimeTicks& deadline) {
+  TRACE_EVENT0("views", "BlockFlow::UpdateVisualLineIndex");
+  if (bounds_.empty())
+    return false;
+  EnsureTextLineCache();
+  // Format chunks near view port first, since they are likely visited by
+  // scrolling. A chunk being counted is continued if it is still dirty.
+  while (!visual_line_index_->is_clean()) {
+    const auto& chunk = visual_line_index_->DirtyChunkNear(
+        count_state_->is_counting ? count_state_->chunk_start : view_start_);
+    if (!CountVisualLines(chunk.start, chunk.end, chunk.is_last, deadline))
+      break;
+    visual_line_index_->SetNumVisualLines(chunk, count_state_->count);
+    if (base::TimeTicks::Now() >= deadline)
+      break;
+  }
+  return !visual_line_index_->is_clean();
+}
+
 // text::BufferMutationObserver
+// Note: Changing style by syntax markers doesn't dirty |visual_line_index_|,
+// since markers rarely change wrapping and syntax coloring marks whole
+// document in background. Number of visual lines is refreshed when chunk is
+// edited or index is invalidated.
 void BlockFlow::DidChangeStyle(const text::StaticRange& range) {
   MarkDirty();
 }
 
 void BlockFlow::DidDeleteAt(const text::StaticRange& range) {
+  CancelCountVisualLines(range.start());
   MarkDirty();
   if (view_start_ <= range.start()) {
     // |view_start_| is before deleted range.
@@ -495,6 +927,7 @@ void BlockFlow::DidDeleteAt(const text::StaticRange& range) {
 }
 
 void BlockFlow::DidInsertBefore(const text::StaticRange& range) {
+  CancelCountVisualLines(range.start());
   MarkDirty();
   if (view_start_ <= range.start())
     return;
@@ -502,6 +935,8 @@ void BlockFlow::DidInsertBefore(const text::StaticRange& range) {
 }
 
 // text::MarkerSetObserver
+// Note: Like |DidChangeStyle()|, marker changes, e.g. spelling, don't dirty
+// |visual_line_index_|.
 void BlockFlow::DidChangeMarker(const text::StaticRange& range) {
   MarkDirty();
 }
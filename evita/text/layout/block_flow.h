@@ -15,6 +15,10 @@
 #include "evita/text/models/offset.h"
 #include "evita/text/style/computed_style.h"
 
+namespace base {
+class TimeTicks;
+}
+
 namespace text {
 class Buffer;
 class MarkerSet;
@@ -28,6 +32,8 @@ class TextFormatter;
 class RootInlineBox;
 class RootInlineBoxCache;
 class StyleTree;
+class VisualLineIndex;
+class WrapPointCache;
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -49,13 +55,20 @@ class BlockFlow final : public text::BufferMutationObserver,
   const text::Buffer& text_buffer() const { return text_buffer_; }
   text::Offset text_end() const;
   text::Offset text_start() const;
+  // Returns number of visual lines in document, it is an estimation if
+  // |NeedsUpdateVisualLineIndex()| is true.
+  int num_visual_lines() const;
   float zoom() const { return zoom_; }
 
   // Returns end of line offset containing |text_offset|.
   text::Offset ComputeEndOfLine(text::Offset text_offset);
+  // Returns start offset of visual line |visual_line|.
+  text::Offset ComputeOffsetOfVisualLine(int visual_line);
   // Returns start of line offset containing |text_offset|.
   text::Offset ComputeStartOfLine(text::Offset text_offset);
   text::Offset ComputeVisibleEnd() const;
+  // Returns visual line number of line containing |text_offset|.
+  int ComputeVisualLineOf(text::Offset text_offset);
 
   void Format(text::Offset text_offset);
   // Returns true if text format is taken place.
@@ -66,6 +79,14 @@ class BlockFlow final : public text::BufferMutationObserver,
   text::Offset MapPointXToOffset(text::Offset text_offset, float point_x);
   // Returns true if we need to format all lines.
   bool NeedsFormat() const;
+  // Returns true if lines around view port aren't pre-formatted yet.
+  bool NeedsPreformat() const;
+  // Returns true if visual line index has chunks to format.
+  bool NeedsUpdateVisualLineIndex() const;
+  // Formats lines above and below view port into line cache until
+  // |deadline| to make scrolling to them fast. Returns true if there are
+  // more lines to format.
+  bool Preformat(const base::TimeTicks& deadline);
   // Returns true if this |BlockFlow| is modified.
   bool ScrollDown();
   // Returns true if this |BlockFlow| is modified.
@@ -75,9 +96,30 @@ class BlockFlow final : public text::BufferMutationObserver,
   void SetBounds(const gfx::RectF& new_bounds);
   void SetZoom(float new_zoom);
   bool ShouldFormat() const;
+  // Formats chunks of visual line index until |deadline|. Returns true if
+  // there are more chunks to format.
+  bool UpdateVisualLineIndex(const base::TimeTicks& deadline);
 
  private:
+  struct CountState;
+  struct PreformatState;
+  struct VisualLineMemo;
+
   void Append(RootInlineBox* line);
+  // Cancels counting visual lines if text at or before counted offset is
+  // changed at |offset|.
+  void CancelCountVisualLines(text::Offset offset);
+  int ComputeVisualLineOfInternal(text::Offset text_offset);
+  // Counts visual lines between |chunk_start| and |chunk_end| into
+  // |count_state_| until |deadline| without registering formatted lines to
+  // |text_line_cache_|. Returns true if counting reaches end of chunk.
+  bool CountVisualLines(text::Offset chunk_start,
+                        text::Offset chunk_end,
+                        bool is_last_chunk,
+                        const base::TimeTicks& deadline);
+  // Returns number of visual lines from |start| to |end|, both of them are
+  // start of logical line, skipping wrapped lines by wrap points.
+  int CountVisualLinesBetween(text::Offset start, text::Offset end);
   // Returns true if discarded the first line.
   bool DiscardFirstLine();
   // Returns true if discarded the last line.
@@ -86,12 +128,19 @@ class BlockFlow final : public text::BufferMutationObserver,
   void EnsureTextLineCache();
   RootInlineBox* FindLineContainng(text::Offset offset) const;
   TextFormatContext FormatContextFor(text::Offset line_start,
-                                     text::Offset offset) const;
+                                     text::Offset offset,
+                                     int line_index) const;
   TextFormatContext FormatContextFor(text::Offset offset) const;
   RootInlineBox* FormatLine(TextFormatter* formatter);
   bool IsShowEndOfDocument() const;
   void MarkDirty();
+  // Returns true if a line is formatted.
+  bool PreformatBackward(float max_height);
+  // Returns true if a line is formatted.
+  bool PreformatForward(float max_height);
   void Prepend(RootInlineBox* line);
+  void RecordFormatMetrics(int num_cache_hits, int num_cache_misses);
+  void StartPreformat();
 
   // text::BufferMutationObserver
   void DidChangeStyle(const text::StaticRange& range) final;
@@ -102,15 +151,27 @@ class BlockFlow final : public text::BufferMutationObserver,
   void DidChangeMarker(const text::StaticRange& range) final;
 
   gfx::RectF bounds_;
+  const std::unique_ptr<CountState> count_state_;
   bool dirty_line_point_ = true;
   std::list<RootInlineBox*> lines_;
   float lines_height_ = 0.0f;
   const text::MarkerSet& markers_;
+  // Number of lines returned by |FormatLine()| from |text_line_cache_| and
+  // formatted by |FormatLine()|.
+  int num_cache_hits_ = 0;
+  int num_cache_misses_ = 0;
+  const std::unique_ptr<PreformatState> preformat_;
   const StyleTree& style_tree_;
+  // |StyleTree::version()| of lines in |text_line_cache_|.
+  int style_version_;
   const text::Buffer& text_buffer_;
   std::unique_ptr<RootInlineBoxCache> text_line_cache_;
   int version_ = 0;
   text::Offset view_start_;
+  const std::unique_ptr<VisualLineIndex> visual_line_index_;
+  const std::unique_ptr<VisualLineMemo> visual_line_memo_;
+  // Wrap points in long logical lines to start formatting from.
+  const std::unique_ptr<WrapPointCache> wrap_points_;
   float zoom_ = 1.0f;
 
   DISALLOW_COPY_AND_ASSIGN(BlockFlow);
@@ -6,11 +6,15 @@
 
 #include "evita/text/layout/text_layout_test_base.h"
 
+#include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "evita/base/strings/atomic_string.h"
 #include "evita/css/style_sheet.h"
 #include "evita/editor/dom_lock.h"
 #include "evita/text/layout/block_flow.h"
 #include "evita/text/models/buffer.h"
 #include "evita/text/models/marker_set.h"
+#include "evita/text/models/static_range.h"
 #include "evita/text/style/style_tree.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -62,6 +66,40 @@ text::Offset BlockFlowTest::HitTestPoint(const gfx::PointF& view_point) const {
   return block()->HitTestPoint(block_point);
 }
 
+TEST_F(BlockFlowTest, ComputeVisualLineOf) {
+  // A long logical line wrapped into multiple visual lines followed by short
+  // lines.
+  buffer()->InsertBefore(text::Offset(0),
+                         base::string16(200, 'x') + L"\nfoo\nbar\n");
+  block()->Format(text::Offset(0));
+  EXPECT_FALSE(block()->UpdateVisualLineIndex(base::TimeTicks::Max()));
+  const auto foo_line = block()->ComputeVisualLineOf(text::Offset(203));
+  EXPECT_LT(2, foo_line) << "Line of 'x' should be wrapped.";
+  EXPECT_EQ(text::Offset(201), block()->ComputeOffsetOfVisualLine(foo_line));
+
+  const auto last_line = block()->ComputeVisualLineOf(buffer()->GetEnd());
+  for (auto visual_line = 0; visual_line <= last_line; ++visual_line) {
+    const auto offset = block()->ComputeOffsetOfVisualLine(visual_line);
+    EXPECT_EQ(visual_line, block()->ComputeVisualLineOf(offset))
+        << "visual_line=" << visual_line << " offset=" << offset;
+  }
+}
+
+TEST_F(BlockFlowTest, ComputeVisualLineOfDirty) {
+  buffer()->InsertBefore(text::Offset(0),
+                         base::string16(200, 'x') + L"\nfoo\nbar\n");
+  block()->Format(text::Offset(0));
+  ASSERT_TRUE(block()->NeedsUpdateVisualLineIndex());
+
+  // Visual lines in dirty chunk are estimated without formatting.
+  EXPECT_EQ(0, block()->ComputeVisualLineOf(text::Offset(0)));
+  EXPECT_EQ(block()->num_visual_lines() - 1,
+            block()->ComputeVisualLineOf(buffer()->GetEnd()));
+  const auto offset = block()->ComputeOffsetOfVisualLine(1);
+  EXPECT_EQ(block()->ComputeStartOfLine(offset), offset)
+      << "Estimated offset should be start of line.";
+}
+
 TEST_F(BlockFlowTest, HitTestPoint) {
   buffer()->InsertBefore(text::Offset(0), L"foo\nbar\nbarz\n");
   block()->Format(text::Offset(0));
@@ -93,4 +131,71 @@ TEST_F(BlockFlowTest, HitTestTextPosition) {
             block()->HitTestTextPosition(text::Offset(5)));
 }
 
+TEST_F(BlockFlowTest, Preformat) {
+  base::string16 text;
+  for (auto count = 0; count < 100; ++count)
+    text += L"line\n";
+  buffer()->InsertBefore(text::Offset(0), text);
+  block()->Format(text::Offset(250));
+  EXPECT_TRUE(block()->NeedsPreformat());
+
+  EXPECT_FALSE(block()->Preformat(base::TimeTicks::Max()));
+  EXPECT_FALSE(block()->NeedsPreformat());
+
+  buffer()->InsertBefore(text::Offset(0), L"x");
+  EXPECT_FALSE(block()->NeedsPreformat())
+      << "We should not pre-format until view port is formatted.";
+  block()->FormatIfNeeded();
+  EXPECT_TRUE(block()->NeedsPreformat())
+      << "Editing cancels pre-formatting.";
+}
+
+TEST_F(BlockFlowTest, UpdateVisualLineIndex) {
+  buffer()->InsertBefore(text::Offset(0),
+                         base::string16(200, 'x') + L"\nfoo\nbar\n");
+  block()->Format(text::Offset(0));
+
+  // Counting visual lines of a chunk is resumed after deadline.
+  auto num_calls = 1;
+  while (block()->UpdateVisualLineIndex(base::TimeTicks()))
+    ++num_calls;
+  EXPECT_LT(1, num_calls);
+  EXPECT_FALSE(block()->NeedsUpdateVisualLineIndex());
+  EXPECT_EQ(block()->ComputeVisualLineOf(buffer()->GetEnd()) + 1,
+            block()->num_visual_lines());
+
+  // Editing text before counted lines restarts counting.
+  buffer()->InsertBefore(text::Offset(0), L"y");
+  EXPECT_TRUE(block()->UpdateVisualLineIndex(base::TimeTicks()));
+  buffer()->InsertBefore(text::Offset(0), L"\n");
+  while (block()->UpdateVisualLineIndex(base::TimeTicks())) {
+  }
+  EXPECT_EQ(block()->ComputeVisualLineOf(buffer()->GetEnd()) + 1,
+            block()->num_visual_lines());
+}
+
+TEST_F(BlockFlowTest, UpdateVisualLineIndexMarkerChurn) {
+  buffer()->InsertBefore(text::Offset(0),
+                         base::string16(200, 'x') + L"\nfoo\nbar\n");
+  block()->Format(text::Offset(0));
+  while (block()->UpdateVisualLineIndex(base::TimeTicks::Max())) {
+  }
+  const auto num_visual_lines = block()->num_visual_lines();
+  const auto foo_line = block()->ComputeVisualLineOf(text::Offset(203));
+
+  // Syntax coloring and spell checking change markers repeatedly without
+  // changing text.
+  for (auto count = 0; count < 100; ++count) {
+    buffer()->syntax_markers()->InsertMarker(
+        text::StaticRange(*buffer(), text::Offset(0), buffer()->GetEnd()),
+        base::AtomicString(count % 2 ? L"keyword" : L"comment"));
+    markers()->InsertMarker(
+        text::StaticRange(*buffer(), text::Offset(201), text::Offset(204)),
+        base::AtomicString(count % 2 ? L"misspelled" : L"bad_grammar"));
+    EXPECT_FALSE(block()->NeedsUpdateVisualLineIndex()) << count;
+  }
+  EXPECT_EQ(num_visual_lines, block()->num_visual_lines());
+  EXPECT_EQ(foo_line, block()->ComputeVisualLineOf(text::Offset(203)));
+}
+
 }  // namespace layout
@@ -0,0 +1,196 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/layout/buffer_replica.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/strings/string16.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/base/strings/atomic_string.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/marker.h"
+#include "evita/text/models/marker_set.h"
+#include "evita/text/models/static_range.h"
+
+namespace layout {
+
+namespace {
+
+std::vector<text::Marker> CollectMarkers(const text::MarkerSet& marker_set,
+                                         text::Offset start,
+                                         text::Offset end) {
+  std::vector<text::Marker> markers;
+  for (auto offset = start; offset < end;) {
+    const auto marker = marker_set.GetLowerBoundMarker(offset);
+    if (!marker || marker->start() >= end)
+      break;
+    markers.push_back(*marker);
+    offset = marker->end();
+  }
+  return markers;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// BufferReplica::Mutation
+//
+struct BufferReplica::Mutation {
+  enum class Type {
+    Delete,
+    Insert,
+    Markers,
+  };
+
+  text::Offset end;
+  // Target of |Type::Markers| in copies.
+  text::MarkerSet* marker_set = nullptr;
+  std::vector<text::Marker> markers;
+  text::Offset start;
+  base::string16 text;
+  Type type;
+};
+
+//////////////////////////////////////////////////////////////////////
+//
+// BufferReplica
+//
+BufferReplica::BufferReplica(const text::Buffer& buffer,
+                             const text::MarkerSet& markers)
+    : buffer_(new text::Buffer()),
+      markers_(new text::MarkerSet(markers.kind(), *buffer_)),
+      original_buffer_(buffer),
+      original_markers_(markers) {
+  buffer_->InsertBefore(text::Offset(0),
+                        buffer.GetText(text::Offset(0), buffer.GetEnd()));
+  buffer_->ClearUndo();
+  const auto end = buffer.GetEnd();
+  const std::pair<const text::MarkerSet*, text::MarkerSet*> pairs[] = {
+      {buffer.spelling_markers(), buffer_->spelling_markers()},
+      {buffer.syntax_markers(), buffer_->syntax_markers()},
+      {&markers, markers_.get()},
+  };
+  for (const auto& pair : pairs) {
+    for (const auto& marker : CollectMarkers(*pair.first, text::Offset(0), end))
+      pair.second->InsertMarker(
+          text::StaticRange(*buffer_, marker.start(), marker.end()),
+          marker.type());
+  }
+}
+
+BufferReplica::~BufferReplica() {}
+
+void BufferReplica::Apply(const Mutation& mutation) {
+  switch (mutation.type) {
+    case Mutation::Type::Delete:
+      buffer_->Delete(mutation.start, mutation.end);
+      return;
+    case Mutation::Type::Insert:
+      buffer_->InsertBefore(mutation.start, mutation.text);
+      return;
+    case Mutation::Type::Markers:
+      mutation.marker_set->InsertMarker(
+          text::StaticRange(*buffer_, mutation.start, mutation.end),
+          base::AtomicString());
+      for (const auto& marker : mutation.markers) {
+        mutation.marker_set->InsertMarker(
+            text::StaticRange(*buffer_, std::max(marker.start(), mutation.start),
+                              std::min(marker.end(), mutation.end)),
+            marker.type());
+      }
+      return;
+  }
+  NOTREACHED();
+}
+
+bool BufferReplica::Commit() {
+  const auto revision = revision_;
+  CommitUntil(RecordedRevision());
+  return revision_ != revision;
+}
+
+bool BufferReplica::CommitUntil(int revision) {
+  if (revision < revision_)
+    return false;
+  std::deque<Mutation> mutations;
+  {
+    base::AutoLock lock_scope(lock_);
+    DCHECK_LE(static_cast<size_t>(revision - revision_), mutations_.size());
+    const auto last = mutations_.begin() + (revision - revision_);
+    std::move(mutations_.begin(), last, std::back_inserter(mutations));
+    mutations_.erase(mutations_.begin(), last);
+  }
+  if (mutations.empty())
+    return true;
+  TRACE_EVENT1("layout", "BufferReplica::Commit", "mutations",
+               mutations.size());
+  for (const auto& mutation : mutations)
+    Apply(mutation);
+  buffer_->ClearUndo();
+  revision_ = revision;
+  return true;
+}
+
+int BufferReplica::RecordedRevision() const {
+  base::AutoLock lock_scope(lock_);
+  return revision_ + static_cast<int>(mutations_.size());
+}
+
+void BufferReplica::Record(Mutation mutation) {
+  base::AutoLock lock_scope(lock_);
+  mutations_.push_back(std::move(mutation));
+}
+
+void BufferReplica::DidChangeMarker(const text::StaticRange& range) {
+  Mutation mutation;
+  mutation.end = range.end();
+  mutation.marker_set = markers_.get();
+  mutation.markers =
+      CollectMarkers(original_markers_, range.start(), range.end());
+  mutation.start = range.start();
+  mutation.type = Mutation::Type::Markers;
+  Record(std::move(mutation));
+}
+
+// Since |text::Buffer| doesn't tell which of spelling and syntax markers are
+// changed, we record both of them.
+void BufferReplica::DidChangeStyle(const text::StaticRange& range) {
+  const std::pair<const text::MarkerSet*, text::MarkerSet*> pairs[] = {
+      {original_buffer_.spelling_markers(), buffer_->spelling_markers()},
+      {original_buffer_.syntax_markers(), buffer_->syntax_markers()},
+  };
+  for (const auto& pair : pairs) {
+    Mutation mutation;
+    mutation.end = range.end();
+    mutation.marker_set = pair.second;
+    mutation.markers = CollectMarkers(*pair.first, range.start(), range.end());
+    mutation.start = range.start();
+    mutation.type = Mutation::Type::Markers;
+    Record(std::move(mutation));
+  }
+}
+
+void BufferReplica::DidDeleteAt(const text::StaticRange& range) {
+  Mutation mutation;
+  mutation.end = range.end();
+  mutation.start = range.start();
+  mutation.type = Mutation::Type::Delete;
+  Record(std::move(mutation));
+}
+
+void BufferReplica::DidInsertBefore(const text::StaticRange& range) {
+  Mutation mutation;
+  mutation.end = range.end();
+  mutation.start = range.start();
+  mutation.text = original_buffer_.GetText(range.start(), range.end());
+  mutation.type = Mutation::Type::Insert;
+  Record(std::move(mutation));
+}
+
+}  // namespace layout
@@ -0,0 +1,81 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_LAYOUT_BUFFER_REPLICA_H_
+#define EVITA_TEXT_LAYOUT_BUFFER_REPLICA_H_
+
+#include <deque>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+
+namespace text {
+class Buffer;
+class MarkerSet;
+class StaticRange;
+}
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// BufferReplica
+//
+// Holds copies of |text::Buffer|, including its spelling and syntax markers,
+// and a |text::MarkerSet| of a window, for formatting text on layout thread.
+// Thread of originals records mutations by |Did*()| functions, which are
+// called from observers of originals, and |Commit()| applies recorded
+// mutations to copies. Copies are immutable between commits, and copies at
+// revision N are equivalent to originals after the first N mutations.
+//
+// Callers should serialize |Commit()| and readers of copies, e.g. by
+// |LayoutThread::lock()|. Recording functions are cheap and don't wait for
+// them.
+//
+class BufferReplica final {
+ public:
+  BufferReplica(const text::Buffer& buffer, const text::MarkerSet& markers);
+  ~BufferReplica();
+
+  const text::Buffer& buffer() const { return *buffer_; }
+  const text::MarkerSet& markers() const { return *markers_; }
+  // Returns number of mutations applied to copies.
+  int revision() const { return revision_; }
+
+  // Applies recorded mutations to copies. Returns true if copies are changed.
+  bool Commit();
+  // Applies recorded mutations until copies reach |revision|. Returns false if
+  // copies are already newer than |revision|.
+  bool CommitUntil(int revision);
+  // Returns number of recorded mutations. Called on thread of originals.
+  int RecordedRevision() const;
+
+  // Called by observers of originals.
+  void DidChangeMarker(const text::StaticRange& range);
+  void DidChangeStyle(const text::StaticRange& range);
+  void DidDeleteAt(const text::StaticRange& range);
+  void DidInsertBefore(const text::StaticRange& range);
+
+ private:
+  struct Mutation;
+
+  void Apply(const Mutation& mutation);
+  void Record(Mutation mutation);
+
+  const std::unique_ptr<text::Buffer> buffer_;
+  mutable base::Lock lock_;
+  const std::unique_ptr<text::MarkerSet> markers_;
+  // Recorded mutations not applied yet. Guarded by |lock_|.
+  std::deque<Mutation> mutations_;
+  const text::Buffer& original_buffer_;
+  const text::MarkerSet& original_markers_;
+  int revision_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferReplica);
+};
+
+}  // namespace layout
+
+#endif  // EVITA_TEXT_LAYOUT_BUFFER_REPLICA_H_
@@ -0,0 +1,205 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/text/layout/buffer_replica.h"
+
+#include "base/strings/string16.h"
+#include "evita/base/strings/atomic_string.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/buffer_mutation_observer.h"
+#include "evita/text/models/marker.h"
+#include "evita/text/models/marker_set.h"
+#include "evita/text/models/marker_set_observer.h"
+#include "evita/text/models/static_range.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// BufferReplicaTest
+//
+class BufferReplicaTest : public ::testing::Test,
+                          public text::BufferMutationObserver,
+                          public text::MarkerSetObserver {
+ protected:
+  BufferReplicaTest();
+  ~BufferReplicaTest() override;
+
+  text::Buffer* buffer() const { return buffer_.get(); }
+  text::MarkerSet* markers() { return &markers_; }
+  BufferReplica* replica() const { return replica_.get(); }
+
+  void CreateReplica();
+  void InsertMarker(text::MarkerSet* marker_set,
+                    int start,
+                    int end,
+                    base::AtomicString type);
+  base::string16 ReplicaText() const;
+  base::AtomicString ReplicaTypeAt(const text::MarkerSet& marker_set,
+                                   int offset) const;
+
+ private:
+  // text::BufferMutationObserver
+  void DidChangeStyle(const text::StaticRange& range) final;
+  void DidDeleteAt(const text::StaticRange& range) final;
+  void DidInsertBefore(const text::StaticRange& range) final;
+
+  // text::MarkerSetObserver
+  void DidChangeMarker(const text::StaticRange& range) final;
+
+  const std::unique_ptr<text::Buffer> buffer_;
+  text::MarkerSet markers_;
+  std::unique_ptr<BufferReplica> replica_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferReplicaTest);
+};
+
+BufferReplicaTest::BufferReplicaTest()
+    : buffer_(new text::Buffer()),
+      markers_(text::MarkerSet::Kind::Sticky, *buffer_) {}
+
+BufferReplicaTest::~BufferReplicaTest() {
+  if (!replica_)
+    return;
+  markers_.RemoveObserver(this);
+  buffer_->RemoveObserver(this);
+}
+
+void BufferReplicaTest::CreateReplica() {
+  replica_.reset(new BufferReplica(*buffer_, markers_));
+  buffer_->AddObserver(this);
+  markers_.AddObserver(this);
+}
+
+void BufferReplicaTest::InsertMarker(text::MarkerSet* marker_set,
+                                     int start,
+                                     int end,
+                                     base::AtomicString type) {
+  marker_set->InsertMarker(
+      text::StaticRange(*buffer_, text::Offset(start), text::Offset(end)),
+      type);
+}
+
+base::string16 BufferReplicaTest::ReplicaText() const {
+  const auto& buffer = replica_->buffer();
+  return buffer.GetText(text::Offset(0), buffer.GetEnd());
+}
+
+base::AtomicString BufferReplicaTest::ReplicaTypeAt(
+    const text::MarkerSet& marker_set,
+    int offset) const {
+  const auto marker = marker_set.GetMarkerAt(text::Offset(offset));
+  return marker ? marker->type() : base::AtomicString();
+}
+
+// text::BufferMutationObserver
+void BufferReplicaTest::DidChangeStyle(const text::StaticRange& range) {
+  replica_->DidChangeStyle(range);
+}
+
+void BufferReplicaTest::DidDeleteAt(const text::StaticRange& range) {
+  replica_->DidDeleteAt(range);
+}
+
+void BufferReplicaTest::DidInsertBefore(const text::StaticRange& range) {
+  replica_->DidInsertBefore(range);
+}
+
+// text::MarkerSetObserver
+void BufferReplicaTest::DidChangeMarker(const text::StaticRange& range) {
+  replica_->DidChangeMarker(range);
+}
+
+TEST_F(BufferReplicaTest, Commit) {
+  buffer()->InsertBefore(text::Offset(0), L"foo bar");
+  CreateReplica();
+
+  buffer()->InsertBefore(text::Offset(3), L" baz");
+  buffer()->Delete(text::Offset(0), text::Offset(4));
+  EXPECT_EQ(L"foo bar", ReplicaText())
+      << "Copies aren't changed until commit.";
+  EXPECT_EQ(2, replica()->RecordedRevision());
+
+  EXPECT_TRUE(replica()->Commit());
+  EXPECT_EQ(L"baz bar", ReplicaText());
+  EXPECT_EQ(2, replica()->revision());
+  EXPECT_FALSE(replica()->Commit()) << "There are no mutations.";
+}
+
+TEST_F(BufferReplicaTest, CommitUntil) {
+  buffer()->InsertBefore(text::Offset(0), L"foo");
+  CreateReplica();
+
+  buffer()->InsertBefore(text::Offset(3), L"bar");
+  buffer()->InsertBefore(text::Offset(6), L"baz");
+
+  EXPECT_TRUE(replica()->CommitUntil(1));
+  EXPECT_EQ(L"foobar", ReplicaText());
+  EXPECT_EQ(1, replica()->revision());
+  EXPECT_EQ(2, replica()->RecordedRevision());
+
+  EXPECT_FALSE(replica()->CommitUntil(0))
+      << "Copies are newer than revision 0.";
+  EXPECT_TRUE(replica()->CommitUntil(2));
+  EXPECT_EQ(L"foobarbaz", ReplicaText());
+}
+
+TEST_F(BufferReplicaTest, Copy) {
+  const base::AtomicString misspelled(L"misspelled");
+  const base::AtomicString keyword(L"keyword");
+  const base::AtomicString highlight(L"highlight");
+  buffer()->InsertBefore(text::Offset(0), L"foo bar baz");
+  InsertMarker(buffer()->spelling_markers(), 0, 3, misspelled);
+  InsertMarker(buffer()->syntax_markers(), 4, 7, keyword);
+  InsertMarker(markers(), 8, 11, highlight);
+  CreateReplica();
+
+  EXPECT_EQ(L"foo bar baz", ReplicaText());
+  const auto& buffer = replica()->buffer();
+  EXPECT_EQ(misspelled, ReplicaTypeAt(*buffer.spelling_markers(), 1));
+  EXPECT_EQ(keyword, ReplicaTypeAt(*buffer.syntax_markers(), 5));
+  EXPECT_EQ(highlight, ReplicaTypeAt(replica()->markers(), 9));
+  EXPECT_EQ(base::AtomicString(), ReplicaTypeAt(replica()->markers(), 3));
+  EXPECT_EQ(text::MarkerSet::Kind::Sticky, replica()->markers().kind());
+}
+
+TEST_F(BufferReplicaTest, DidChangeMarker) {
+  const base::AtomicString highlight(L"highlight");
+  const base::AtomicString misspelled(L"misspelled");
+  buffer()->InsertBefore(text::Offset(0), L"foo bar baz");
+  InsertMarker(markers(), 0, 7, highlight);
+  CreateReplica();
+
+  InsertMarker(markers(), 2, 5, base::AtomicString());
+  InsertMarker(buffer()->spelling_markers(), 8, 11, misspelled);
+  EXPECT_EQ(highlight, ReplicaTypeAt(replica()->markers(), 3));
+
+  EXPECT_TRUE(replica()->Commit());
+  const auto& buffer = replica()->buffer();
+  EXPECT_EQ(highlight, ReplicaTypeAt(replica()->markers(), 1));
+  EXPECT_EQ(base::AtomicString(), ReplicaTypeAt(replica()->markers(), 3));
+  EXPECT_EQ(highlight, ReplicaTypeAt(replica()->markers(), 6));
+  EXPECT_EQ(misspelled, ReplicaTypeAt(*buffer.spelling_markers(), 9));
+}
+
+// Markers are recorded in offsets at time of change, and later insertion
+// shifts them in copies as in originals.
+TEST_F(BufferReplicaTest, DidChangeMarkerThenEdit) {
+  const base::AtomicString highlight(L"highlight");
+  buffer()->InsertBefore(text::Offset(0), L"foo bar");
+  CreateReplica();
+
+  InsertMarker(markers(), 4, 7, highlight);
+  buffer()->InsertBefore(text::Offset(0), L"baz ");
+
+  EXPECT_TRUE(replica()->Commit());
+  EXPECT_EQ(L"baz foo bar", ReplicaText());
+  EXPECT_EQ(base::AtomicString(), ReplicaTypeAt(replica()->markers(), 5));
+  EXPECT_EQ(highlight, ReplicaTypeAt(replica()->markers(), 9));
+}
+
+}  // namespace layout
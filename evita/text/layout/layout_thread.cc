@@ -0,0 +1,44 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/layout/layout_thread.h"
+
+#include "base/logging.h"
+#include "base/memory/singleton.h"
+#include "base/message_loop/message_loop.h"
+#include "base/threading/thread.h"
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// LayoutThread
+//
+LayoutThread::LayoutThread() : thread_(new base::Thread("layout thread")) {
+  CHECK(thread_->Start()) << "failed to start layout thread";
+}
+
+LayoutThread::~LayoutThread() {}
+
+bool LayoutThread::CalledOnLayoutThread() const {
+  return thread_->message_loop() == base::MessageLoop::current();
+}
+
+// static
+LayoutThread* LayoutThread::GetInstance() {
+  return base::Singleton<LayoutThread>::get();
+}
+
+void LayoutThread::PostDelayedTask(const base::Location& from_here,
+                                   const base::Closure& task,
+                                   base::TimeDelta delay) {
+  thread_->task_runner()->PostDelayedTask(from_here, task, delay);
+}
+
+void LayoutThread::PostTask(const base::Location& from_here,
+                            const base::Closure& task) {
+  thread_->task_runner()->PostTask(from_here, task);
+}
+
+}  // namespace layout
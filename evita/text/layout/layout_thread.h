@@ -0,0 +1,59 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_LAYOUT_LAYOUT_THREAD_H_
+#define EVITA_TEXT_LAYOUT_LAYOUT_THREAD_H_
+
+#include <memory>
+
+#include "base/callback_forward.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+template <typename Type>
+struct DefaultSingletonTraits;
+class Location;
+class Thread;
+}
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// LayoutThread
+//
+// Formats text of windows and builds paint views out of script thread.
+// |lock()| guards layout objects, e.g. |TextView|, and style sheets they
+// refer. Script thread holds it while it queries layout or changes style
+// sheets, and layout thread holds it while it formats a frame.
+//
+class LayoutThread final {
+ public:
+  ~LayoutThread();
+
+  base::Lock* lock() { return &lock_; }
+
+  bool CalledOnLayoutThread() const;
+  static LayoutThread* GetInstance();
+  void PostDelayedTask(const base::Location& from_here,
+                       const base::Closure& task,
+                       base::TimeDelta delay);
+  void PostTask(const base::Location& from_here, const base::Closure& task);
+
+ private:
+  friend struct base::DefaultSingletonTraits<LayoutThread>;
+
+  LayoutThread();
+
+  base::Lock lock_;
+  const std::unique_ptr<base::Thread> thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayoutThread);
+};
+
+}  // namespace layout
+
+#endif  // EVITA_TEXT_LAYOUT_LAYOUT_THREAD_H_
@@ -119,7 +119,7 @@ InlineTextBoxBase::InlineTextBoxBase(const ComputedStyle& style,
                                      float height,
                                      text::OffsetDelta start,
                                      text::OffsetDelta end,
-                                     const base::string16& characters)
+                                     base::StringPiece16 characters)
     : InlineBox(style, left, width, height, start, end, font.descent()),
       WithFont(font),
       characters_(characters) {}
@@ -148,7 +148,7 @@ InlineTextBox::InlineTextBox(const ComputedStyle& style,
                              float width,
                              float height,
                              text::OffsetDelta start,
-                             const base::string16& characters)
+                             base::StringPiece16 characters)
     : InlineTextBoxBase(style,
                         font,
                         left,
@@ -186,7 +186,7 @@ InlineUnicodeBox::InlineUnicodeBox(const ComputedStyle& style,
                                    float width,
                                    float height,
                                    text::OffsetDelta start,
-                                   const base::string16& characters)
+                                   base::StringPiece16 characters)
     : InlineTextBoxBase(style,
                         font,
                         left,
@@ -6,7 +6,9 @@
 #define EVITA_TEXT_LAYOUT_LINE_INLINE_BOX_H_
 
 #include "base/macros.h"
+#include "base/strings/string_piece.h"
 #include "evita/base/castable.h"
+#include "evita/base/memory/zone_allocated.h"
 #include "evita/gfx/rect.h"
 #include "evita/text/layout/line/inline_box_forward.h"
 #include "evita/text/models/offset.h"
@@ -42,7 +44,12 @@ class ComputedStyle;
 //
 // InlineBox
 //
-class InlineBox : public base::Castable<InlineBox> {
+// Inline boxes are allocated in |evita::Zone| of |RootInlineBox| and
+// released with it without calling destructor. So, inline boxes should not
+// have members requiring destruction.
+//
+class InlineBox : public base::Castable<InlineBox>,
+                  public evita::ZoneAllocated {
   DECLARE_INLINE_BOX_ABSTRACT_CLASS(InlineBox, Castable);
 
  public:
@@ -170,7 +177,8 @@ class InlineTextBoxBase : public InlineBox, public WithFont {
   DECLARE_INLINE_BOX_ABSTRACT_CLASS(InlineTextBoxBase, InlineBox);
 
  public:
-  const base::string16 characters() const { return characters_; }
+  // |characters()| are stored in |evita::Zone| of |RootInlineBox|.
+  base::StringPiece16 characters() const { return characters_; }
 
  protected:
   InlineTextBoxBase(const ComputedStyle& style,
@@ -180,14 +188,14 @@ class InlineTextBoxBase : public InlineBox, public WithFont {
                     float height,
                     text::OffsetDelta start,
                     text::OffsetDelta end,
-                    const base::string16& characters);
+                    base::StringPiece16 characters);
   ~InlineTextBoxBase() override;
 
  private:
   // InlineBox
   text::OffsetDelta HitTestPoint(float x) const override;
 
-  const base::string16 characters_;
+  const base::StringPiece16 characters_;
 
   DISALLOW_COPY_AND_ASSIGN(InlineTextBoxBase);
 };
@@ -206,7 +214,7 @@ class InlineTextBox final : public InlineTextBoxBase {
                 float width,
                 float height,
                 text::OffsetDelta start,
-                const base::string16& characters);
+                base::StringPiece16 characters);
   ~InlineTextBox() final;
 
  private:
@@ -231,7 +239,7 @@ class InlineUnicodeBox final : public InlineTextBoxBase {
                    float width,
                    float height,
                    text::OffsetDelta start,
-                   const base::string16& characters);
+                   base::StringPiece16 characters);
   ~InlineUnicodeBox() final;
 
  private:
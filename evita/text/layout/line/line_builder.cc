@@ -4,11 +4,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 #include "evita/text/layout/line/line_builder.h"
 
 #include "base/logging.h"
 #include "evita/gfx/font.h"
+#include "evita/metrics/histogram.h"
 #include "evita/text/layout/line/inline_box.h"
 #include "evita/text/layout/line/root_inline_box.h"
 
@@ -30,6 +32,10 @@ float AlignHeightToPixel(float height) {
 }
 #endif
 
+// Size of segment of |evita::Zone| for a line. Most of lines fit in a
+// segment.
+const size_t kZoneSegmentSize = 1024;
+
 }  // namespace
 
 LineBuilder::LineBuilder(text::Offset line_start,
@@ -37,7 +43,8 @@ LineBuilder::LineBuilder(text::Offset line_start,
                          float line_width)
     : line_start_(line_start),
       line_width_(line_width),
-      text_start_(text_start) {}
+      text_start_(text_start),
+      zone_("LineBuilder", kZoneSegmentSize) {}
 
 LineBuilder::~LineBuilder() {}
 
@@ -55,8 +62,9 @@ void LineBuilder::AddCodeUnitBox(const ComputedStyle& style,
                                  text::Offset offset,
                                  const base::string16& text) {
   AddTextBoxIfNeeded();
-  AddBoxInternal(new InlineUnicodeBox(style, font, current_x_, width, height,
-                                      offset - text_start_, text));
+  AddBoxInternal(NewBox<InlineUnicodeBox>(style, font, current_x_, width,
+                                          height, offset - text_start_,
+                                          CopyText(text)));
 }
 
 void LineBuilder::AddFillerBox(const ComputedStyle& style,
@@ -64,8 +72,8 @@ void LineBuilder::AddFillerBox(const ComputedStyle& style,
                                float height,
                                text::Offset offset) {
   AddTextBoxIfNeeded();
-  AddBoxInternal(new InlineFillerBox(style, current_x_, width, height,
-                                     offset - text_start_));
+  AddBoxInternal(NewBox<InlineFillerBox>(style, current_x_, width, height,
+                                         offset - text_start_));
   font_ = style.fonts()[0];
 }
 
@@ -77,19 +85,20 @@ void LineBuilder::AddMarkerBox(const ComputedStyle& style,
                                text::Offset end,
                                TextMarker marker_name) {
   AddTextBoxIfNeeded();
-  AddBoxInternal(new InlineMarkerBox(style, font, current_x_, width, height,
-                                     start - text_start_, end - text_start_,
-                                     marker_name));
+  AddBoxInternal(NewBox<InlineMarkerBox>(style, font, current_x_, width,
+                                         height, start - text_start_,
+                                         end - text_start_, marker_name));
 }
 
 void LineBuilder::AddTextBoxIfNeeded() {
   if (pending_text_.empty())
     return;
   DCHECK_GT(pending_text_width_, 0.0f);
-  AddBoxInternal(new InlineTextBox(
+  AddBoxInternal(NewBox<InlineTextBox>(
       *style_, *font_, current_x_, pending_text_width_, ::ceil(font_->height()),
       current_offset_ - text_start_,
-      base::string16(pending_text_.data(), pending_text_.size())));
+      CopyText(base::StringPiece16(pending_text_.data(),
+                                   pending_text_.size()))));
   pending_text_.clear();
   pending_text_width_ = 0.0f;
 }
@@ -101,11 +110,20 @@ void LineBuilder::AddTextBoxIfNeeded() {
 std::unique_ptr<RootInlineBox> LineBuilder::Build() {
   DCHECK(!boxes_.empty());
   const auto end = boxes_.back()->end();
+  RecordMetrics();
   return std::make_unique<RootInlineBox>(
-      boxes_, line_start_, text_start_, text_start_ + end,
+      std::move(zone_), boxes_, line_start_, text_start_, text_start_ + end,
       AlignHeightToPixel(ascent_), AlignHeightToPixel(descent_));
 }
 
+base::StringPiece16 LineBuilder::CopyText(base::StringPiece16 text) {
+  const auto size = text.size() * sizeof(base::char16);
+  num_allocated_bytes_ += size;
+  const auto characters = zone_.AllocateObjects<base::char16>(text.size());
+  std::copy(text.begin(), text.end(), characters);
+  return base::StringPiece16(characters, text.size());
+}
+
 bool LineBuilder::HasRoomFor(float width) const {
   DCHECK(!boxes_.empty());
   if (boxes_.size() == 1 && pending_text_.empty())
@@ -114,10 +132,17 @@ bool LineBuilder::HasRoomFor(float width) const {
   return current_x_ + pending_text_width_ + width + marker_width < line_width_;
 }
 
-bool LineBuilder::TryAddChar(const ComputedStyle& style,
-                             const gfx::Font& font,
-                             text::Offset offset,
-                             base::char16 char_code) {
+void LineBuilder::RecordMetrics() const {
+  METRICS_HISTOGRAM_ADD("LineBuilder::Build.Boxes",
+                        static_cast<int>(boxes_.size()));
+  METRICS_HISTOGRAM_ADD("LineBuilder::Build.Bytes",
+                        static_cast<int>(num_allocated_bytes_));
+}
+
+size_t LineBuilder::TryAddText(const ComputedStyle& style,
+                               const gfx::Font& font,
+                               text::Offset offset,
+                               base::StringPiece16 text) {
   if (font_ != &font || style_ != &style) {
     AddTextBoxIfNeeded();
     font_ = &font;
@@ -125,12 +150,17 @@ bool LineBuilder::TryAddChar(const ComputedStyle& style,
   }
   if (pending_text_.empty())
     current_offset_ = offset;
-  auto const width = font_->GetCharWidth(char_code);
-  if (!HasRoomFor(width))
-    return false;
-  pending_text_.push_back(char_code);
-  pending_text_width_ += width;
-  return true;
+  DCHECK_EQ(current_offset_ + text::OffsetDelta(pending_text_.size()), offset);
+  size_t num_added = 0;
+  for (auto const char_code : text) {
+    auto const width = font_->GetCharWidth(char_code);
+    if (!HasRoomFor(width))
+      break;
+    pending_text_.push_back(char_code);
+    pending_text_width_ += width;
+    ++num_added;
+  }
+  return num_added;
 }
 
 }  // namespace layout
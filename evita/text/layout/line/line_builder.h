@@ -6,10 +6,13 @@
 #define EVITA_TEXT_LAYOUT_LINE_LINE_BUILDER_H_
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/macros.h"
 #include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
+#include "evita/base/memory/zone.h"
 #include "evita/text/models/offset.h"
 #include "evita/text/style/computed_style.h"
 
@@ -28,6 +31,9 @@ enum class TextMarker;
 //
 // LineBuilder
 //
+// |LineBuilder| allocates inline boxes and their characters in |zone_|,
+// which is passed to |RootInlineBox| by |Build()|.
+//
 class LineBuilder final {
  public:
   LineBuilder(text::Offset line_start,
@@ -57,13 +63,24 @@ class LineBuilder final {
   void AddTextBoxIfNeeded();
   std::unique_ptr<RootInlineBox> Build();
   bool HasRoomFor(float width) const;
-  bool TryAddChar(const ComputedStyle& style,
-                  const gfx::Font& font,
-                  text::Offset offset,
-                  base::char16 char_code);
+  // Adds leading characters of |text| which fit into this line, and returns
+  // number of added characters. |text| is rendered with |style| and |font|
+  // and starts at |offset|.
+  size_t TryAddText(const ComputedStyle& style,
+                    const gfx::Font& font,
+                    text::Offset offset,
+                    base::StringPiece16 text);
 
  private:
   void AddBoxInternal(InlineBox* inline_box);
+  // Returns copy of |text| allocated in |zone_|.
+  base::StringPiece16 CopyText(base::StringPiece16 text);
+  template <typename T, typename... Args>
+  T* NewBox(Args&&... args) {
+    num_allocated_bytes_ += sizeof(T);
+    return new (&zone_) T(std::forward<Args>(args)...);
+  }
+  void RecordMetrics() const;
 
   float ascent_ = 0.0f;
   std::vector<InlineBox*> boxes_;
@@ -73,10 +90,13 @@ class LineBuilder final {
   const gfx::Font* font_ = nullptr;
   const float line_width_;
   const text::Offset line_start_;
+  // Number of bytes allocated in |zone_| for metrics.
+  size_t num_allocated_bytes_ = 0;
   const ComputedStyle* style_ = nullptr;
   const text::Offset text_start_;
   float pending_text_width_ = 0.0f;
   std::vector<base::char16> pending_text_;
+  evita::Zone zone_;
 
   DISALLOW_COPY_AND_ASSIGN(LineBuilder);
 };
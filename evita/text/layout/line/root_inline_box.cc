@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <utility>
 
 #include "evita/text/layout/line/root_inline_box.h"
 
@@ -13,6 +14,7 @@
 #include "evita/text/layout/line/inline_box.h"
 #include "evita/text/layout/render_selection.h"
 #include "evita/text/paint/inline_box_painter.h"
+#include "evita/text/paint/public/line/root_inline_box.h"
 
 namespace layout {
 
@@ -20,7 +22,8 @@ namespace layout {
 //
 // RootInlineBox
 //
-RootInlineBox::RootInlineBox(const std::vector<InlineBox*>& boxes,
+RootInlineBox::RootInlineBox(evita::Zone&& zone,
+                             const std::vector<InlineBox*>& boxes,
                              text::Offset line_start,
                              text::Offset text_start,
                              text::Offset text_end,
@@ -30,7 +33,8 @@ RootInlineBox::RootInlineBox(const std::vector<InlineBox*>& boxes,
       descent_(descent),
       line_start_(line_start),
       text_start_(text_start),
-      text_end_(text_end) {
+      text_end_(text_end),
+      zone_(std::move(zone)) {
   DCHECK(!boxes_.empty());
   auto right = 0.0f;
   for (const auto& box : boxes_)
@@ -41,18 +45,21 @@ RootInlineBox::RootInlineBox(const std::vector<InlineBox*>& boxes,
   DCHECK_EQ(bounds_.bottom, ::floor(bounds_.bottom));
 }
 
-RootInlineBox::~RootInlineBox() {
-  for (const auto& box : boxes_)
-    delete box;
-}
+RootInlineBox::~RootInlineBox() {}
 
 void RootInlineBox::set_origin(const gfx::PointF& origin) {
+  if (bounds_.origin() != origin)
+    paint_root_box_ = nullptr;
   bounds_.right = bounds_.width() + origin.x;
   bounds_.bottom = bounds_.height() + origin.y;
   bounds_.left = origin.x;
   bounds_.top = origin.y;
 }
 
+void RootInlineBox::set_paint_root_box(paint::RootInlineBox* paint_root_box) {
+  paint_root_box_ = paint_root_box;
+}
+
 bool RootInlineBox::Contains(text::Offset offset) const {
   DCHECK(offset.IsValid());
   DCHECK(!boxes_.empty());
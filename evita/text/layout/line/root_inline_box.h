@@ -10,9 +10,15 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "evita/base/memory/zone.h"
 #include "evita/gfx/rect_f.h"
 #include "evita/text/models/offset.h"
 
+namespace paint {
+class RootInlineBox;
+}
+
 namespace layout {
 
 class InlineBox;
@@ -20,9 +26,17 @@ class Formatter;
 class TextBlock;
 class TextSelection;
 
+//////////////////////////////////////////////////////////////////////
+//
+// RootInlineBox
+//
+// |RootInlineBox| owns |zone| holding |boxes| and their characters, so
+// inline boxes are released at once when the line is discarded.
+//
 class RootInlineBox final {
  public:
-  RootInlineBox(const std::vector<InlineBox*>& boxes,
+  RootInlineBox(evita::Zone&& zone,
+                const std::vector<InlineBox*>& boxes,
                 text::Offset line_start,
                 text::Offset text_start,
                 text::Offset text_end,
@@ -43,6 +57,9 @@ class RootInlineBox final {
   float top() const { return bounds_.top; }
   const gfx::PointF origin() const { return bounds_.origin(); }
   void set_origin(const gfx::PointF& origin);
+  // Paint line built from this line. It is reset when this line is moved.
+  paint::RootInlineBox* paint_root_box() const { return paint_root_box_.get(); }
+  void set_paint_root_box(paint::RootInlineBox* paint_root_box);
   text::Offset text_end() const { return text_end_; }
   text::Offset text_start() const { return text_start_; }
   float width() const { return bounds_.width(); }
@@ -61,8 +78,10 @@ class RootInlineBox final {
   const std::vector<InlineBox*> boxes_;
   const float descent_;
   text::Offset line_start_;
+  scoped_refptr<paint::RootInlineBox> paint_root_box_;
   text::Offset text_start_;
   text::Offset text_end_;
+  evita::Zone zone_;
 
   DISALLOW_COPY_AND_ASSIGN(RootInlineBox);
 };
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 #include "evita/text/layout/line/root_inline_box_cache.h"
@@ -21,7 +22,7 @@ namespace layout {
 //
 RootInlineBoxCache::RootInlineBoxCache(const text::Buffer& buffer,
                                        const text::MarkerSet& markers)
-    : buffer_(buffer), markers_(markers) {
+    : buffer_(buffer), gap_offset_(0), markers_(markers) {
   DCHECK_EQ(&buffer_, &markers_.buffer());
   buffer_.AddObserver(this);
   markers_.AddObserver(this);
@@ -32,24 +33,55 @@ RootInlineBoxCache::~RootInlineBoxCache() {
   markers_.RemoveObserver(this);
 }
 
+void RootInlineBoxCache::Clear() {
+  lines_.clear();
+  relocated_lines_.clear();
+}
+
+RootInlineBox* RootInlineBoxCache::EnsureRelocated(
+    RelocatedLine* entry) const {
+  if (entry->delta != relocation_delta_) {
+    entry->line->UpdateTextStart(
+        text::OffsetDelta(relocation_delta_ - entry->delta));
+    entry->delta = relocation_delta_;
+  }
+  return entry->line.get();
+}
+
 RootInlineBox* RootInlineBoxCache::FindLine(text::Offset offset) const {
-  if (lines_.empty())
-    return nullptr;
   auto it = lines_.lower_bound(offset);
+  if (it != lines_.end() && it->second->text_end() == offset)
+    ++it;
   if (it == lines_.end())
-    return nullptr;
-  if (it->second->text_end() == offset) {
+    return FindRelocatedLine(offset);
+  const auto line = it->second.get();
+  return line->Contains(offset) ? line : nullptr;
+}
+
+RootInlineBox* RootInlineBoxCache::FindRelocatedLine(
+    text::Offset offset) const {
+  auto it = relocated_lines_.lower_bound(offset.value() - relocation_delta_);
+  if (it != relocated_lines_.end() &&
+      it->first + relocation_delta_ == offset.value()) {
     ++it;
-    if (it == lines_.end())
-      return nullptr;
   }
-  const auto line = it->second.get();
+  if (it == relocated_lines_.end())
+    return nullptr;
+  const auto line = EnsureRelocated(&it->second);
   return line->Contains(offset) ? line : nullptr;
 }
 
 RootInlineBox* RootInlineBoxCache::Insert(
     std::unique_ptr<RootInlineBox> line_ptr) {
   const auto line = line_ptr.get();
+  if (line->text_end() > gap_offset_) {
+    const auto key = line->text_end().value() - relocation_delta_;
+    DCHECK(relocated_lines_.find(key) == relocated_lines_.end())
+        << "We've already have RootInlineBox ends with " << line->text_end();
+    relocated_lines_.emplace(
+        key, RelocatedLine{relocation_delta_, std::move(line_ptr)});
+    return line;
+  }
   DCHECK(lines_.find(line->text_end()) == lines_.end())
       << "We've already have RootInlineBox ends with " << line->text_end();
   lines_.insert(std::make_pair(line->text_end(), std::move(line_ptr)));
@@ -66,7 +98,7 @@ RootInlineBox* RootInlineBoxCache::Insert(
 void RootInlineBoxCache::Invalidate(const gfx::RectF& new_bounds,
                                     float new_zoom) {
   if (zoom_ != new_zoom) {
-    lines_.clear();
+    Clear();
     bounds_ = new_bounds;
     zoom_ = new_zoom;
     return;
@@ -76,23 +108,25 @@ void RootInlineBoxCache::Invalidate(const gfx::RectF& new_bounds,
     return;
   const auto is_width_changed = bounds_.width() != new_bounds.width();
   bounds_ = new_bounds;
-  if (lines_.empty() || !is_width_changed)
+  if (!is_width_changed)
     return;
 
-  // Collect lines longer than |bounds_.width()|
-  std::vector<text::Offset> dirty_lines;
-  for (const auto& pair : lines_) {
-    const auto& line = *pair.second;
-    if (line.right() > new_bounds.right || line.IsContinuingLine() ||
-        line.IsContinuedLine()) {
-      dirty_lines.push_back(line.text_end());
-    }
+  // Remove lines longer than |bounds_.width()|
+  const auto is_dirty = [new_bounds](const RootInlineBox& line) {
+    return line.right() > new_bounds.right || line.IsContinuingLine() ||
+           line.IsContinuedLine();
+  };
+  for (auto it = lines_.begin(); it != lines_.end();) {
+    if (is_dirty(*it->second))
+      it = lines_.erase(it);
+    else
+      ++it;
   }
-  // Remove dirty lines
-  for (auto offset : dirty_lines) {
-    const auto& it = lines_.find(offset);
-    DCHECK(it != lines_.end());
-    lines_.erase(it);
+  for (auto it = relocated_lines_.begin(); it != relocated_lines_.end();) {
+    if (is_dirty(*it->second.line))
+      it = relocated_lines_.erase(it);
+    else
+      ++it;
   }
 }
 
@@ -102,52 +136,93 @@ bool RootInlineBoxCache::IsDirty(const gfx::RectF& bounds, float zoom) const {
   return bounds_ != bounds;
 }
 
+void RootInlineBoxCache::MoveGapTo(text::Offset offset) {
+  if (offset == gap_offset_)
+    return;
+  TRACE_EVENT0("views", "RootInlineBoxCache::MoveGapTo");
+  // Move lines ending after |offset| to |relocated_lines_|.
+  for (auto it = lines_.upper_bound(offset); it != lines_.end();
+       it = lines_.erase(it)) {
+    relocated_lines_.emplace(
+        it->first.value() - relocation_delta_,
+        RelocatedLine{relocation_delta_, std::move(it->second)});
+  }
+  // Move lines ending at or before |offset| to |lines_|.
+  while (!relocated_lines_.empty()) {
+    const auto it = relocated_lines_.begin();
+    if (it->first + relocation_delta_ > offset.value())
+      break;
+    const auto line = EnsureRelocated(&it->second);
+    lines_.emplace(line->text_end(), std::move(it->second.line));
+    relocated_lines_.erase(it);
+  }
+  gap_offset_ = offset;
+}
+
 RootInlineBox* RootInlineBoxCache::Register(
     std::unique_ptr<RootInlineBox> line) {
   DCHECK_GE(line->text_end(), line->text_start());
-  auto const present = lines_.find(line->text_end());
-  if (present != lines_.end())
-    lines_.erase(present);
+  if (line->text_end() > gap_offset_) {
+    relocated_lines_.erase(line->text_end().value() - relocation_delta_);
+    return Insert(std::move(line));
+  }
+  lines_.erase(line->text_end());
   return Insert(std::move(line));
 }
 
 void RootInlineBoxCache::RelocateLines(text::Offset offset,
                                        text::OffsetDelta delta) {
-  std::vector<RootInlineBox*> lines;
-  auto it = lines_.lower_bound(offset);
-  if (it != lines_.end() && it->second->text_end() == offset)
-    ++it;
-  const auto start = it;
-  while (it != lines_.end()) {
-    lines.push_back(it->second.release());
-    ++it;
-  }
-  lines_.erase(start, it);
-  for (auto line : lines) {
-    line->UpdateTextStart(delta);
-    Insert(std::unique_ptr<RootInlineBox>(line));
-  }
+  MoveGapTo(offset);
+  relocation_delta_ += delta.value();
 }
 
 // Remove lines crossing |range|.
 void RootInlineBoxCache::RemoveOverwapLines(const text::StaticRange& range) {
-  if (lines_.empty())
-    return;
-  auto it = lines_.lower_bound(range.start());
-  if (it == lines_.end()) {
-    // All lines ends before |range.start()|
-    return;
-  }
-  if (it->second->text_end() == range.start()) {
-    // Skip line ends with |range.start()|.
+  // Lines ending at or before |range.start()| are in |lines_|.
+  MoveGapTo(range.start());
+  auto it = relocated_lines_.begin();
+  while (it != relocated_lines_.end() &&
+         TextStartOf(it->second) < range.end()) {
     ++it;
   }
-  const auto start = it;
-  while (it != lines_.end() && it->second->text_start() < range.end())
-    ++it;
-  while (it != lines_.end() && it->second->IsContinuedLine())
+  while (it != relocated_lines_.end() && it->second.line->IsContinuedLine())
     ++it;
-  lines_.erase(start, it);
+  relocated_lines_.erase(relocated_lines_.begin(), it);
+}
+
+void RootInlineBoxCache::Shrink(text::Offset keep_start,
+                                text::Offset keep_end,
+                                size_t max_size) {
+  if (size() <= max_size)
+    return;
+  TRACE_EVENT0("views", "RootInlineBoxCache::Shrink");
+  // Lines ending at or before |keep_start| are in |lines_| and others are
+  // in |relocated_lines_|. Both are sorted by end offset, so the farthest
+  // lines are at the first of |lines_| and the last of |relocated_lines_|.
+  MoveGapTo(keep_start);
+  while (size() > max_size) {
+    const auto distance_before =
+        lines_.empty()
+            ? -1
+            : (keep_start - lines_.begin()->second->text_end()).value();
+    const auto distance_after =
+        relocated_lines_.empty()
+            ? -1
+            : (TextStartOf(relocated_lines_.rbegin()->second) - keep_end)
+                  .value();
+    if (distance_before < 0 && distance_after < 0)
+      return;
+    if (distance_before >= distance_after)
+      lines_.erase(lines_.begin());
+    else
+      relocated_lines_.erase(std::prev(relocated_lines_.end()));
+  }
+}
+
+text::Offset RootInlineBoxCache::TextStartOf(
+    const RelocatedLine& entry) const {
+  return entry.line->text_start() +
+         text::OffsetDelta(relocation_delta_ - entry.delta);
 }
 
 // text::BufferMutationObserver
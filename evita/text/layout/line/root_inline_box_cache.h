@@ -28,6 +28,15 @@ class RootInlineBox;
 //
 // RootInlineBoxCache
 //
+// Lines are split at |gap_offset_|, like gap buffer. Lines ending after
+// |gap_offset_| are indexed by relative offset, so relocating lines after
+// editing changes only |relocation_delta_| when editing happens at
+// |gap_offset_|. Offsets of each relocated line are updated when it is
+// returned by |FindLine()|.
+//
+// Number of lines is bounded by |Shrink()|, which discards lines farthest
+// from view port.
+//
 class RootInlineBoxCache final : public text::BufferMutationObserver,
                                  public text::MarkerSetObserver {
  public:
@@ -35,15 +44,38 @@ class RootInlineBoxCache final : public text::BufferMutationObserver,
                      const text::MarkerSet& markers);
   ~RootInlineBoxCache();
 
+  size_t size() const { return lines_.size() + relocated_lines_.size(); }
+
+  // Discards all lines, e.g. when computed styles are changed.
+  void Clear();
   // Returns |RootInlineBox| containing |text_offset|.
   RootInlineBox* FindLine(text::Offset text_offset) const;
   void Invalidate(const gfx::RectF& bounds, float zoom);
   bool IsDirty(const gfx::RectF& bounds, float zoom) const;
   RootInlineBox* Register(std::unique_ptr<RootInlineBox> line);
+  // Discards lines farthest from |keep_start| to |keep_end| until we have at
+  // most |max_size| lines. Lines overlapping |keep_start| to |keep_end| are
+  // never discarded, since |BlockFlow| holds them.
+  void Shrink(text::Offset keep_start, text::Offset keep_end, size_t max_size);
 
  private:
+  struct RelocatedLine {
+    // |relocation_delta_| when offsets of |line| are updated.
+    int delta;
+    std::unique_ptr<RootInlineBox> line;
+  };
+
+  // Returns |entry.line| after updating its offsets.
+  RootInlineBox* EnsureRelocated(RelocatedLine* entry) const;
+  RootInlineBox* FindRelocatedLine(text::Offset offset) const;
   RootInlineBox* Insert(std::unique_ptr<RootInlineBox> line);
+  // Moves lines so that |lines_| contains lines ending at or before |offset|
+  // and |relocated_lines_| contains lines ending after |offset|.
+  void MoveGapTo(text::Offset offset);
   void RelocateLines(text::Offset offset, text::OffsetDelta delta);
+  // Returns offset of |entry| in |relocated_lines_| with applying
+  // |relocation_delta_| without updating |entry.line|.
+  text::Offset TextStartOf(const RelocatedLine& entry) const;
   void RemoveOverwapLines(const text::StaticRange& range);
 
   // text::BufferMutationObserver
@@ -56,10 +88,15 @@ class RootInlineBoxCache final : public text::BufferMutationObserver,
 
   gfx::RectF bounds_;
   const text::Buffer& buffer_;
-  // |lines_| keeps |RootInlineBox| indexed by end offset and manages
-  // life time of |RootInlineBox|.
+  text::Offset gap_offset_;
+  // |lines_| keeps |RootInlineBox| ending at or before |gap_offset_|
+  // indexed by end offset and manages life time of |RootInlineBox|.
   std::map<text::Offset, std::unique_ptr<RootInlineBox>> lines_;
   const text::MarkerSet& markers_;
+  // |relocated_lines_| keeps |RootInlineBox| ending after |gap_offset_|
+  // indexed by end offset minus |relocation_delta_|.
+  mutable std::map<int, RelocatedLine> relocated_lines_;
+  int relocation_delta_ = 0;
   float zoom_ = 0.0f;
 
   DISALLOW_COPY_AND_ASSIGN(RootInlineBoxCache);
@@ -134,6 +134,27 @@ TEST_F(RootInlineBoxCacheTest, DidInsertBefore) {
   EXPECT_EQ(lines()[2], cache()->FindLine(text::Offset(11)));
 }
 
+TEST_F(RootInlineBoxCacheTest, DidInsertBeforeRepeatedly) {
+  PopulateCache(L"foo\nbar\nbaz\nqux");
+  buffer()->InsertBefore(text::Offset(9), L"X");
+  buffer()->InsertBefore(text::Offset(1), L"Y");
+  //       01234_5678_90123_456
+  // text: fYoo\nbar\nbXaz\nqux
+  EXPECT_EQ(nullptr, cache()->FindLine(text::Offset(0)));
+  EXPECT_EQ(lines()[1], cache()->FindLine(text::Offset(5)));
+  EXPECT_EQ(text::Offset(5), lines()[1]->text_start());
+  EXPECT_EQ(nullptr, cache()->FindLine(text::Offset(10)));
+  EXPECT_EQ(lines()[3], cache()->FindLine(text::Offset(14)));
+  EXPECT_EQ(text::Offset(14), lines()[3]->text_start());
+
+  buffer()->Delete(text::Offset(5), text::Offset(6));
+  //       01234_567_89012_345
+  // text: fYoo\nar\nbXaz\nqux
+  EXPECT_EQ(nullptr, cache()->FindLine(text::Offset(5)));
+  EXPECT_EQ(lines()[3], cache()->FindLine(text::Offset(13)));
+  EXPECT_EQ(text::Offset(13), lines()[3]->text_start());
+}
+
 TEST_F(RootInlineBoxCacheTest, DidInsertBeforeWithLineWrap) {
   SetBounds(gfx::RectF(gfx::SizeF(60.0f, 100.0f)));
   PopulateCache(L"0123456789\nabcd");
@@ -186,6 +207,25 @@ TEST_F(RootInlineBoxCacheTest, Invalidate) {
   EXPECT_EQ(nullptr, cache()->FindLine(text::Offset(2)));
 }
 
+TEST_F(RootInlineBoxCacheTest, Shrink) {
+  PopulateCache(L"0\n1\n2\n3\n4\n5\n6\n7\n8\n9");
+  EXPECT_EQ(10u, cache()->size());
+
+  cache()->Shrink(text::Offset(8), text::Offset(12), 4);
+  EXPECT_EQ(4u, cache()->size());
+  EXPECT_EQ(nullptr, cache()->FindLine(text::Offset(4)));
+  EXPECT_EQ(lines()[3], cache()->FindLine(text::Offset(6)));
+  EXPECT_EQ(lines()[4], cache()->FindLine(text::Offset(8)));
+  EXPECT_EQ(lines()[5], cache()->FindLine(text::Offset(10)));
+  EXPECT_EQ(lines()[6], cache()->FindLine(text::Offset(12)));
+  EXPECT_EQ(nullptr, cache()->FindLine(text::Offset(14)));
+
+  cache()->Shrink(text::Offset(8), text::Offset(12), 1);
+  EXPECT_EQ(2u, cache()->size()) << "Lines in keep range are kept.";
+  EXPECT_EQ(lines()[4], cache()->FindLine(text::Offset(8)));
+  EXPECT_EQ(lines()[5], cache()->FindLine(text::Offset(10)));
+}
+
 TEST_F(RootInlineBoxCacheTest, InvalidateWithLineWrap) {
   SetBounds(gfx::RectF(gfx::SizeF(40.0f, 100.0f)));
   PopulateCache(L"0\n123456");
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 #include <vector>
 
 #include "evita/gfx/font.h"
@@ -31,11 +32,12 @@ class LineBuilder final {
   void AddCodeUnit(const base::char16 code_unit);
   void AddMarker(TextMarker marker);
   void AddText(const base::string16& text);
-  std::unique_ptr<RootInlineBox> Build() const;
+  std::unique_ptr<RootInlineBox> Build();
   float WidthOf(const base::string16& text) const;
 
  private:
   void AddBoxInternal(InlineBox* box);
+  base::StringPiece16 CopyText(const base::string16& text);
   static ComputedStyle CreateStyle();
 
   float ascent_ = 0;
@@ -46,14 +48,18 @@ class LineBuilder final {
   text::OffsetDelta offset_;
   text::Offset start_;
   const ComputedStyle& style_;
+  evita::Zone zone_;
 
   DISALLOW_COPY_AND_ASSIGN(LineBuilder);
 };
 
 LineBuilder::LineBuilder(text::Offset start, const ComputedStyle& style)
-    : font_(*style.fonts()[0]), style_(style), start_(start) {
-  AddBoxInternal(
-      new InlineFillerBox(style_, 0, kLeadingWidth, 10, text::OffsetDelta(0)));
+    : font_(*style.fonts()[0]),
+      style_(style),
+      start_(start),
+      zone_("LineBuilder") {
+  AddBoxInternal(new (&zone_) InlineFillerBox(style_, 0, kLeadingWidth, 10,
+                                              text::OffsetDelta(0)));
 }
 
 void LineBuilder::AddBoxInternal(InlineBox* box) {
@@ -67,26 +73,36 @@ void LineBuilder::AddBoxInternal(InlineBox* box) {
 void LineBuilder::AddCodeUnit(const base::char16 code_unit) {
   const auto next_offset = offset_ + text::OffsetDelta(1);
   base::string16 text = L"uFFFF";
-  AddBoxInternal(new InlineUnicodeBox(style_, font_, left_, WidthOf(text),
-                                      font_.height() + 4, offset_, text));
+  AddBoxInternal(new (&zone_)
+                     InlineUnicodeBox(style_, font_, left_, WidthOf(text),
+                                      font_.height() + 4, offset_,
+                                      CopyText(text)));
 }
 
 void LineBuilder::AddMarker(TextMarker marker) {
   const auto next_offset =
       marker == TextMarker::LineWrap ? offset_ : offset_ + text::OffsetDelta(1);
-  AddBoxInternal(new InlineMarkerBox(style_, font_, left_, WidthOf(L"x"),
-                                     font_.height(), offset_, next_offset,
-                                     marker));
+  AddBoxInternal(new (&zone_) InlineMarkerBox(style_, font_, left_,
+                                              WidthOf(L"x"), font_.height(),
+                                              offset_, next_offset, marker));
 }
 
 void LineBuilder::AddText(const base::string16& text) {
-  AddBoxInternal(new InlineTextBox(style_, font_, left_, WidthOf(text),
-                                   font_.height(), offset_, text));
+  AddBoxInternal(new (&zone_) InlineTextBox(style_, font_, left_,
+                                            WidthOf(text), font_.height(),
+                                            offset_, CopyText(text)));
 }
 
-std::unique_ptr<RootInlineBox> LineBuilder::Build() const {
-  return std::make_unique<RootInlineBox>(boxes_, start_, start_,
-                                         start_ + offset_, ascent_, descent_);
+std::unique_ptr<RootInlineBox> LineBuilder::Build() {
+  return std::make_unique<RootInlineBox>(std::move(zone_), boxes_, start_,
+                                         start_, start_ + offset_, ascent_,
+                                         descent_);
+}
+
+base::StringPiece16 LineBuilder::CopyText(const base::string16& text) {
+  const auto characters = zone_.AllocateObjects<base::char16>(text.size());
+  std::copy(text.begin(), text.end(), characters);
+  return base::StringPiece16(characters, text.size());
 }
 
 gfx::RectF CaretBoundsOf(int origin_x, int origin_y, int height) {
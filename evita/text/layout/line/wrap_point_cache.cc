@@ -0,0 +1,215 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "evita/text/layout/line/wrap_point_cache.h"
+
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/text/layout/line/root_inline_box.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/marker_set.h"
+#include "evita/text/models/static_range.h"
+
+namespace layout {
+
+namespace {
+
+// Number of characters to copy from buffer at once for looking for newline.
+const int kScanSpanLength = 256;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// WrapPointCache
+//
+WrapPointCache::WrapPointCache(const text::Buffer& buffer,
+                               const text::MarkerSet& markers)
+    : buffer_(buffer), markers_(markers) {
+  DCHECK_EQ(&buffer_, &markers_.buffer());
+  buffer_.AddObserver(this);
+  markers_.AddObserver(this);
+}
+
+WrapPointCache::~WrapPointCache() {
+  buffer_.RemoveObserver(this);
+  markers_.RemoveObserver(this);
+}
+
+void WrapPointCache::Clear() {
+  pending_delta_ = text::OffsetDelta();
+  pending_index_ = 0;
+  wrap_points_.clear();
+}
+
+void WrapPointCache::DidFormat(const RootInlineBox& line, int line_index) {
+  if (!line.IsContinuedLine() || line_index <= 0)
+    return;
+  const auto line_start = line.line_start();
+  const auto offset = line.text_start();
+  const auto index = IndexOf(offset, true);
+  if (index < wrap_points_.size()) {
+    const auto& next = WrapPointAt(index);
+    if (next.offset == offset)
+      return;
+    if (next.line_start == line_start &&
+        next.offset - offset < text::OffsetDelta(kMinWrapPointDistance)) {
+      return;
+    }
+  }
+  const auto previous_offset =
+      index == 0 || WrapPointAt(index - 1).line_start != line_start
+          ? line_start
+          : WrapPointAt(index - 1).offset;
+  if (offset - previous_offset < text::OffsetDelta(kMinWrapPointDistance))
+    return;
+  // Store new wrap point without |pending_delta_| if it is in pending part.
+  const auto delta = index < pending_index_ ? 0 : pending_delta_.value();
+  wrap_points_.insert(
+      wrap_points_.begin() + index,
+      Entry{line_index, line_start.value() - delta, offset.value() - delta});
+  if (index < pending_index_)
+    ++pending_index_;
+}
+
+size_t WrapPointCache::IndexOf(text::Offset offset, bool inclusive) const {
+  // Since offsets with |pending_delta_| are sorted, we can use binary search.
+  size_t first = 0;
+  size_t last = wrap_points_.size();
+  while (first < last) {
+    const auto middle = first + (last - first) / 2;
+    const auto middle_offset = WrapPointAt(middle).offset;
+    if (middle_offset < offset || (!inclusive && middle_offset == offset))
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+void WrapPointCache::Invalidate(float new_width, float new_zoom) {
+  if (width_ == new_width && zoom_ == new_zoom)
+    return;
+  Clear();
+  width_ = new_width;
+  zoom_ = new_zoom;
+}
+
+void WrapPointCache::MovePendingIndex(size_t index) {
+  DCHECK_LE(index, wrap_points_.size());
+  const auto delta = pending_delta_.value();
+  for (; pending_index_ < index; ++pending_index_) {
+    wrap_points_[pending_index_].line_start += delta;
+    wrap_points_[pending_index_].offset += delta;
+  }
+  for (; pending_index_ > index; --pending_index_) {
+    wrap_points_[pending_index_ - 1].line_start -= delta;
+    wrap_points_[pending_index_ - 1].offset -= delta;
+  }
+}
+
+void WrapPointCache::RemoveWrapPoints(text::Offset start,
+                                      text::Offset end,
+                                      text::OffsetDelta delta) {
+  // Since both |line_start| and |offset| of wrap points are increasing,
+  // wrap points to remove are contiguous.
+  const auto first = IndexOf(start, true);
+  auto last = first;
+  while (last < wrap_points_.size() && WrapPointAt(last).line_start <= end)
+    ++last;
+  MovePendingIndex(first);
+  wrap_points_.erase(wrap_points_.begin() + first,
+                     wrap_points_.begin() + last);
+  if (pending_index_ == wrap_points_.size()) {
+    pending_delta_ = text::OffsetDelta();
+    return;
+  }
+  pending_delta_ = pending_delta_ + delta;
+}
+
+WrapPointCache::WrapPoint WrapPointCache::WrapPointAt(size_t index) const {
+  const auto& entry = wrap_points_[index];
+  const auto delta = index < pending_index_ ? 0 : pending_delta_.value();
+  return WrapPoint{text::Offset(entry.line_start + delta),
+                   text::Offset(entry.offset + delta), entry.line_index};
+}
+
+WrapPointCache::WrapPoint WrapPointCache::WrapPointBefore(
+    text::Offset offset,
+    text::Offset min_line_start) const {
+  DCHECK_LE(min_line_start, offset);
+  const auto index = IndexOf(offset, false);
+  const auto has_wrap_point =
+      index > 0 && WrapPointAt(index - 1).offset >= min_line_start;
+  const auto limit =
+      has_wrap_point ? WrapPointAt(index - 1).offset : min_line_start;
+  // Look for newline between |limit| and |offset| by copying span of
+  // characters rather than using |text::Buffer::ComputeStartOfLine()|, which
+  // scans whole logical line by |GetCharAt()|.
+  base::char16 span[kScanSpanLength];
+  for (auto span_end = offset; span_end > limit;) {
+    const auto span_length =
+        std::min((span_end - limit).value(), kScanSpanLength);
+    const auto span_start = span_end - text::OffsetDelta(span_length);
+    const auto num_copied = buffer_.GetText(span, span_start, span_end);
+    for (auto index = num_copied.value(); index > 0; --index) {
+      if (span[index - 1] != 0x0A)
+        continue;
+      const auto line_start = span_start + text::OffsetDelta(index);
+      return WrapPoint{line_start, line_start, 0};
+    }
+    span_end = span_start;
+  }
+  if (!has_wrap_point)
+    return WrapPoint{min_line_start, min_line_start, 0};
+  return WrapPointAt(index - 1);
+}
+
+WrapPointCache::WrapPoint WrapPointCache::WrapPointOfLineIndex(
+    text::Offset line_start,
+    int line_index) const {
+  // Wrap points in a logical line are contiguous and sorted by index.
+  const auto begin = IndexOf(line_start, false);
+  auto first = begin;
+  auto last = wrap_points_.size();
+  while (first < last) {
+    const auto middle = first + (last - first) / 2;
+    const auto& wrap_point = WrapPointAt(middle);
+    if (wrap_point.line_start == line_start &&
+        wrap_point.line_index <= line_index) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+  if (first == begin)
+    return WrapPoint{line_start, line_start, 0};
+  return WrapPointAt(first - 1);
+}
+
+// text::BufferMutationObserver
+void WrapPointCache::DidChangeStyle(const text::StaticRange& range) {
+  RemoveWrapPoints(range.start(), range.end(), text::OffsetDelta(0));
+}
+
+void WrapPointCache::DidDeleteAt(const text::StaticRange& range) {
+  TRACE_EVENT0("layout", "WrapPointCache::DidDeleteAt");
+  // Deleting newline joins the next line, whose start is |range.end()|.
+  RemoveWrapPoints(range.start(), range.end(),
+                   text::OffsetDelta(-range.length().value()));
+}
+
+void WrapPointCache::DidInsertBefore(const text::StaticRange& range) {
+  TRACE_EVENT0("layout", "WrapPointCache::DidInsertBefore");
+  RemoveWrapPoints(range.start(), range.start(), range.length());
+}
+
+// text::MarkerSetObserver
+void WrapPointCache::DidChangeMarker(const text::StaticRange& range) {
+  RemoveWrapPoints(range.start(), range.end(), text::OffsetDelta(0));
+}
+
+}  // namespace layout
@@ -0,0 +1,131 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_LAYOUT_LINE_WRAP_POINT_CACHE_H_
+#define EVITA_TEXT_LAYOUT_LINE_WRAP_POINT_CACHE_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "evita/text/models/buffer_mutation_observer.h"
+#include "evita/text/models/marker_set_observer.h"
+#include "evita/text/models/offset.h"
+
+namespace text {
+class Buffer;
+class MarkerSet;
+class StaticRange;
+}
+
+namespace layout {
+
+class RootInlineBox;
+
+//////////////////////////////////////////////////////////////////////
+//
+// WrapPointCache
+//
+// |WrapPointCache| remembers start offsets of wrapped lines in long logical
+// lines, at least |kMinWrapPointDistance| characters apart. A wrapped line
+// always starts at left margin and |TextFormatter| computes style of
+// characters from markers, so formatting can start at a wrap point instead
+// of start of logical line. This makes formatting lines in middle of very
+// long logical line, e.g. minified JavaScript, cost proportional to
+// formatted text rather than length of logical line.
+//
+// Each wrap point also remembers index of visual line starting at it in its
+// logical line, so |BlockFlow| can map between offset and visual line number
+// without formatting lines before the wrap point.
+//
+// Edits shift wrap points after them lazily. Wrap points at or after
+// |pending_index_| are stored without |pending_delta_|, and an edit moves
+// |pending_index_| to the edit, which costs number of wrap points between
+// the last edit and the edit rather than number of wrap points after the
+// edit, e.g. typing at same place costs nothing.
+//
+class WrapPointCache final : public text::BufferMutationObserver,
+                             public text::MarkerSetObserver {
+ public:
+  struct WrapPoint {
+    text::Offset line_start;
+    text::Offset offset;
+    // Index of visual line starting at |offset| in logical line.
+    int line_index;
+  };
+
+  // Minimum number of characters between wrap points in a logical line.
+  static const int kMinWrapPointDistance = 1024;
+
+  WrapPointCache(const text::Buffer& buffer, const text::MarkerSet& markers);
+  ~WrapPointCache() final;
+
+  size_t size() const { return wrap_points_.size(); }
+
+  // Discards all wrap points, e.g. when computed styles are changed.
+  void Clear();
+  // Records start of |line| if it is a wrapped line far enough from the
+  // previous wrap point and |line_index|, index of |line| in its logical
+  // line, is known.
+  void DidFormat(const RootInlineBox& line, int line_index);
+  // Clears wrap points when |width| or |zoom| is changed.
+  void Invalidate(float width, float zoom);
+  // Returns the last wrap point at or before |offset| in logical line
+  // containing |offset|, or start of logical line if there is no such wrap
+  // point. |min_line_start| is a known start of logical line at or before
+  // |offset|, which bounds looking for start of logical line.
+  WrapPoint WrapPointBefore(text::Offset offset,
+                            text::Offset min_line_start) const;
+  // Returns the last wrap point of which index is at or before |line_index|
+  // in logical line starting at |line_start|, or start of logical line if
+  // there is no such wrap point.
+  WrapPoint WrapPointOfLineIndex(text::Offset line_start, int line_index) const;
+
+ private:
+  // Wrap point in |wrap_points_|. Offsets are values rather than
+  // |text::Offset|, since wrap points stored without |pending_delta_| can
+  // have negative offsets.
+  struct Entry {
+    int line_index;
+    int line_start;
+    int offset;
+  };
+
+  // Returns index of the first wrap point of which offset is at or after
+  // |offset|, or after |offset| if |inclusive| is false.
+  size_t IndexOf(text::Offset offset, bool inclusive) const;
+  // Applies |pending_delta_| to wrap points between |index| and
+  // |pending_index_|, or un-applies if |index| is less than |pending_index_|,
+  // then sets |pending_index_| to |index|.
+  void MovePendingIndex(size_t index);
+  // Removes wrap points at or after |start| in logical lines overlapping
+  // |start| to |end|, then moves wrap points after them by |delta|.
+  void RemoveWrapPoints(text::Offset start,
+                        text::Offset end,
+                        text::OffsetDelta delta);
+  // Returns wrap point at |index| with |pending_delta_| applied if needed.
+  WrapPoint WrapPointAt(size_t index) const;
+
+  // text::BufferMutationObserver
+  void DidChangeStyle(const text::StaticRange& range) final;
+  void DidDeleteAt(const text::StaticRange& range) final;
+  void DidInsertBefore(const text::StaticRange& range) final;
+
+  // text::MarkerSetObserver
+  void DidChangeMarker(const text::StaticRange& range) final;
+
+  const text::Buffer& buffer_;
+  const text::MarkerSet& markers_;
+  text::OffsetDelta pending_delta_;
+  size_t pending_index_ = 0;
+  // Sorted by offset with |pending_delta_| applied.
+  std::vector<Entry> wrap_points_;
+  float width_ = 0.0f;
+  float zoom_ = 0.0f;
+
+  DISALLOW_COPY_AND_ASSIGN(WrapPointCache);
+};
+
+}  // namespace layout
+
+#endif  // EVITA_TEXT_LAYOUT_LINE_WRAP_POINT_CACHE_H_
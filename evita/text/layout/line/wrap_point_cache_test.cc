@@ -0,0 +1,186 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "evita/text/layout/text_layout_test_base.h"
+
+#include "base/strings/string16.h"
+#include "evita/text/layout/line/root_inline_box.h"
+#include "evita/text/layout/line/wrap_point_cache.h"
+#include "evita/text/layout/text_format_context.h"
+#include "evita/text/layout/text_formatter.h"
+#include "evita/text/models/buffer.h"
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// WrapPointCacheTest
+//
+class WrapPointCacheTest : public TextLayoutTestBase {
+ protected:
+  WrapPointCacheTest();
+  ~WrapPointCacheTest() override = default;
+
+  WrapPointCache* cache() const { return cache_.get(); }
+
+  // Formats all lines and records wrap points into |cache()|.
+  void FormatLines();
+  // Inserts "foo\n", |length| of "x" and "\nbar" at start of buffer, then
+  // formats all lines.
+  void PopulateCache(int length);
+
+ private:
+  // |cache_| takes |buffer_| and |markers_|.
+  const std::unique_ptr<WrapPointCache> cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(WrapPointCacheTest);
+};
+
+WrapPointCacheTest::WrapPointCacheTest()
+    : cache_(new WrapPointCache(*buffer(), *markers())) {}
+
+void WrapPointCacheTest::FormatLines() {
+  cache_->Invalidate(bounds().width(), zoom());
+  TextFormatter formatter(FormatContextFor(text::Offset(0)));
+  for (;;) {
+    const auto line_index = formatter.line_index();
+    const auto& line = formatter.FormatLine();
+    cache_->DidFormat(*line, line_index);
+    if (line->IsEndOfDocument())
+      break;
+  }
+}
+
+void WrapPointCacheTest::PopulateCache(int length) {
+  buffer()->InsertBefore(text::Offset(),
+                         L"foo\n" + base::string16(length, 'x') + L"\nbar");
+  FormatLines();
+}
+
+TEST_F(WrapPointCacheTest, DidDeleteAt) {
+  PopulateCache(3000);
+  buffer()->Delete(text::Offset(3000), text::Offset(3002));
+  EXPECT_EQ(2u, cache()->size()) << "Wrap points before 3000 are kept.";
+
+  buffer()->Delete(text::Offset(3), text::Offset(4));
+  EXPECT_EQ(0u, cache()->size()) << "Joining lines removes wrap points.";
+}
+
+TEST_F(WrapPointCacheTest, DidFormat) {
+  PopulateCache(3000);
+  EXPECT_EQ(2u, cache()->size());
+
+  const auto& wrap_point =
+      cache()->WrapPointBefore(text::Offset(3000), text::Offset(0));
+  EXPECT_EQ(text::Offset(4), wrap_point.line_start);
+  EXPECT_LE(text::Offset(2052), wrap_point.offset);
+
+  // Formatting from a wrap point produces the same line as formatting from
+  // start of line.
+  TextFormatter formatter(
+      FormatContextFor(wrap_point.line_start, wrap_point.offset));
+  const auto& line = formatter.FormatLine();
+  EXPECT_EQ(wrap_point.offset, line->text_start());
+  EXPECT_TRUE(line->IsContinuedLine());
+}
+
+TEST_F(WrapPointCacheTest, DidInsertBefore) {
+  PopulateCache(3000);
+  buffer()->InsertBefore(text::Offset(2000), L"abc");
+  EXPECT_EQ(1u, cache()->size());
+
+  const auto& wrap_point =
+      cache()->WrapPointBefore(text::Offset(3000), text::Offset(0));
+  buffer()->InsertBefore(text::Offset(1), L"abc");
+  EXPECT_EQ(1u, cache()->size());
+  const auto& wrap_point2 =
+      cache()->WrapPointBefore(text::Offset(3003), text::Offset(0));
+  EXPECT_EQ(text::Offset(7), wrap_point2.line_start);
+  EXPECT_EQ(wrap_point.offset + text::OffsetDelta(3), wrap_point2.offset);
+}
+
+// Edits at different places shift wrap points after them.
+TEST_F(WrapPointCacheTest, DidInsertBeforeMultipleTimes) {
+  PopulateCache(3000);
+  PopulateCache(3000);
+  EXPECT_EQ(4u, cache()->size()) << "Wrap points are shifted by insertion.";
+  const auto& wrap_point =
+      cache()->WrapPointBefore(text::Offset(6000), text::Offset(3012));
+
+  buffer()->InsertBefore(text::Offset(3008), L"abc");
+  buffer()->InsertBefore(text::Offset(1), L"abc");
+  buffer()->Delete(text::Offset(3011), text::Offset(3012));
+  EXPECT_EQ(4u, cache()->size()) << "Edits are outside of long lines.";
+
+  const auto& wrap_point2 =
+      cache()->WrapPointBefore(text::Offset(6005), text::Offset(3017));
+  EXPECT_EQ(wrap_point.line_start + text::OffsetDelta(5),
+            wrap_point2.line_start);
+  EXPECT_EQ(wrap_point.offset + text::OffsetDelta(5), wrap_point2.offset);
+  EXPECT_EQ(wrap_point.line_index, wrap_point2.line_index);
+
+  FormatLines();
+  EXPECT_EQ(4u, cache()->size()) << "Formatting finds the same wrap points.";
+}
+
+TEST_F(WrapPointCacheTest, Invalidate) {
+  PopulateCache(3000);
+  cache()->Invalidate(bounds().width(), zoom());
+  EXPECT_EQ(2u, cache()->size());
+
+  cache()->Invalidate(bounds().width() * 2, zoom());
+  EXPECT_EQ(0u, cache()->size());
+}
+
+TEST_F(WrapPointCacheTest, WrapPointOfLineIndex) {
+  PopulateCache(3000);
+  const auto& wrap_point =
+      cache()->WrapPointBefore(text::Offset(3000), text::Offset(0));
+  EXPECT_LT(0, wrap_point.line_index);
+  EXPECT_EQ(wrap_point.offset,
+            cache()
+                ->WrapPointOfLineIndex(wrap_point.line_start,
+                                       wrap_point.line_index)
+                .offset);
+  EXPECT_EQ(wrap_point.offset,
+            cache()->WrapPointOfLineIndex(text::Offset(4), 1000).offset)
+      << "The last wrap point in line.";
+  EXPECT_EQ(text::Offset(4),
+            cache()->WrapPointOfLineIndex(text::Offset(4), 0).offset);
+  EXPECT_EQ(text::Offset(3005),
+            cache()->WrapPointOfLineIndex(text::Offset(3005), 1).offset)
+      << "No wrap point in line.";
+
+  // |line_index| is number of visual lines before wrap point.
+  TextFormatter formatter(FormatContextFor(text::Offset(4)));
+  for (auto count = 0; count < wrap_point.line_index; ++count)
+    formatter.FormatLine();
+  EXPECT_EQ(wrap_point.offset, formatter.text_offset());
+}
+
+TEST_F(WrapPointCacheTest, WrapPointBefore) {
+  PopulateCache(3000);
+  EXPECT_EQ(text::Offset(0),
+            cache()->WrapPointBefore(text::Offset(2), text::Offset(0)).offset);
+  EXPECT_EQ(text::Offset(4),
+            cache()->WrapPointBefore(text::Offset(4), text::Offset(0)).offset);
+  EXPECT_EQ(text::Offset(4),
+            cache()->WrapPointBefore(text::Offset(5), text::Offset(0)).offset)
+      << "No wrap point near start of line.";
+
+  const auto& wrap_point =
+      cache()->WrapPointBefore(text::Offset(3006), text::Offset(0));
+  EXPECT_EQ(text::Offset(3005), wrap_point.line_start);
+  EXPECT_EQ(text::Offset(3005), wrap_point.offset);
+
+  const auto& wrap_point2 =
+      cache()->WrapPointBefore(text::Offset(3006), text::Offset(3005));
+  EXPECT_EQ(text::Offset(3005), wrap_point2.offset)
+      << "Start looking for newline from known start of line.";
+}
+
+}  // namespace layout
@@ -79,15 +79,16 @@ void PaintInlineBoxBuilder::VisitInlineMarkerBox(InlineMarkerBox* box) {
 void PaintInlineBoxBuilder::VisitInlineTextBox(InlineTextBox* box) {
   DCHECK(!paint_box_);
   paint_box_ = new paint::InlineTextBox(box->style(), box->font(), box->width(),
-                                        box->height(), box->characters(),
+                                        box->height(),
+                                        box->characters().as_string(),
                                         line_height_, line_descent_);
 }
 
 void PaintInlineBoxBuilder::VisitInlineUnicodeBox(InlineUnicodeBox* box) {
   DCHECK(!paint_box_);
   paint_box_ = new paint::InlineUnicodeBox(
-      box->style(), box->font(), box->width(), box->height(), box->characters(),
-      line_height_, line_descent_);
+      box->style(), box->font(), box->width(), box->height(),
+      box->characters().as_string(), line_height_, line_descent_);
 }
 
 gfx::RectF RoundBounds(const gfx::RectF& bounds) {
@@ -213,8 +214,14 @@ scoped_refptr<paint::View> PaintViewBuilder::Build(
 
   std::vector<paint::RootInlineBox*> lines;
   lines.reserve(block.lines().size());
-  for (const auto& line : block.lines())
-    lines.push_back(CreatePaintRootInlineBox(*line));
+  for (const auto& line : block.lines()) {
+    // Paint lines are immutable, so we reuse paint line built in previous
+    // frame unless |line| is moved, e.g. for caret blinking and selection
+    // change.
+    if (!line->paint_root_box())
+      line->set_paint_root_box(CreatePaintRootInlineBox(*line));
+    lines.push_back(line->paint_root_box());
+  }
   return new paint::View(block.version(), block.bounds(), lines,
                          base::WrapRefCounted(new paint::Selection(
                              selection.color(), selection_bounds_set)),
@@ -549,6 +549,16 @@ ScrollBar::~ScrollBar() {
     delete part;
 }
 
+float ScrollBar::ComputeValueDelta(float pixel_delta) const {
+  // Buttons are square at both ends of track.
+  const auto track_size = IsVertical()
+                              ? bounds_.height() - bounds_.width() * 2
+                              : bounds_.width() - bounds_.height() * 2;
+  if (track_size <= 0)
+    return 0;
+  return pixel_delta * data_.track().length() / track_size;
+}
+
 Part* ScrollBar::FindPart(ScrollBarPart part_name) const {
   for (const auto& part : parts_) {
     if (part->part() == part_name)
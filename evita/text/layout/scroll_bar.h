@@ -46,6 +46,9 @@ class ScrollBar final {
 
   const gfx::RectF& bounds() const { return bounds_; }
 
+  // Returns amount of data value corresponding to moving thumb by
+  // |pixel_delta| pixels.
+  float ComputeValueDelta(float pixel_delta) const;
   ScrollBarPart HitTestPoint(const gfx::PointF& point) const;
   bool IsVertical() const;
   std::unique_ptr<DisplayItemList> Paint();
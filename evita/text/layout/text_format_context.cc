@@ -13,10 +13,12 @@ TextFormatContext::TextFormatContext(const text::Buffer& buffer,
                                      const StyleTree& style_tree,
                                      text::Offset line_start,
                                      text::Offset offset,
+                                     int line_index,
                                      const gfx::RectF& bounds,
                                      float zoom)
     : buffer_(buffer),
       bounds_(bounds),
+      line_index_(offset == line_start ? 0 : line_index),
       line_start_(line_start),
       markers_(markers),
       offset_(offset),
@@ -31,6 +33,7 @@ TextFormatContext::TextFormatContext(const TextFormatContext& other)
                         other.style_tree_,
                         other.line_start_,
                         other.offset_,
+                        other.line_index_,
                         other.bounds_,
                         other.zoom_) {}
 
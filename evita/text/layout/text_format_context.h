@@ -19,11 +19,16 @@ class StyleTree;
 
 class TextFormatContext {
  public:
+  // Used for |line_index| when we don't know index of visual line starting
+  // at |offset| in logical line.
+  static const int kUnknownLineIndex = -1;
+
   TextFormatContext(const text::Buffer& buffer,
                     const text::MarkerSet& markers,
                     const StyleTree& style_tree,
                     text::Offset line_start,
                     text::Offset offset,
+                    int line_index,
                     const gfx::RectF& bounds,
                     float zoom);
   TextFormatContext(const TextFormatContext& other);
@@ -33,6 +38,9 @@ class TextFormatContext {
 
   const gfx::RectF& bounds() const { return bounds_; }
   const text::Buffer& buffer() const { return buffer_; }
+  // Returns index of visual line starting at |offset()| in logical line
+  // starting at |line_start()|, or |kUnknownLineIndex|.
+  int line_index() const { return line_index_; }
   const text::Offset line_start() const { return line_start_; }
   const text::MarkerSet& markers() const { return markers_; }
   const text::Offset offset() const { return offset_; }
@@ -42,6 +50,7 @@ class TextFormatContext {
  private:
   const gfx::RectF& bounds_;
   const text::Buffer& buffer_;
+  const int line_index_;
   const text::Offset line_start_;
   const text::MarkerSet& markers_;
   const text::Offset offset_;
@@ -59,6 +59,10 @@ const ComputedStyle& ComputeDefaultStyle(const StyleTree& style_tree) {
   return style_tree.ComputedStyleOf(selector);
 }
 
+bool IsControl(base::char16 char_code) {
+  return char_code < 0x20 || char_code == 0xFEFF;
+}
+
 base::char16 IntToHex(int k) {
   DCHECK_GE(k, 0);
   DCHECK_LE(k, 15);
@@ -88,6 +92,9 @@ class TextFormatter::TextScanner final {
   }
 
   bool AtEnd() const;
+  // Returns offset where any of highlight, spelling or syntax changes after
+  // |text_offset()|, or end of buffer.
+  text::Offset ComputeRunEnd() const;
   base::char16 GetChar();
   void Next();
 
@@ -153,6 +160,25 @@ bool TextFormatter::TextScanner::AtEnd() const {
   return text_offset_ == buffer_.GetEnd();
 }
 
+text::Offset TextFormatter::TextScanner::ComputeRunEnd() const {
+  // Update cached markers.
+  highlight();
+  spelling();
+  syntax();
+  auto run_end = buffer_.GetEnd();
+  for (const auto* marker :
+       {highlight_marker_, spelling_marker_, syntax_marker_}) {
+    if (!marker)
+      continue;
+    if (marker->Contains(text_offset_))
+      run_end = std::min(marker->end(), run_end);
+    else if (marker->start() > text_offset_)
+      run_end = std::min(marker->start(), run_end);
+  }
+  DCHECK_GT(run_end, text_offset_);
+  return run_end;
+}
+
 base::char16 TextFormatter::TextScanner::GetChar() {
   if (AtEnd())
     return 0;
@@ -181,6 +207,7 @@ void TextFormatter::TextScanner::Next() {
 TextFormatter::TextFormatter(const TextFormatContext& context)
     : bounds_(context.bounds()),
       default_computed_style_(ComputeDefaultStyle(context.style_tree())),
+      line_index_(context.line_index()),
       line_start_(context.line_start()),
       style_tree_(context.style_tree()),
       text_scanner_(new TextScanner(context.buffer(), context.markers())),
@@ -197,14 +224,10 @@ text::Offset TextFormatter::text_offset() const {
   return text_scanner_->text_offset();
 }
 
-const ComputedStyle& TextFormatter::ComputedStyleOf(
-    const css::Selector& selector) const {
-  return style_tree_.ComputedStyleOf(selector);
-}
-
 void TextFormatter::DidFormat(const RootInlineBox* line) {
   line_start_ = line->IsEndOfLine() ? line->text_end() : line->line_start();
   text_scanner_->set_text_offset(line->text_end());
+  UpdateLineIndex(*line);
 }
 
 const gfx::Font* TextFormatter::FontFor(const ComputedStyle& style,
@@ -240,65 +263,34 @@ std::unique_ptr<RootInlineBox> TextFormatter::FormatLine() {
       break;
     }
 
-    if (!FormatChar(&line_builder, char_code)) {
+    if (!FormatRun(&line_builder)) {
       FormatMarker(&line_builder, TextMarker::LineWrap, text::OffsetDelta(0));
       break;
     }
-
-    text_scanner_->Next();
   }
-  return std::move(line_builder.Build());
+  auto line = line_builder.Build();
+  UpdateLineIndex(*line);
+  return std::move(line);
 }
 
-bool TextFormatter::FormatChar(LineBuilder* line_builder,
-                               base::char16 char_code) {
-  css::Selector::Builder selectorBuilder;
-  if (char_code < 0x20 || char_code == 0xFEFF) {
-    selectorBuilder.SetTagName(KNOWN_NAME_OF(marker));
-  } else {
-    const auto& syntax = text_scanner_->syntax();
-    if (syntax.empty())
-      selectorBuilder.SetTagName(KNOWN_NAME_OF(normal));
-    else
-      selectorBuilder.SetTagName(syntax);
-  }
-
-  const auto& spelling = text_scanner_->spelling();
-  if (!spelling.empty())
-    selectorBuilder.AddClass(spelling);
-
-  const auto highlight = text_scanner_->highlight();
-  if (!highlight.empty())
-    selectorBuilder.AddClass(highlight);
-
-  if (char_code == 0x09) {
-    const auto& style = ComputedStyleOf(selectorBuilder.Build());
-    return FormatTab(line_builder, style);
-  }
-
-  if (char_code < 0x20 || char_code == 0xFEFF) {
-    selectorBuilder.AddClass(KNOWN_NAME_OF(control));
-    const auto& style = ComputedStyleOf(selectorBuilder.Build());
-    return FormatMissing(line_builder, style, char_code);
-  }
-
-  const auto& style = ComputedStyleOf(selectorBuilder.Build());
-  if (const auto* font = FontFor(style, char_code)) {
-    return line_builder->TryAddChar(style, *font, text_scanner_->text_offset(),
-                                    char_code);
-  }
-
-  selectorBuilder.AddClass(KNOWN_NAME_OF(missing));
-  const auto& style2 = ComputedStyleOf(selectorBuilder.Build());
-  return FormatMissing(line_builder, style2, char_code);
+bool TextFormatter::FormatControl(LineBuilder* line_builder,
+                                  const StyleKey& run_key,
+                                  base::char16 char_code) {
+  StyleKey key = run_key;
+  key.tag_name = KNOWN_NAME_OF(marker);
+  if (char_code == 0x09)
+    return FormatTab(line_builder, style_tree_.ComputedStyleOf(key));
+  key.classes[2] = KNOWN_NAME_OF(control);
+  return FormatMissing(line_builder, style_tree_.ComputedStyleOf(key),
+                       char_code);
 }
 
 void TextFormatter::FormatMarker(LineBuilder* line_builder,
                                  TextMarker marker_name,
                                  text::OffsetDelta length) {
-  css::Selector::Builder selectorBuilder;
-  selectorBuilder.SetTagName(KNOWN_NAME_OF(marker));
-  const auto& style = ComputedStyleOf(selectorBuilder.Build());
+  StyleKey key;
+  key.tag_name = KNOWN_NAME_OF(marker);
+  const auto& style = style_tree_.ComputedStyleOf(key);
   const auto* font = FontFor(style, 'x');
   const auto width = AlignWidthToPixel(font->GetCharWidth('x'));
   const auto height = AlignHeightToPixel(font->height());
@@ -332,6 +324,60 @@ bool TextFormatter::FormatMissing(LineBuilder* line_builder,
   return true;
 }
 
+bool TextFormatter::FormatRun(LineBuilder* line_builder) {
+  const auto run_end = text_scanner_->ComputeRunEnd();
+  StyleKey run_key;
+  const auto& syntax = text_scanner_->syntax();
+  run_key.tag_name = syntax.empty() ? KNOWN_NAME_OF(normal) : syntax;
+  run_key.classes[0] = text_scanner_->spelling();
+  run_key.classes[1] = text_scanner_->highlight();
+  const auto& style = style_tree_.ComputedStyleOf(run_key);
+
+  while (text_scanner_->text_offset() < run_end) {
+    const auto char_code = text_scanner_->GetChar();
+    if (char_code == 0x0A)
+      return true;
+    if (IsControl(char_code)) {
+      if (!FormatControl(line_builder, run_key, char_code))
+        return false;
+      text_scanner_->Next();
+      continue;
+    }
+
+    const auto* font = FontFor(style, char_code);
+    if (!font) {
+      StyleKey key = run_key;
+      key.classes[2] = KNOWN_NAME_OF(missing);
+      if (!FormatMissing(line_builder, style_tree_.ComputedStyleOf(key),
+                         char_code)) {
+        return false;
+      }
+      text_scanner_->Next();
+      continue;
+    }
+
+    // Collect characters rendered with |font| and add them at once.
+    const auto text_start = text_scanner_->text_offset();
+    text_run_.clear();
+    while (text_scanner_->text_offset() < run_end) {
+      const auto next_char_code = text_scanner_->GetChar();
+      if (next_char_code == 0x0A || IsControl(next_char_code) ||
+          FontFor(style, next_char_code) != font) {
+        break;
+      }
+      text_run_.push_back(next_char_code);
+      text_scanner_->Next();
+    }
+    const auto num_added =
+        line_builder->TryAddText(style, *font, text_start, text_run_);
+    if (num_added == text_run_.size())
+      continue;
+    text_scanner_->set_text_offset(text_start + text::OffsetDelta(num_added));
+    return false;
+  }
+  return true;
+}
+
 bool TextFormatter::FormatTab(LineBuilder* line_builder,
                               const ComputedStyle& style) {
   const auto* font = FontFor(style, 'x');
@@ -348,4 +394,14 @@ bool TextFormatter::FormatTab(LineBuilder* line_builder,
   return true;
 }
 
+void TextFormatter::UpdateLineIndex(const RootInlineBox& line) {
+  if (line.IsEndOfLine()) {
+    line_index_ = 0;
+    return;
+  }
+  if (line_index_ == TextFormatContext::kUnknownLineIndex)
+    return;
+  ++line_index_;
+}
+
 }  // namespace layout
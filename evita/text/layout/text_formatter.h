@@ -8,14 +8,11 @@
 #include <memory>
 
 #include "base/macros.h"
+#include "base/strings/string16.h"
 #include "evita/gfx/rect_f.h"
 #include "evita/text/models/offset.h"
 #include "evita/text/style/computed_style.h"
 
-namespace css {
-class Selector;
-}
-
 namespace gfx {
 class Font;
 }
@@ -30,6 +27,7 @@ namespace layout {
 class InlineBox;
 class LineBuilder;
 class RootInlineBox;
+struct StyleKey;
 class StyleTree;
 class TextFormatContext;
 enum class TextMarker;
@@ -41,6 +39,10 @@ class TextFormatter final {
   explicit TextFormatter(const TextFormatContext& context);
   ~TextFormatter();
 
+  // Returns index of the next visual line in its logical line, or
+  // |TextFormatContext::kUnknownLineIndex| if we started formatting in
+  // middle of logical line without knowing index.
+  int line_index() const { return line_index_; }
   text::Offset text_offset() const;
 
   void DidFormat(const RootInlineBox* line);
@@ -49,22 +51,31 @@ class TextFormatter final {
  private:
   class TextScanner;
 
-  const ComputedStyle& ComputedStyleOf(const css::Selector& selector) const;
   const gfx::Font* FontFor(const ComputedStyle& style,
                            base::char16 char_code) const;
-  bool FormatChar(LineBuilder* line_builder, base::char16 char_code);
+  bool FormatControl(LineBuilder* line_builder,
+                     const StyleKey& run_key,
+                     base::char16 char_code);
   void FormatMarker(LineBuilder* line_buffer,
                     TextMarker marker_name,
                     text::OffsetDelta length);
   bool FormatMissing(LineBuilder* line_builder,
                      const ComputedStyle& style,
                      base::char16 char_code);
+  // Formats characters until end of style run or end of line. Returns false
+  // if |line_builder| has no room for the next character.
+  bool FormatRun(LineBuilder* line_builder);
   bool FormatTab(LineBuilder* line_builder, const ComputedStyle& style);
+  // Updates |line_index_| for the line after |line|.
+  void UpdateLineIndex(const RootInlineBox& line);
 
   const gfx::RectF bounds_;
   const ComputedStyle& default_computed_style_;
+  int line_index_;
   text::Offset line_start_;
   const StyleTree& style_tree_;
+  // Characters rendered with same font in a style run.
+  base::string16 text_run_;
   std::unique_ptr<TextScanner> text_scanner_;
   const float zoom_;
 
@@ -0,0 +1,104 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "evita/base/strings/atomic_string.h"
+#include "evita/base/testing/perf_test_util.h"
+#include "evita/text/layout/line/root_inline_box.h"
+#include "evita/text/layout/text_format_context.h"
+#include "evita/text/layout/text_formatter.h"
+#include "evita/text/layout/text_layout_test_base.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/marker_set.h"
+#include "evita/text/models/static_range.h"
+
+namespace layout {
+
+namespace {
+
+const int kNumberOfLines = 200;
+const int kLineLength = 2000;
+// Length of each syntax token in highlighted lines.
+const int kTokenLength = 5;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// TextFormatterPerfTest
+//
+class TextFormatterPerfTest : public TextLayoutTestBase {
+ protected:
+  TextFormatterPerfTest();
+  ~TextFormatterPerfTest() override = default;
+
+  void HighlightTokens();
+  void PopulateBuffer();
+  void RunFormatTest(const std::string& trace);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TextFormatterPerfTest);
+};
+
+TextFormatterPerfTest::TextFormatterPerfTest() {
+  set_bounds(gfx::RectF(gfx::PointF(0, 0), gfx::SizeF(1000, 800)));
+}
+
+void TextFormatterPerfTest::HighlightTokens() {
+  const base::AtomicString keyword(L"keyword");
+  const base::AtomicString identifier(L"identifier");
+  auto const end = buffer()->GetEnd();
+  auto is_keyword = true;
+  for (auto offset = text::Offset(0); offset < end;
+       offset += text::OffsetDelta(kTokenLength)) {
+    auto const token_end =
+        std::min(offset + text::OffsetDelta(kTokenLength - 1), end);
+    buffer()->syntax_markers()->InsertMarker(
+        text::StaticRange(*buffer(), offset, token_end),
+        is_keyword ? keyword : identifier);
+    is_keyword = !is_keyword;
+  }
+}
+
+void TextFormatterPerfTest::PopulateBuffer() {
+  base::string16 line;
+  for (auto index = 0; index < kLineLength; ++index)
+    line.push_back(index % kTokenLength == kTokenLength - 1 ? ' ' : 'x');
+  line.push_back('\n');
+  for (auto index = 0; index < kNumberOfLines; ++index)
+    buffer()->InsertBefore(buffer()->GetEnd(), line);
+}
+
+void TextFormatterPerfTest::RunFormatTest(const std::string& trace) {
+  auto num_lines = 0;
+  const auto elapsed = base::MeasureTime([&]() {
+    TextFormatter formatter(FormatContextFor(text::Offset(0)));
+    for (;;) {
+      const auto line = formatter.FormatLine();
+      ++num_lines;
+      if (line->IsEndOfDocument())
+        break;
+      formatter.DidFormat(line.get());
+    }
+  });
+  base::PrintPerfResult("format_line", trace, num_lines / elapsed.InSecondsF(),
+                        "lines/s");
+}
+
+TEST_F(TextFormatterPerfTest, FormatLine) {
+  PopulateBuffer();
+  RunFormatTest("plain");
+}
+
+TEST_F(TextFormatterPerfTest, FormatLineHighlighted) {
+  PopulateBuffer();
+  HighlightTokens();
+  RunFormatTest("highlighted");
+}
+
+}  // namespace layout
@@ -163,4 +163,31 @@ TEST_F(TextFormatterTest, FormatLineWrap) {
   EXPECT_EQ(text::Offset(8), line3->text_end()) << "document.length + 1";
   EXPECT_TRUE(line3->IsContinuedLine());
 }
+
+TEST_F(TextFormatterTest, FormatLineWrapInStyleRun) {
+  buffer()->InsertBefore(text::Offset(0), L"0123456");
+  buffer()->syntax_markers()->InsertMarker(
+      text::StaticRange(*buffer(), text::Offset(1), text::Offset(5)),
+      base::AtomicString(L"keyword"));
+  set_bounds(gfx::RectF(gfx::SizeF(40.0f, 50.0f)));
+  TextFormatter formatter1(FormatContextFor(text::Offset(0)));
+  // View:
+  //    0[12>
+  //    34]5>
+  //    6<
+  const auto line1 = formatter1.FormatLine();
+  EXPECT_EQ(TextMarker::LineWrap,
+            line1->boxes().back()->as<InlineMarkerBox>()->marker_name());
+  EXPECT_EQ(text::Offset(3), line1->text_end());
+
+  const auto line2 = formatter1.FormatLine();
+  EXPECT_EQ(text::Offset(3), line2->text_start());
+  EXPECT_EQ(text::Offset(6), line2->text_end())
+      << "Style run starting at previous line continues.";
+
+  const auto line3 = formatter1.FormatLine();
+  EXPECT_EQ(text::Offset(6), line3->text_start());
+  EXPECT_EQ(text::Offset(8), line3->text_end());
+}
+
 }  // namespace layout
@@ -50,7 +50,8 @@ TextFormatContext TextLayoutTestBase::FormatContextFor(
     text::Offset line_start,
     text::Offset offset) const {
   return TextFormatContext(*buffer_, *markers_, *style_tree_, line_start,
-                           offset, bounds_, zoom_);
+                           offset, TextFormatContext::kUnknownLineIndex,
+                           bounds_, zoom_);
 }
 
 TextFormatContext TextLayoutTestBase::FormatContextFor(
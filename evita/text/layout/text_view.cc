@@ -57,6 +57,15 @@ TextView::TextView(const text::Buffer& buffer,
 
 TextView::~TextView() {}
 
+int TextView::num_visible_lines() const {
+  DCHECK(!block_->NeedsFormat());
+  return static_cast<int>(block_->lines().size());
+}
+
+int TextView::num_visual_lines() const {
+  return block_->num_visual_lines();
+}
+
 text::Offset TextView::text_end() const {
   DCHECK(!block_->NeedsFormat());
   return block_->text_end();
@@ -90,6 +99,10 @@ gfx::RectF TextView::ComputeCaretBounds(
                     char_rect.bottom);
 }
 
+text::Offset TextView::ComputeOffsetOfVisualLine(int visual_line) {
+  return block_->ComputeOffsetOfVisualLine(visual_line);
+}
+
 text::Offset TextView::ComputeStartOfLine(text::Offset text_offset) const {
   return block_->ComputeStartOfLine(text_offset);
 }
@@ -98,6 +111,14 @@ text::Offset TextView::ComputeVisibleEnd() const {
   return block_->ComputeVisibleEnd();
 }
 
+int TextView::ComputeVisualLineOf(text::Offset text_offset) {
+  return block_->ComputeVisualLineOf(text_offset);
+}
+
+void TextView::DidCommitLayout() {
+  style_tree_->DidCommitLayout();
+}
+
 void TextView::Format(text::Offset text_offset) {
   block_->Format(text_offset);
 }
@@ -129,6 +150,18 @@ text::Offset TextView::MapPointXToOffset(text::Offset text_offset,
   return block_->MapPointXToOffset(text_offset, point_x);
 }
 
+bool TextView::NeedsPreformat() const {
+  return block_->NeedsPreformat();
+}
+
+bool TextView::NeedsUpdateVisualLineIndex() const {
+  return block_->NeedsUpdateVisualLineIndex();
+}
+
+bool TextView::Preformat(const base::TimeTicks& deadline) {
+  return block_->Preformat(deadline);
+}
+
 bool TextView::ScrollDown() {
   return block_->ScrollDown();
 }
@@ -164,4 +197,8 @@ void TextView::Update(const TextSelectionModel& selection_model) {
   ScrollToPosition(new_caret_offset);
 }
 
+bool TextView::UpdateVisualLineIndex(const base::TimeTicks& deadline) {
+  return block_->UpdateVisualLineIndex(deadline);
+}
+
 }  // namespace layout
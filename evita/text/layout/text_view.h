@@ -56,6 +56,9 @@ class TextView final {
 
   const BlockFlow& block() const { return *block_; }
   const text::Buffer& buffer() const { return buffer_; }
+  // Returns number of lines in view port including partially visible line.
+  int num_visible_lines() const;
+  int num_visual_lines() const;
   text::Offset text_end() const;
   text::Offset text_start() const;
   float zoom() const;
@@ -63,11 +66,17 @@ class TextView final {
   // Returns end of line offset containing |text_offset|.
   text::Offset ComputeEndOfLine(text::Offset text_offset) const;
   gfx::RectF ComputeCaretBounds(const TextSelectionModel& selection) const;
+  // Returns start offset of visual line |visual_line|.
+  text::Offset ComputeOffsetOfVisualLine(int visual_line);
   // Returns start of line offset containing |text_offset|.
   text::Offset ComputeStartOfLine(text::Offset text_offset) const;
   // Returns fully visible end offset or end of line position if there is only
   // one line.
   text::Offset ComputeVisibleEnd() const;
+  // Returns visual line number of line containing |text_offset|.
+  int ComputeVisualLineOf(text::Offset text_offset);
+  // Called after paint view is built from |block()|.
+  void DidCommitLayout();
   void Format(text::Offset text_offset);
   // Returns true if text format is taken place.
   bool FormatIfNeeded();
@@ -75,11 +84,17 @@ class TextView final {
   void MakeSelectionVisible();
   text::Offset HitTestPoint(gfx::PointF point);
   text::Offset MapPointXToOffset(text::Offset text_offset, float point_x) const;
+  bool NeedsPreformat() const;
+  bool NeedsUpdateVisualLineIndex() const;
+  // Returns true if there are more lines to pre-format.
+  bool Preformat(const base::TimeTicks& deadline);
   bool ScrollDown();
   bool ScrollUp();
   void SetBounds(const gfx::RectF& new_bounds);
   void SetZoom(float new_zoom);
   void Update(const TextSelectionModel& selection);
+  // Returns true if visual line index needs more update.
+  bool UpdateVisualLineIndex(const base::TimeTicks& deadline);
 
  private:
   void ScrollToPosition(text::Offset offset);
@@ -0,0 +1,394 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <utility>
+
+#include "evita/text/layout/visual_line_index.h"
+
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/static_range.h"
+
+namespace layout {
+
+namespace {
+
+// A chunk is closed at end of line after |kMaxNewlinesPerChunk| newlines or
+// |kMaxChunkLength| characters, so formatting a chunk in idle time is
+// bounded unless a line is very long.
+const int kMaxChunkLength = 16 * 1024;
+const int kMaxNewlinesPerChunk = 64;
+
+// Inserting text shorter than |kMaxGrowingInsertion|, e.g. typing newline,
+// grows chunk up to twice of limits rather than splitting it, so we don't
+// need to rebuild trees.
+const int kMaxGrowingInsertion = 64;
+
+bool ContainsNewline(const text::Buffer& buffer,
+                     text::Offset start,
+                     text::Offset end) {
+  for (auto offset = start; offset < end; ++offset) {
+    if (buffer.GetCharAt(offset) == 0x0A)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// VisualLineIndex::SumTree
+//
+VisualLineIndex::SumTree::SumTree() : nodes_(1, 0) {}
+VisualLineIndex::SumTree::~SumTree() {}
+
+void VisualLineIndex::SumTree::Add(size_t index, int delta) {
+  for (auto node = index + 1; node < nodes_.size(); node += node & (~node + 1))
+    nodes_[node] += delta;
+}
+
+size_t VisualLineIndex::SumTree::IndexOf(int value) const {
+  const auto size = nodes_.size() - 1;
+  auto step = size_t(1);
+  while (step * 2 <= size)
+    step *= 2;
+  auto index = size_t(0);
+  auto rest = value;
+  for (; step; step /= 2) {
+    if (index + step > size || nodes_[index + step] > rest)
+      continue;
+    index += step;
+    rest -= nodes_[index];
+  }
+  return index;
+}
+
+template <typename ValueOf>
+void VisualLineIndex::SumTree::Reset(size_t first,
+                                     size_t size,
+                                     const ValueOf& value_of) {
+  nodes_.resize(size + 1);
+  for (auto node = first + 1; node < nodes_.size(); ++node)
+    nodes_[node] = value_of(node - 1);
+  // Nodes of entries before |first| are kept. Add ones on path of
+  // |SumBefore(first)| to their parents, which cover entries at or after
+  // |first|.
+  for (auto node = first; node; node -= node & (~node + 1)) {
+    const auto parent = node + (node & (~node + 1));
+    if (parent < nodes_.size())
+      nodes_[parent] += nodes_[node];
+  }
+  for (auto node = first + 1; node < nodes_.size(); ++node) {
+    const auto parent = node + (node & (~node + 1));
+    if (parent < nodes_.size())
+      nodes_[parent] += nodes_[node];
+  }
+}
+
+int VisualLineIndex::SumTree::SumBefore(size_t index) const {
+  auto sum = 0;
+  for (auto node = index; node; node -= node & (~node + 1))
+    sum += nodes_[node];
+  return sum;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// VisualLineIndex
+//
+VisualLineIndex::VisualLineIndex(const text::Buffer& buffer) : buffer_(buffer) {
+  ResetUnscanned(0, buffer_.GetEnd());
+  if (has_unscanned_)
+    ScanUnscanned();
+  buffer_.AddObserver(this);
+}
+
+VisualLineIndex::~VisualLineIndex() {
+  buffer_.RemoveObserver(this);
+}
+
+int VisualLineIndex::num_visual_lines() const {
+  return visual_line_tree_.SumBefore(entries_.size());
+}
+
+VisualLineIndex::Chunk VisualLineIndex::ChunkAt(text::Offset offset) const {
+  return ChunkOf(IndexAt(offset));
+}
+
+VisualLineIndex::Chunk VisualLineIndex::ChunkOf(size_t index) const {
+  DCHECK_LT(index, entries_.size());
+  const auto& entry = entries_[index];
+  Chunk chunk;
+  chunk.index = index;
+  chunk.start = text::Offset(length_tree_.SumBefore(index));
+  chunk.end = chunk.start + text::OffsetDelta(entry.length);
+  chunk.visual_line = visual_line_tree_.SumBefore(index);
+  chunk.num_visual_lines = entry.num_visual_lines;
+  chunk.is_dirty = entry.is_dirty;
+  chunk.is_last = index + 1 == entries_.size();
+  return chunk;
+}
+
+VisualLineIndex::Chunk VisualLineIndex::ChunkOfVisualLine(
+    int visual_line) const {
+  const auto index = visual_line_tree_.IndexOf(std::max(visual_line, 0));
+  return ChunkOf(std::min(index, entries_.size() - 1));
+}
+
+VisualLineIndex::Chunk VisualLineIndex::DirtyChunkNear(text::Offset offset) {
+  DCHECK(!is_clean());
+  const auto start = IndexAt(offset);
+  for (size_t count = 0; count < entries_.size(); ++count) {
+    const auto index = (start + count) % entries_.size();
+    if (!entries_[index].is_dirty)
+      continue;
+    if (IsUnscanned(index))
+      ScanUnscanned();
+    return ChunkOf(index);
+  }
+  NOTREACHED() << "num_dirty_chunks_=" << num_dirty_chunks_;
+  return ChunkOf(start);
+}
+
+int VisualLineIndex::EstimateNumVisualLines(int length) const {
+  if (num_scanned_chars_ == 0)
+    return 1;
+  return std::max(static_cast<int>(length * num_scanned_newlines_ /
+                                   num_scanned_chars_),
+                  1);
+}
+
+size_t VisualLineIndex::IndexAt(text::Offset offset) const {
+  const auto index = length_tree_.IndexOf(offset.value());
+  return std::min(index, entries_.size() - 1);
+}
+
+void VisualLineIndex::Invalidate() {
+  for (auto& entry : entries_)
+    entry.is_dirty = true;
+  num_dirty_chunks_ = static_cast<int>(entries_.size());
+  ++version_;
+}
+
+bool VisualLineIndex::IsUnscanned(size_t index) const {
+  return has_unscanned_ && index + 1 == entries_.size();
+}
+
+void VisualLineIndex::MarkEntryDirty(size_t index) {
+  auto& entry = entries_[index];
+  if (entry.is_dirty)
+    return;
+  entry.is_dirty = true;
+  ++num_dirty_chunks_;
+}
+
+void VisualLineIndex::RebuildTrees(size_t first) {
+  TRACE_EVENT0("views", "VisualLineIndex::RebuildTrees");
+  length_tree_.Reset(first, entries_.size(), [this](size_t index) {
+    return entries_[index].length;
+  });
+  visual_line_tree_.Reset(first, entries_.size(), [this](size_t index) {
+    return entries_[index].num_visual_lines;
+  });
+}
+
+void VisualLineIndex::ReplaceEntries(size_t first,
+                                     size_t last,
+                                     std::vector<Entry> new_entries) {
+  if (first == last && first < entries_.size() && new_entries.size() == 1) {
+    // Keep number of visual lines as estimation.
+    const auto& old_entry = entries_[first];
+    auto& new_entry = new_entries.front();
+    new_entry.num_visual_lines =
+        std::max(old_entry.num_visual_lines + new_entry.num_newlines -
+                     old_entry.num_newlines,
+                 1);
+    SetLength(first, new_entry.length);
+    visual_line_tree_.Add(
+        first, new_entry.num_visual_lines - old_entry.num_visual_lines);
+    if (!old_entry.is_dirty)
+      ++num_dirty_chunks_;
+    entries_[first] = new_entry;
+    return;
+  }
+  const auto end_index = std::min(last + 1, entries_.size());
+  for (auto index = first; index < end_index; ++index) {
+    if (entries_[index].is_dirty)
+      --num_dirty_chunks_;
+  }
+  if (!new_entries.empty() && new_entries.size() == end_index - first) {
+    // Update trees without rebuilding, since number of entries isn't
+    // changed, e.g. joining lines at end of chunk.
+    num_dirty_chunks_ += static_cast<int>(new_entries.size());
+    for (auto index = first; index < end_index; ++index) {
+      const auto& new_entry = new_entries[index - first];
+      SetLength(index, new_entry.length);
+      visual_line_tree_.Add(index, new_entry.num_visual_lines -
+                                       entries_[index].num_visual_lines);
+      entries_[index] = new_entry;
+    }
+    return;
+  }
+  entries_.erase(entries_.begin() + first, entries_.begin() + end_index);
+  if (entries_.empty() && new_entries.empty())
+    new_entries.push_back(Entry{0, 0, 1, true});
+  num_dirty_chunks_ += static_cast<int>(new_entries.size());
+  entries_.insert(entries_.begin() + first, new_entries.begin(),
+                  new_entries.end());
+  RebuildTrees(first);
+}
+
+void VisualLineIndex::ResetUnscanned(size_t first, text::Offset end) {
+  const auto start = text::Offset(length_tree_.SumBefore(first));
+  for (auto index = first; index < entries_.size(); ++index) {
+    if (entries_[index].is_dirty)
+      --num_dirty_chunks_;
+  }
+  entries_.erase(entries_.begin() + first, entries_.end());
+  const auto length = (end - start).value();
+  has_unscanned_ = length > 0;
+  if (has_unscanned_ || entries_.empty()) {
+    entries_.push_back(
+        Entry{length, 0, has_unscanned_ ? EstimateNumVisualLines(length) : 1,
+              true});
+    ++num_dirty_chunks_;
+  }
+  RebuildTrees(first);
+}
+
+std::vector<VisualLineIndex::Entry> VisualLineIndex::ScanEntries(
+    text::Offset start,
+    text::Offset end,
+    int scale,
+    size_t max_entries) const {
+  TRACE_EVENT0("views", "VisualLineIndex::ScanEntries");
+  std::vector<Entry> entries;
+  auto entry = Entry{0, 0, 0, true};
+  for (auto line_start = start;
+       line_start < end && entries.size() < max_entries;) {
+    const auto newline = buffer_.ComputeEndOfLine(line_start);
+    if (newline >= end) {
+      // The last line without newline.
+      entry.length += (end - line_start).value();
+      ++entry.num_visual_lines;
+      break;
+    }
+    const auto line_end = newline + text::OffsetDelta(1);
+    entry.length += (line_end - line_start).value();
+    ++entry.num_newlines;
+    ++entry.num_visual_lines;
+    line_start = line_end;
+    if (entry.num_newlines < kMaxNewlinesPerChunk * scale &&
+        entry.length < kMaxChunkLength * scale) {
+      continue;
+    }
+    entries.push_back(entry);
+    entry = Entry{0, 0, 0, true};
+  }
+  if (entry.length > 0)
+    entries.push_back(entry);
+  return entries;
+}
+
+void VisualLineIndex::ScanUnscanned() {
+  DCHECK(has_unscanned_);
+  const auto index = entries_.size() - 1;
+  const auto& chunk = ChunkOf(index);
+  auto entries = ScanEntries(chunk.start, chunk.end, 1, 1);
+  DCHECK_EQ(1u, entries.size());
+  const auto& entry = entries.front();
+  num_scanned_chars_ += entry.length;
+  num_scanned_newlines_ += entry.num_newlines;
+  const auto rest = (chunk.end - chunk.start).value() - entry.length;
+  has_unscanned_ = rest > 0;
+  if (has_unscanned_)
+    entries.push_back(Entry{rest, 0, EstimateNumVisualLines(rest), true});
+  entries_.pop_back();
+  entries_.insert(entries_.end(), entries.begin(), entries.end());
+  num_dirty_chunks_ += static_cast<int>(entries.size()) - 1;
+  RebuildTrees(index);
+  ++version_;
+}
+
+void VisualLineIndex::SetLength(size_t index, int new_length) {
+  auto& entry = entries_[index];
+  length_tree_.Add(index, new_length - entry.length);
+  entry.length = new_length;
+}
+
+void VisualLineIndex::SetNumVisualLines(const Chunk& chunk,
+                                        int num_visual_lines) {
+  DCHECK_LT(chunk.index, entries_.size());
+  DCHECK_EQ(chunk.start.value(), length_tree_.SumBefore(chunk.index));
+  DCHECK(!IsUnscanned(chunk.index));
+  ++version_;
+  auto& entry = entries_[chunk.index];
+  const auto new_num_visual_lines = std::max(num_visual_lines, 1);
+  visual_line_tree_.Add(chunk.index,
+                        new_num_visual_lines - entry.num_visual_lines);
+  entry.num_visual_lines = new_num_visual_lines;
+  if (!entry.is_dirty)
+    return;
+  entry.is_dirty = false;
+  --num_dirty_chunks_;
+}
+
+// text::BufferMutationObserver
+void VisualLineIndex::DidDeleteAt(const text::StaticRange& range) {
+  // Note: |length_tree_| isn't updated yet, so offsets of chunks are
+  // offsets before deletion.
+  const auto length = range.length().value();
+  if (length == 0)
+    return;
+  ++version_;
+  const auto first = IndexAt(range.start());
+  if (!is_deleting_newline_ || IsUnscanned(first)) {
+    DCHECK_EQ(first, IndexAt(range.end() - text::OffsetDelta(1)));
+    SetLength(first, entries_[first].length - length);
+    MarkEntryDirty(first);
+    return;
+  }
+  // Deleting newline joins lines, the last line of a chunk may join the
+  // first line of the next chunk.
+  const auto last = IndexAt(range.end());
+  if (IsUnscanned(last)) {
+    ResetUnscanned(first, ChunkOf(last).end - range.length());
+    return;
+  }
+  ReplaceEntries(first, last,
+                 ScanEntries(ChunkOf(first).start,
+                             ChunkOf(last).end - range.length(), 1));
+}
+
+void VisualLineIndex::DidInsertBefore(const text::StaticRange& range) {
+  // Note: |length_tree_| isn't updated yet, so offsets of chunks are
+  // offsets before insertion.
+  ++version_;
+  const auto index = IndexAt(range.start());
+  if (IsUnscanned(index) ||
+      !ContainsNewline(buffer_, range.start(), range.end())) {
+    SetLength(index, entries_[index].length + range.length().value());
+    MarkEntryDirty(index);
+    return;
+  }
+  const auto& chunk = ChunkOf(index);
+  const auto end = chunk.end + range.length();
+  if (range.length().value() < kMaxGrowingInsertion) {
+    auto entries = ScanEntries(chunk.start, end, 2);
+    if (entries.size() == 1) {
+      ReplaceEntries(index, index, std::move(entries));
+      return;
+    }
+  }
+  ReplaceEntries(index, index, ScanEntries(chunk.start, end, 1));
+}
+
+void VisualLineIndex::WillDeleteAt(const text::StaticRange& range) {
+  is_deleting_newline_ = ContainsNewline(buffer_, range.start(), range.end());
+}
+
+}  // namespace layout
@@ -0,0 +1,160 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_LAYOUT_VISUAL_LINE_INDEX_H_
+#define EVITA_TEXT_LAYOUT_VISUAL_LINE_INDEX_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "evita/text/models/buffer_mutation_observer.h"
+#include "evita/text/models/offset.h"
+
+namespace text {
+class Buffer;
+class StaticRange;
+}
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// VisualLineIndex
+//
+// |VisualLineIndex| holds number of visual lines, e.g. lines wrapped at
+// width of view, of each chunk of logical lines. Chunks start at start of
+// logical line and are indexed by Fenwick tree for mapping offset and
+// visual line number to chunk in O(log n).
+//
+// Number of visual lines of dirty chunk is an estimation, e.g. number of
+// visual lines before invalidation or number of logical lines. |BlockFlow|
+// formats dirty chunks in idle time and updates the index by
+// |SetNumVisualLines()|.
+//
+// Only the first chunk is scanned at construction. Text after scanned chunks
+// is held in the last dirty chunk, the unscanned chunk, whose number of
+// visual lines is estimated from scanned chunks. |DirtyChunkNear()| splits
+// chunks off the unscanned chunk on demand, so opening a large document
+// doesn't scan whole text.
+//
+class VisualLineIndex final : public text::BufferMutationObserver {
+ public:
+  struct Chunk {
+    size_t index;
+    text::Offset start;
+    text::Offset end;
+    // Visual line number of |start|.
+    int visual_line;
+    int num_visual_lines;
+    bool is_dirty;
+    bool is_last;
+  };
+
+  explicit VisualLineIndex(const text::Buffer& buffer);
+  ~VisualLineIndex() final;
+
+  bool is_clean() const { return num_dirty_chunks_ == 0; }
+  size_t num_chunks() const { return entries_.size(); }
+  int num_visual_lines() const;
+  // Incremented when chunks or number of visual lines are changed.
+  int version() const { return version_; }
+
+  // Returns chunk containing |offset|.
+  Chunk ChunkAt(text::Offset offset) const;
+  // Returns chunk containing |visual_line|.
+  Chunk ChunkOfVisualLine(int visual_line) const;
+  // Returns the first dirty chunk at or after chunk containing |offset|,
+  // wrapping around to the start of document. Index must be dirty. The
+  // returned chunk is scanned from the unscanned chunk if needed.
+  Chunk DirtyChunkNear(text::Offset offset);
+  // Marks all chunks dirty, e.g. when width of view or zoom is changed.
+  void Invalidate();
+  void SetNumVisualLines(const Chunk& chunk, int num_visual_lines);
+
+ private:
+  struct Entry {
+    int length;
+    int num_newlines;
+    int num_visual_lines;
+    bool is_dirty;
+  };
+
+  // Fenwick tree of |int|.
+  class SumTree final {
+   public:
+    SumTree();
+    ~SumTree();
+
+    void Add(size_t index, int delta);
+    // Returns index of entry containing |value|, or number of entries if
+    // |value| is greater than or equal to sum of all entries.
+    size_t IndexOf(int value) const;
+    // Rebuilds nodes for |size| entries from |first| by |value_of(index)|
+    // without touching nodes of entries before |first|.
+    template <typename ValueOf>
+    void Reset(size_t first, size_t size, const ValueOf& value_of);
+    // Returns sum of entries before |index|.
+    int SumBefore(size_t index) const;
+
+   private:
+    std::vector<int> nodes_;
+
+    DISALLOW_COPY_AND_ASSIGN(SumTree);
+  };
+
+  Chunk ChunkOf(size_t index) const;
+  // Returns estimated number of visual lines of unscanned text of |length|.
+  int EstimateNumVisualLines(int length) const;
+  size_t IndexAt(text::Offset offset) const;
+  bool IsUnscanned(size_t index) const;
+  void MarkEntryDirty(size_t index);
+  // Rebuilds trees for entries at or after |first|.
+  void RebuildTrees(size_t first);
+  // Replaces entries between |first| and |last|, inclusive, by
+  // |new_entries|. Trees are updated in place if number of entries isn't
+  // changed.
+  void ReplaceEntries(size_t first,
+                      size_t last,
+                      std::vector<Entry> new_entries);
+  // Replaces entries at or after |first| by the unscanned chunk of text
+  // from start of entry |first| to |end|.
+  void ResetUnscanned(size_t first, text::Offset end);
+  // Returns entries for text between |start| and |end| with limits of chunk
+  // size multiplied by |scale|, up to |max_entries| entries.
+  std::vector<Entry> ScanEntries(text::Offset start,
+                                 text::Offset end,
+                                 int scale,
+                                 size_t max_entries = SIZE_MAX) const;
+  // Splits the first chunk off the unscanned chunk.
+  void ScanUnscanned();
+  void SetLength(size_t index, int new_length);
+
+  // text::BufferMutationObserver
+  void DidDeleteAt(const text::StaticRange& range) final;
+  void DidInsertBefore(const text::StaticRange& range) final;
+  void WillDeleteAt(const text::StaticRange& range) final;
+
+  const text::Buffer& buffer_;
+  std::vector<Entry> entries_;
+  // True if the last entry is the unscanned chunk.
+  bool has_unscanned_ = false;
+  // True if text being deleted contains newline.
+  bool is_deleting_newline_ = false;
+  SumTree length_tree_;
+  int num_dirty_chunks_ = 0;
+  // Total length and number of newlines of scanned chunks for estimating
+  // number of visual lines of the unscanned chunk.
+  int64_t num_scanned_chars_ = 0;
+  int64_t num_scanned_newlines_ = 0;
+  int version_ = 0;
+  SumTree visual_line_tree_;
+
+  DISALLOW_COPY_AND_ASSIGN(VisualLineIndex);
+};
+
+}  // namespace layout
+
+#endif  // EVITA_TEXT_LAYOUT_VISUAL_LINE_INDEX_H_
@@ -0,0 +1,204 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/text/layout/text_layout_test_base.h"
+
+#include "base/strings/string16.h"
+#include "evita/text/layout/visual_line_index.h"
+#include "evita/text/models/buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace layout {
+
+//////////////////////////////////////////////////////////////////////
+//
+// VisualLineIndexTest
+//
+class VisualLineIndexTest : public TextLayoutTestBase {
+ protected:
+  VisualLineIndexTest();
+  ~VisualLineIndexTest() override = default;
+
+  VisualLineIndex* index() const { return index_.get(); }
+
+  void PopulateLines(int num_lines);
+
+ private:
+  const std::unique_ptr<VisualLineIndex> index_;
+
+  DISALLOW_COPY_AND_ASSIGN(VisualLineIndexTest);
+};
+
+VisualLineIndexTest::VisualLineIndexTest()
+    : index_(new VisualLineIndex(*buffer())) {}
+
+void VisualLineIndexTest::PopulateLines(int num_lines) {
+  base::string16 text;
+  for (auto count = 0; count < num_lines; ++count)
+    text += L"a\n";
+  buffer()->InsertBefore(text::Offset(0), text);
+}
+
+TEST_F(VisualLineIndexTest, Empty) {
+  EXPECT_EQ(1u, index()->num_chunks());
+  EXPECT_EQ(1, index()->num_visual_lines());
+  const auto& chunk = index()->ChunkAt(text::Offset(0));
+  EXPECT_EQ(text::Offset(0), chunk.start);
+  EXPECT_EQ(text::Offset(0), chunk.end);
+  EXPECT_TRUE(chunk.is_last);
+}
+
+TEST_F(VisualLineIndexTest, ChunkAt) {
+  PopulateLines(100);
+  EXPECT_EQ(2u, index()->num_chunks());
+  EXPECT_EQ(100, index()->num_visual_lines())
+      << "Number of visual lines is estimated by number of logical lines.";
+
+  const auto& chunk0 = index()->ChunkAt(text::Offset(127));
+  EXPECT_EQ(0u, chunk0.index);
+  EXPECT_EQ(text::Offset(0), chunk0.start);
+  EXPECT_EQ(text::Offset(128), chunk0.end);
+
+  const auto& chunk1 = index()->ChunkAt(text::Offset(128));
+  EXPECT_EQ(1u, chunk1.index);
+  EXPECT_EQ(text::Offset(128), chunk1.start);
+  EXPECT_EQ(text::Offset(200), chunk1.end);
+  EXPECT_EQ(64, chunk1.visual_line);
+  EXPECT_TRUE(chunk1.is_last);
+
+  EXPECT_EQ(1u, index()->ChunkAt(text::Offset(200)).index);
+}
+
+TEST_F(VisualLineIndexTest, ChunkOfVisualLine) {
+  PopulateLines(100);
+  EXPECT_EQ(0u, index()->ChunkOfVisualLine(-1).index);
+  EXPECT_EQ(0u, index()->ChunkOfVisualLine(63).index);
+  EXPECT_EQ(1u, index()->ChunkOfVisualLine(64).index);
+  EXPECT_EQ(1u, index()->ChunkOfVisualLine(1000).index);
+}
+
+TEST_F(VisualLineIndexTest, DidDeleteAt) {
+  PopulateLines(100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(0)), 100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(128)), 36);
+  EXPECT_TRUE(index()->is_clean());
+
+  buffer()->Delete(text::Offset(0), text::Offset(1));
+  EXPECT_FALSE(index()->is_clean());
+  EXPECT_EQ(2u, index()->num_chunks());
+  EXPECT_EQ(136, index()->num_visual_lines())
+      << "Deleting characters other than newline keeps visual lines.";
+  EXPECT_EQ(text::Offset(127), index()->ChunkAt(text::Offset(127)).start);
+
+  // Join the last line of the first chunk and the first line of the second
+  // chunk.
+  buffer()->Delete(text::Offset(126), text::Offset(127));
+  EXPECT_EQ(2u, index()->num_chunks());
+  EXPECT_EQ(99, index()->num_visual_lines());
+  EXPECT_EQ(text::Offset(128), index()->ChunkAt(text::Offset(128)).start);
+}
+
+TEST_F(VisualLineIndexTest, DidInsertBefore) {
+  PopulateLines(100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(0)), 100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(128)), 36);
+
+  buffer()->InsertBefore(text::Offset(0), L"xyz");
+  EXPECT_EQ(136, index()->num_visual_lines());
+  EXPECT_EQ(text::Offset(131), index()->ChunkAt(text::Offset(131)).start);
+  EXPECT_TRUE(index()->ChunkAt(text::Offset(0)).is_dirty);
+  EXPECT_FALSE(index()->ChunkAt(text::Offset(131)).is_dirty);
+
+  buffer()->InsertBefore(text::Offset(131), L"b\n");
+  EXPECT_EQ(2u, index()->num_chunks());
+  EXPECT_EQ(137, index()->num_visual_lines());
+  EXPECT_EQ(text::Offset(205), index()->ChunkAt(text::Offset(131)).end);
+}
+
+TEST_F(VisualLineIndexTest, DidInsertBeforeGrowChunk) {
+  PopulateLines(100);
+
+  buffer()->InsertBefore(text::Offset(0), L"\n");
+  EXPECT_EQ(2u, index()->num_chunks())
+      << "Inserting a few characters grows chunk rather than splitting.";
+  EXPECT_EQ(101, index()->num_visual_lines());
+  EXPECT_EQ(text::Offset(129), index()->ChunkAt(text::Offset(129)).start);
+  EXPECT_EQ(65, index()->ChunkAt(text::Offset(129)).visual_line);
+
+  base::string16 text;
+  for (auto count = 0; count < 100; ++count)
+    text += L"x\n";
+  buffer()->InsertBefore(text::Offset(0), text);
+  EXPECT_EQ(4u, index()->num_chunks());
+  EXPECT_EQ(201, index()->num_visual_lines());
+  const auto& last_chunk = index()->ChunkAt(text::Offset(329));
+  EXPECT_EQ(3u, last_chunk.index);
+  EXPECT_EQ(text::Offset(329), last_chunk.start);
+  EXPECT_EQ(165, last_chunk.visual_line);
+}
+
+TEST_F(VisualLineIndexTest, Invalidate) {
+  PopulateLines(100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(0)), 100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(128)), 36);
+
+  index()->Invalidate();
+  EXPECT_FALSE(index()->is_clean());
+  EXPECT_EQ(136, index()->num_visual_lines())
+      << "Invalidation keeps number of visual lines as estimation.";
+  EXPECT_EQ(0u, index()->DirtyChunkNear(text::Offset(0)).index);
+  EXPECT_EQ(1u, index()->DirtyChunkNear(text::Offset(150)).index);
+}
+
+TEST_F(VisualLineIndexTest, ScanLazily) {
+  PopulateLines(1000);
+  VisualLineIndex index(*buffer());
+  EXPECT_EQ(2u, index.num_chunks())
+      << "Only the first chunk is scanned at construction.";
+  EXPECT_EQ(1000, index.num_visual_lines())
+      << "Visual lines of unscanned text are estimated by scanned chunks.";
+  EXPECT_EQ(text::Offset(128), index.ChunkAt(text::Offset(128)).start);
+  EXPECT_EQ(text::Offset(2000), index.ChunkAt(text::Offset(128)).end);
+
+  index.SetNumVisualLines(index.DirtyChunkNear(text::Offset(0)), 64);
+  const auto& chunk1 = index.DirtyChunkNear(text::Offset(0));
+  EXPECT_EQ(3u, index.num_chunks());
+  EXPECT_EQ(text::Offset(128), chunk1.start);
+  EXPECT_EQ(text::Offset(256), chunk1.end);
+
+  // Editing unscanned text doesn't scan it.
+  buffer()->InsertBefore(text::Offset(1000), L"x\n");
+  buffer()->Delete(text::Offset(500), text::Offset(600));
+  EXPECT_EQ(3u, index.num_chunks());
+  EXPECT_EQ(text::Offset(1902), index.ChunkAt(text::Offset(256)).end);
+
+  // Joining scanned chunk and unscanned text makes them unscanned.
+  buffer()->Delete(text::Offset(255), text::Offset(256));
+  EXPECT_EQ(2u, index.num_chunks());
+  EXPECT_EQ(text::Offset(128), index.ChunkAt(text::Offset(128)).start);
+
+  while (!index.is_clean()) {
+    const auto& chunk = index.DirtyChunkNear(text::Offset(0));
+    index.SetNumVisualLines(chunk, chunk.num_visual_lines);
+  }
+  EXPECT_EQ(text::Offset(1901), index.ChunkAt(text::Offset(1900)).end);
+}
+
+TEST_F(VisualLineIndexTest, SetNumVisualLines) {
+  PopulateLines(100);
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(0)), 100);
+  EXPECT_FALSE(index()->is_clean());
+  EXPECT_EQ(136, index()->num_visual_lines());
+  EXPECT_EQ(0u, index()->ChunkOfVisualLine(99).index);
+  EXPECT_EQ(1u, index()->ChunkOfVisualLine(100).index);
+  EXPECT_EQ(100, index()->ChunkOfVisualLine(100).visual_line);
+  EXPECT_EQ(1u, index()->DirtyChunkNear(text::Offset(0)).index);
+
+  index()->SetNumVisualLines(index()->ChunkAt(text::Offset(128)), 36);
+  EXPECT_TRUE(index()->is_clean());
+}
+
+}  // namespace layout
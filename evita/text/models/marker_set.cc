@@ -232,6 +232,7 @@ class MarkerSet::Impl final : public BufferMutationObserver {
   ~Impl() final;
 
   const Buffer& buffer() const { return buffer_; }
+  Kind kind() const { return kind_; }
 
   void AddObserver(MarkerSetObserver* observer);
   const Marker* GetMarkerAt(Offset offset) const;
@@ -429,6 +430,10 @@ const Buffer& MarkerSet::buffer() const {
   return impl_->buffer();
 }
 
+MarkerSet::Kind MarkerSet::kind() const {
+  return impl_->kind();
+}
+
 void MarkerSet::AddObserver(MarkerSetObserver* observer) const {
   impl_->AddObserver(observer);
 }
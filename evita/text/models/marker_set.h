@@ -37,6 +37,7 @@ class MarkerSet final {
   ~MarkerSet();
 
   const Buffer& buffer() const;
+  Kind kind() const;
 
   // Add |observer|
   void AddObserver(MarkerSetObserver* observer) const;
@@ -42,6 +42,9 @@ void DrawHLine(gfx::Canvas* canvas,
                float stroke_width,
                const gfx::StrokeStyle& stroke_style) {
   const auto size2 = stroke_width / 2;
+  canvas->RecordDraw(
+      gfx::DrawRecorder::Op::Line,
+      gfx::RectF(gfx::PointF(sx, y), gfx::PointF(ex, y + stroke_width)));
   (*canvas)->DrawLine(gfx::PointF(sx + size2, y + size2),
                       gfx::PointF(ex - size2, y + size2), brush, stroke_width,
                       stroke_style);
@@ -96,6 +99,7 @@ void DrawWave(gfx::Canvas* canvas,
                                  .SetCapStyle(gfx::CapStyle::Round)
                                  .SetLineJoin(gfx::LineJoin::Round)
                                  .Build(canvas);
+  canvas->RecordDraw(gfx::DrawRecorder::Op::Geometry, bounds);
   (*canvas)->DrawGeometry(geometry, brush, pen_width, stroke_style);
 }
 
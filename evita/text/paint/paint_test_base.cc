@@ -0,0 +1,74 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/text/paint/paint_test_base.h"
+
+#include "base/strings/utf_string_conversions.h"
+#include "evita/css/selector_parser.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/style_sheet.h"
+#include "evita/editor/dom_lock.h"
+#include "evita/gfx/canvas.h"
+#include "evita/gfx/offscreen_canvas_owner.h"
+#include "evita/text/layout/block_flow.h"
+#include "evita/text/layout/paint_view_builder.h"
+#include "evita/text/layout/render_selection.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/models/marker_set.h"
+#include "evita/text/paint/public/caret.h"
+#include "evita/text/paint/public/view.h"
+#include "evita/text/style/style_tree.h"
+
+namespace paint {
+
+namespace {
+
+css::Selector AsSelector(base::StringPiece text) {
+  return css::Selector::Parser().Parse(base::UTF8ToUTF16(text));
+}
+
+css::StyleSheet* CreateStyleSheet() {
+  auto style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(
+      AsSelector("*"),
+      std::move(css::StyleBuilder()
+                    .SetColor(css::ColorValue::Rgba(0, 0, 0))
+                    .SetBackgroundColor(css::ColorValue::Rgba(255, 255, 255))
+                    .SetFontSize(10)
+                    .SetFontFamily(
+                        css::FontFamily(css::String(L"Consolas, Meiryo")))
+                    .Build()));
+  return style_sheet;
+}
+
+}  // namespace
+
+PaintTestBase::PaintTestBase()
+    : bounds_(gfx::PointF(0, 0), gfx::SizeF(400, 300)),
+      buffer_(new text::Buffer()),
+      markers_(new text::MarkerSet(text::MarkerSet::Kind::Sticky, *buffer_)),
+      style_sheet_(CreateStyleSheet()),
+      style_tree_(new layout::StyleTree({style_sheet_.get()})),
+      block_(new layout::BlockFlow(*buffer_, *markers_, *style_tree_)),
+      canvas_owner_(new gfx::OffscreenCanvasOwner(bounds_)),
+      canvas_(new gfx::Canvas(canvas_owner_.get())) {
+  block_->SetBounds(bounds_);
+  canvas_->SetDrawRecorder(&recorder_);
+  editor::DomLock::GetInstance()->Acquire(FROM_HERE);
+}
+
+PaintTestBase::~PaintTestBase() {
+  editor::DomLock::GetInstance()->Release(FROM_HERE);
+  canvas_->SetDrawRecorder(nullptr);
+}
+
+scoped_refptr<View> PaintTestBase::BuildView() {
+  block_->FormatIfNeeded();
+  return layout::PaintViewBuilder().Build(
+      *block_, layout::TextSelectionModel(),
+      Caret(CaretState::None, gfx::RectF()));
+}
+
+}  // namespace paint
@@ -0,0 +1,79 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_TEXT_PAINT_PAINT_TEST_BASE_H_
+#define EVITA_TEXT_PAINT_PAINT_TEST_BASE_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "evita/gfx/base/paint/draw_recorder.h"
+#include "evita/gfx/rect_f.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace css {
+class StyleSheet;
+}
+
+namespace gfx {
+class Canvas;
+class OffscreenCanvasOwner;
+}
+
+namespace layout {
+class BlockFlow;
+class StyleTree;
+}
+
+namespace text {
+class Buffer;
+class MarkerSet;
+}
+
+namespace paint {
+
+class View;
+
+//////////////////////////////////////////////////////////////////////
+//
+// PaintTestBase
+//
+// Paints text laid out by |layout::BlockFlow| into offscreen canvas, which
+// records draw calls into |recorder()|.
+//
+class PaintTestBase : public ::testing::Test {
+ protected:
+  PaintTestBase();
+  ~PaintTestBase() override;
+
+  layout::BlockFlow* block() const { return block_.get(); }
+  const gfx::RectF& bounds() const { return bounds_; }
+  text::Buffer* buffer() const { return buffer_.get(); }
+  gfx::Canvas* canvas() const { return canvas_.get(); }
+  gfx::DrawRecorder* recorder() { return &recorder_; }
+
+  // Formats |block()| if needed and returns paint view of it.
+  scoped_refptr<View> BuildView();
+
+ private:
+  const gfx::RectF bounds_;
+  const std::unique_ptr<text::Buffer> buffer_;
+  const std::unique_ptr<text::MarkerSet> markers_;
+  const std::unique_ptr<css::StyleSheet> style_sheet_;
+  // |style_tree_| depends on |style_sheet_|.
+  const std::unique_ptr<layout::StyleTree> style_tree_;
+  // |block_| depends on |buffer_|, |markers_| and |style_tree_|.
+  const std::unique_ptr<layout::BlockFlow> block_;
+  const std::unique_ptr<gfx::OffscreenCanvasOwner> canvas_owner_;
+  // |canvas_| depends on |canvas_owner_|.
+  const std::unique_ptr<gfx::Canvas> canvas_;
+  gfx::DrawRecorder recorder_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintTestBase);
+};
+
+}  // namespace paint
+
+#endif  // EVITA_TEXT_PAINT_PAINT_TEST_BASE_H_
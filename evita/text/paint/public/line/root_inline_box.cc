@@ -54,6 +54,8 @@ RootInlineBox* RootInlineBox::Copy() const {
 }
 
 bool RootInlineBox::Equal(const RootInlineBox* other) const {
+  if (this == other)
+    return true;
   if (ComputeHashCode() != other->ComputeHashCode())
     return false;
   if (boxes_.size() != other->boxes_.size())
@@ -21,7 +21,9 @@ class InlineBox;
 //
 // RootInlineBox
 //
-class RootInlineBox final : public base::RefCounted<RootInlineBox> {
+// Note: |RootInlineBox| is shared between layout on script thread and
+// |View| on paint thread.
+class RootInlineBox final : public base::RefCountedThreadSafe<RootInlineBox> {
  public:
   RootInlineBox(const std::vector<InlineBox*>& boxes, const gfx::RectF& bounds);
 
@@ -37,16 +39,17 @@ class RootInlineBox final : public base::RefCounted<RootInlineBox> {
   const gfx::PointF origin() const { return bounds_.origin(); }
   float width() const { return bounds_.width(); }
 
+  // Returns hash code of inline boxes, lines having different hash codes are
+  // not equal.
+  size_t ComputeHashCode() const;
   RootInlineBox* Copy() const;
   bool Equal(const RootInlineBox*) const;
 
  private:
-  friend class base::RefCounted<RootInlineBox>;
+  friend class base::RefCountedThreadSafe<RootInlineBox>;
 
   ~RootInlineBox();
 
-  size_t ComputeHashCode() const;
-
   const gfx::RectF bounds_;
   const std::vector<InlineBox*> boxes_;
   mutable size_t hash_code_ = 0;
@@ -24,7 +24,10 @@ View::View(int layout_version,
       layout_version_(layout_version),
       lines_(lines),
       ruler_(new Ruler(ruler)),
-      selection_(selection) {}
+      selection_(selection) {
+  for (const auto& line : lines_)
+    line->AddRef();
+}
 
 View::~View() {
   for (const auto& line : lines_)
@@ -9,6 +9,8 @@
 #include "base/logging.h"
 #include "evita/gfx/brush.h"
 #include "evita/gfx/canvas.h"
+#include "evita/metrics/counter.h"
+#include "evita/metrics/histogram.h"
 #include "evita/text/paint/public/line/inline_box.h"
 #include "evita/text/paint/public/line/root_inline_box.h"
 #include "evita/text/paint/root_inline_box_painter.h"
@@ -48,6 +50,18 @@ void AddRect(std::vector<gfx::RectF>* rects, const gfx::RectF& rect) {
   rects->push_back(rect);
 }
 
+float ComputeArea(const std::vector<gfx::RectF>& rects,
+                  const gfx::RectF& bounds) {
+  auto area = 0.0f;
+  for (const auto& rect : rects) {
+    const auto visible_rect = bounds.Intersect(rect);
+    if (visible_rect.empty())
+      continue;
+    area += visible_rect.width() * visible_rect.height();
+  }
+  return area;
+}
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////
@@ -68,6 +82,41 @@ RootInlineBoxListPainter::RootInlineBoxListPainter(
 
 RootInlineBoxListPainter::~RootInlineBoxListPainter() {}
 
+void RootInlineBoxListPainter::BuildScreenLineMap() {
+  DCHECK(screen_line_map_.empty());
+  for (size_t index = 0; index < screen_lines_.size(); ++index)
+    screen_line_map_[screen_lines_[index]->ComputeHashCode()].push_back(index);
+}
+
+float RootInlineBoxListPainter::ComputeScrollDelta() const {
+  std::unordered_map<float, int> delta_counts;
+  for (const auto& format_line : format_lines_) {
+    if (format_line->top() >= bounds_.bottom)
+      break;
+    const auto it = screen_line_map_.find(format_line->ComputeHashCode());
+    if (it == screen_line_map_.end())
+      continue;
+    for (const auto index : it->second) {
+      const auto screen_line = screen_lines_[index];
+      if (screen_line->bottom() > bounds_.bottom ||
+          !screen_line->Equal(format_line)) {
+        continue;
+      }
+      ++delta_counts[screen_line->top() - format_line->top()];
+      break;
+    }
+  }
+  auto scroll_delta = 0.0f;
+  auto max_count = 0;
+  for (const auto& pair : delta_counts) {
+    if (pair.second <= max_count)
+      continue;
+    scroll_delta = pair.first;
+    max_count = pair.second;
+  }
+  return scroll_delta;
+}
+
 void RootInlineBoxListPainter::Copy(float dst_top,
                                     float dst_bottom,
                                     float src_top) const {
@@ -176,16 +225,30 @@ RootInlineBoxListPainter::FindLastMatch() const {
 
 RootInlineBoxListPainter::FormatLineIterator
 RootInlineBoxListPainter::FindCopyable(RootInlineBox* format_line) const {
-  for (auto runner = screen_lines_.begin(); runner != screen_lines_.end();
-       ++runner) {
+  const auto it = screen_line_map_.find(format_line->ComputeHashCode());
+  if (it == screen_line_map_.end())
+    return screen_lines_.end();
+  // We prefer screen line at same position, which we don't need to copy,
+  // then screen line shifted by scroll delta, which extends copy of
+  // scrolled region.
+  auto first_copyable = screen_lines_.end();
+  auto scrolled = screen_lines_.end();
+  for (const auto index : it->second) {
+    auto const runner = screen_lines_.begin() + index;
     auto const screen_line = *runner;
-    if (screen_line->Equal(format_line) &&
-        (format_line->bounds().top == screen_line->bounds().top ||
-         screen_line->bounds().bottom <= bounds_.bottom)) {
+    if (!screen_line->Equal(format_line))
+      continue;
+    auto const delta = screen_line->top() - format_line->top();
+    if (delta == 0.0f)
       return runner;
-    }
+    if (screen_line->bottom() > bounds_.bottom)
+      continue;
+    if (delta == scroll_delta_ && scrolled == screen_lines_.end())
+      scrolled = runner;
+    if (first_copyable == screen_lines_.end())
+      first_copyable = runner;
   }
-  return screen_lines_.end();
+  return scrolled != screen_lines_.end() ? scrolled : first_copyable;
 }
 
 void RootInlineBoxListPainter::Finish() {
@@ -224,6 +287,12 @@ bool RootInlineBoxListPainter::Paint() {
   auto const dirty_line_start = FindFirstMismatch();
   if (dirty_line_start != format_lines_.end()) {
     auto const clean_line_start = FindLastMatch();
+    if (!screen_lines_.empty()) {
+      // Screen lines are looked up by hash code only when some lines differ
+      // from screen, e.g. not for blinking caret.
+      BuildScreenLineMap();
+      scroll_delta_ = ComputeScrollDelta();
+    }
 #if DEBUG_DRAW
     DVLOG(0) << "dirty " << (*dirty_line_start)->bounds().top << ","
              << (clean_line_start == format_lines_.end()
@@ -239,6 +308,7 @@ bool RootInlineBoxListPainter::Paint() {
       RootInlineBoxPainter(*format_line).Paint(canvas_);
       FillRight(format_line);
       AddRect(&dirty_rects_, format_line->bounds());
+      ++num_painted_lines_;
       canvas_->Flush();
     }
   }
@@ -256,9 +326,40 @@ bool RootInlineBoxListPainter::Paint() {
 #if DEBUG_DRAW
   DVLOG(0) << "End painting dirty=" << dirty;
 #endif
+  RecordMetrics();
   return dirty;
 }
 
+void RootInlineBoxListPainter::RecordMetrics() const {
+  auto const kind =
+      dirty_rects_.empty()
+          ? copy_rects_.empty() ? "clean" : "copy"
+          : copy_rects_.empty() ? "repaint" : "copy_and_repaint";
+  METRICS_COUNTER_ADD("RootInlineBoxListPainter::Paint", kind);
+  if (copy_rects_.empty() && dirty_rects_.empty())
+    return;
+  auto const copied_area = ComputeArea(copy_rects_, bounds_);
+  auto const repainted_area = ComputeArea(dirty_rects_, bounds_);
+  METRICS_HISTOGRAM_ADD("RootInlineBoxListPainter::Paint.CopiedPixels",
+                        static_cast<int>(copied_area));
+  METRICS_HISTOGRAM_ADD("RootInlineBoxListPainter::Paint.RepaintedPixels",
+                        static_cast<int>(repainted_area));
+  METRICS_HISTOGRAM_ADD("RootInlineBoxListPainter::Paint.PaintedLines",
+                        num_painted_lines_);
+  // Percent of view area compares damage across sizes of window.
+  auto const area = bounds_.width() * bounds_.height();
+  if (area > 0.0f) {
+    METRICS_HISTOGRAM_ADD("RootInlineBoxListPainter::Paint.CopiedPercent",
+                          static_cast<int>(copied_area * 100 / area));
+    METRICS_HISTOGRAM_ADD("RootInlineBoxListPainter::Paint.RepaintedPercent",
+                          static_cast<int>(repainted_area * 100 / area));
+  }
+  if (scroll_delta_ != 0.0f) {
+    METRICS_COUNTER_ADD("RootInlineBoxListPainter::Paint.Scroll",
+                        scroll_delta_ > 0 ? "down" : "up");
+  }
+}
+
 void RootInlineBoxListPainter::RestoreSkipRect(const gfx::RectF& rect) const {
   auto marker_rect = rect;
   marker_rect.left += kMarkerLeftMargin;
@@ -5,6 +5,7 @@
 #ifndef EVITA_TEXT_PAINT_ROOT_INLINE_BOX_LIST_PAINTER_H_
 #define EVITA_TEXT_PAINT_ROOT_INLINE_BOX_LIST_PAINTER_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include "base/macros.h"
@@ -19,6 +20,10 @@ class RootInlineBox;
 //
 // RootInlineBoxListPainter
 //
+// Paints format lines by reusing screen image of lines on screen. Screen
+// lines are looked up by hash code of their inline boxes, and when view is
+// scrolled, lines shifted by scroll delta are copied in one bitmap copy.
+//
 class RootInlineBoxListPainter final {
  public:
   using FormatLineIterator = std::vector<RootInlineBox*>::const_iterator;
@@ -36,6 +41,11 @@ class RootInlineBoxListPainter final {
                              const FormatLineIterator& format_line_end) const;
 
  private:
+  // Indexes |screen_lines_| by hash code into |screen_line_map_|.
+  void BuildScreenLineMap();
+  // Returns the most common difference of top of equal screen line and
+  // format line, or zero if there are no such lines.
+  float ComputeScrollDelta() const;
   void Copy(float dst_top, float dst_bottom, float src_top) const;
   void DrawDirtyRect(const gfx::RectF& rect,
                      float red,
@@ -47,6 +57,7 @@ class RootInlineBoxListPainter final {
   FormatLineIterator FindLastMatch() const;
   std::vector<RootInlineBox*>::const_iterator FindCopyable(
       RootInlineBox* line) const;
+  void RecordMetrics() const;
   void RestoreSkipRect(const gfx::RectF& rect) const;
 
   const gfx::ColorF bgcolor_;
@@ -55,6 +66,11 @@ class RootInlineBoxListPainter final {
   mutable std::vector<gfx::RectF> copy_rects_;
   mutable std::vector<gfx::RectF> dirty_rects_;
   const std::vector<RootInlineBox*>& format_lines_;
+  int num_painted_lines_ = 0;
+  float scroll_delta_ = 0.0f;
+  // Maps hash code of screen line to indexes in |screen_lines_|. This map is
+  // built by |Paint()| only when there are dirty lines.
+  std::unordered_map<size_t, std::vector<size_t>> screen_line_map_;
   const std::vector<RootInlineBox*>& screen_lines_;
   mutable std::vector<gfx::RectF> skip_rects_;
 
@@ -0,0 +1,99 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "evita/text/paint/paint_test_base.h"
+
+#include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
+#include "evita/gfx/canvas.h"
+#include "evita/text/layout/block_flow.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/paint/public/view.h"
+#include "evita/text/paint/root_inline_box_list_painter.h"
+
+namespace paint {
+
+using Op = gfx::DrawRecorder::Op;
+
+//////////////////////////////////////////////////////////////////////
+//
+// RootInlineBoxListPainterTest
+//
+class RootInlineBoxListPainterTest : public PaintTestBase {
+ protected:
+  RootInlineBoxListPainterTest();
+  ~RootInlineBoxListPainterTest() override = default;
+
+  // Paints lines of |view| over |screen_lines| as |ViewPainter| does. Returns
+  // true if any line is painted or copied.
+  bool Paint(const View& view, const std::vector<RootInlineBox*>& lines);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(RootInlineBoxListPainterTest);
+};
+
+RootInlineBoxListPainterTest::RootInlineBoxListPainterTest() {
+  base::string16 text;
+  for (auto index = 0; index < 100; ++index)
+    text += L"line " + base::IntToString16(index) + L"\n";
+  buffer()->InsertBefore(text::Offset(0), text);
+}
+
+bool RootInlineBoxListPainterTest::Paint(
+    const View& view,
+    const std::vector<RootInlineBox*>& screen_lines) {
+  recorder()->Reset();
+  gfx::Canvas::DrawingScope drawing_scope(canvas());
+  RootInlineBoxListPainter painter(canvas(), view.bounds(), view.bgcolor(),
+                                   view.lines(), screen_lines);
+  if (!painter.Paint())
+    return false;
+  canvas()->SaveScreenImage(view.bounds());
+  painter.Finish();
+  return true;
+}
+
+TEST_F(RootInlineBoxListPainterTest, PaintAll) {
+  const auto& view = BuildView();
+  EXPECT_TRUE(Paint(*view, std::vector<RootInlineBox*>()));
+  EXPECT_EQ(0u, recorder()->CountOf(Op::Bitmap)) << "Nothing to copy.";
+  EXPECT_LE(view->lines().size(), recorder()->CountOf(Op::Text));
+}
+
+TEST_F(RootInlineBoxListPainterTest, PaintClean) {
+  const auto& view = BuildView();
+  Paint(*view, std::vector<RootInlineBox*>());
+  EXPECT_FALSE(Paint(*view, view->lines()));
+  EXPECT_EQ(0u, recorder()->CountOf(Op::Bitmap));
+  EXPECT_EQ(0u, recorder()->CountOf(Op::Text));
+}
+
+TEST_F(RootInlineBoxListPainterTest, PaintEdit) {
+  const auto& view1 = BuildView();
+  Paint(*view1, std::vector<RootInlineBox*>());
+  buffer()->InsertBefore(text::Offset(0), L"x");
+  const auto& view2 = BuildView();
+  EXPECT_TRUE(Paint(*view2, view1->lines()));
+  EXPECT_EQ(0u, recorder()->CountOf(Op::Bitmap))
+      << "Lines after edited line are at same position.";
+  EXPECT_LT(0u, recorder()->CountOf(Op::Text));
+  EXPECT_GT(view2->lines().size() / 2, recorder()->CountOf(Op::Text))
+      << "Only edited line is painted.";
+}
+
+TEST_F(RootInlineBoxListPainterTest, PaintScroll) {
+  const auto& view1 = BuildView();
+  Paint(*view1, std::vector<RootInlineBox*>());
+  ASSERT_TRUE(block()->ScrollUp());
+  const auto& view2 = BuildView();
+  EXPECT_TRUE(Paint(*view2, view1->lines()));
+  EXPECT_LT(0u, recorder()->CountOf(Op::Bitmap))
+      << "Lines on screen are copied.";
+  EXPECT_GT(view2->lines().size() / 2, recorder()->CountOf(Op::Text))
+      << "Only a line scrolled into view is painted.";
+}
+
+}  // namespace paint
@@ -24,8 +24,11 @@ ViewPaintCache::ViewPaintCache(gfx::Canvas* canvas,
       canvas_(canvas),
       layout_version_(view.layout_version()),
       selection_(view.selection()) {
-  for (const auto& line : view.lines())
-    lines_.push_back(line->Copy());
+  // Lines are immutable, so we share them with |view|.
+  for (const auto& line : view.lines()) {
+    line->AddRef();
+    lines_.push_back(line);
+  }
 }
 
 ViewPaintCache::~ViewPaintCache() {
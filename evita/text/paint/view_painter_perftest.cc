@@ -0,0 +1,145 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "evita/text/paint/paint_test_base.h"
+
+#include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
+#include "evita/base/testing/perf_test_util.h"
+#include "evita/gfx/base/geometry/int_size.h"
+#include "evita/gfx/canvas.h"
+#include "evita/text/layout/block_flow.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/paint/public/view.h"
+#include "evita/text/paint/root_inline_box_list_painter.h"
+#include "evita/text/paint/view_paint_cache.h"
+#include "evita/text/paint/view_painter.h"
+
+namespace paint {
+
+namespace {
+
+const int kNumberOfLines = 1000;
+const int kNumberOfRepeats = 100;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// ViewPainterPerfTest
+//
+class ViewPainterPerfTest : public PaintTestBase {
+ protected:
+  ViewPainterPerfTest();
+  ~ViewPainterPerfTest() override = default;
+
+  // Returns paint view of |block()| and paint view scrolled by one line.
+  std::vector<scoped_refptr<View>> BuildScrollViews();
+  void PrintOverdraw(const std::string& trace);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ViewPainterPerfTest);
+};
+
+ViewPainterPerfTest::ViewPainterPerfTest() {
+  base::string16 text;
+  for (auto index = 0; index < kNumberOfLines; ++index)
+    text += L"line " + base::IntToString16(index) + L" of text\n";
+  buffer()->InsertBefore(text::Offset(0), text);
+}
+
+std::vector<scoped_refptr<View>> ViewPainterPerfTest::BuildScrollViews() {
+  std::vector<scoped_refptr<View>> views;
+  views.push_back(BuildView());
+  block()->ScrollUp();
+  views.push_back(BuildView());
+  return views;
+}
+
+void ViewPainterPerfTest::PrintOverdraw(const std::string& trace) {
+  const auto& coverage = recorder()->ComputeCoverage(
+      gfx::IntSize(static_cast<int>(bounds().width()),
+                   static_cast<int>(bounds().height())));
+  base::PrintPerfResult("view_painter_overdraw", trace, coverage.overdraw(),
+                        "writes/pixel");
+}
+
+TEST_F(ViewPainterPerfTest, RootInlineBoxListPainter) {
+  const auto& views = BuildScrollViews();
+  const auto& empty_lines = std::vector<RootInlineBox*>();
+  const auto num_lines = static_cast<int>(views[0]->lines().size());
+  const auto full_rate = base::MeasureRate(num_lines, kNumberOfRepeats, [&]() {
+    recorder()->Reset();
+    gfx::Canvas::DrawingScope drawing_scope(canvas());
+    RootInlineBoxListPainter painter(canvas(), views[0]->bounds(),
+                                     views[0]->bgcolor(), views[0]->lines(),
+                                     empty_lines);
+    painter.Paint();
+    canvas()->SaveScreenImage(views[0]->bounds());
+    painter.Finish();
+  });
+  base::PrintPerfResult("root_inline_box_list_painter", "full", full_rate,
+                        "lines/s");
+  auto index = 0;
+  const auto scroll_rate =
+      base::MeasureRate(num_lines, kNumberOfRepeats, [&]() {
+        const auto& screen_view = views[index];
+        index = 1 - index;
+        const auto& view = views[index];
+        recorder()->Reset();
+        gfx::Canvas::DrawingScope drawing_scope(canvas());
+        RootInlineBoxListPainter painter(canvas(), view->bounds(),
+                                         view->bgcolor(), view->lines(),
+                                         screen_view->lines());
+        painter.Paint();
+        canvas()->SaveScreenImage(view->bounds());
+        painter.Finish();
+      });
+  base::PrintPerfResult("root_inline_box_list_painter", "scroll", scroll_rate,
+                        "lines/s");
+}
+
+TEST_F(ViewPainterPerfTest, ViewPainter) {
+  const auto& views = BuildScrollViews();
+  const auto num_lines = static_cast<int>(views[0]->lines().size());
+  const auto full_rate = base::MeasureRate(num_lines, kNumberOfRepeats, [&]() {
+    recorder()->Reset();
+    gfx::Canvas::DrawingScope drawing_scope(canvas());
+    ViewPainter(*views[0]).Paint(canvas(), nullptr);
+  });
+  base::PrintPerfResult("view_painter", "full", full_rate, "lines/s");
+  PrintOverdraw("full");
+
+  std::unique_ptr<ViewPaintCache> view_cache;
+  {
+    gfx::Canvas::DrawingScope drawing_scope(canvas());
+    view_cache = ViewPainter(*views[0]).Paint(canvas(), nullptr);
+  }
+  const auto clean_rate =
+      base::MeasureRate(num_lines, kNumberOfRepeats, [&]() {
+        recorder()->Reset();
+        gfx::Canvas::DrawingScope drawing_scope(canvas());
+        view_cache =
+            ViewPainter(*views[0]).Paint(canvas(), std::move(view_cache));
+      });
+  base::PrintPerfResult("view_painter", "clean", clean_rate, "lines/s");
+
+  auto index = 0;
+  const auto scroll_rate =
+      base::MeasureRate(num_lines, kNumberOfRepeats, [&]() {
+        index = 1 - index;
+        recorder()->Reset();
+        gfx::Canvas::DrawingScope drawing_scope(canvas());
+        view_cache =
+            ViewPainter(*views[index]).Paint(canvas(), std::move(view_cache));
+      });
+  base::PrintPerfResult("view_painter", "scroll", scroll_rate, "lines/s");
+  PrintOverdraw("scroll");
+}
+
+}  // namespace paint
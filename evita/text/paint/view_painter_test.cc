@@ -0,0 +1,88 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/text/paint/paint_test_base.h"
+
+#include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
+#include "evita/gfx/base/geometry/int_size.h"
+#include "evita/gfx/canvas.h"
+#include "evita/text/models/buffer.h"
+#include "evita/text/paint/public/view.h"
+#include "evita/text/paint/view_paint_cache.h"
+#include "evita/text/paint/view_painter.h"
+
+namespace paint {
+
+using Op = gfx::DrawRecorder::Op;
+
+//////////////////////////////////////////////////////////////////////
+//
+// ViewPainterTest
+//
+class ViewPainterTest : public PaintTestBase {
+ protected:
+  ViewPainterTest();
+  ~ViewPainterTest() override = default;
+
+  std::unique_ptr<ViewPaintCache> Paint(
+      const View& view,
+      std::unique_ptr<ViewPaintCache> view_cache);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ViewPainterTest);
+};
+
+ViewPainterTest::ViewPainterTest() {
+  base::string16 text;
+  for (auto index = 0; index < 100; ++index)
+    text += L"line " + base::IntToString16(index) + L"\n";
+  buffer()->InsertBefore(text::Offset(0), text);
+}
+
+std::unique_ptr<ViewPaintCache> ViewPainterTest::Paint(
+    const View& view,
+    std::unique_ptr<ViewPaintCache> view_cache) {
+  recorder()->Reset();
+  gfx::Canvas::DrawingScope drawing_scope(canvas());
+  return ViewPainter(view).Paint(canvas(), std::move(view_cache));
+}
+
+TEST_F(ViewPainterTest, Paint) {
+  const auto& view = BuildView();
+  const auto& view_cache = Paint(*view, nullptr);
+  EXPECT_NE(nullptr, view_cache.get());
+  EXPECT_LE(view->lines().size(), recorder()->CountOf(Op::Text));
+  const auto& coverage = recorder()->ComputeCoverage(
+      gfx::IntSize(static_cast<int>(bounds().width()),
+                   static_cast<int>(bounds().height())));
+  EXPECT_EQ(static_cast<size_t>(bounds().width() * bounds().height()),
+            coverage.num_painted_pixels)
+      << "All pixels in view should be painted.";
+}
+
+TEST_F(ViewPainterTest, PaintWithCache) {
+  const auto& view = BuildView();
+  auto view_cache = Paint(*view, nullptr);
+  view_cache = Paint(*view, std::move(view_cache));
+  EXPECT_NE(nullptr, view_cache.get());
+  EXPECT_EQ(0u, recorder()->CountOf(Op::Text))
+      << "Text isn't changed, we paint selection only.";
+}
+
+TEST_F(ViewPainterTest, PaintWithCacheEdit) {
+  const auto& view1 = BuildView();
+  auto view_cache = Paint(*view1, nullptr);
+  buffer()->InsertBefore(text::Offset(0), L"x");
+  const auto& view2 = BuildView();
+  view_cache = Paint(*view2, std::move(view_cache));
+  EXPECT_NE(nullptr, view_cache.get());
+  EXPECT_LT(0u, recorder()->CountOf(Op::Text));
+  EXPECT_GT(view2->lines().size() / 2, recorder()->CountOf(Op::Text))
+      << "Only edited line is painted.";
+}
+
+}  // namespace paint
@@ -2,11 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <utility>
+
 #include "evita/text/style/style_tree.h"
 
 #include "base/strings/string_util.h"
 #include "base/trace_event/trace_event.h"
-#include "evita/css/selector.h"
+#include "evita/css/rule.h"
+#include "evita/css/selector_builder.h"
 #include "evita/css/style.h"
 #include "evita/css/values.h"
 #include "evita/gfx/base/colors/float_color.h"
@@ -158,24 +161,65 @@ std::unique_ptr<ComputedStyle> ComputeStyle(const css::Style& css_style,
 
 }  // namespace
 
+//////////////////////////////////////////////////////////////////////
+//
+// StyleKey
+//
+bool StyleKey::operator==(const StyleKey& other) const {
+  if (tag_name != other.tag_name)
+    return false;
+  for (size_t index = 0; index < kMaxClasses; ++index) {
+    if (classes[index] != other.classes[index])
+      return false;
+  }
+  return true;
+}
+
+size_t StyleKey::Hash() const {
+  auto hash = tag_name.hash_value();
+  for (const auto& class_name : classes)
+    hash = hash * 31 + class_name.hash_value();
+  return hash;
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // Style Tree
 //
 StyleTree::StyleTree(const std::vector<css::StyleSheet*> style_sheets)
-    : style_sheet_set_(new CompiledStyleSheetSet(style_sheets)) {}
-
-StyleTree::~StyleTree() = default;
+    : style_sheet_set_(new CompiledStyleSheetSet(style_sheets)) {
+  style_sheet_set_->AddObserver(this);
+}
 
-void StyleTree::ResetCache() {
-  style_cache_.clear();
+StyleTree::~StyleTree() {
+  style_sheet_set_->RemoveObserver(this);
 }
 
 const ComputedStyle& StyleTree::ComputedStyleOf(
     const css::Selector& selector) const {
-  const auto& it = style_cache_.find(selector);
-  if (it != style_cache_.end())
-    return *it->second;
+  return ComputedStyleOf(InternSelector(selector));
+}
+
+const ComputedStyle& StyleTree::ComputedStyleOf(const StyleKey& key) const {
+  const auto& it = style_key_ids_.find(key);
+  if (it != style_key_ids_.end())
+    return ComputedStyleOf(it->second);
+  css::Selector::Builder builder;
+  builder.SetTagName(key.tag_name);
+  for (const auto& class_name : key.classes) {
+    if (!class_name.empty())
+      builder.AddClass(class_name);
+  }
+  const auto style_id = InternSelector(builder.Build());
+  style_key_ids_.emplace(key, style_id);
+  return ComputedStyleOf(style_id);
+}
+
+const ComputedStyle& StyleTree::ComputedStyleOf(int style_id) const {
+  auto& entry = styles_[static_cast<size_t>(style_id)];
+  if (entry.style)
+    return *entry.style;
+  const auto& selector = entry.selector;
   TRACE_EVENT0("view", "StyleTree::ComputedStyleOf");
   const auto& css_style = std::make_unique<css::Style>();
   style_sheet_set_->Merge(css_style.get(), selector);
@@ -187,12 +231,66 @@ const ComputedStyle& StyleTree::ComputedStyleOf(
                                        << ' ' << *css_style;
   DCHECK(css_style->has_font_size()) << "No font-size for " << selector << ' '
                                      << *css_style;
-  auto style = ComputeStyle(*css_style, zoom_);
-  DCHECK(!style->fonts().empty()) << "No fonts for " << selector << ' '
-                                  << *css_style;
-  const auto& result = style_cache_.emplace(selector, std::move(style));
-  DCHECK(result.second) << "must not be in cache " << selector;
-  return *result.first->second;
+  entry.style = ComputeStyle(*css_style, zoom_);
+  DCHECK(!entry.style->fonts().empty()) << "No fonts for " << selector << ' '
+                                        << *css_style;
+  return *entry.style;
+}
+
+void StyleTree::DidCommitLayout() {
+  committed_obsolete_styles_ = std::move(obsolete_styles_);
+  obsolete_styles_.clear();
+}
+
+int StyleTree::InternClassSet(std::vector<base::AtomicString> classes) const {
+  if (classes.empty())
+    return 0;
+  const auto& result = class_set_ids_.emplace(
+      std::move(classes), static_cast<int>(class_set_ids_.size() + 1));
+  return result.first->second;
+}
+
+int StyleTree::InternSelector(const css::Selector& selector) const {
+  DCHECK(!selector.has_id()) << "Text is styled by tag name and classes "
+                             << selector;
+  // Note: |css::Selector::classes()| is sorted.
+  const auto class_set_id = InternClassSet(std::vector<base::AtomicString>(
+      selector.classes().begin(), selector.classes().end()));
+  const auto tag_id = InternTagName(selector.tag_name());
+  const auto key = static_cast<uint64_t>(tag_id) << 32 |
+                   static_cast<uint32_t>(class_set_id);
+  const auto& result =
+      style_ids_.emplace(key, static_cast<int>(styles_.size()));
+  if (result.second)
+    styles_.push_back(StyleEntry{selector, nullptr});
+  return result.first->second;
+}
+
+int StyleTree::InternTagName(base::AtomicString tag_name) const {
+  const auto& result =
+      tag_ids_.emplace(tag_name, static_cast<int>(tag_ids_.size()));
+  return result.first->second;
+}
+
+void StyleTree::InvalidateStyle(StyleEntry* entry) {
+  if (!entry->style)
+    return;
+  obsolete_styles_.push_back(std::move(entry->style));
+  // Formatted lines referring |entry->style| are obsolete.
+  ++version_;
+}
+
+void StyleTree::InvalidateStylesMatchedBy(const css::Selector& selector) {
+  TRACE_EVENT0("view", "StyleTree::InvalidateStylesMatchedBy");
+  for (auto& entry : styles_) {
+    if (entry.selector.IsSubsetOf(selector))
+      InvalidateStyle(&entry);
+  }
+}
+
+void StyleTree::ResetCache() {
+  for (auto& entry : styles_)
+    InvalidateStyle(&entry);
 }
 
 void StyleTree::SetZoom(float new_zoom) {
@@ -204,11 +302,11 @@ void StyleTree::SetZoom(float new_zoom) {
 
 // css::StyleSheetObserver
 void StyleTree::DidInsertRule(const css::Rule& new_rule, size_t index) {
-  ResetCache();
+  InvalidateStylesMatchedBy(new_rule.selector());
 }
 
 void StyleTree::DidRemoveRule(const css::Rule& old_rule, size_t index) {
-  ResetCache();
+  InvalidateStylesMatchedBy(old_rule.selector());
 }
 
 }  // namespace layout
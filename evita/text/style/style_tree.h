@@ -5,14 +5,18 @@
 #ifndef EVITA_TEXT_STYLE_STYLE_TREE_H_
 #define EVITA_TEXT_STYLE_STYLE_TREE_H_
 
+#include <stdint.h>
+
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "evita/base/strings/atomic_string.h"
+#include "evita/css/selector.h"
 #include "evita/css/style_sheet_observer.h"
 
 namespace css {
-class Selector;
 class Style;
 class StyleSheet;
 }
@@ -25,10 +29,46 @@ namespace layout {
 
 class ComputedStyle;
 
+//////////////////////////////////////////////////////////////////////
+//
+// StyleKey
+//
+// Represents simple selector, a tag name with up to three class names, by
+// identities of atomic strings. Empty class name means no class.
+//
+struct StyleKey final {
+  static const size_t kMaxClasses = 3;
+
+  bool operator==(const StyleKey& other) const;
+  bool operator!=(const StyleKey& other) const { return !operator==(other); }
+
+  size_t Hash() const;
+
+  base::AtomicString tag_name;
+  base::AtomicString classes[kMaxClasses];
+};
+
+}  // namespace layout
+
+namespace std {
+template <>
+struct hash<layout::StyleKey> {
+  size_t operator()(const layout::StyleKey& key) const { return key.Hash(); }
+};
+}  // namespace std
+
+namespace layout {
+
 //////////////////////////////////////////////////////////////////////
 //
 // StyleTree
 //
+// Tag names and class sets of selectors are interned into small integer
+// ids, and computed styles are stored in an array indexed by style id, which
+// is interned pair of tag id and class set id. When a rule is inserted or
+// removed, only computed styles of selectors matched by the rule are
+// recomputed.
+//
 class StyleTree final : public css::StyleSheetObserver {
   using CompiledStyleSheetSet = visuals::CompiledStyleSheetSet;
 
@@ -39,21 +79,59 @@ class StyleTree final : public css::StyleSheetObserver {
 
   StyleTree& operator=(const StyleTree& other) = delete;
 
+  // Incremented when computed styles are invalidated by rule changes or
+  // zoom. Formatted lines refer computed styles of this version.
+  int version() const { return version_; }
+
   const ComputedStyle& ComputedStyleOf(const css::Selector& selector) const;
+  // Returns computed style for |key| without building |css::Selector| once
+  // style for |key| is computed.
+  const ComputedStyle& ComputedStyleOf(const StyleKey& key) const;
 
   void AddStyleSheet(const css::StyleSheet& style_sheet);
+  // Called after layout is committed, e.g. paint view is built. Releases
+  // computed styles invalidated before the previous commit, since paint
+  // view of the previous commit may still refer them.
+  void DidCommitLayout();
   void RemoveStyleSheet(const css::StyleSheet& style_sheet);
   void SetZoom(float zoom);
 
  private:
+  struct StyleEntry {
+    css::Selector selector;
+    // Null if style should be computed.
+    std::unique_ptr<ComputedStyle> style;
+  };
+
+  const ComputedStyle& ComputedStyleOf(int style_id) const;
+  void InvalidateStyle(StyleEntry* entry);
+  void InvalidateStylesMatchedBy(const css::Selector& selector);
+  int InternClassSet(std::vector<base::AtomicString> classes) const;
+  int InternSelector(const css::Selector& selector) const;
+  int InternTagName(base::AtomicString tag_name) const;
   void ResetCache();
 
   // css::StyleSheetObserver
   void DidInsertRule(const css::Rule& new_rule, size_t index);
   void DidRemoveRule(const css::Rule& old_rule, size_t index);
 
-  mutable std::map<css::Selector, std::unique_ptr<ComputedStyle>> style_cache_;
+  // Maps sorted class names to class set id.
+  mutable std::map<std::vector<base::AtomicString>, int> class_set_ids_;
+  // Computed styles invalidated before the last |DidCommitLayout()|.
+  std::vector<std::unique_ptr<ComputedStyle>> committed_obsolete_styles_;
+  // Computed styles invalidated since the last |DidCommitLayout()|. We keep
+  // them alive, since formatted lines and paint views may still refer them.
+  std::vector<std::unique_ptr<ComputedStyle>> obsolete_styles_;
+  // Maps pair of tag id and class set id to style id.
+  mutable std::unordered_map<uint64_t, int> style_ids_;
+  // Maps |StyleKey| to style id, for formatting text without building
+  // |css::Selector|.
+  mutable std::unordered_map<StyleKey, int> style_key_ids_;
   std::unique_ptr<CompiledStyleSheetSet> style_sheet_set_;
+  // Indexed by style id.
+  mutable std::vector<StyleEntry> styles_;
+  mutable std::unordered_map<base::AtomicString, int> tag_ids_;
+  int version_ = 0;
   float zoom_ = 1.0f;
 };
 
@@ -0,0 +1,129 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/text/style/style_tree.h"
+
+#include "base/strings/utf_string_conversions.h"
+#include "evita/css/selector_builder.h"
+#include "evita/css/selector_parser.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/style_sheet.h"
+#include "evita/gfx/color_f.h"
+#include "evita/text/style/computed_style.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace layout {
+
+namespace {
+
+css::Selector AsSelector(base::StringPiece text) {
+  return css::Selector::Parser().Parse(base::UTF8ToUTF16(text));
+}
+
+StyleKey AsStyleKey(base::StringPiece16 tag_name,
+                    base::StringPiece16 class_name) {
+  StyleKey key;
+  key.tag_name = base::AtomicString(tag_name);
+  key.classes[1] = base::AtomicString(class_name);
+  return key;
+}
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// StyleTreeTest
+//
+class StyleTreeTest : public ::testing::Test {
+ protected:
+  StyleTreeTest();
+  ~StyleTreeTest() override = default;
+
+  css::StyleSheet* style_sheet() const { return style_sheet_.get(); }
+  StyleTree* mutable_style_tree() const { return style_tree_.get(); }
+  const StyleTree& style_tree() const { return *style_tree_; }
+
+ private:
+  const std::unique_ptr<css::StyleSheet> style_sheet_;
+  const std::unique_ptr<StyleTree> style_tree_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleTreeTest);
+};
+
+StyleTreeTest::StyleTreeTest()
+    : style_sheet_(new css::StyleSheet()),
+      style_tree_(new StyleTree({style_sheet_.get()})) {
+  style_sheet_->AppendRule(
+      AsSelector("*"),
+      std::move(css::StyleBuilder()
+                    .SetColor(css::ColorValue::Rgba(0, 0, 0))
+                    .SetBackgroundColor(css::ColorValue::Rgba(255, 255, 255))
+                    .SetFontSize(10)
+                    .SetFontFamily(css::FontFamily(css::String(L"Consolas")))
+                    .Build()));
+}
+
+TEST_F(StyleTreeTest, ComputedStyleOf) {
+  const auto& style1 = style_tree().ComputedStyleOf(AsSelector("normal.c1"));
+  const auto& style2 =
+      style_tree().ComputedStyleOf(AsStyleKey(L"normal", L"c1"));
+  EXPECT_EQ(&style1, &style2) << "Selector and key share interned style.";
+
+  const auto& style3 =
+      style_tree().ComputedStyleOf(AsSelector("normal.c2.c1"));
+  const auto& style4 =
+      style_tree().ComputedStyleOf(AsSelector("normal.c1.c2"));
+  EXPECT_EQ(&style3, &style4) << "Order of classes doesn't matter.";
+  EXPECT_NE(&style1, &style3);
+}
+
+TEST_F(StyleTreeTest, DidInsertRule) {
+  const auto& normal_style = style_tree().ComputedStyleOf(AsSelector("normal"));
+  const auto& keyword_style =
+      style_tree().ComputedStyleOf(AsSelector("keyword"));
+  EXPECT_EQ(gfx::ColorF(0, 0, 0), keyword_style.color());
+
+  style_sheet()->InsertRule(
+      AsSelector("keyword"),
+      std::move(css::StyleBuilder()
+                    .SetColor(css::ColorValue::Rgba(255, 0, 0))
+                    .Build()),
+      1);
+
+  EXPECT_EQ(&normal_style, &style_tree().ComputedStyleOf(AsSelector("normal")))
+      << "Style of 'normal' isn't affected by rule for 'keyword'.";
+  EXPECT_EQ(gfx::ColorF(1, 0, 0),
+            style_tree().ComputedStyleOf(AsSelector("keyword")).color());
+  EXPECT_EQ(gfx::ColorF(1, 0, 0),
+            style_tree().ComputedStyleOf(AsSelector("keyword.c1")).color());
+}
+
+TEST_F(StyleTreeTest, version) {
+  const auto version0 = style_tree().version();
+  const auto& keyword_style =
+      style_tree().ComputedStyleOf(AsSelector("keyword"));
+  style_sheet()->InsertRule(
+      AsSelector("keyword"),
+      std::move(css::StyleBuilder()
+                    .SetColor(css::ColorValue::Rgba(255, 0, 0))
+                    .Build()),
+      1);
+  const auto version1 = style_tree().version();
+  EXPECT_NE(version0, version1) << "Rule change invalidates style.";
+
+  // Invalidated style is alive until the second layout commit, since paint
+  // view built before the first commit may refer it.
+  mutable_style_tree()->DidCommitLayout();
+  EXPECT_EQ(gfx::ColorF(0, 0, 0), keyword_style.color());
+
+  mutable_style_tree()->SetZoom(2.0f);
+  EXPECT_NE(version1, style_tree().version()) << "Zoom invalidates styles.";
+  mutable_style_tree()->DidCommitLayout();
+  mutable_style_tree()->DidCommitLayout();
+}
+
+}  // namespace layout
@@ -107,7 +107,7 @@ Event::Event(EventType event_type, int flags)
     : default_prevented_(false),
       flags_(flags),
       sequence_number_(++current_sequence_number),
-      time_stamp_(base::Time::Now()),
+      time_stamp_(base::TimeTicks::Now()),
       type_(event_type) {}
 
 Event::Event() : Event(EventType::Invalid, 0) {}
@@ -119,7 +119,7 @@ class Event : public base::Castable<Event> {
   bool default_prevented() const { return default_prevented_; }
   int id() const { return sequence_number_; }
   int flags() const { return flags_; }
-  base::Time time_stamp() const { return time_stamp_; }
+  base::TimeTicks time_stamp() const { return time_stamp_; }
   EventType type() const { return type_; }
   const char* type_name() const;
 
@@ -133,7 +133,7 @@ class Event : public base::Castable<Event> {
   bool default_prevented_;
   int flags_;
   int sequence_number_;
-  base::Time time_stamp_;
+  base::TimeTicks time_stamp_;
   EventType type_;
 };
 
@@ -10,6 +10,7 @@
 #include "evita/dom/public/view_event_handler.h"
 #include "evita/dom/public/view_events.h"
 #include "evita/editor/application.h"
+#include "evita/metrics/latency_tracker.h"
 #include "evita/ui/base/ime/text_composition.h"
 #include "evita/ui/events/event.h"
 
@@ -27,6 +28,18 @@ domapi::ViewEventHandler* view_event_handler() {
   return editor::Application::instance()->view_event_handler();
 }
 
+// Tracks latency of |event| if it is a discrete user action. We don't track
+// key release and mouse move since they rarely change screen.
+void DidCreateEvent(const ui::Event& event) {
+  if (event.type() != ui::EventType::KeyPressed &&
+      event.type() != ui::EventType::MousePressed &&
+      event.type() != ui::EventType::MouseWheel) {
+    return;
+  }
+  metrics::LatencyTracker::instance()->DidCreateEvent(
+      event.id(), event.type_name(), event.time_stamp());
+}
+
 domapi::EventType ConvertEventType(const ui::KeyEvent& event) {
   auto const event_type = event.type();
   if (event_type == ui::EventType::KeyPressed)
@@ -124,6 +137,7 @@ void EventSource::DispatchKeyboardEvent(const ui::KeyEvent& event) {
   api_event.repeat = event.repeat();
   api_event.shift_key = event.shift_key();
   api_event.target_id = event_target_id_;
+  DidCreateEvent(event);
   view_event_handler()->DispatchKeyboardEvent(api_event);
 }
 
@@ -143,6 +157,7 @@ void EventSource::DispatchMouseEvent(const ui::MouseEvent& event) {
   domapi::MouseEvent api_event;
   InitMouseEvent(&api_event, event);
   api_event.target_id = event_target_id_;
+  DidCreateEvent(event);
   view_event_handler()->DispatchMouseEvent(api_event);
   if (event.type() != ui::EventType::MouseReleased)
     return;
@@ -188,6 +203,7 @@ void EventSource::DispatchWheelEvent(const ui::MouseWheelEvent& event) {
   api_event.delta_x = 0.0;
   api_event.delta_y = event.delta();
   api_event.delta_z = 0.0;
+  DidCreateEvent(event);
   view_event_handler()->DispatchWheelEvent(api_event);
 }
 
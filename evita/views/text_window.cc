@@ -17,6 +17,7 @@
 #include "evita/gfx/color_f.h"
 #include "evita/gfx/rect_conversions.h"
 #include "evita/gfx/rect_f.h"
+#include "evita/metrics/latency_tracker.h"
 #include "evita/metrics/time_scope.h"
 #include "evita/text/models/buffer.h"
 #include "evita/text/models/selection.h"
@@ -120,7 +121,8 @@ bool TextWindow::DragController::OnMouseReleased(const ui::MouseEvent& event) {
 TextWindow::TextWindow(WindowId window_id)
     : CanvasContentWindow(window_id),
       drag_controller_(new DragController(this)),
-      metrics_view_(new MetricsView()) {
+      metrics_view_(new MetricsView()),
+      processor_(new visuals::DisplayItemListProcessor()) {
   AppendChild(metrics_view_);
 }
 
@@ -144,10 +146,10 @@ void TextWindow::Paint(std::unique_ptr<TextAreaDisplayItem> display_item) {
 
   auto display_item_list = std::move(display_item->display_item_list());
   // Paint scroll bar
-  visuals::DisplayItemListProcessor processor;
-  processor.Paint(canvas(), std::move(display_item_list));
+  processor_->Paint(canvas(), std::move(display_item_list));
 
   NotifyUpdateContent();
+  metrics::LatencyTracker::instance()->DidPaint(window_id());
 }
 
 void TextWindow::UpdateBounds() {
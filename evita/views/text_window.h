@@ -21,6 +21,10 @@ namespace paint {
 class ViewPaintCache;
 }
 
+namespace visuals {
+class DisplayItemListProcessor;
+}
+
 namespace views {
 
 class MetricsView;
@@ -76,6 +80,8 @@ class TextWindow final : public CanvasContentWindow,
 
   std::unique_ptr<DragController> drag_controller_;
   MetricsView* const metrics_view_;
+  // Paints scroll bar.
+  const std::unique_ptr<visuals::DisplayItemListProcessor> processor_;
   gfx::RectF scroll_bar_bounds_;
   std::unique_ptr<paint::ViewPaintCache> view_paint_cache_;
 
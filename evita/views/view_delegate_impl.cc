@@ -29,8 +29,10 @@
 #include "evita/frames/frame_list.h"
 #include "evita/gc/collector.h"
 #include "evita/metrics/counter.h"
+#include "evita/metrics/latency_tracker.h"
 #include "evita/metrics/time_scope.h"
 #include "evita/resource.h"
+#include "evita/spellchecker/spelling_engine.h"
 #include "evita/ui/animation/animator.h"
 #include "evita/ui/base/ime/text_input_client.h"
 #include "evita/ui/controls/text_field_control.h"
@@ -272,12 +274,25 @@ void ViewDelegateImpl::GetMetrics(const base::string16& name,
     delimiter = comma;
   }
 
+  auto const latency = metrics::LatencyTracker::instance()->GetJson(name);
+  if (!latency.empty()) {
+    ostream << delimiter << L"\"latency\": " << latency;
+    delimiter = comma;
+  }
+
   auto const objects = gc::Collector::instance()->GetJson(name);
   if (!objects.empty()) {
     ostream << delimiter << L"\"objects\": " << objects;
     delimiter = comma;
   }
 
+  auto const spelling =
+      spellchecker::SpellingEngine::GetSpellingEngine()->GetJson(name);
+  if (!spelling.empty()) {
+    ostream << delimiter << L"\"spelling\": " << spelling;
+    delimiter = comma;
+  }
+
   ostream << '}';
   ScriptDelegate()->RunCallback(base::Bind(promise.resolve, ostream.str()));
 }
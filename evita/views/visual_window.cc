@@ -19,7 +19,8 @@ using DisplayItemListProcessor = visuals::DisplayItemListProcessor;
 // VisualWindow
 //
 VisualWindow::VisualWindow(WindowId window_id)
-    : CanvasContentWindow(window_id) {}
+    : CanvasContentWindow(window_id),
+      processor_(new DisplayItemListProcessor()) {}
 
 VisualWindow::~VisualWindow() {}
 
@@ -28,8 +29,7 @@ void VisualWindow::Paint(std::unique_ptr<DisplayItemList> display_item_list) {
     return;
   TRACE_EVENT_WITH_FLOW0("visuals", "VisualWindow::Paint", window_id(),
                          TRACE_EVENT_FLAG_FLOW_IN);
-  DisplayItemListProcessor processor;
-  processor.Paint(canvas(), std::move(display_item_list));
+  processor_->Paint(canvas(), std::move(display_item_list));
   NotifyUpdateContent();
 }
 
@@ -5,10 +5,13 @@
 #ifndef EVITA_VIEWS_VISUAL_WINDOW_H_
 #define EVITA_VIEWS_VISUAL_WINDOW_H_
 
+#include <memory>
+
 #include "evita/views/canvas_content_window.h"
 
 namespace visuals {
 class DisplayItemList;
+class DisplayItemListProcessor;
 }
 
 namespace views {
@@ -25,6 +28,8 @@ class VisualWindow final : public CanvasContentWindow {
   void Paint(std::unique_ptr<visuals::DisplayItemList> display_item_list);
 
  private:
+  const std::unique_ptr<visuals::DisplayItemListProcessor> processor_;
+
   DISALLOW_COPY_AND_ASSIGN(VisualWindow);
 };
 
@@ -0,0 +1,121 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/visuals/demo/demo_document.h"
+
+#include "base/strings/stringprintf.h"
+#include "evita/css/selector_parser.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/css/style_sheet.h"
+#include "evita/visuals/dom/document.h"
+#include "evita/visuals/dom/element.h"
+#include "evita/visuals/dom/node_editor.h"
+#include "evita/visuals/dom/node_tree_builder.h"
+
+namespace visuals {
+
+namespace {
+
+const auto kMargin = 8;
+const auto kBorder = 1;
+
+css::Selector ParseSelector(base::StringPiece16 text) {
+  return css::Selector::Parser().Parse(text);
+}
+
+}  // namespace
+
+Document* LoadDemoDocument(int number_of_list_items) {
+  const auto document = NodeTreeBuilder()
+                            .Begin(L"main")
+                            .SetInlineStyle(*css::StyleBuilder()
+                                                 .SetPaddingBottom(kMargin)
+                                                 .SetPaddingRight(kMargin)
+                                                 .SetPaddingTop(kMargin)
+                                                 .Build())
+                            .Begin(L"input", L"input")
+                            .AddText(L"this is a text field.")
+                            .End(L"input")
+                            .AddShape({0})
+                            .AddText(L"Check box 1")
+                            .Begin(L"list", L"list")
+                            .End(L"list")
+                            .End(L"main")
+                            .Build();
+  const auto list = document->GetElementById(L"list");
+  for (auto index = 0; index < number_of_list_items; ++index) {
+    NodeTreeBuilder(list)
+        .Begin(L"list_item")
+        .Begin(L"name")
+        .AddText(base::StringPrintf(L"name %d", index))
+        .End(L"name")
+        .Begin(L"size")
+        .AddText(L"size")
+        .End(L"size")
+        .Begin(L"status")
+        .AddText(L"status")
+        .End(L"status")
+        .Begin(L"file")
+        .AddText(L"file")
+        .End(L"file")
+        .End(L"list_item")
+        .Finish(list);
+    if (index == 0) {
+      NodeEditor().SetInlineStyle(
+          list->last_child()->as<ElementNode>(),
+          *css::StyleBuilder().SetDisplay(css::Display::None()).Build());
+    }
+  }
+  return document;
+}
+
+css::StyleSheet* LoadDemoStyleSheet() {
+  const auto style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(
+      ParseSelector(L"list_item:hover"),
+      std::move(
+          css::StyleBuilder()
+              .SetBackgroundColor(css::ColorValue::Rgba(51, 153, 255, 0.1f))
+              .SetBorder(css::ColorValue::Rgba(51, 153, 255, 1.0f), 1)
+              .Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"input"),
+      std::move(css::StyleBuilder()
+                    .SetBorder(css::ColorValue::Rgba(128, 128, 128), 1)
+                    .SetPadding(2)
+                    .SetWidth(300)
+                    .Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"list"),
+      std::move(css::StyleBuilder().SetDisplay(css::Display::Block()).Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"list_item"),
+      std::move(css::StyleBuilder()
+                    .SetBorder(css::ColorValue::Rgba(255, 255, 255), 1)
+                    .SetColor(0, 0, 0)
+                    .SetDisplay(css::Display::Block())
+                    .SetPaddingTop(2)
+                    .SetPaddingRight(5)
+                    .SetPaddingBottom(2)
+                    .SetPaddingLeft(5)
+                    .Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"main"),
+      std::move(css::StyleBuilder().SetDisplay(css::Display::Block()).Build()));
+  style_sheet->AppendRule(ParseSelector(L"name"),
+                          std::move(css::StyleBuilder().SetWidth(150).Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"size"),
+      std::move(css::StyleBuilder().SetMarginRight(5).Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"status"),
+      std::move(css::StyleBuilder().SetMarginRight(5).Build()));
+  style_sheet->AppendRule(
+      ParseSelector(L"file"),
+      std::move(css::StyleBuilder().SetMarginRight(5).Build()));
+  return style_sheet;
+}
+
+}  // namespace visuals
@@ -0,0 +1,26 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EVITA_VISUALS_DEMO_DEMO_DOCUMENT_H_
+#define EVITA_VISUALS_DEMO_DEMO_DOCUMENT_H_
+
+namespace css {
+class StyleSheet;
+}
+
+namespace visuals {
+
+class Document;
+
+// Returns a document of the demo, which has a text field and a list of
+// |number_of_list_items| items. The document is also used for measuring
+// performance of style and box tree updates.
+Document* LoadDemoDocument(int number_of_list_items);
+
+// Returns a style sheet for the document returned by |LoadDemoDocument()|.
+css::StyleSheet* LoadDemoStyleSheet();
+
+}  // namespace visuals
+
+#endif  // EVITA_VISUALS_DEMO_DEMO_DOCUMENT_H_
@@ -8,16 +8,13 @@
 
 #include "base/bind.h"
 #include "base/logging.h"
-#include "base/strings/stringprintf.h"
 // TODO(eval174): We should move |ui::KeyCode| to its own file from "event.h".
 #include "evita/css/media_state.h"
 #include "evita/css/media_type.h"
-#include "evita/css/selector_parser.h"
-#include "evita/css/style.h"
-#include "evita/css/style_builder.h"
 #include "evita/css/style_sheet.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 #include "evita/ui/events/event.h"
+#include "evita/visuals/demo/demo_document.h"
 #include "evita/visuals/demo/demo_window.h"
 #include "evita/visuals/display/display_item_list_processor.h"
 #include "evita/visuals/display/public/display_item_list.h"
@@ -25,8 +22,6 @@
 #include "evita/visuals/dom/ancestors_or_self.h"
 #include "evita/visuals/dom/document.h"
 #include "evita/visuals/dom/element.h"
-#include "evita/visuals/dom/node_editor.h"
-#include "evita/visuals/dom/node_tree_builder.h"
 #include "evita/visuals/dom/text.h"
 #include "evita/visuals/layout/box_tree.h"
 #include "evita/visuals/view/public/selection.h"
@@ -37,103 +32,7 @@ namespace visuals {
 
 namespace {
 
-const auto kMargin = 8;
-const auto kBorder = 1;
-
-css::Selector ParseSelector(base::StringPiece16 text) {
-  return css::Selector::Parser().Parse(text);
-}
-
-Document* LoadDocument() {
-  const auto document = NodeTreeBuilder()
-                            .Begin(L"main")
-                            .SetInlineStyle(*css::StyleBuilder()
-                                                 .SetPaddingBottom(kMargin)
-                                                 .SetPaddingRight(kMargin)
-                                                 .SetPaddingTop(kMargin)
-                                                 .Build())
-                            .Begin(L"input", L"input")
-                            .AddText(L"this is a text field.")
-                            .End(L"input")
-                            .AddShape({0})
-                            .AddText(L"Check box 1")
-                            .Begin(L"list", L"list")
-                            .End(L"list")
-                            .End(L"main")
-                            .Build();
-  const auto list = document->GetElementById(L"list");
-  for (auto index = 0; index < 20; ++index) {
-    NodeTreeBuilder(list)
-        .Begin(L"list_item")
-        .Begin(L"name")
-        .AddText(base::StringPrintf(L"name %d", index))
-        .End(L"name")
-        .Begin(L"size")
-        .AddText(L"size")
-        .End(L"size")
-        .Begin(L"status")
-        .AddText(L"status")
-        .End(L"status")
-        .Begin(L"file")
-        .AddText(L"file")
-        .End(L"file")
-        .End(L"list_item")
-        .Finish(list);
-    if (index == 0) {
-      NodeEditor().SetInlineStyle(
-          list->last_child()->as<ElementNode>(),
-          *css::StyleBuilder().SetDisplay(css::Display::None()).Build());
-    }
-  }
-  return document;
-}
-
-css::StyleSheet* LoadStyleSheet() {
-  const auto style_sheet = new css::StyleSheet();
-  style_sheet->AppendRule(
-      ParseSelector(L"list_item:hover"),
-      std::move(
-          css::StyleBuilder()
-              .SetBackgroundColor(css::ColorValue::Rgba(51, 153, 255, 0.1f))
-              .SetBorder(css::ColorValue::Rgba(51, 153, 255, 1.0f), 1)
-              .Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"input"),
-      std::move(css::StyleBuilder()
-                    .SetBorder(css::ColorValue::Rgba(128, 128, 128), 1)
-                    .SetPadding(2)
-                    .SetWidth(300)
-                    .Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"list"),
-      std::move(css::StyleBuilder().SetDisplay(css::Display::Block()).Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"list_item"),
-      std::move(css::StyleBuilder()
-                    .SetBorder(css::ColorValue::Rgba(255, 255, 255), 1)
-                    .SetColor(0, 0, 0)
-                    .SetDisplay(css::Display::Block())
-                    .SetPaddingTop(2)
-                    .SetPaddingRight(5)
-                    .SetPaddingBottom(2)
-                    .SetPaddingLeft(5)
-                    .Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"main"),
-      std::move(css::StyleBuilder().SetDisplay(css::Display::Block()).Build()));
-  style_sheet->AppendRule(ParseSelector(L"name"),
-                          std::move(css::StyleBuilder().SetWidth(150).Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"size"),
-      std::move(css::StyleBuilder().SetMarginRight(5).Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"status"),
-      std::move(css::StyleBuilder().SetMarginRight(5).Build()));
-  style_sheet->AppendRule(
-      ParseSelector(L"file"),
-      std::move(css::StyleBuilder().SetMarginRight(5).Build()));
-  return style_sheet;
-}
+const int kNumberOfListItems = 20;
 
 void PrintBox(const BoxTree& box_tree) {
   std::cout << "Box Tree:" << std::endl << box_tree << std::endl;
@@ -167,8 +66,9 @@ void PrintPaint(const DisplayItemList& list) {
 /// DemoModel
 //
 DemoModel::DemoModel()
-    : document_(LoadDocument()),
-      style_sheet_(LoadStyleSheet()),
+    : document_(LoadDemoDocument(kNumberOfListItems)),
+      processor_(new DisplayItemListProcessor()),
+      style_sheet_(LoadDemoStyleSheet()),
       view_(new View(*document_, *this, *this, {style_sheet_})) {
   view_->AddObserver(this);
 }
@@ -237,8 +137,7 @@ void DemoModel::DidBeginAnimationFrame(const base::TimeTicks& now) {
   }
 #endif
 
-  DisplayItemListProcessor processor;
-  processor.Paint(canvas, std::move(display_item_list));
+  processor_->Paint(canvas, std::move(display_item_list));
 }
 
 const char* DemoModel::GetAnimationFrameType() const {
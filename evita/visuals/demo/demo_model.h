@@ -25,6 +25,7 @@ class StyleSheet;
 namespace visuals {
 
 class DemoWindow;
+class DisplayItemListProcessor;
 class Document;
 class ElementNode;
 class Selection;
@@ -77,6 +78,7 @@ class DemoModel final : public css::Media,
   const gc::Member<Document> document_;
   Node* hovered_node_ = nullptr;
   mutable base::ObserverList<UserActionSource::Observer> observers_;
+  const std::unique_ptr<DisplayItemListProcessor> processor_;
   const gc::Member<css::StyleSheet> style_sheet_;
   gfx::FloatSize viewport_size_;
   std::unique_ptr<View> view_;
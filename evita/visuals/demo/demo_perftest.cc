@@ -0,0 +1,101 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/observer_list.h"
+#include "base/time/time.h"
+#include "evita/base/testing/perf_test_util.h"
+#include "evita/css/mock_media.h"
+#include "evita/css/style_sheet.h"
+#include "evita/visuals/demo/demo_document.h"
+#include "evita/visuals/display/public/display_item_list.h"
+#include "evita/visuals/dom/document.h"
+#include "evita/visuals/dom/element.h"
+#include "evita/visuals/view/public/user_action_source.h"
+#include "evita/visuals/view/public/view_lifecycle.h"
+#include "evita/visuals/view/view.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+const int kNumberOfListItems = 10000;
+const int kNumberOfHovers = 100;
+
+}  // namespace
+
+//////////////////////////////////////////////////////////////////////
+//
+// DemoPerfTest
+//
+class DemoPerfTest : public ::testing::Test, public UserActionSource {
+ protected:
+  DemoPerfTest();
+  ~DemoPerfTest() override = default;
+
+  Document* document() const { return document_; }
+  View* view() const { return view_.get(); }
+
+  void NotifyChangeHoveredNode(Node* hovered_node);
+
+ private:
+  // visuals::UserActionSource
+  void AddObserver(UserActionSource::Observer* observer) const final;
+  void RemoveObserver(UserActionSource::Observer* observer) const final;
+
+  Document* const document_;
+  css::MockMedia mock_media_;
+  mutable base::ObserverList<UserActionSource::Observer> observers_;
+  css::StyleSheet* const style_sheet_;
+
+  // |View| takes |Document|, |css::Media|, |UserActionSource| and
+  // |css::StyleSheet|.
+  std::unique_ptr<View> view_;
+
+  DISALLOW_COPY_AND_ASSIGN(DemoPerfTest);
+};
+
+DemoPerfTest::DemoPerfTest()
+    : document_(LoadDemoDocument(kNumberOfListItems)),
+      style_sheet_(LoadDemoStyleSheet()),
+      view_(new View(*document_, mock_media_, *this, {style_sheet_})) {
+  ViewLifecycle::Scope(view_->lifecycle(), ViewLifecycle::State::Started);
+}
+
+void DemoPerfTest::NotifyChangeHoveredNode(Node* hovered_node) {
+  for (auto& observer : observers_)
+    observer.DidChangeHoveredNode(hovered_node);
+}
+
+// visuals::UserActionSource
+void DemoPerfTest::AddObserver(UserActionSource::Observer* observer) const {
+  observers_.AddObserver(observer);
+}
+
+void DemoPerfTest::RemoveObserver(UserActionSource::Observer* observer) const {
+  observers_.RemoveObserver(observer);
+}
+
+// Measures style recalculation, box tree update, layout and paint of the
+// demo document, for the first paint and for moving hover over list items.
+TEST_F(DemoPerfTest, Hover) {
+  const auto initial =
+      base::MeasureTime([&]() { EXPECT_TRUE(view()->Paint()); });
+  base::PrintPerfResult("demo_paint", "initial", initial.InMillisecondsF(),
+                        "ms");
+
+  const auto list = document()->GetElementById(L"list");
+  auto list_item = list->first_child();
+  const auto hover_rate = base::MeasureRate(1, kNumberOfHovers, [&]() {
+    NotifyChangeHoveredNode(list_item);
+    view()->Paint();
+    list_item = list_item->next_sibling();
+  });
+  base::PrintPerfResult("demo_paint", "hover", hover_rate, "paints/s");
+}
+
+}  // namespace visuals
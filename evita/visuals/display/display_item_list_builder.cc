@@ -2,29 +2,179 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "evita/visuals/display/display_item_list_builder.h"
 
 #include "base/logging.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 #include "evita/visuals/display/public/display_item_list.h"
+#include "evita/visuals/display/public/display_item_visitor.h"
 #include "evita/visuals/display/public/display_items.h"
 
 namespace visuals {
 
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+//
+// BoundsVisitor
+//
+// Computes bounding box of a display item in the current coordinate.
+//
+class BoundsVisitor final : public DisplayItemVisitor {
+ public:
+  enum class Kind {
+    BeginClip,
+    BeginTransform,
+    Clear,
+    Draw,
+    End,
+  };
+
+  BoundsVisitor() = default;
+  ~BoundsVisitor() final = default;
+
+  const gfx::FloatRect& bounds() const { return bounds_; }
+  Kind kind() const { return kind_; }
+  const gfx::FloatMatrix3x2& matrix() const { return matrix_; }
+
+ private:
+#define V(name) void Visit##name(name##DisplayItem* item) final;
+  FOR_EACH_DISPLAY_ITEM(V)
+#undef V
+
+  void SetDrawBounds(const gfx::FloatRect& bounds, float thickness);
+
+  gfx::FloatRect bounds_;
+  Kind kind_ = Kind::Draw;
+  gfx::FloatMatrix3x2 matrix_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoundsVisitor);
+};
+
+void BoundsVisitor::SetDrawBounds(const gfx::FloatRect& bounds,
+                                  float thickness) {
+  kind_ = Kind::Draw;
+  const auto& outset = gfx::FloatSize(thickness / 2, thickness / 2);
+  bounds_ = gfx::FloatRect(bounds.origin() - outset,
+                           bounds.bottom_right() + outset);
+}
+
+void BoundsVisitor::VisitBeginClip(BeginClipDisplayItem* item) {
+  kind_ = Kind::BeginClip;
+  bounds_ = item->bounds();
+}
+
+void BoundsVisitor::VisitBeginTransform(BeginTransformDisplayItem* item) {
+  kind_ = Kind::BeginTransform;
+  matrix_ = item->matrix();
+}
+
+void BoundsVisitor::VisitClear(ClearDisplayItem* item) {
+  kind_ = Kind::Clear;
+}
+
+void BoundsVisitor::VisitDrawBitmap(DrawBitmapDisplayItem* item) {
+  SetDrawBounds(item->destination(), 0);
+}
+
+void BoundsVisitor::VisitDrawLine(DrawLineDisplayItem* item) {
+  const auto& point1 = item->point1();
+  const auto& point2 = item->point2();
+  const auto& top_left = gfx::FloatPoint(std::min(point1.x(), point2.x()),
+                                         std::min(point1.y(), point2.y()));
+  const auto& bottom_right = gfx::FloatPoint(std::max(point1.x(), point2.x()),
+                                             std::max(point1.y(), point2.y()));
+  SetDrawBounds(gfx::FloatRect(top_left, bottom_right), item->thickness());
+}
+
+void BoundsVisitor::VisitDrawRect(DrawRectDisplayItem* item) {
+  SetDrawBounds(item->bounds(), item->thickness());
+}
+
+void BoundsVisitor::VisitDrawText(DrawTextDisplayItem* item) {
+  SetDrawBounds(item->bounds(), 0);
+}
+
+void BoundsVisitor::VisitEndClip(EndClipDisplayItem* item) {
+  kind_ = Kind::End;
+}
+
+void BoundsVisitor::VisitEndTransform(EndTransformDisplayItem* item) {
+  kind_ = Kind::End;
+}
+
+void BoundsVisitor::VisitFillRect(FillRectDisplayItem* item) {
+  SetDrawBounds(item->bounds(), 0);
+}
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // DisplayItemListBuilder
 //
 DisplayItemListBuilder::DisplayItemListBuilder(
     const gfx::FloatRect& viewport_bounds)
-    : list_(new DisplayItemList()), viewport_bounds_(viewport_bounds) {}
+    : list_(new DisplayItemList()), viewport_bounds_(viewport_bounds) {
+  scopes_.push_back(Scope{0, viewport_bounds_, gfx::FloatRect(),
+                          gfx::AffineTransformer()});
+}
 
 DisplayItemListBuilder::~DisplayItemListBuilder() {
   DCHECK(!list_);
 }
 
-void DisplayItemListBuilder::AddItem(std::unique_ptr<DisplayItem> item) {
-  list_->items_.push_back(item.release());
+void DisplayItemListBuilder::AddItem(DisplayItem* item) {
+  BoundsVisitor visitor;
+  visitor.Visit(item);
+  const auto index = list_->items_.size();
+  list_->items_.push_back(item);
+  list_->next_indexes_.push_back(index + 1);
+  const auto& scope = scopes_.back();
+  switch (visitor.kind()) {
+    case BoundsVisitor::Kind::BeginClip:
+      // Bounding box of begin item is updated by matching end item.
+      list_->bounds_.push_back(gfx::FloatRect());
+      scopes_.push_back(
+          Scope{index, scope.transformer.MapRect(visitor.bounds())
+                           .Intersect(scope.clip_bounds),
+                gfx::FloatRect(), scope.transformer});
+      return;
+    case BoundsVisitor::Kind::BeginTransform:
+      list_->bounds_.push_back(gfx::FloatRect());
+      scopes_.push_back(Scope{index, scope.clip_bounds, gfx::FloatRect(),
+                              gfx::AffineTransformer(visitor.matrix())});
+      return;
+    case BoundsVisitor::Kind::Clear:
+      // Clear item fills current clip rectangle.
+      list_->bounds_.push_back(scope.clip_bounds);
+      scopes_.back().content_bounds =
+          scope.content_bounds.Union(scope.clip_bounds);
+      return;
+    case BoundsVisitor::Kind::Draw: {
+      const auto& bounds =
+          scope.transformer.MapRect(visitor.bounds()).Intersect(
+              scope.clip_bounds);
+      list_->bounds_.push_back(bounds);
+      scopes_.back().content_bounds = scope.content_bounds.Union(bounds);
+      return;
+    }
+    case BoundsVisitor::Kind::End: {
+      DCHECK_GE(scopes_.size(), 2u) << "Unbalanced end item " << *item;
+      const auto begin_index = scope.begin_index;
+      const auto content_bounds = scope.content_bounds;
+      scopes_.pop_back();
+      list_->bounds_[begin_index] = content_bounds;
+      list_->bounds_.push_back(content_bounds);
+      list_->next_indexes_[begin_index] = index + 1;
+      scopes_.back().content_bounds =
+          scopes_.back().content_bounds.Union(content_bounds);
+      return;
+    }
+  }
+  NOTREACHED();
 }
 
 void DisplayItemListBuilder::AddRect(const gfx::FloatRect& rect) {
@@ -36,8 +186,13 @@ void DisplayItemListBuilder::AddRect(const gfx::FloatRect& rect) {
   list_->rects_.push_back(clipped);
 }
 
+void* DisplayItemListBuilder::AllocateItem(size_t size, size_t alignment) {
+  return list_->zone_.Allocate(size, alignment);
+}
+
 std::unique_ptr<DisplayItemList> DisplayItemListBuilder::Build() {
   DCHECK(list_);
+  DCHECK_EQ(1u, scopes_.size()) << "Begin items should have end items.";
   return std::move(list_);
 }
 
@@ -5,10 +5,15 @@
 #ifndef EVITA_VISUALS_DISPLAY_DISPLAY_ITEM_LIST_BUILDER_H_
 #define EVITA_VISUALS_DISPLAY_DISPLAY_ITEM_LIST_BUILDER_H_
 
+#include <stddef.h>
+
 #include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 
 #include "base/macros.h"
+#include "evita/gfx/base/geometry/affine_transformer.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 
 namespace visuals {
@@ -27,18 +32,29 @@ class DisplayItemListBuilder final {
 
   template <typename T, typename... Args>
   void AddNew(Args&&... args) {
-    AddItem(std::move(
-        std::unique_ptr<DisplayItem>(new T(std::forward<Args>(args)...))));
+    AddItem(new (AllocateItem(sizeof(T), alignof(T)))
+                T(std::forward<Args>(args)...));
   }
 
   void AddRect(const gfx::FloatRect& rect);
   std::unique_ptr<DisplayItemList> Build();
 
  private:
-  void AddItem(std::unique_ptr<DisplayItem> item);
+  // Represents a begin item and items after it.
+  struct Scope {
+    size_t begin_index;
+    gfx::FloatRect clip_bounds;
+    gfx::FloatRect content_bounds;
+    gfx::AffineTransformer transformer;
+  };
+
+  void AddItem(DisplayItem* item);
+  void* AllocateItem(size_t size, size_t alignment);
 
   std::unique_ptr<DisplayItemList> list_;
   std::vector<gfx::FloatRect> rects_;
+  // The first entry of |scopes_| represents viewport.
+  std::vector<Scope> scopes_;
 
   // Display item list should contains items paint inside |viewport_bounds_|.
   const gfx::FloatRect viewport_bounds_;
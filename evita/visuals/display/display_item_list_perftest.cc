@@ -0,0 +1,111 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "evita/base/testing/perf_test_util.h"
+#include "evita/visuals/display/display_item_list_builder.h"
+#include "evita/visuals/display/public/display_item_list.h"
+#include "evita/visuals/display/public/display_item_visitor.h"
+#include "evita/visuals/display/public/display_items.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+const float kRowHeight = 20;
+const float kRowWidth = 800;
+const float kScreenHeight = 600;
+const int kNumberOfRows = 10000;
+const int kNumberOfRepeats = 100;
+
+const gfx::FloatColor kBlack(0, 0, 0);
+const gfx::FloatColor kRed(1, 0, 0);
+const gfx::FloatColor kWhite(1, 1, 1);
+
+gfx::FloatRect RectOf(float x, float y, float width, float height) {
+  return gfx::FloatRect(gfx::FloatPoint(x, y), gfx::FloatSize(width, height));
+}
+
+// Builds display item list of synthetic document of |kNumberOfRows| rows,
+// each row has background, border and underline. Row |row_index| has
+// |row_color| background.
+std::unique_ptr<DisplayItemList> BuildDocument(
+    int row_index,
+    const gfx::FloatColor& row_color) {
+  DisplayItemListBuilder builder(
+      RectOf(0, 0, kRowWidth, kRowHeight * kNumberOfRows));
+  for (auto index = 0; index < kNumberOfRows; ++index) {
+    const auto& bounds =
+        RectOf(0, index * kRowHeight, kRowWidth, kRowHeight);
+    builder.AddNew<BeginClipDisplayItem>(bounds);
+    builder.AddNew<FillRectDisplayItem>(
+        bounds, index == row_index ? row_color : kWhite);
+    builder.AddNew<DrawRectDisplayItem>(bounds, kBlack, 1);
+    builder.AddNew<DrawLineDisplayItem>(bounds.bottom_left(),
+                                        bounds.bottom_right(), kBlack, 1);
+    builder.AddNew<EndClipDisplayItem>();
+  }
+  return builder.Build();
+}
+
+class NullVisitor final : public DisplayItemVisitor {
+ public:
+  NullVisitor() = default;
+  ~NullVisitor() final = default;
+
+ private:
+#define V(name) \
+  void Visit##name(name##DisplayItem* item) final {}
+  FOR_EACH_DISPLAY_ITEM(V)
+#undef V
+
+  DISALLOW_COPY_AND_ASSIGN(NullVisitor);
+};
+
+}  // namespace
+
+TEST(DisplayItemListPerfTest, Build) {
+  const auto rate = base::MeasureRate(kNumberOfRows, kNumberOfRepeats,
+                                      []() { BuildDocument(0, kRed); });
+  base::PrintPerfResult("display_item_list_build", "zone", rate, "rows/s");
+}
+
+TEST(DisplayItemListPerfTest, ComputeDamageRects) {
+  const auto row_index = kNumberOfRows / 2;
+  const auto& list1 = BuildDocument(row_index, kWhite);
+  const auto& list2 = BuildDocument(row_index, kWhite);
+  const auto& list3 = BuildDocument(row_index, kRed);
+  const auto same_rate =
+      base::MeasureRate(kNumberOfRows, kNumberOfRepeats, [&]() {
+        EXPECT_TRUE(list2->ComputeDamageRects(*list1).empty());
+      });
+  base::PrintPerfResult("display_item_list_diff", "same", same_rate, "rows/s");
+  const auto one_row_rate =
+      base::MeasureRate(kNumberOfRows, kNumberOfRepeats, [&]() {
+        EXPECT_EQ(1u, list3->ComputeDamageRects(*list2).size());
+      });
+  base::PrintPerfResult("display_item_list_diff", "one_row", one_row_rate,
+                        "rows/s");
+}
+
+TEST(DisplayItemListPerfTest, VisitItemsIn) {
+  const auto& list = BuildDocument(0, kRed);
+  NullVisitor visitor;
+  const auto all_rate =
+      base::MeasureRate(kNumberOfRows, kNumberOfRepeats, [&]() {
+        for (const auto& item : list->items())
+          visitor.Visit(item);
+      });
+  base::PrintPerfResult("display_item_list_visit", "all", all_rate, "rows/s");
+  const auto screen_rate =
+      base::MeasureRate(kNumberOfRows, kNumberOfRepeats, [&]() {
+        list->VisitItemsIn(RectOf(0, 0, kRowWidth, kScreenHeight), &visitor);
+      });
+  base::PrintPerfResult("display_item_list_visit", "screen", screen_rate,
+                        "rows/s");
+}
+
+}  // namespace visuals
@@ -15,6 +15,7 @@
 
 #include "evita/visuals/display/display_item_list_processor.h"
 
+#include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 #include "evita/gfx/bitmap.h"
@@ -165,28 +166,37 @@ DisplayItemListProcessor::~DisplayItemListProcessor() {}
 
 void DisplayItemListProcessor::Paint(gfx::Canvas* canvas,
                                      std::unique_ptr<DisplayItemList> list) {
+  TRACE_EVENT0("visuals", "DisplayItemListProcessor::Paint");
   gfx::Canvas::DrawingScope drawing_scope(canvas);
-  for (const auto& rect : list->rects())
-    canvas->AddDirtyRect(ToRectF(rect));
+  // Canvas has pixels of |last_items_| unless it recreates bitmap.
+  const auto& dirty_rects =
+      last_items_ && last_bitmap_id_ == canvas->bitmap_id()
+          ? list->ComputeDamageRects(*last_items_)
+          : list->rects();
   PaintVisitor painter(canvas);
-  for (const auto& item : list->items())
-    painter.Visit(item);
+  for (const auto& rect : dirty_rects) {
+    canvas->AddDirtyRect(ToRectF(rect));
+    gfx::Canvas::AxisAlignedClipScope clip_scope(canvas, ToRectF(rect));
+    list->VisitItemsIn(rect, &painter);
+  }
 
 #if PRINT_DIRTY
   std::cout << "DisplayItemListProcessor::Paint(): dirty rects" << std::endl;
   auto index = 0;
-  for (const auto& rect : list->rects())
+  for (const auto& rect : dirty_rects)
     std::cout << ' ' << ++index << ' ' << rect;
   std::cout << std::endl;
 #endif
 #if PAINT_DIRTY
-  for (const auto& rect : list->rects()) {
+  for (const auto& rect : dirty_rects) {
     gfx::Brush brush(canvas, gfx::ColorF(1, 0, 0, 0.1f));
     const auto& rect_f = ToRectF(rect);
     canvas->FillRectangle(brush, rect_f);
     canvas->DrawRectangle(brush, rect_f);
   }
 #endif
+  last_bitmap_id_ = canvas->bitmap_id();
+  last_items_ = std::move(list);
 }
 
 }  // namespace visuals
@@ -23,6 +23,10 @@ class DisplayItemList;
 //
 // DisplayItemListProcessor
 //
+// |DisplayItemListProcessor| paints display item list into canvas. When
+// canvas still has pixels of the last display item list, we paint only
+// changed area by diffing display item lists, and skip items outside of it.
+//
 class DisplayItemListProcessor final {
  public:
   DisplayItemListProcessor();
@@ -31,6 +35,7 @@ class DisplayItemListProcessor final {
   void Paint(gfx::Canvas* canvas, std::unique_ptr<DisplayItemList> list);
 
  private:
+  int last_bitmap_id_ = 0;
   std::unique_ptr<DisplayItemList> last_items_;
 
   DISALLOW_COPY_AND_ASSIGN(DisplayItemListProcessor);
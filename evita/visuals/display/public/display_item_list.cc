@@ -2,21 +2,108 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "evita/visuals/display/public/display_item_list.h"
 
+#include "base/logging.h"
+#include "evita/visuals/display/public/display_item_visitor.h"
 #include "evita/visuals/display/public/display_items.h"
 
 namespace visuals {
 
+namespace {
+
+// When there are more than |kMaxDamageRects| damage rectangles, we use
+// bounding box of them, since painting cost of each rectangle is higher than
+// painting unchanged pixels.
+const size_t kMaxDamageRects = 8;
+
+void AddDamageRect(std::vector<gfx::FloatRect>* rects,
+                   const gfx::FloatRect& rect) {
+  if (rect.IsEmpty())
+    return;
+  for (const auto& present : *rects) {
+    if (present.Contains(rect))
+      return;
+  }
+  rects->erase(std::remove_if(rects->begin(), rects->end(),
+                              [&](const gfx::FloatRect& present) {
+                                return rect.Contains(present);
+                              }),
+               rects->end());
+  rects->push_back(rect);
+}
+
+// Collects damage rectangles of items in [index, end) of |list| compared to
+// items in [previous_index, previous_end) of |previous|.
+void CollectDamageRects(const DisplayItemList& list,
+                        size_t index,
+                        size_t end,
+                        const DisplayItemList& previous,
+                        size_t previous_index,
+                        size_t previous_end,
+                        std::vector<gfx::FloatRect>* rects) {
+  while (index < end && previous_index < previous_end) {
+    const auto next_index = list.next_indexes()[index];
+    const auto previous_next_index = previous.next_indexes()[previous_index];
+    if (*list.items()[index] != *previous.items()[previous_index]) {
+      AddDamageRect(rects, list.bounds()[index]);
+      AddDamageRect(rects, previous.bounds()[previous_index]);
+    } else if (next_index - index > 1) {
+      // Begin items are same, e.g. same clip rectangle or same transform,
+      // so we compare items inside them, excluding end items.
+      CollectDamageRects(list, index + 1, next_index - 1, previous,
+                         previous_index + 1, previous_next_index - 1, rects);
+    }
+    index = next_index;
+    previous_index = previous_next_index;
+  }
+  for (; index < end; index = list.next_indexes()[index])
+    AddDamageRect(rects, list.bounds()[index]);
+  for (; previous_index < previous_end;
+       previous_index = previous.next_indexes()[previous_index]) {
+    AddDamageRect(rects, previous.bounds()[previous_index]);
+  }
+}
+
+}  // namespace
+
 //////////////////////////////////////////////////////////////////////
 //
 // DisplayItemList
 //
-DisplayItemList::DisplayItemList() {}
+DisplayItemList::DisplayItemList() : zone_("DisplayItemList") {}
 
 DisplayItemList::~DisplayItemList() {
+  // Memory of items are released by |zone_|.
   for (const auto& item : items_)
-    delete item;
+    item->~DisplayItem();
+}
+
+std::vector<gfx::FloatRect> DisplayItemList::ComputeDamageRects(
+    const DisplayItemList& previous) const {
+  std::vector<gfx::FloatRect> rects;
+  CollectDamageRects(*this, 0, items_.size(), previous, 0,
+                     previous.items_.size(), &rects);
+  if (rects.size() <= kMaxDamageRects)
+    return rects;
+  gfx::FloatRect bounds;
+  for (const auto& rect : rects)
+    bounds = bounds.Union(rect);
+  return std::vector<gfx::FloatRect>{bounds};
+}
+
+void DisplayItemList::VisitItemsIn(const gfx::FloatRect& rect,
+                                   DisplayItemVisitor* visitor) const {
+  for (auto index = 0u; index < items_.size();) {
+    if (!bounds_[index].Intersects(rect)) {
+      index = next_indexes_[index];
+      continue;
+    }
+    visitor->Visit(items_[index]);
+    ++index;
+  }
 }
 
 }  // namespace visuals
@@ -5,33 +5,62 @@
 #ifndef EVITA_VISUALS_DISPLAY_PUBLIC_DISPLAY_ITEM_LIST_H_
 #define EVITA_VISUALS_DISPLAY_PUBLIC_DISPLAY_ITEM_LIST_H_
 
+#include <stddef.h>
+
 #include <vector>
 
 #include "base/macros.h"
+#include "evita/base/memory/zone.h"
 #include "evita/gfx/base/geometry/float_rect.h"
 
 namespace visuals {
 
 class DisplayItem;
 class DisplayItemListBuilder;
+class DisplayItemVisitor;
 
 //////////////////////////////////////////////////////////////////////
 //
 // DisplayItemList
 //
+// |DisplayItemList| owns display items allocated in its zone, and holds
+// bounding box index of them for culling items by dirty rectangles and
+// diffing against display item list of the last frame.
+//
 class DisplayItemList final {
  public:
   DisplayItemList();
   ~DisplayItemList();
 
+  // Bounding box of each item in viewport coordinate. A begin item and its
+  // matching end item have bounding box of items between them.
+  const std::vector<gfx::FloatRect>& bounds() const { return bounds_; }
   const std::vector<DisplayItem*>& items() const { return items_; }
+  // Index of item after matching end item for a begin item, or index of next
+  // item for other items.
+  const std::vector<size_t>& next_indexes() const { return next_indexes_; }
   const std::vector<gfx::FloatRect>& rects() const { return rects_; }
 
+  // Returns rectangles covering items different from |previous|. Subtrees
+  // with same begin item are compared item by item, other changed subtrees
+  // are covered by their bounding box.
+  std::vector<gfx::FloatRect> ComputeDamageRects(
+      const DisplayItemList& previous) const;
+
+  // Visits items intersecting |rect| in order, skipping subtrees outside of
+  // |rect|.
+  void VisitItemsIn(const gfx::FloatRect& rect,
+                    DisplayItemVisitor* visitor) const;
+
  private:
   friend class DisplayItemListBuilder;
 
+  std::vector<gfx::FloatRect> bounds_;
   std::vector<DisplayItem*> items_;
+  std::vector<size_t> next_indexes_;
   std::vector<gfx::FloatRect> rects_;
+  // |zone_| holds display items in |items_|.
+  evita::Zone zone_;
 
   DISALLOW_COPY_AND_ASSIGN(DisplayItemList);
 };
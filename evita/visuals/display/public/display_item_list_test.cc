@@ -2,13 +2,62 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <vector>
+
 #include "evita/visuals/display/public/display_item_list.h"
 #include "evita/visuals/display/display_item_list_builder.h"
+#include "evita/visuals/display/public/display_item_visitor.h"
 #include "evita/visuals/display/public/display_items.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace visuals {
 
+namespace {
+
+const gfx::FloatColor kRed(1, 0, 0);
+const gfx::FloatColor kWhite(1, 1, 1);
+
+gfx::FloatRect RectOf(float x, float y, float width, float height) {
+  return gfx::FloatRect(gfx::FloatPoint(x, y), gfx::FloatSize(width, height));
+}
+
+// Builds list of |num_rows| rows of height 10 each in a clip, and paints
+// |row_color| for row |row_index|.
+std::unique_ptr<DisplayItemList> BuildRows(int num_rows,
+                                           int row_index,
+                                           const gfx::FloatColor& row_color) {
+  DisplayItemListBuilder builder(RectOf(0, 0, 100, 100));
+  for (auto index = 0; index < num_rows; ++index) {
+    const auto& bounds = RectOf(0, index * 10, 100, 10);
+    builder.AddNew<BeginClipDisplayItem>(bounds);
+    builder.AddNew<FillRectDisplayItem>(
+        bounds, index == row_index ? row_color : kWhite);
+    builder.AddNew<EndClipDisplayItem>();
+  }
+  return builder.Build();
+}
+
+class CountingVisitor final : public DisplayItemVisitor {
+ public:
+  CountingVisitor() = default;
+  ~CountingVisitor() final = default;
+
+  int count() const { return count_; }
+
+ private:
+#define V(name) \
+  void Visit##name(name##DisplayItem* item) final { ++count_; }
+  FOR_EACH_DISPLAY_ITEM(V)
+#undef V
+
+  int count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingVisitor);
+};
+
+}  // namespace
+
 TEST(DisplayItemList, Basic) {
   gfx::FloatRect viewport_bounds(gfx::FloatSize(10, 10));
   DisplayItemListBuilder builder(viewport_bounds);
@@ -21,4 +70,68 @@ TEST(DisplayItemList, Basic) {
   EXPECT_EQ(3, list->items().size());
 }
 
+TEST(DisplayItemList, Bounds) {
+  DisplayItemListBuilder builder(RectOf(0, 0, 100, 100));
+  builder.AddNew<BeginClipDisplayItem>(RectOf(10, 10, 20, 20));
+  builder.AddNew<FillRectDisplayItem>(RectOf(0, 0, 50, 50), kRed);
+  builder.AddNew<EndClipDisplayItem>();
+  builder.AddNew<BeginTransformDisplayItem>(
+      gfx::FloatMatrix3x2({1, 0, 0, 1, 30, 40}));
+  builder.AddNew<DrawRectDisplayItem>(RectOf(0, 0, 10, 10), kRed, 2);
+  builder.AddNew<EndTransformDisplayItem>();
+  const auto& list = builder.Build();
+
+  EXPECT_EQ(RectOf(10, 10, 20, 20), list->bounds()[0])
+      << "Begin item covers clipped items.";
+  EXPECT_EQ(RectOf(10, 10, 20, 20), list->bounds()[1]);
+  EXPECT_EQ(RectOf(10, 10, 20, 20), list->bounds()[2]);
+  EXPECT_EQ(RectOf(29, 39, 12, 12), list->bounds()[4])
+      << "Bounds are transformed and include thickness.";
+  EXPECT_EQ(RectOf(29, 39, 12, 12), list->bounds()[5]);
+  EXPECT_EQ((std::vector<size_t>{3, 2, 3, 6, 5, 6}), list->next_indexes());
+}
+
+TEST(DisplayItemList, ComputeDamageRects) {
+  const auto& list1 = BuildRows(5, 2, kRed);
+  const auto& list2 = BuildRows(5, 2, kRed);
+  EXPECT_TRUE(list2->ComputeDamageRects(*list1).empty());
+
+  const auto& list3 = BuildRows(5, 3, kRed);
+  EXPECT_EQ((std::vector<gfx::FloatRect>{RectOf(0, 20, 100, 10),
+                                         RectOf(0, 30, 100, 10)}),
+            list3->ComputeDamageRects(*list2));
+
+  const auto& list4 = BuildRows(4, 3, kRed);
+  EXPECT_EQ((std::vector<gfx::FloatRect>{RectOf(0, 40, 100, 10)}),
+            list4->ComputeDamageRects(*list3))
+      << "Removed row is damaged.";
+}
+
+TEST(DisplayItemList, ComputeDamageRectsMany) {
+  DisplayItemListBuilder builder1(RectOf(0, 0, 100, 100));
+  DisplayItemListBuilder builder2(RectOf(0, 0, 100, 100));
+  for (auto index = 0; index < 10; ++index) {
+    builder1.AddNew<FillRectDisplayItem>(RectOf(0, index * 10, 10, 10), kRed);
+    builder2.AddNew<FillRectDisplayItem>(RectOf(0, index * 10, 10, 10),
+                                         kWhite);
+  }
+  const auto& list1 = builder1.Build();
+  const auto& list2 = builder2.Build();
+  EXPECT_EQ((std::vector<gfx::FloatRect>{RectOf(0, 0, 10, 100)}),
+            list2->ComputeDamageRects(*list1))
+      << "Many damage rectangles are merged into one.";
+}
+
+TEST(DisplayItemList, VisitItemsIn) {
+  const auto& list = BuildRows(10, 0, kRed);
+
+  CountingVisitor visitor1;
+  list->VisitItemsIn(RectOf(0, 0, 100, 100), &visitor1);
+  EXPECT_EQ(30, visitor1.count());
+
+  CountingVisitor visitor2;
+  list->VisitItemsIn(RectOf(0, 25, 100, 10), &visitor2);
+  EXPECT_EQ(6, visitor2.count()) << "Only rows 2 and 3 are visited.";
+}
+
 }  // namespace visuals
@@ -5,7 +5,6 @@
 #include "evita/visuals/dom/container_node.h"
 
 #include "base/logging.h"
-#include "evita/visuals/dom/node_editor.h"
 
 namespace visuals {
 
@@ -22,16 +21,12 @@ ContainerNode::ContainerNode(Document* document,
 ContainerNode::ContainerNode(Document* document, base::StringPiece16 tag_name)
     : Node(document, tag_name) {}
 
-ContainerNode::~ContainerNode() {
-  DCHECK_EQ(static_cast<ContainerNode*>(nullptr), parent());
-  auto runner = first_child_;
-  while (runner) {
-    const auto next_child = runner->next_sibling();
-    NodeEditor().WillDestroy(runner);
-    delete runner;
-    runner = next_child;
-  }
-}
+// Nodes are owned by |gc::Collector| and destroyed only by it, see
+// |gc::internal::AbstractCollectable::~AbstractCollectable()|. Child nodes
+// are unreachable when this node is unreachable, so they are destroyed in the
+// same collection. Since the collector destroys dead objects in arbitrary
+// order, we don't touch child nodes here.
+ContainerNode::~ContainerNode() {}
 
 // gc::Visitable
 void ContainerNode::Accept(gc::Visitor* visitor) {
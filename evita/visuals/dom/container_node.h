@@ -46,8 +46,8 @@ class ContainerNode : public Node {
   void Accept(gc::Visitor* visitor) override;
 
   // For ease of using list of child nodes, we don't use |Node*|
-  Node* first_child_ = nullptr;
-  Node* last_child_ = nullptr;
+  gc::Member<Node> first_child_;
+  gc::Member<Node> last_child_;
 
   // |is_children_changed_| is true if one of child is changed affects
   // siblings or this container node. This flag is also true adding/removing
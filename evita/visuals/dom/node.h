@@ -14,6 +14,7 @@
 #include "evita/base/castable.h"
 #include "evita/base/strings/atomic_string.h"
 #include "evita/gc/collectable.h"
+#include "evita/gc/member.h"
 #include "evita/gc/visitor.h"
 #include "evita/visuals/dom/nodes_forward.h"
 
@@ -87,14 +88,14 @@ class Node : public base::Castable<Node>, public gc::Collectable<Node> {
   // gc::Visitable
   void Accept(gc::Visitor* visitor) override;
 
-  Document* document_;
+  gc::Member<Document> document_;
   // User specified string identifier of this node. Multiple nodes can have
   // same string id.
   const base::AtomicString id_;
-  Node* next_sibling_ = nullptr;
+  gc::Member<Node> next_sibling_;
   const base::AtomicString node_name_;
-  ContainerNode* parent_ = nullptr;
-  Node* previous_sibling_ = nullptr;
+  gc::Member<ContainerNode> parent_;
+  gc::Member<Node> previous_sibling_;
   const int sequence_id_;
 
   DISALLOW_COPY_AND_ASSIGN(Node);
@@ -268,9 +268,4 @@ void NodeEditor::UnregisterElementIdForSubtree(const Node& node) {
   }
 }
 
-void NodeEditor::WillDestroy(Node* node) {
-  DCHECK(!node->document()->is_locked());
-  node->parent_ = nullptr;
-}
-
 }  // namespace visuals
@@ -39,8 +39,6 @@ class NodeEditor final {
   void SetShapeData(Shape* shape, const ShapeData& data);
   void SetTextData(Text* text, base::StringPiece16 data);
 
-  void WillDestroy(Node* node);
-
  private:
   void DidChangeChild(ContainerNode* container);
   void RegisterElementIdForSubtree(const Node& node);
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <ostream>
+#include <unordered_set>
 #include <vector>
 
 #include "evita/visuals/layout/box_tree.h"
@@ -12,6 +13,8 @@
 #include "base/trace_event/trace_event.h"
 #include "evita/css/media.h"
 #include "evita/css/style.h"
+#include "evita/visuals/dom/ancestors.h"
+#include "evita/visuals/dom/ancestors_or_self.h"
 #include "evita/visuals/dom/descendants_or_self.h"
 #include "evita/visuals/dom/document.h"
 #include "evita/visuals/dom/element.h"
@@ -106,10 +109,14 @@ class BoxTree::Impl final {
   void UpdateContainerNode(Context* context, const ContainerNode& container);
   void UpdateContainerNodeIfNeeded(Context* context,
                                    const ContainerNode& container);
-  void UpdateNode(Context* context, const Node& node);
-  void UpdateNodeIfNeeded(Context* context, const Node& node);
 
   BoxMap box_map_;
+  // Nodes having descendants in |dirty_nodes_|.
+  std::unordered_set<const Node*> child_dirty_nodes_;
+  // Nodes to be assigned boxes again. We track dirty nodes here rather than
+  // using |Box::is_changed()|, since painter resets it only for boxes in
+  // viewport.
+  std::unordered_set<const Node*> dirty_nodes_;
   const Document& document_;
   RootBox* const root_box_;
   BoxTreeState state_;
@@ -124,7 +131,9 @@ BoxTree::Impl::Impl(ViewLifecycle* lifecycle, const StyleTree& style_tree)
       document_(style_tree.document()),
       root_box_(box_map_.root_box()),
       state_(BoxTreeState::Dirty),
-      style_tree_(style_tree) {}
+      style_tree_(style_tree) {
+  dirty_nodes_.insert(&document_);
+}
 
 RootBox* BoxTree::Impl::root_box() const {
   DCHECK_NE(BoxTreeState::Updating, state_);
@@ -238,10 +247,20 @@ void BoxTree::Impl::MarkDirty(const Node& node) {
     return;
   state_ = BoxTreeState::Dirty;
   // Note: When |BoxTree| is dirty, we can't use |BoxTree::Impl::BoxFor()|.
-  const auto box = box_map_.BoxFor(node);
-  if (!box)
+  // When |node| doesn't have a box, e.g. it was "display:none", we mark
+  // the nearest ancestor having a box to assign a box to |node|.
+  for (const auto& runner : Node::AncestorsOrSelf(node)) {
+    const auto box = box_map_.BoxFor(*runner);
+    if (!box)
+      continue;
+    BoxEditor().MarkDirty(box);
+    dirty_nodes_.insert(runner);
+    for (const auto& ancestor : Node::Ancestors(*runner)) {
+      if (!child_dirty_nodes_.insert(ancestor).second)
+        break;
+    }
     return;
-  BoxEditor().MarkDirty(box);
+  }
 }
 
 void BoxTree::Impl::UpdateContainerNode(Context* context,
@@ -250,27 +269,26 @@ void BoxTree::Impl::UpdateContainerNode(Context* context,
   const auto container_box = BoxFor(container);
   if (!container_box)
     return;
-  for (const auto& child : container.child_nodes())
-    UpdateNode(context, *child);
+  // Child containers without changes keep their boxes and descendant boxes,
+  // and they are attached to |container_box| again. Other children are
+  // assigned again, since they get computed style from |container|.
+  for (const auto& child : container.child_nodes()) {
+    if (const auto child_container = child->as<ContainerNode>())
+      UpdateContainerNodeIfNeeded(context, *child_container);
+    else
+      AssignBoxToNode(context, *child);
+  }
   FormatContainerBox(context, container_box->as<ContainerBox>());
 }
 
 void BoxTree::Impl::UpdateContainerNodeIfNeeded(
     Context* context,
     const ContainerNode& container) {
-  if (const auto box = BoxFor(container)) {
-    if (box->is_changed())
-      return UpdateContainerNode(context, container);
-    if (!box->as<ContainerBox>()->is_child_changed())
-      return;
-  }
-  AssignBoxToNode(context, container);
-  const auto container_box = BoxFor(container);
-  if (!container_box)
+  if (BoxFor(container) && dirty_nodes_.count(&container) == 0 &&
+      child_dirty_nodes_.count(&container) == 0) {
     return;
-  for (const auto& child : container.child_nodes())
-    UpdateNodeIfNeeded(context, *child);
-  FormatContainerBox(context, container_box->as<ContainerBox>());
+  }
+  UpdateContainerNode(context, container);
 }
 
 void BoxTree::Impl::UpdateIfNeeded() {
@@ -295,30 +313,13 @@ void BoxTree::Impl::UpdateIfNeeded() {
   Context context;
   context.is_updated = false;
   state_ = BoxTreeState::Updating;
-  if (root_box_->is_changed())
-    UpdateContainerNode(&context, document_);
-  else
-    UpdateContainerNodeIfNeeded(&context, document_);
+  UpdateContainerNodeIfNeeded(&context, document_);
+  child_dirty_nodes_.clear();
+  dirty_nodes_.clear();
   DCHECK(context.is_updated);
   state_ = BoxTreeState::Clean;
 }
 
-void BoxTree::Impl::UpdateNode(Context* context, const Node& node) {
-  if (const auto container = node.as<ContainerNode>())
-    return UpdateContainerNode(context, *container);
-  AssignBoxToNode(context, node);
-}
-
-void BoxTree::Impl::UpdateNodeIfNeeded(Context* context, const Node& node) {
-  if (const auto container = node.as<ContainerNode>())
-    return UpdateContainerNodeIfNeeded(context, *container);
-  if (const auto box = BoxFor(node)) {
-    if (!box->is_changed())
-      return;
-  }
-  AssignBoxToNode(context, node);
-}
-
 //////////////////////////////////////////////////////////////////////
 //
 // BoxTree
@@ -15,6 +15,7 @@
 #include "evita/css/style_builder.h"
 #include "evita/visuals/dom/document.h"
 #include "evita/visuals/dom/element.h"
+#include "evita/visuals/dom/node_editor.h"
 #include "evita/visuals/dom/node_tree_builder.h"
 #include "evita/visuals/layout/descendants_or_self.h"
 #include "evita/visuals/layout/root_box.h"
@@ -87,6 +88,8 @@ class MockView final : public UserActionSource {
 
   const BoxTree& box_tree() const { return *box_tree_; }
 
+  void Update();
+
  private:
   std::unique_ptr<ViewLifecycle> lifecycle_;
   std::unique_ptr<Selection> selection_;
@@ -106,8 +109,7 @@ MockView::MockView(const Document& document, const css::Media& media)
       style_tree_(new StyleTree(lifecycle_.get(), *this, {})),
       box_tree_(new BoxTree(lifecycle_.get(), *selection_, *style_tree_)) {
   ViewLifecycle::Scope(lifecycle_.get(), ViewLifecycle::State::Started);
-  style_tree_->UpdateIfNeeded();
-  box_tree_->UpdateIfNeeded();
+  Update();
 }
 
 MockView::~MockView() {
@@ -116,6 +118,11 @@ MockView::~MockView() {
   lifecycle_->FinishShutdown();
 }
 
+void MockView::Update() {
+  style_tree_->UpdateIfNeeded();
+  box_tree_->UpdateIfNeeded();
+}
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////
@@ -146,6 +153,31 @@ TEST_F(BoxTreeTest, Basic) {
             BoxTreeToString(view.box_tree()));
 }
 
+TEST_F(BoxTreeTest, DisplayNoneToInline) {
+  const auto& document =
+      NodeTreeBuilder()
+          .Begin(L"body")
+          .Begin(L"foo", L"foo")
+          .SetInlineStyle(
+              *css::StyleBuilder().SetDisplay(css::Display::None()).Build())
+          .AddText(L"bar")
+          .End(L"foo")
+          .AddText(L"baz")
+          .End(L"body")
+          .Build();
+  MockView view(*document, mock_media());
+  EXPECT_EQ("RootBox:inline(FlowBox:inline('baz'))",
+            BoxTreeToString(view.box_tree()));
+
+  NodeEditor().SetInlineStyle(
+      document->GetElementById(L"foo"),
+      *css::StyleBuilder().SetDisplay(css::Display::Inline()).Build());
+  view.Update();
+  EXPECT_EQ("RootBox:inline(FlowBox:inline(FlowBox:inline('bar') 'baz'))",
+            BoxTreeToString(view.box_tree()))
+      << "Parent of a node without box is updated.";
+}
+
 TEST_F(BoxTreeTest, FlowAnonymous) {
   auto display_block =
       css::StyleBuilder().SetDisplay(css::Display::Block()).Build();
@@ -0,0 +1,64 @@
+// Copyright (c) 2016 Project Vogue. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "evita/base/testing/perf_test_util.h"
+#include "evita/css/style.h"
+#include "evita/css/style_builder.h"
+#include "evita/gfx/base/geometry/float_rect.h"
+#include "evita/visuals/display/public/display_item_list.h"
+#include "evita/visuals/layout/flow_box.h"
+#include "evita/visuals/layout/layouter.h"
+#include "evita/visuals/layout/root_box.h"
+#include "evita/visuals/layout/simple_box_tree.h"
+#include "evita/visuals/paint/paint_info.h"
+#include "evita/visuals/paint/painter.h"
+#include "evita/visuals/view/public/view_lifecycle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace visuals {
+
+namespace {
+
+const float kRowHeight = 20;
+const int kNumberOfRows = 10000;
+const int kNumberOfRepeats = 100;
+
+}  // namespace
+
+TEST(PainterPerfTest, Paint) {
+  SimpleBoxTree box_tree;
+  box_tree.Begin<FlowBox>();
+  for (auto index = 0; index < kNumberOfRows; ++index) {
+    box_tree.Begin<FlowBox>()
+        .SetStyle(*css::StyleBuilder()
+                       .SetBackgroundColor(css::ColorValue(1, 1, 1))
+                       .SetDisplay(css::Display::Block())
+                       .SetBorder(css::ColorValue(0, 0, 0), 1)
+                       .SetHeight(kRowHeight)
+                       .Build())
+        .End<FlowBox>();
+  }
+  box_tree.End<FlowBox>().Finish();
+  const auto root = box_tree.root_box();
+  Layouter().Layout(root);
+
+  const auto& document_bounds =
+      gfx::FloatRect(gfx::FloatSize(root->viewport_size().width(),
+                                    kRowHeight * kNumberOfRows));
+  const auto document_rate =
+      base::MeasureRate(kNumberOfRows, kNumberOfRepeats, [&]() {
+        root->lifecycle()->LimitTo(ViewLifecycle::State::LayoutClean);
+        Painter().Paint(PaintInfo(document_bounds), *root);
+      });
+  base::PrintPerfResult("painter_paint", "document", document_rate, "rows/s");
+  const auto viewport_rate =
+      base::MeasureRate(kNumberOfRows, kNumberOfRepeats, [&]() {
+        root->lifecycle()->LimitTo(ViewLifecycle::State::LayoutClean);
+        Painter().Paint(PaintInfo(gfx::FloatRect(root->viewport_size())),
+                        *root);
+      });
+  base::PrintPerfResult("painter_paint", "viewport", viewport_rate, "rows/s");
+}
+
+}  // namespace visuals
@@ -16,6 +16,7 @@
 #include "evita/visuals/layout/root_box.h"
 #include "evita/visuals/layout/simple_box_tree.h"
 #include "evita/visuals/paint/paint_info.h"
+#include "evita/visuals/view/public/view_lifecycle.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace visuals {
@@ -35,4 +36,30 @@ TEST(PainterTest, Basic) {
   EXPECT_EQ(5, display_item_list->items().size());
 }
 
+TEST(PainterTest, CullRect) {
+  SimpleBoxTree box_tree;
+  box_tree.Begin<FlowBox>();
+  for (auto index = 0; index < 100; ++index) {
+    box_tree.Begin<FlowBox>()
+        .SetStyle(*css::StyleBuilder()
+                       .SetBackgroundColor(css::ColorValue(1, 1, 1))
+                       .SetDisplay(css::Display::Block())
+                       .SetHeight(20)
+                       .Build())
+        .End<FlowBox>();
+  }
+  box_tree.End<FlowBox>().Finish();
+  const auto root = box_tree.root_box();
+  Layouter().Layout(root);
+
+  const auto& document_list = Painter().Paint(
+      PaintInfo(gfx::FloatRect(gfx::FloatSize(800, 2000))), *root);
+  root->lifecycle()->LimitTo(ViewLifecycle::State::LayoutClean);
+  const auto& viewport_list = Painter().Paint(
+      PaintInfo(gfx::FloatRect(gfx::FloatSize(800, 100))), *root);
+  EXPECT_LT(viewport_list->items().size() * 10,
+            document_list->items().size())
+      << "Rows outside of cull rect are not painted.";
+}
+
 }  // namespace visuals
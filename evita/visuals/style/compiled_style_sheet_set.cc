@@ -8,7 +8,6 @@
 #include "base/trace_event/trace_event.h"
 #include "evita/base/strings/atomic_string.h"
 #include "evita/css/rule.h"
-#include "evita/css/selector_builder.h"
 #include "evita/css/style.h"
 #include "evita/css/style_editor.h"
 #include "evita/css/style_sheet.h"
@@ -78,7 +77,11 @@ void CompiledStyleSheetSet::AddObserver(
 
 void CompiledStyleSheetSet::ClearCache() {
   cached_matches_.clear();
+  class_rules_.clear();
+  id_rules_.clear();
   rules_.clear();
+  tag_rules_.clear();
+  universal_rules_.clear();
 }
 
 void CompiledStyleSheetSet::CompileStyleSheetsIfNeeded() {
@@ -88,6 +91,8 @@ void CompiledStyleSheetSet::CompileStyleSheetsIfNeeded() {
     for (const auto& rule : style_sheet->rules())
       CompileRule(*rule);
   }
+  for (auto rule = rules_.cbegin(); rule != rules_.cend(); ++rule)
+    IndexRule(rule);
   if (DLOG_IS_ON(INFO) && VLOG_IS_ON(1)) {
     DVLOG(1) << "Compiled Rules";
     for (const auto& entry : rules_)
@@ -107,101 +112,63 @@ void CompiledStyleSheetSet::CompileRule(const css::Rule& rule) {
                       std::move(std::make_unique<css::Style>(rule.style())))));
 }
 
-// Returns true if this function adds class to |builder|.
-static bool AddClass(css::Selector::Builder* builder,
-                     const css::Selector& selector,
-                     size_t start) {
-  const auto& classes = selector.classes();
-  DCHECK_LE(start, classes.size());
-  if (start == classes.size())
-    return false;
-  size_t index = 0;
-  for (const auto& class_name : classes) {
-    if (index >= start)
-      builder->AddClass(class_name);
-    ++index;
+void CompiledStyleSheetSet::IndexRule(Rule rule) {
+  const auto& selector = rule->first;
+  if (selector.has_id()) {
+    id_rules_[selector.id()].push_back(rule);
+    return;
+  }
+  if (selector.has_classes()) {
+    // An element matched to |selector| has all classes in |selector|, so
+    // any class in |selector| works as a key.
+    class_rules_[*selector.classes().begin()].push_back(rule);
+    return;
+  }
+  if (!selector.is_universal()) {
+    tag_rules_[selector.tag_name()].push_back(rule);
+    return;
   }
-  return true;
+  universal_rules_.push_back(rule);
 }
 
+// Collects rules matched to |selector| from buckets keyed by id, classes and
+// tag name of |selector|. Since each rule is in exactly one bucket, this
+// function checks only rules sharing a key with |selector|.
 CompiledStyleSheetSet::MatchSet CompiledStyleSheetSet::Match(
     const css::Selector& selector) const {
   DVLOG(1) << "Match: " << selector;
   MatchSet matched;
-  MatchOne(&matched, css::Selector(), selector);
-  for (size_t index = 0; index <= selector.classes().size(); ++index) {
-    if (!selector.is_universal() && selector.has_id()) {
-      css::Selector::Builder builder;
-      builder.SetTagName(selector.tag_name()).SetId(selector.id());
-      if (index == 0)
-        MatchOne(&matched, builder.Build(), selector);
-      if (AddClass(&builder, selector, index))
-        MatchOne(&matched, builder.Build(), selector);
-    }
-
-    if (!selector.is_universal()) {
-      css::Selector::Builder builder;
-      builder.SetTagName(selector.tag_name());
-      if (index == 0)
-        MatchOne(&matched, builder.Build(), selector);
-      if (AddClass(&builder, selector, index))
-        MatchOne(&matched, builder.Build(), selector);
-    }
-
-    if (selector.has_id()) {
-      css::Selector::Builder builder;
-      builder.SetId(selector.id());
-      if (index == 0)
-        MatchOne(&matched, builder.Build(), selector);
-      if (AddClass(&builder, selector, index))
-        MatchOne(&matched, builder.Build(), selector);
-    }
-
-    css::Selector::Builder builder;
-    if (!AddClass(&builder, selector, index))
-      continue;
-    MatchOne(&matched, builder.Build(), selector);
-  }
+  MatchRules(&matched, universal_rules_, selector);
+  if (!selector.is_universal())
+    MatchRules(&matched, tag_rules_, selector.tag_name(), selector);
+  if (selector.has_id())
+    MatchRules(&matched, id_rules_, selector.id(), selector);
+  for (const auto& class_name : selector.classes())
+    MatchRules(&matched, class_rules_, class_name, selector);
   return std::move(matched);
 }
 
-static bool StartsWith(const css::Selector& selector1,
-                       const css::Selector& selector2) {
-  if (selector1.tag_name() != selector2.tag_name())
-    return false;
-  if (selector1.id() != selector2.id())
-    return false;
-  if (selector1.classes().empty() || selector2.classes().empty())
-    return selector1.classes().empty() == selector2.classes().empty();
-  if (selector1.classes().size() > selector2.classes().size())
-    return false;
-  return *selector1.classes().begin() == *selector2.classes().begin();
+void CompiledStyleSheetSet::MatchRules(MatchSet* match_set,
+                                       const RuleIndex& rule_index,
+                                       base::AtomicString key,
+                                       const css::Selector& selector) const {
+  const auto& it = rule_index.find(key);
+  if (it == rule_index.end())
+    return;
+  MatchRules(match_set, it->second, selector);
 }
 
-void CompiledStyleSheetSet::MatchOne(MatchSet* match_set,
-                                     const css::Selector& needle,
-                                     const css::Selector& selector) const {
-  DVLOG(1) << "  MatchOne: needle=" << needle;
-  auto runner = rules_.lower_bound(needle);
-  while (runner != rules_.end()) {
-    if (!StartsWith(runner->first, needle)) {
-      DVLOG(1) << "    exit " << runner->first << " doesn't start with "
-               << needle;
-      return;
-    }
-    if (selector.IsSubsetOf(runner->first)) {
-      DVLOG(1) << "    " << runner->first;
-      const auto& result = match_set->emplace(runner);
-      if (!result.second) {
-        DVLOG(1) << "  Matched Rules:";
-        for (const auto& rule : *match_set)
-          DVLOG(1) << "    " << rule->first;
-        NOTREACHED();
-      }
-    } else {
-      DVLOG(1) << "    skip " << runner->first;
+void CompiledStyleSheetSet::MatchRules(MatchSet* match_set,
+                                       const std::vector<Rule>& rules,
+                                       const css::Selector& selector) const {
+  for (const auto& rule : rules) {
+    if (!selector.IsSubsetOf(rule->first)) {
+      DVLOG(1) << "    skip " << rule->first;
+      continue;
     }
-    ++runner;
+    DVLOG(1) << "    " << rule->first;
+    const auto& result = match_set->emplace(rule);
+    DCHECK(result.second) << "Rule " << rule->first << " is matched twice.";
   }
 }
 
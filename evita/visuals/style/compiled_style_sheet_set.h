@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "base/macros.h"
@@ -62,22 +63,33 @@ class CompiledStyleSheetSet final : public css::StyleSheetObserver {
     bool operator()(const Rule& rule1, const Rule& rule2) const;
   };
   using MatchSet = std::set<Rule, RuleLess>;
+  // Rules bucketed by id, class or tag name of selector.
+  using RuleIndex = std::unordered_map<base::AtomicString, std::vector<Rule>>;
 
   void ClearCache();
   void CompileStyleSheetsIfNeeded();
   void CompileRule(const css::Rule& rule);
+  void IndexRule(Rule rule);
   MatchSet Match(const css::Selector& selector) const;
-  void MatchOne(MatchSet* match_set,
-                const css::Selector& needle,
-                const css::Selector& selector) const;
+  void MatchRules(MatchSet* match_set,
+                  const RuleIndex& rule_index,
+                  base::AtomicString key,
+                  const css::Selector& selector) const;
+  void MatchRules(MatchSet* match_set,
+                  const std::vector<Rule>& rules,
+                  const css::Selector& selector) const;
 
   // css::StyleSheetObserver
   void DidInsertRule(const css::Rule& new_rule, size_t index);
   void DidRemoveRule(const css::Rule& old_rule, size_t index);
 
   mutable CacheMap cached_matches_;
+  mutable RuleIndex class_rules_;
+  mutable RuleIndex id_rules_;
   mutable base::ObserverList<css::StyleSheetObserver> observers_;
   mutable RuleMap rules_;
+  mutable RuleIndex tag_rules_;
+  mutable std::vector<Rule> universal_rules_;
   const std::vector<css::StyleSheet*> style_sheets_;
 
   DISALLOW_COPY_AND_ASSIGN(CompiledStyleSheetSet);
@@ -156,6 +156,32 @@ TEST_F(CompiledStyleSheetSetTest, Match) {
             Match(compiled, ParseSelector(L".c1:hover")));
 }
 
+TEST_F(CompiledStyleSheetSetTest, MatchIdAndUniversal) {
+  const auto style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(ParseSelector(L"*"),
+                          css::StyleBuilder().SetColor(1, 0, 0).Build());
+  style_sheet->AppendRule(ParseSelector(L"#id"),
+                          css::StyleBuilder().SetColor(0, 1, 0).Build());
+  style_sheet->AppendRule(ParseSelector(L"tag#id"),
+                          css::StyleBuilder().SetColor(0, 0, 1).Build());
+  style_sheet->AppendRule(ParseSelector(L"tag.c2"),
+                          css::StyleBuilder().SetColor(1, 1, 0).Build());
+  CompiledStyleSheetSet compiled({style_sheet});
+
+  EXPECT_EQ(std::vector<css::Selector>{ParseSelector(L"*")},
+            Match(compiled, ParseSelector(L"tag")));
+  EXPECT_EQ((std::vector<css::Selector>{ParseSelector(L"tag#id"),
+                                        ParseSelector(L"#id"),
+                                        ParseSelector(L"*")}),
+            Match(compiled, ParseSelector(L"tag#id.c1")));
+  EXPECT_EQ((std::vector<css::Selector>{ParseSelector(L"#id"),
+                                        ParseSelector(L"*")}),
+            Match(compiled, ParseSelector(L"other#id.c2")));
+  EXPECT_EQ((std::vector<css::Selector>{ParseSelector(L"tag.c2"),
+                                        ParseSelector(L"*")}),
+            Match(compiled, ParseSelector(L"tag.c1.c2")));
+}
+
 TEST_F(CompiledStyleSheetSetTest, Hover) {
   const auto style_sheet = new css::StyleSheet();
   style_sheet->AppendRule(
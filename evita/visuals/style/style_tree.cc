@@ -57,6 +57,21 @@ void InheritStyle(css::Style* style, const css::Style& parent_style) {
 #undef V
 }
 
+// Returns true if |style1| and |style2| have different inheritable
+// properties. Children of an element need not be restyled when its
+// inheritable properties are unchanged.
+bool IsInheritedStyleChanged(const css::Style& style1,
+                             const css::Style& style2) {
+#define V(Name, name)                                        \
+  if (style1.has_##name() != style2.has_##name())            \
+    return true;                                             \
+  if (style1.has_##name() && style1.name() != style2.name()) \
+    return true;
+  FOR_EACH_INHERITABLE_PROPERTY(V)
+#undef V
+  return false;
+}
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////
@@ -125,8 +140,10 @@ class StyleTree::Impl final {
   Item* GetOrNewItem(const Node& element);
   void IncrementVersionIfNeeded(Context* context);
   css::Selector MakeSelectorForElement(const ElementNode& element) const;
+  void MarkAllDirty();
   void UpdateAsAnonymousInlineBox(Context* context, const Node& node);
   void UpdateChildren(Context* context, const ContainerNode& element);
+  void UpdateChildrenIfNeeded(Context* context, const ContainerNode& element);
   void UpdateDocumentStyleIfNeeded(Context* context);
   void UpdateElement(Context* context, const ElementNode& element);
   void UpdateElementIfNeeded(Context* context, const ElementNode& element);
@@ -170,6 +187,7 @@ void StyleTree::Impl::AddObserver(StyleTreeObserver* observer) {
 
 void StyleTree::Impl::Clear() {
   state_ = StyleTreeState::Dirty;
+  MarkAllDirty();
 }
 
 const css::Style& StyleTree::Impl::ComputedStyleOf(const Node& node) const {
@@ -262,6 +280,15 @@ css::Selector StyleTree::Impl::MakeSelectorForElement(
   return std::move(builder.Build());
 }
 
+// Marks all nodes dirty for changes affecting any node, e.g. style sheet
+// changes.
+void StyleTree::Impl::MarkAllDirty() {
+  for (const auto& entry : item_map_) {
+    entry.second->is_child_dirty = true;
+    entry.second->is_dirty = true;
+  }
+}
+
 void StyleTree::Impl::MarkDirty(const Node& node) {
   state_ = StyleTreeState::Dirty;
   GetOrNewItem(node)->is_dirty = true;
@@ -279,7 +306,9 @@ void StyleTree::Impl::MarkInclusiveAncestorsDirty(const Node& node) {
   for (const auto& ancestor : Node::Ancestors(node)) {
     const auto item = GetOrNewItem(*ancestor);
     item->is_child_dirty = true;
-    item->is_dirty = true;
+    // Only style of element depends on :focus and :hover.
+    if (ancestor->is<ElementNode>())
+      item->is_dirty = true;
   }
 }
 
@@ -322,17 +351,27 @@ void StyleTree::Impl::UpdateChildren(Context* context,
   }
 }
 
+void StyleTree::Impl::UpdateChildrenIfNeeded(Context* context,
+                                             const ContainerNode& container) {
+  for (const auto& child : container.child_nodes())
+    UpdateNodeIfNeeded(context, *child);
+}
+
 void StyleTree::Impl::UpdateDocumentStyleIfNeeded(Context* context) {
   const auto item = GetOrNewItem(document_);
   if (!item->is_dirty) {
     if (!item->is_child_dirty)
       return;
-    for (const auto& child : document_.child_nodes())
-      UpdateNodeIfNeeded(context, *child);
-    return;
+    item->is_child_dirty = false;
+    return UpdateChildrenIfNeeded(context, document_);
   }
   IncrementVersionIfNeeded(context);
+  const auto old_initial_style = std::move(initial_style_);
   initial_style_ = std::move(ComputeInitialStyle());
+  // All elements have initial style, e.g. "display", so we should restyle
+  // all elements when initial style is changed.
+  if (old_initial_style && *old_initial_style != initial_style())
+    MarkAllDirty();
   DCHECK(!initial_style().has_background_color())
       << "initial style should not have background-color property. "
       << initial_style();
@@ -347,7 +386,9 @@ void StyleTree::Impl::UpdateDocumentStyleIfNeeded(Context* context) {
   DCHECK(item->style->has_background_color())
       << "document style should not have background-color property. "
       << *item->style;
-  UpdateChildren(context, document_);
+  if (!old_style || IsInheritedStyleChanged(*old_style, *item->style))
+    return UpdateChildren(context, document_);
+  UpdateChildrenIfNeeded(context, document_);
 }
 
 void StyleTree::Impl::UpdateElement(Context* context,
@@ -362,11 +403,15 @@ void StyleTree::Impl::UpdateElement(Context* context,
   // Simple style merge check.
   DCHECK(item->style->has_display())
       << "Style merge failed. We should merge initial style. " << *item->style;
-  if (old_style) {
+  if (!old_style)
+    return UpdateChildren(context, element);
+  if (*old_style != *item->style) {
     for (auto& observer : observers_)
       observer.DidChangeComputedStyle(element, *old_style);
   }
-  UpdateChildren(context, element);
+  if (IsInheritedStyleChanged(*old_style, *item->style))
+    return UpdateChildren(context, element);
+  UpdateChildrenIfNeeded(context, element);
 }
 
 void StyleTree::Impl::UpdateElementIfNeeded(Context* context,
@@ -377,8 +422,7 @@ void StyleTree::Impl::UpdateElementIfNeeded(Context* context,
   if (!item->is_child_dirty)
     return;
   item->is_child_dirty = false;
-  for (const auto& child : element.child_nodes())
-    UpdateNodeIfNeeded(context, *child);
+  UpdateChildrenIfNeeded(context, element);
 }
 
 // The entry point
@@ -412,6 +456,10 @@ void StyleTree::Impl::UpdateNodeIfNeeded(Context* context, const Node& node) {
   if (const auto element = node.as<Element>())
     return UpdateElementIfNeeded(context, *element);
   DCHECK(!node.is<ContainerNode>()) << "Unsupported node type " << node;
+  // |Image|, |Shape| and |Text| are dirty when they are inserted.
+  if (!GetOrNewItem(node)->is_dirty)
+    return;
+  UpdateAsAnonymousInlineBox(context, node);
 }
 
 // |Image| node is treated as anonymous inline box which inherits style from
@@ -578,7 +626,7 @@ void StyleTree::DidAddClass(const ElementNode& element,
 }
 
 void StyleTree::DidAppendChild(const ContainerNode& parent, const Node& child) {
-  MarkDirty(parent);
+  MarkDirty(child);
 }
 
 void StyleTree::DidChangeInlineStyle(const ElementNode& element,
@@ -595,7 +643,7 @@ void StyleTree::DidChangeInlineStyle(const ElementNode& element,
 void StyleTree::DidInsertBefore(const ContainerNode& parent,
                                 const Node& child,
                                 const Node& ref_child) {
-  MarkDirty(parent);
+  MarkDirty(child);
 }
 
 void StyleTree::DidRemoveChild(const ContainerNode& parent, const Node& child) {
@@ -610,7 +658,7 @@ void StyleTree::DidRemoveClass(const ElementNode& element,
 void StyleTree::DidReplaceChild(const ContainerNode& parent,
                                 const Node& child,
                                 const Node& ref_child) {
-  MarkDirty(parent);
+  MarkDirty(child);
 }
 
 void StyleTree::DidSetImageData(const Image& image,
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "evita/visuals/style/style_tree.h"
 
 #include "base/observer_list.h"
@@ -14,6 +16,7 @@
 #include "evita/visuals/dom/document.h"
 #include "evita/visuals/dom/element.h"
 #include "evita/visuals/dom/node_tree_builder.h"
+#include "evita/visuals/style/style_tree_observer.h"
 #include "evita/visuals/view/public/user_action_source.h"
 #include "evita/visuals/view/public/view_lifecycle.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -21,9 +24,50 @@
 namespace visuals {
 
 namespace {
+
 css::Selector ParseSelector(base::StringPiece16 text) {
   return css::Selector::Parser().Parse(text);
 }
+
+//////////////////////////////////////////////////////////////////////
+//
+// MockStyleTreeObserver
+//
+class MockStyleTreeObserver final : public StyleTreeObserver {
+ public:
+  explicit MockStyleTreeObserver(const StyleTree& style_tree);
+  ~MockStyleTreeObserver() final;
+
+  const std::vector<const ElementNode*>& changed_elements() const {
+    return changed_elements_;
+  }
+
+ private:
+  // StyleTreeObserver
+  void DidChangeComputedStyle(const ElementNode& element,
+                              const css::Style& old_style) final;
+
+  std::vector<const ElementNode*> changed_elements_;
+  const StyleTree& style_tree_;
+
+  DISALLOW_COPY_AND_ASSIGN(MockStyleTreeObserver);
+};
+
+MockStyleTreeObserver::MockStyleTreeObserver(const StyleTree& style_tree)
+    : style_tree_(style_tree) {
+  style_tree_.AddObserver(this);
+}
+
+MockStyleTreeObserver::~MockStyleTreeObserver() {
+  style_tree_.RemoveObserver(this);
+}
+
+void MockStyleTreeObserver::DidChangeComputedStyle(
+    const ElementNode& element,
+    const css::Style& old_style) {
+  changed_elements_.push_back(&element);
+}
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////
@@ -141,6 +185,50 @@ TEST_F(StyleTreeTest, Hover) {
   lifecycle.FinishShutdown();
 }
 
+TEST_F(StyleTreeTest, HoverIncremental) {
+  const auto& kColorGreen = css::Color(css::ColorValue(0, 1, 0));
+  auto* const style_sheet = new css::StyleSheet();
+  style_sheet->AppendRule(
+      ParseSelector(L"row:hover"),
+      std::move(css::StyleBuilder().SetColor(kColorGreen).Build()));
+  const auto& document = NodeTreeBuilder()
+                             .Begin(L"body")
+                             .Begin(L"row", L"row1")
+                             .AddText(L"row1")
+                             .End(L"row")
+                             .Begin(L"row", L"row2")
+                             .AddText(L"row2")
+                             .End(L"row")
+                             .End(L"body")
+                             .Build();
+  const auto row1 = document->GetElementById(L"row1");
+  const auto row2 = document->GetElementById(L"row2");
+  ViewLifecycle lifecycle(*document, mock_media());
+  ViewLifecycle::Scope(&lifecycle, ViewLifecycle::State::Started);
+  StyleTree style_tree(&lifecycle, *this, {style_sheet});
+  MockStyleTreeObserver observer(style_tree);
+  style_tree.UpdateIfNeeded();
+  const auto row1_style = &style_tree.ComputedStyleOf(*row1);
+  const auto row1_text_style =
+      &style_tree.ComputedStyleOf(*row1->first_child());
+
+  NotifyChangeHoveredNode(row2);
+  style_tree.UpdateIfNeeded();
+  EXPECT_EQ(std::vector<const ElementNode*>{row2},
+            observer.changed_elements())
+      << "body matches no :hover rule.";
+  EXPECT_EQ(kColorGreen,
+            style_tree.ComputedStyleOf(*row2->first_child()).color());
+  EXPECT_EQ(row1_style, &style_tree.ComputedStyleOf(*row1))
+      << "row1 isn't restyled.";
+  EXPECT_EQ(row1_text_style,
+            &style_tree.ComputedStyleOf(*row1->first_child()))
+      << "Text in row1 isn't restyled.";
+
+  lifecycle.StartShutdown();
+  lifecycle.FinishShutdown();
+}
+
 TEST_F(StyleTreeTest, Inheritance) {
   const auto& kColorRed = css::Color(css::ColorValue(1, 0, 0));
   const auto& document =